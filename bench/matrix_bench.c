@@ -0,0 +1,735 @@
+/**
+ * @file matrix_bench.c
+ * @brief Микробенчмарки матричных операций
+ * @defgroup Matrix_Bench
+ *
+ * Для каждой операции перебираются размеры и формы матриц. Каждый случай
+ * измеряется так:
+ * 1. Прогрев: одна операция, результат которой отбрасывается (первое обращение
+ *    к памяти и файлам заметно медленнее остальных).
+ * 2. Калибровка: число повторений операции в одном замере подбирается так, чтобы
+ *    замер длился не меньше --min-sample (иначе разрешения таймера не хватает
+ *    для маленьких матриц).
+ * 3. Серия замеров, пока не израсходовано --time-per-case секунд (не меньше
+ *    BENCH_MIN_SAMPLES и не больше --max-samples замеров).
+ *
+ * Для времени одной операции выводятся минимум, медиана и процентили, а также
+ * производительность (GFLOP/s) и пропускная способность (GB/s) по медиане.
+ * Результаты печатаются таблицей и сохраняются в JSON.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/include/config.h"
+#include "../src/matrix/matrix_operations.h"
+#include "../src/matrix/simd_kernels.h"
+#include "../src/matrix/thread_pool.h"
+#include "../src/output/output.h"
+
+/**
+ * @brief Наименьшее число замеров одного случая
+ */
+#define BENCH_MIN_SAMPLES 3
+
+/**
+ * @brief Наибольшее число замеров одного случая по умолчанию
+ */
+#define BENCH_MAX_SAMPLES 25
+
+/**
+ * @brief Наибольшее число повторений операции в одном замере
+ */
+#define BENCH_MAX_INNER 1000000
+
+/**
+ * @brief Наибольшее число размеров в списке
+ */
+#define BENCH_MAX_SIZES 32
+
+/**
+ * @brief Параметры запуска
+ */
+typedef struct {
+    const char *json_path;      /**< Файл для JSON или NULL */
+    const char *ops;            /**< Список операций через запятую или NULL (все) */
+    const char *tmpdir;         /**< Каталог для временных файлов */
+    int sizes[BENCH_MAX_SIZES]; /**< Размеры */
+    int size_count;             /**< Число размеров */
+    int max_samples;            /**< Наибольшее число замеров */
+    double time_per_case;       /**< Время на один случай, с */
+    double min_sample_ns;       /**< Наименьшая длительность замера, нс */
+    double max_memory;          /**< Наибольший объем данных случая, байт */
+    double max_op_time_ns;      /**< Наибольшее ожидаемое время одной операции, нс */
+} BenchConfig;
+
+/**
+ * @brief Данные одного случая
+ */
+typedef struct {
+    int rows, cols, depth; /**< Размеры: A rows×depth, B depth×cols для умножения */
+    Matrix a, b, dst;      /**< Операнды и результат */
+    char path[4096];       /**< Временный файл для загрузки и сохранения */
+    double file_bytes;     /**< Размер файла */
+    volatile double sink;  /**< Сток для результатов, чтобы их не выбросил компилятор */
+} BenchState;
+
+/**
+ * @brief Описание измеряемой операции
+ */
+typedef struct {
+    const char *name;                          /**< Имя операции */
+    int square_only;                           /**< Только квадратные матрицы */
+    int uses_depth;                            /**< Форма задает три размера */
+    int files;                                 /**< Работает с файлами */
+    void (*setup)(BenchState *state);          /**< Подготовка данных */
+    void (*run)(BenchState *state);            /**< Одна операция */
+    double (*flops)(const BenchState *state);  /**< Операций с плавающей точкой */
+    double (*bytes)(const BenchState *state);  /**< Минимальный объем данных */
+    double (*memory)(const BenchState *state); /**< Объем памяти случая */
+} BenchOperation;
+
+/**
+ * @brief Результат одного случая
+ */
+typedef struct {
+    const BenchOperation *op;
+    int rows, cols, depth;
+    int inner;                                    /**< Повторений в замере */
+    int samples;                                  /**< Число замеров */
+    double min, p10, median, p90, p99, max, mean; /**< Время одной операции, нс */
+    double gflops;                                /**< GFLOP/s по медиане */
+    double gbps;                                  /**< GB/s по медиане */
+} BenchResult;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Заполняет матрицу псевдослучайными числами из [-1, 1)
+ */
+static void fill_random(Matrix mat, unsigned seed) {
+    uint64_t state = 0x9E3779B97F4A7C15ull ^ seed;
+    for (int iter = 0; iter < mat.rows; iter++) {
+        double *row = MATRIX_ROW(mat, iter);
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            row[iter_2] = (double)(state >> 11) / 4503599627370496.0 - 1.0;
+        }
+    }
+}
+
+static Matrix random_matrix(int rows, int cols, unsigned seed) {
+    Matrix mat = create_matrix(rows, cols);
+    fill_random(mat, seed);
+    return mat;
+}
+
+static double elements(const BenchState *state) {
+    return (double)state->rows * (double)state->cols;
+}
+
+static double zero(const BenchState *state) {
+    (void)state;
+    return 0.0;
+}
+
+/* create: выделение и обнуление матрицы */
+
+static void setup_none(BenchState *state) {
+    (void)state;
+}
+
+static void run_create(BenchState *state) {
+    Matrix mat = create_matrix(state->rows, state->cols);
+    free_matrix(mat);
+}
+
+static double bytes_one(const BenchState *state) {
+    return elements(state) * sizeof(double);
+}
+
+/* copy, transpose: один операнд и результат */
+
+static void setup_unary(BenchState *state) {
+    state->a = random_matrix(state->rows, state->cols, 1);
+    state->dst = create_matrix(state->rows, state->cols);
+}
+
+static void setup_transpose(BenchState *state) {
+    state->a = random_matrix(state->rows, state->cols, 1);
+    state->dst = create_matrix(state->cols, state->rows);
+}
+
+static void run_copy(BenchState *state) {
+    copy_matrix_into(&state->dst, state->a);
+}
+
+static void run_transpose(BenchState *state) {
+    transpose_matrix_into(&state->dst, state->a);
+}
+
+static double bytes_two(const BenchState *state) {
+    return 2.0 * elements(state) * sizeof(double);
+}
+
+/* add, subtract: два операнда и результат */
+
+static void setup_binary(BenchState *state) {
+    state->a = random_matrix(state->rows, state->cols, 1);
+    state->b = random_matrix(state->rows, state->cols, 2);
+    state->dst = create_matrix(state->rows, state->cols);
+}
+
+static void run_add(BenchState *state) {
+    plus_matrices_into(&state->dst, state->a, state->b);
+}
+
+static void run_subtract(BenchState *state) {
+    subtract_matrices_into(&state->dst, state->a, state->b);
+}
+
+static double bytes_three(const BenchState *state) {
+    return 3.0 * elements(state) * sizeof(double);
+}
+
+/* multiply: A rows×depth, B depth×cols */
+
+static void setup_multiply(BenchState *state) {
+    state->a = random_matrix(state->rows, state->depth, 1);
+    state->b = random_matrix(state->depth, state->cols, 2);
+    state->dst = create_matrix(state->rows, state->cols);
+}
+
+static void run_multiply(BenchState *state) {
+    multiply_matrices_into(&state->dst, state->a, state->b);
+}
+
+static double flops_multiply(const BenchState *state) {
+    return 2.0 * state->rows * (double)state->cols * state->depth;
+}
+
+static double bytes_multiply(const BenchState *state) {
+    double m = state->rows, n = state->cols, k = state->depth;
+    return (m * k + k * n + m * n) * sizeof(double);
+}
+
+/* determinant: LU-разложение копии */
+
+static void setup_square(BenchState *state) {
+    state->a = random_matrix(state->rows, state->cols, 1);
+}
+
+static void run_determinant(BenchState *state) {
+    state->sink = determinant(state->a);
+}
+
+static double flops_determinant(const BenchState *state) {
+    double n = state->rows;
+    return 2.0 / 3.0 * n * n * n;
+}
+
+/* load, save: текстовый и двоичный форматы во временном файле */
+
+static double file_size(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0.0;
+    }
+    fseek(file, 0, SEEK_END);
+    double size = (double)ftell(file);
+    fclose(file);
+    return size;
+}
+
+static void run_save_text(BenchState *state) {
+    if (save_matrix_to_file(&state->a, state->path) != 0) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void run_save_binary(BenchState *state) {
+    if (save_matrix_to_binary_file(&state->a, state->path) != 0) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void setup_save_text(BenchState *state) {
+    setup_square(state);
+    run_save_text(state);
+    state->file_bytes = file_size(state->path);
+}
+
+static void setup_save_binary(BenchState *state) {
+    setup_square(state);
+    run_save_binary(state);
+    state->file_bytes = file_size(state->path);
+}
+
+static void setup_load_text(BenchState *state) {
+    setup_save_text(state);
+    free_matrix(state->a);
+    state->a.data = NULL;
+}
+
+static void setup_load_binary(BenchState *state) {
+    setup_save_binary(state);
+    free_matrix(state->a);
+    state->a.data = NULL;
+}
+
+/**
+ * @brief Загружает матрицу и читает все элементы
+ *
+ * Двоичный файл отображается в память лениво, поэтому без чтения элементов
+ * измерялось бы только создание отображения.
+ */
+static void run_load(BenchState *state) {
+    Matrix mat = load_matrix_from_file(state->path);
+    double sum = 0.0;
+    for (int iter = 0; iter < mat.rows; iter++) {
+        const double *row = MATRIX_ROW(mat, iter);
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            sum += row[iter_2];
+        }
+    }
+    state->sink = sum;
+    free_matrix(mat);
+}
+
+static double bytes_file(const BenchState *state) {
+    return state->file_bytes;
+}
+
+static double memory_one(const BenchState *state) {
+    return elements(state) * sizeof(double);
+}
+
+static double memory_two(const BenchState *state) {
+    return 2.0 * elements(state) * sizeof(double);
+}
+
+static double memory_three(const BenchState *state) {
+    return 3.0 * elements(state) * sizeof(double);
+}
+
+static double memory_file(const BenchState *state) {
+    /* Матрица, файл (до 25 символов на элемент) и буферы разбора */
+    return elements(state) * (2.0 * sizeof(double) + 25.0);
+}
+
+/**
+ * @brief Измеряемые операции
+ */
+static const BenchOperation operations[] = {
+    {"create", 0, 0, 0, setup_none, run_create, zero, bytes_one, memory_one},
+    {"copy", 0, 0, 0, setup_unary, run_copy, zero, bytes_two, memory_two},
+    {"add", 0, 0, 0, setup_binary, run_add, elements, bytes_three, memory_three},
+    {"subtract", 0, 0, 0, setup_binary, run_subtract, elements, bytes_three, memory_three},
+    {"multiply", 0, 1, 0, setup_multiply, run_multiply, flops_multiply, bytes_multiply,
+     bytes_multiply},
+    {"transpose", 0, 0, 0, setup_transpose, run_transpose, zero, bytes_two, memory_two},
+    {"determinant", 1, 0, 0, setup_square, run_determinant, flops_determinant, bytes_two,
+     memory_two},
+    {"save_text", 0, 0, 1, setup_save_text, run_save_text, zero, bytes_file, memory_file},
+    {"load_text", 0, 0, 1, setup_load_text, run_load, zero, bytes_file, memory_file},
+    {"save_binary", 0, 0, 1, setup_save_binary, run_save_binary, zero, bytes_file, memory_file},
+    {"load_binary", 0, 0, 1, setup_load_binary, run_load, zero, bytes_file, memory_file},
+};
+
+/**
+ * @brief Форма матриц относительно размера n
+ */
+typedef struct {
+    const char *name;
+    int square;               /**< Квадратные операнды */
+    int multiply_only;        /**< Только для умножения */
+    int rows_mul, rows_div;   /**< rows = n · rows_mul / rows_div */
+    int cols_mul, cols_div;   /**< cols = n · cols_mul / cols_div */
+    int depth_mul, depth_div; /**< depth = n · depth_mul / depth_div (только умножение) */
+} BenchShape;
+
+/**
+ * @brief Формы: квадратная, высокая, широкая; для умножения - внутреннее
+ * произведение узких панелей и произведение на узкую панель
+ */
+static const BenchShape shapes[] = {
+    {"square", 1, 0, 1, 1, 1, 1, 1, 1},
+    {"tall", 0, 0, 4, 1, 1, 4, 1, 1},
+    {"wide", 0, 0, 1, 4, 4, 1, 1, 1},
+    {"panel", 0, 1, 1, 1, 1, 1, 1, 16},
+    {"skinny", 0, 1, 1, 1, 1, 16, 1, 1},
+};
+
+static int operation_selected(const BenchConfig *config, const char *name) {
+    if (config->ops == NULL) {
+        return 1;
+    }
+    size_t length = strlen(name);
+    const char *list = config->ops;
+    while (*list) {
+        const char *comma = strchr(list, ',');
+        size_t item = comma ? (size_t)(comma - list) : strlen(list);
+        if (item == length && strncmp(list, name, length) == 0) {
+            return 1;
+        }
+        list += item + (comma ? 1 : 0);
+    }
+    return 0;
+}
+
+static double percentile(const double *sorted, int count, double p) {
+    double position = p * (count - 1);
+    int low = (int)position;
+    int high = low + 1 < count ? low + 1 : low;
+    return sorted[low] + (sorted[high] - sorted[low]) * (position - low);
+}
+
+static int compare_doubles(const void *lhs, const void *rhs) {
+    double a = *(const double *)lhs, b = *(const double *)rhs;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Время inner повторений операции, нс
+ */
+static double sample(const BenchOperation *op, BenchState *state, int inner) {
+    double start = now_ns();
+    for (int iter = 0; iter < inner; iter++) {
+        op->run(state);
+    }
+    return now_ns() - start;
+}
+
+/**
+ * @brief Измеряет один случай
+ */
+static void measure(const BenchConfig *config, const BenchOperation *op, BenchState *state,
+                    BenchResult *result) {
+    /* Прогрев */
+    op->run(state);
+
+    /* Калибровка */
+    int inner = 1;
+    double elapsed = sample(op, state, inner);
+    while (elapsed < config->min_sample_ns && inner < BENCH_MAX_INNER) {
+        double factor = elapsed > 0.0 ? config->min_sample_ns / elapsed * 1.2 : 10.0;
+        factor = factor < 2.0 ? 2.0 : factor > 100.0 ? 100.0 : factor;
+        inner = (int)fmin(inner * factor, BENCH_MAX_INNER);
+        elapsed = sample(op, state, inner);
+    }
+
+    double times[BENCH_MAX_SAMPLES * 4];
+    int max_samples = config->max_samples;
+    int count = 0;
+    double spent = 0.0;
+    while (count < max_samples &&
+           (count < BENCH_MIN_SAMPLES || spent < config->time_per_case * 1e9)) {
+        double ns = sample(op, state, inner);
+        spent += ns;
+        times[count++] = ns / inner;
+    }
+    qsort(times, (size_t)count, sizeof(double), compare_doubles);
+
+    double sum = 0.0;
+    for (int iter = 0; iter < count; iter++) {
+        sum += times[iter];
+    }
+    result->inner = inner;
+    result->samples = count;
+    result->min = times[0];
+    result->p10 = percentile(times, count, 0.10);
+    result->median = percentile(times, count, 0.50);
+    result->p90 = percentile(times, count, 0.90);
+    result->p99 = percentile(times, count, 0.99);
+    result->max = times[count - 1];
+    result->mean = sum / count;
+    result->gflops = op->flops(state) / result->median;
+    result->gbps = op->bytes(state) / result->median;
+}
+
+static void release_state(BenchState *state) {
+    free_matrix(state->a);
+    free_matrix(state->b);
+    free_matrix(state->dst);
+    if (state->path[0] != '\0') {
+        remove(state->path);
+    }
+}
+
+/**
+ * @brief Форматирует время с подходящей единицей
+ */
+static const char *format_time(double ns, char *buffer, size_t size) {
+    if (ns < 1e3) {
+        snprintf(buffer, size, "%.1f ns", ns);
+    } else if (ns < 1e6) {
+        snprintf(buffer, size, "%.2f us", ns / 1e3);
+    } else if (ns < 1e9) {
+        snprintf(buffer, size, "%.2f ms", ns / 1e6);
+    } else {
+        snprintf(buffer, size, "%.3f s", ns / 1e9);
+    }
+    return buffer;
+}
+
+static void format_shape(const BenchResult *result, char *buffer, size_t size) {
+    if (result->op->uses_depth) {
+        snprintf(buffer, size, "%dx%dx%d", result->rows, result->depth, result->cols);
+    } else {
+        snprintf(buffer, size, "%dx%d", result->rows, result->cols);
+    }
+}
+
+static void print_header(const BenchOperation *op) {
+    printf("\n%s\n", op->name);
+    printf("%-20s %9s %11s %11s %11s %11s %11s %9s %9s\n", "shape", "samples", "min", "p10",
+           "median", "p90", "p99", "GFLOP/s", "GB/s");
+}
+
+static void print_result(const BenchResult *result) {
+    char shape[64], t1[32], t2[32], t3[32], t4[32], t5[32], reps[32];
+    format_shape(result, shape, sizeof(shape));
+    snprintf(reps, sizeof(reps), "%dx%d", result->samples, result->inner);
+    printf("%-20s %9s %11s %11s %11s %11s %11s %9.2f %9.2f\n", shape, reps,
+           format_time(result->min, t1, sizeof(t1)), format_time(result->p10, t2, sizeof(t2)),
+           format_time(result->median, t3, sizeof(t3)), format_time(result->p90, t4, sizeof(t4)),
+           format_time(result->p99, t5, sizeof(t5)), result->gflops, result->gbps);
+    fflush(stdout);
+}
+
+/**
+ * @brief Сохраняет результаты в JSON
+ * @return 0 при успехе, -1 при ошибке
+ */
+static int write_json(const BenchConfig *config, const BenchResult *results, int count) {
+    FILE *file = fopen(config->json_path, "w");
+    if (file == NULL) {
+        perror("Ошибка открытя файла!");
+        return -1;
+    }
+    fprintf(file, "{\n  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(file, "  \"threads\": %d,\n  \"simd\": \"%s\",\n", matrix_get_num_threads(),
+            simd_kernels()->name);
+    fprintf(file, "  \"time_per_case_s\": %g,\n  \"min_sample_ns\": %g,\n",
+            config->time_per_case, config->min_sample_ns);
+    fprintf(file, "  \"results\": [");
+    for (int iter = 0; iter < count; iter++) {
+        const BenchResult *result = &results[iter];
+        fprintf(file, "%s\n    {\"operation\": \"%s\", \"rows\": %d, \"cols\": %d", iter ? "," : "",
+                result->op->name, result->rows, result->cols);
+        if (result->op->uses_depth) {
+            fprintf(file, ", \"depth\": %d", result->depth);
+        }
+        fprintf(file, ", \"samples\": %d, \"inner\": %d,\n", result->samples, result->inner);
+        fprintf(file,
+                "     \"ns_per_op\": {\"min\": %.6g, \"p10\": %.6g, \"median\": %.6g, "
+                "\"p90\": %.6g, \"p99\": %.6g, \"max\": %.6g, \"mean\": %.6g},\n",
+                result->min, result->p10, result->median, result->p90, result->p99, result->max,
+                result->mean);
+        fprintf(file, "     \"gflops\": %.6g, \"gbps\": %.6g}", result->gflops, result->gbps);
+    }
+    fprintf(file, "\n  ]\n}\n");
+    if (fclose(file) != 0) {
+        perror("Ошибка записи файла!");
+        return -1;
+    }
+    return 0;
+}
+
+static void usage(const char *program) {
+    printf("Использование: %s [параметры]\n"
+           "  --ops LIST           операции через запятую (по умолчанию все):\n"
+           "                       create,copy,add,subtract,multiply,transpose,determinant,\n"
+           "                       save_text,load_text,save_binary,load_binary\n"
+           "  --sizes LIST         размеры n через запятую\n"
+           "  --quick              небольшие размеры и короткие замеры\n"
+           "  --threads N          число потоков\n"
+           "  --time-per-case S    время на один случай, с (по умолчанию 0.3)\n"
+           "  --max-samples N      наибольшее число замеров (по умолчанию %d)\n"
+           "  --min-sample US      наименьшая длительность замера, мкс (по умолчанию 200)\n"
+           "  --max-memory MB      пропускать случаи, которым нужно больше памяти\n"
+           "  --max-op-time S      пропускать размеры, для которых одна операция по оценке\n"
+           "                       займет больше S секунд (по умолчанию 1)\n"
+           "  --tmpdir DIR         каталог для временных файлов (по умолчанию /tmp)\n"
+           "  --json FILE          файл JSON (по умолчанию matrix_bench.json)\n"
+           "  --no-json            не сохранять JSON\n",
+           program, BENCH_MAX_SAMPLES);
+}
+
+static int parse_sizes(BenchConfig *config, const char *list) {
+    config->size_count = 0;
+    while (*list && config->size_count < BENCH_MAX_SIZES) {
+        char *end;
+        long value = strtol(list, &end, 10);
+        if (end == list || value <= 0 || value > 1 << 20) {
+            return -1;
+        }
+        config->sizes[config->size_count++] = (int)value;
+        list = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') {
+            return -1;
+        }
+    }
+    return config->size_count > 0 ? 0 : -1;
+}
+
+static void parse_args(BenchConfig *config, int argc, char **argv) {
+    static const int default_sizes[] = {2, 8, 32, 100, 256, 1000, 1024, 2048, 4096, 10000,
+                                        16384, 32768};
+    memcpy(config->sizes, default_sizes, sizeof(default_sizes));
+    config->size_count = (int)(sizeof(default_sizes) / sizeof(default_sizes[0]));
+    config->json_path = "matrix_bench.json";
+    config->ops = NULL;
+    config->tmpdir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    config->max_samples = BENCH_MAX_SAMPLES;
+    config->time_per_case = 0.3;
+    config->min_sample_ns = 200e3;
+    config->max_op_time_ns = 1e9;
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    config->max_memory = pages > 0 && page_size > 0 ? (double)pages * page_size / 4 : 1e9;
+
+    for (int iter = 1; iter < argc; iter++) {
+        const char *arg = argv[iter];
+        const char *value = iter + 1 < argc ? argv[iter + 1] : NULL;
+        int takes_value = 1;
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0]);
+            exit(EXIT_SUCCESS);
+        } else if (strcmp(arg, "--quick") == 0) {
+            static const int quick_sizes[] = {2, 8, 32, 100, 256};
+            memcpy(config->sizes, quick_sizes, sizeof(quick_sizes));
+            config->size_count = (int)(sizeof(quick_sizes) / sizeof(quick_sizes[0]));
+            config->time_per_case = 0.05;
+            config->max_samples = 10;
+            takes_value = 0;
+        } else if (strcmp(arg, "--no-json") == 0) {
+            config->json_path = NULL;
+            takes_value = 0;
+        } else if (value == NULL) {
+            fprintf(stderr, "Неизвестный параметр или нет значения: %s!\n", arg);
+            exit(EXIT_FAILURE);
+        } else if (strcmp(arg, "--ops") == 0) {
+            config->ops = value;
+        } else if (strcmp(arg, "--sizes") == 0) {
+            if (parse_sizes(config, value) != 0) {
+                fprintf(stderr, "Неверный список размеров: %s!\n", value);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(arg, "--threads") == 0) {
+            matrix_set_num_threads(atoi(value));
+        } else if (strcmp(arg, "--time-per-case") == 0) {
+            config->time_per_case = atof(value);
+        } else if (strcmp(arg, "--max-samples") == 0) {
+            int samples = atoi(value);
+            config->max_samples = samples < BENCH_MIN_SAMPLES   ? BENCH_MIN_SAMPLES
+                                  : samples > BENCH_MAX_SAMPLES * 4 ? BENCH_MAX_SAMPLES * 4
+                                                                    : samples;
+        } else if (strcmp(arg, "--min-sample") == 0) {
+            config->min_sample_ns = atof(value) * 1e3;
+        } else if (strcmp(arg, "--max-memory") == 0) {
+            config->max_memory = atof(value) * 1024.0 * 1024.0;
+        } else if (strcmp(arg, "--max-op-time") == 0) {
+            config->max_op_time_ns = atof(value) * 1e9;
+        } else if (strcmp(arg, "--tmpdir") == 0) {
+            config->tmpdir = value;
+        } else if (strcmp(arg, "--json") == 0) {
+            config->json_path = value;
+        } else {
+            fprintf(stderr, "Неизвестный параметр: %s!\n", arg);
+            exit(EXIT_FAILURE);
+        }
+        iter += takes_value;
+    }
+}
+
+/**
+ * @brief Точка входа: перебирает операции, формы и размеры
+ * @return 0 при успешном выполнении, EXIT_FAILURE при ошибке
+ */
+int main(int argc, char **argv) {
+    BenchConfig config;
+    parse_args(&config, argc, argv);
+    printf("Потоков: %d, векторные ядра: %s\n", matrix_get_num_threads(), simd_kernels()->name);
+
+    const int op_count = (int)(sizeof(operations) / sizeof(operations[0]));
+    const int shape_count = (int)(sizeof(shapes) / sizeof(shapes[0]));
+    int capacity = op_count * shape_count * config.size_count;
+    BenchResult *results = (BenchResult *)calloc((size_t)capacity, sizeof(BenchResult));
+    if (results == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти!\n");
+        return EXIT_FAILURE;
+    }
+    int count = 0;
+
+    for (int iter = 0; iter < op_count; iter++) {
+        const BenchOperation *op = &operations[iter];
+        if (!operation_selected(&config, op->name)) {
+            continue;
+        }
+        print_header(op);
+        for (int iter_2 = 0; iter_2 < shape_count; iter_2++) {
+            const BenchShape *shape = &shapes[iter_2];
+            if ((shape->multiply_only && !op->uses_depth) ||
+                ((op->square_only || op->files) && !shape->square)) {
+                continue;
+            }
+            /* Время предыдущего размера для оценки времени следующего */
+            double previous_time = 0.0;
+            double previous_work = 0.0;
+            for (int iter_3 = 0; iter_3 < config.size_count; iter_3++) {
+                const int n = config.sizes[iter_3];
+                BenchState state;
+                memset(&state, 0, sizeof(state));
+                state.rows = (int)((long long)n * shape->rows_mul / shape->rows_div);
+                state.cols = (int)((long long)n * shape->cols_mul / shape->cols_div);
+                state.depth = (int)((long long)n * shape->depth_mul / shape->depth_div);
+                if (state.rows < 1 || state.cols < 1 || state.depth < 1 ||
+                    (!shape->square && n < 16)) {
+                    continue;
+                }
+                double work = fmax(op->flops(&state), op->memory(&state));
+                if (op->memory(&state) > config.max_memory ||
+                    (previous_work > 0.0 &&
+                     previous_time * work / previous_work > config.max_op_time_ns)) {
+                    continue;
+                }
+                if (op->files) {
+                    snprintf(state.path, sizeof(state.path), "%s/matrix_bench_%ld.tmp",
+                             config.tmpdir, (long)getpid());
+                }
+
+                op->setup(&state);
+                BenchResult *result = &results[count++];
+                result->op = op;
+                result->rows = state.rows;
+                result->cols = state.cols;
+                result->depth = state.depth;
+                measure(&config, op, &state, result);
+                print_result(result);
+                previous_time = result->median;
+                previous_work = work;
+                release_state(&state);
+            }
+        }
+    }
+
+    int status = 0;
+    if (config.json_path != NULL) {
+        status = write_json(&config, results, count);
+        if (status == 0) {
+            printf("\nРезультаты сохранены в %s\n", config.json_path);
+        }
+    }
+    free(results);
+    thread_pool_shutdown();
+    return status == 0 ? 0 : EXIT_FAILURE;
+}
@@ -8,18 +8,165 @@
 #ifndef MATRIX_STRUCT_H
 #define MATRIX_STRUCT_H
 
+#include <stddef.h>
+
+/**
+ * @brief Выравнивание буфера данных матрицы в байтах (одна строка кэша)
+ */
+#define MATRIX_ALIGNMENT 64
+
+/**
+ * @brief Минимальное число столбцов, начиная с которого строки дополняются до выравнивания
+ *
+ * Для узких матриц выравнивание каждой строки дало бы слишком большой перерасход памяти,
+ * поэтому у них ведущая размерность совпадает с числом столбцов.
+ */
+#define MATRIX_PAD_MIN_COLS 32
+
+/**
+ * @brief Флаг матрицы: буфер данных не принадлежит матрице (free_matrix его не освобождает)
+ *
+ * Устанавливается для матриц, размещенных в арене (matrix_arena.h).
+ */
+#define MATRIX_BORROWED 0x1u
+
+/**
+ * @brief Флаг матрицы: буфер данных отображен из файла (mmap), free_matrix снимает отображение
+ *
+ * Устанавливается для матриц, загруженных из двоичного файла (matrix_binary.h).
+ */
+#define MATRIX_MAPPED 0x2u
+
+/**
+ * @brief Флаг матрицы: элементы доступны только для чтения
+ *
+ * Такая матрица не может быть результатом операций *_into.
+ */
+#define MATRIX_READONLY 0x4u
+
+/**
+ * @brief Флаг матрицы: представление части другой матрицы (matrix_view)
+ *
+ * Представление использует буфер и ведущую размерность исходной матрицы и всегда
+ * имеет флаг MATRIX_BORROWED.
+ */
+#define MATRIX_VIEW 0x8u
+
+/**
+ * @brief Флаг матрицы: буфер со счетчиком ссылок, разделяемый копиями (copy-on-write)
+ *
+ * Устанавливается для матриц, созданных в режиме matrix_set_copy_on_write. Перед
+ * записью элементов через MATRIX_AT такую матрицу нужно сделать изменяемой
+ * (matrix_make_writable); операции *_into делают это сами.
+ */
+#define MATRIX_SHARED 0x10u
+
 /**
  * @brief Структура, представляющая матрицу
  *
- * Структура содержит данные о размерах матрицы (количество строк и столбцов)
- * и указатель на двумерный массив с элементами матрицы типа double.
+ * Элементы хранятся построчно в одном непрерывном буфере. Строка с номером i
+ * начинается с элемента data[i * stride], где stride (ведущая размерность)
+ * не меньше числа столбцов.
  */
 typedef struct {
-    int rows;      /**< Количество строк в матрице */
-    int cols;      /**< Количество столбцов в матрице */
-    double **data; /**< Указатель на двумерный массив данных матрицы */
+    int rows;       /**< Количество строк в матрице */
+    int cols;       /**< Количество столбцов в матрице */
+    int stride;     /**< Ведущая размерность: расстояние между началами строк в элементах */
+    double *data;   /**< Указатель на непрерывный буфер элементов матрицы */
+    unsigned flags; /**< Флаги владения буфером (MATRIX_BORROWED, MATRIX_MAPPED и др.) */
 } Matrix;
 
+/**
+ * @brief Указатель на начало строки row матрицы mat (Matrix или MatrixF)
+ */
+#define MATRIX_ROW(mat, row) ((mat).data + (size_t)(row) * (size_t)(mat).stride)
+
+/**
+ * @brief Доступ к элементу (row, col) матрицы mat (может использоваться как lvalue)
+ *
+ * Заменяет прежнее обращение mat.data[row][col].
+ */
+#define MATRIX_AT(mat, row, col) (MATRIX_ROW(mat, row)[(col)])
+
+/**
+ * @brief Матрица одинарной точности (float)
+ *
+ * Устроена так же, как Matrix, и использует те же флаги; строки выравниваются на
+ * MATRIX_ALIGNMENT байт, поэтому в строке кэша помещается вдвое больше элементов.
+ * Операции над ней объявлены в matrix_float.h, доступ к элементам - те же MATRIX_ROW
+ * и MATRIX_AT.
+ */
+typedef struct {
+    int rows;       /**< Количество строк в матрице */
+    int cols;       /**< Количество столбцов в матрице */
+    int stride;     /**< Ведущая размерность: расстояние между началами строк в элементах */
+    float *data;    /**< Указатель на непрерывный буфер элементов матрицы */
+    unsigned flags; /**< Флаги владения буфером (MATRIX_BORROWED, MATRIX_MAPPED и др.) */
+} MatrixF;
+
+/**
+ * @brief Формат хранения разреженной матрицы
+ */
+typedef enum {
+    SPARSE_CSR = 0, /**< Сжатые строки: ненулевые элементы сгруппированы по строкам */
+    SPARSE_CSC      /**< Сжатые столбцы: ненулевые элементы сгруппированы по столбцам */
+} SparseFormat;
+
+/**
+ * @brief Структура, представляющая разреженную матрицу
+ *
+ * Хранятся только ненулевые элементы. Основное измерение - строки для SPARSE_CSR
+ * и столбцы для SPARSE_CSC. Элементы линии (строки или столбца) с номером i
+ * занимают позиции [offsets[i], offsets[i + 1]) массивов indices и values,
+ * indices содержит номера во втором измерении в порядке возрастания без повторов.
+ */
+typedef struct {
+    int rows;            /**< Количество строк в матрице */
+    int cols;            /**< Количество столбцов в матрице */
+    SparseFormat format; /**< Формат хранения */
+    size_t *offsets;     /**< Начала линий основного измерения (их число + 1 элемент) */
+    int *indices;        /**< Номера элементов во втором измерении */
+    double *values;      /**< Значения ненулевых элементов */
+} SparseMatrix;
+
+/**
+ * @brief Число линий основного измерения разреженной матрицы (строк CSR, столбцов CSC)
+ */
+#define SPARSE_MAJOR(mat) ((mat).format == SPARSE_CSR ? (mat).rows : (mat).cols)
+
+/**
+ * @brief Число хранимых ненулевых элементов разреженной матрицы
+ */
+#define SPARSE_NNZ(mat) ((mat).offsets[SPARSE_MAJOR(mat)])
+
+/**
+ * @brief Вид квадратной матрицы в упакованном хранении
+ */
+typedef enum {
+    PACKED_SYMMETRIC = 0, /**< Симметричная: хранится нижний треугольник */
+    PACKED_LOWER,         /**< Нижняя треугольная: элементы над диагональю равны нулю */
+    PACKED_UPPER          /**< Верхняя треугольная: элементы под диагональю равны нулю */
+} PackedKind;
+
+/**
+ * @brief Структура, представляющая симметричную или треугольную матрицу в упакованном виде
+ *
+ * Хранится только один треугольник вместе с диагональю, построчно и без промежутков:
+ * n·(n + 1)/2 элементов. Строка i нижнего треугольника содержит столбцы [0, i] и
+ * начинается с элемента i·(i + 1)/2; строка i верхнего треугольника содержит
+ * столбцы [i, n) и начинается с элемента i·n - i·(i - 1)/2.
+ */
+typedef struct {
+    int order;       /**< Порядок матрицы */
+    PackedKind kind; /**< Вид матрицы */
+    double *data;    /**< Элементы хранимого треугольника */
+} PackedMatrix;
+
+/**
+ * @brief Число элементов упакованной матрицы порядка order
+ */
+#define PACKED_SIZE(order) ((size_t)(order) * ((size_t)(order) + 1) / 2)
+
 #endif
 
-/** @} */
\ No newline at end of file
+/** @} */
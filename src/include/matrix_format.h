@@ -0,0 +1,78 @@
+/**
+ * @file matrix_format.h
+ * @brief Двоичный формат файла матрицы
+ * @defgroup Matrix_Format
+ * @{
+ *
+ * Файл состоит из заголовка MatrixFileHeader (64 байта) и следующих за ним
+ * строк матрицы: rows строк по stride элементов типа dtype (double или float), из
+ * которых значимы первые cols. Шаг строк совпадает с matrix_stride_for(cols)
+ * (matrix_stride_for_f для float), а данные начинаются со смещения 64, поэтому
+ * при отображении файла в память
+ * (mmap выравнивает начало на границу страницы) строки выровнены так же,
+ * как у матрицы из create_matrix, и файл используется без копирования.
+ */
+
+#ifndef MATRIX_FORMAT_H
+#define MATRIX_FORMAT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Сигнатура двоичного файла матрицы (первые 8 байт)
+ */
+#define MATRIX_FILE_MAGIC "MATRIX\x1a\n"
+
+/**
+ * @brief Длина сигнатуры в байтах
+ */
+#define MATRIX_FILE_MAGIC_SIZE 8
+
+/**
+ * @brief Текущая версия формата
+ */
+#define MATRIX_FILE_VERSION 1
+
+/**
+ * @brief Тип элементов: double (IEEE 754, 8 байт)
+ */
+#define MATRIX_DTYPE_FLOAT64 1
+
+/**
+ * @brief Тип элементов: float (IEEE 754, 4 байта)
+ */
+#define MATRIX_DTYPE_FLOAT32 2
+
+/**
+ * @brief Метка порядка байт: записывается в порядке байт записавшей машины
+ *
+ * При чтении на машине с другим порядком байт метка читается как 0x04030201.
+ */
+#define MATRIX_FILE_ENDIAN_MARK 0x01020304u
+
+/**
+ * @brief Размер заголовка и смещение данных в байтах
+ */
+#define MATRIX_FILE_HEADER_SIZE 64
+
+/**
+ * @brief Заголовок двоичного файла матрицы
+ *
+ * Все поля после magic записываются в порядке байт, заданном меткой endianness.
+ */
+typedef struct {
+    char magic[MATRIX_FILE_MAGIC_SIZE]; /**< Сигнатура MATRIX_FILE_MAGIC */
+    uint32_t version;                   /**< Версия формата (MATRIX_FILE_VERSION) */
+    uint32_t dtype;                     /**< Тип элементов (MATRIX_DTYPE_FLOAT64 или FLOAT32) */
+    uint32_t endianness;                /**< Метка порядка байт (MATRIX_FILE_ENDIAN_MARK) */
+    uint32_t alignment;                 /**< Выравнивание данных и строк в байтах */
+    uint64_t rows;                      /**< Количество строк */
+    uint64_t cols;                      /**< Количество столбцов */
+    uint64_t stride;                    /**< Шаг между началами строк в элементах */
+    uint64_t data_offset;               /**< Смещение данных от начала файла в байтах */
+    uint64_t reserved;                  /**< Зарезервировано (0) */
+} MatrixFileHeader;
+
+#endif
+
+/** @} */
@@ -9,28 +9,86 @@
  * 3. Выводит результаты промежуточных вычислений.
  * 4. Выполенние тестирования основных матричных операций и ввода-вывода.
  * 5. Освобождает выделенную память.
+ *
+ * С ключом --batch программа вместо этого выполняет команды из stdin, а с ключом
+ * --socket PATH - из соединений Unix-сокета, сохраняя матрицы между запросами
+ * (matrix_server.h).
  */
 
+#include <string.h>
+#include "matrix/matrix_arena.h"
 #include "matrix/matrix_operations.h"
+#include "output/matrix_cache.h"
 #include "output/output.h"
+#include "server/matrix_server.h"
+
+/**
+ * @brief Выводит справку по аргументам программы
+ * @param program Имя программы (argv[0])
+ */
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Использование:\n"
+            "  %s [A B C D]      вычислить A - (B + C * D)^T (по умолчанию файлы из data/)\n"
+            "  %s --batch        выполнять команды из stdin\n"
+            "  %s --socket PATH  выполнять команды из соединений Unix-сокета PATH\n",
+            program, program, program);
+}
+
+/**
+ * @brief Выполняет команды пакетного режима из stdin или Unix-сокета
+ * @param socket_path Путь сокета или NULL для stdin
+ * @return 0 при успешном выполнении, EXIT_FAILURE при ошибке сокета
+ */
+static int run_server(const char *socket_path) {
+    MatrixServer *server = matrix_server_create();
+    int status = 0;
+    if (socket_path != NULL) {
+        status = matrix_server_listen(server, socket_path) == 0 ? 0 : EXIT_FAILURE;
+    } else {
+        matrix_server_run(server, stdin, stdout);
+    }
+    matrix_server_destroy(server);
+    return status;
+}
 
 /**
  * @brief Точка входа в программу
+ * @param argc Число аргументов
+ * @param argv Аргументы: пути к матрицам A, B, C, D, либо --batch, либо --socket PATH
  * @return 0 при успешном выполнении, EXIT_FAILURE при ошибке
  *
- * @note Матрицы загружаются из файлов в папке data/
+ * @note Без аргументов матрицы загружаются из файлов в папке data/
  * @note Формат файлов матриц:
  * - Первые два числа - размеры матрицы (строки, столбцы)
  * - Последующие числа - элементы матрицы построчно
  *
  * @warning Проверяет совместимость размеров матриц перед операциями
  */
-int main() {
-    // Загрузка матриц из файлов
-    Matrix A = load_matrix_from_file("data/A.txt");
-    Matrix B = load_matrix_from_file("data/B.txt");
-    Matrix C = load_matrix_from_file("data/C.txt");
-    Matrix D = load_matrix_from_file("data/D.txt");
+int main(int argc, char **argv) {
+    const char *paths[4] = {"data/A.txt", "data/B.txt", "data/C.txt", "data/D.txt"};
+    if (argc == 2 && strcmp(argv[1], "--batch") == 0) {
+        return run_server(NULL);
+    }
+    if (argc == 3 && strcmp(argv[1], "--socket") == 0) {
+        return run_server(argv[2]);
+    }
+    if (argc == 5) {
+        for (int iter = 0; iter < 4; iter++) {
+            paths[iter] = argv[iter + 1];
+        }
+    } else if (argc != 1) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Загрузка матриц из файлов; при включенном кэше (MATRIX_CACHE_DIR) неизменившиеся
+    // текстовые файлы не разбираются повторно
+    MatrixHash hashes[4];
+    Matrix A = matrix_cache_load_file(paths[0], &hashes[0]);
+    Matrix B = matrix_cache_load_file(paths[1], &hashes[1]);
+    Matrix C = matrix_cache_load_file(paths[2], &hashes[2]);
+    Matrix D = matrix_cache_load_file(paths[3], &hashes[3]);
 
     // Вывод загруженных матриц
     printf("Matrix A:\n");
@@ -42,18 +100,31 @@ int main() {
     printf("\nMatrix D:\n");
     print_matrix(&D, 2);
 
-    // 1. Вычисление произведения C × D
-    Matrix CD = multiply_matrices(C, D);
+    // Промежуточные результаты размещаются в одной арене и освобождаются вместе
+    MatrixArena arena = matrix_arena_create(matrix_arena_bytes_for(B.rows, B.cols) +
+                                            matrix_arena_bytes_for(B.cols, B.rows) +
+                                            matrix_arena_bytes_for(A.rows, A.cols));
+
+    // 1. Вычисление произведения C × D; при включенном кэше произведение неизменившихся
+    // C и D берется из кэша
+    MatrixHash CD_hash;
+    Matrix CD = matrix_cache_multiply(C, hashes[2], D, hashes[3], &CD_hash);
     printf("\n1) C * D:\n");
     print_matrix(&CD, 2);
 
     // 2. Вычисление суммы B + (C × D)
-    Matrix B_plus_CD = plus_matrices(B, CD);
+    Matrix B_plus_CD = matrix_arena_matrix(&arena, B.rows, B.cols);
+    plus_matrices_into(&B_plus_CD, B, CD);
     printf("\n2) B + (C * D):\n");
     print_matrix(&B_plus_CD, 2);
 
-    // 3. Транспонирование результата (B + C × D)^T
-    Matrix B_plus_CD_transposed = transpose_matrix(B_plus_CD);
+    // 3. Транспонирование результата (B + C × D)^T; квадратная матрица транспонируется
+    // на месте, так как сумма B + C × D дальше не нужна
+    Matrix B_plus_CD_transposed = B_plus_CD;
+    if (B_plus_CD.rows != B_plus_CD.cols) {
+        B_plus_CD_transposed = matrix_arena_matrix(&arena, B_plus_CD.cols, B_plus_CD.rows);
+    }
+    transpose_matrix_into(&B_plus_CD_transposed, B_plus_CD);
     printf("\n3) (B + C * D)**T:\n");
     print_matrix(&B_plus_CD_transposed, 2);
 
@@ -65,8 +136,10 @@ int main() {
         exit(EXIT_FAILURE);
     }
 
-    // 4. Вычисление финального результата A - (B + C × D)^T
-    Matrix result = subtract_matrices(A, B_plus_CD_transposed);
+    // 4. Вычисление финального результата A - (B + C × D)^T из уже напечатанной
+    // транспонированной суммы
+    Matrix result = matrix_arena_matrix(&arena, A.rows, A.cols);
+    subtract_matrices_into(&result, A, B_plus_CD_transposed);
     printf("\n4) Результат A - (B + C * D)**T:\n");
     print_matrix(&result, 2);
 
@@ -79,9 +152,7 @@ int main() {
     free_matrix(C);
     free_matrix(D);
     free_matrix(CD);
-    free_matrix(B_plus_CD);
-    free_matrix(B_plus_CD_transposed);
-    free_matrix(result);
+    matrix_arena_destroy(&arena);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+/**
+ * @file batch_template.h
+ * @brief Шаблон ядер пакетных операций для одного уровня инструкций
+ * @ingroup Matrix_Operations
+ *
+ * Файл не имеет защиты от повторного включения: каждое включение порождает
+ * статические функции BATCH_NAME(multiply) и BATCH_NAME(determinant) для
+ * параметров, заданных макросами:
+ * - BATCH_NAME(name) - имя функции этого экземпляра
+ * - BATCH_ATTR - атрибут target уровня инструкций (пусто для базового уровня)
+ *
+ * Ядра обрабатывают блок из MATRIX_BATCH_LANES матриц: каждый элемент блока - вектор
+ * из одноименных элементов этих матриц, т.е. одна матрица пакета занимает одну
+ * позицию вектора. Для квадратных матриц порядка до MATRIX_BATCH_MAX_ORDER ядра
+ * вызываются с порядком-константой и полностью разворачиваются; для остальных
+ * размеров выполняются те же циклы с границами времени выполнения.
+ * В конце файла все параметры отменяются.
+ */
+
+/** Элемент блока: по одному значению из каждой матрицы блока (допускает невыровненный адрес) */
+typedef double BATCH_NAME(vector) __attribute__((
+    vector_size(MATRIX_BATCH_LANES * sizeof(double)), aligned(sizeof(double)), may_alias));
+
+/** Маска сравнения элементов блока */
+typedef long long BATCH_NAME(mask)
+    __attribute__((vector_size(MATRIX_BATCH_LANES * sizeof(double))));
+
+#define BATCH_VECTOR BATCH_NAME(vector)
+#define BATCH_MASK BATCH_NAME(mask)
+
+/** Элемент (row, col) блока матриц с расстоянием между плоскостями stride */
+#define BATCH_ELEMENT(base, cols, row, col, stride)                                                \
+    (*(BATCH_VECTOR *)((base) + ((size_t)(row) * (size_t)(cols) + (size_t)(col)) * (stride)))
+
+/** Элементы if_true там, где маска установлена, и if_false иначе */
+#define BATCH_SELECT(mask, if_true, if_false)                                                      \
+    ((BATCH_VECTOR)(((mask) & (BATCH_MASK)(if_true)) | (~(mask) & (BATCH_MASK)(if_false))))
+
+/** Модули элементов блока (сброс знакового бита) */
+#define BATCH_ABS(value) ((BATCH_VECTOR)((BATCH_MASK)(value) & magnitude))
+
+/**
+ * @brief C = A·B для одного блока матриц размера m×k и k×n
+ *
+ * Строка C накапливается в n независимых векторах, чтобы сложения соседних
+ * элементов не ждали друг друга; каждый элемент суммируется в порядке возрастания k.
+ * Цикл по k разворачивается только вдвое: после полного разворачивания GCC
+ * выстраивает сложения одного элемента подряд, и ядро упирается в задержку сложения.
+ */
+BATCH_ATTR static inline __attribute__((always_inline)) void
+BATCH_NAME(multiply_block)(int m, int k, int n, const double *a, const double *b, double *c,
+                           size_t stride) {
+#pragma GCC unroll 8
+    for (int iter = 0; iter < m; iter++) {
+#pragma GCC unroll 8
+        for (int col0 = 0; col0 < n; col0 += MATRIX_BATCH_MAX_ORDER) {
+            const int width = n - col0 < MATRIX_BATCH_MAX_ORDER ? n - col0 : MATRIX_BATCH_MAX_ORDER;
+            BATCH_VECTOR row[MATRIX_BATCH_MAX_ORDER] = {{0}};
+#pragma GCC unroll 2
+            for (int iter_3 = 0; iter_3 < k; iter_3++) {
+                const BATCH_VECTOR a_val = BATCH_ELEMENT(a, k, iter, iter_3, stride);
+#pragma GCC unroll 8
+                for (int iter_2 = 0; iter_2 < width; iter_2++) {
+                    row[iter_2] += a_val * BATCH_ELEMENT(b, n, iter_3, col0 + iter_2, stride);
+                }
+            }
+#pragma GCC unroll 8
+            for (int iter_2 = 0; iter_2 < width; iter_2++) {
+                BATCH_ELEMENT(c, n, iter, col0 + iter_2, stride) = row[iter_2];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Определители блока квадратных матриц порядка n
+ *
+ * LU-разложение с частичным выбором ведущего элемента, как в lu_factor_inplace:
+ * ведущая строка (первая с наибольшим модулем) выбирается для каждой матрицы блока
+ * отдельно и переставляется со строкой iter выбором по маске, без ветвлений. Порядок
+ * строк и операций совпадает с determinant, поэтому совпадают и результаты.
+ */
+BATCH_ATTR static inline __attribute__((always_inline)) void
+BATCH_NAME(determinant_block)(int n, const double *a, size_t stride, double *out) {
+    if (n == 1) {
+        *(BATCH_VECTOR *)out = BATCH_ELEMENT(a, 1, 0, 0, stride);
+        return;
+    }
+    if (n == 2) {
+        *(BATCH_VECTOR *)out =
+            BATCH_ELEMENT(a, 2, 0, 0, stride) * BATCH_ELEMENT(a, 2, 1, 1, stride) -
+            BATCH_ELEMENT(a, 2, 0, 1, stride) * BATCH_ELEMENT(a, 2, 1, 0, stride);
+        return;
+    }
+
+    BATCH_VECTOR lu[MATRIX_BATCH_MAX_ORDER][MATRIX_BATCH_MAX_ORDER];
+#pragma GCC unroll 8
+    for (int iter = 0; iter < n; iter++) {
+#pragma GCC unroll 8
+        for (int iter_2 = 0; iter_2 < n; iter_2++) {
+            lu[iter][iter_2] = BATCH_ELEMENT(a, n, iter, iter_2, stride);
+        }
+    }
+
+    const BATCH_MASK magnitude = (BATCH_MASK){0} + 0x7FFFFFFFFFFFFFFFLL;
+    BATCH_VECTOR det = (BATCH_VECTOR){0} + 1.0;
+    BATCH_MASK singular = {0};
+#pragma GCC unroll 8
+    for (int iter = 0; iter < n; iter++) {
+        // Первый наибольший по модулю элемент столбца, как в factor_panel
+        BATCH_VECTOR best = BATCH_ABS(lu[iter][iter]);
+        BATCH_MASK pivot_row = (BATCH_MASK){0} + iter;
+#pragma GCC unroll 8
+        for (int iter_2 = iter + 1; iter_2 < n; iter_2++) {
+            BATCH_VECTOR candidate = BATCH_ABS(lu[iter_2][iter]);
+            BATCH_MASK larger = candidate > best;
+            best = BATCH_SELECT(larger, candidate, best);
+            pivot_row = (larger & iter_2) | (~larger & pivot_row);
+        }
+        // Одна перестановка строки iter с ведущей, остальные строки остаются на местах
+        det = BATCH_SELECT(pivot_row != iter, -det, det);
+#pragma GCC unroll 8
+        for (int iter_2 = iter + 1; iter_2 < n; iter_2++) {
+            BATCH_MASK swap = pivot_row == iter_2;
+#pragma GCC unroll 8
+            for (int iter_3 = iter; iter_3 < n; iter_3++) {
+                BATCH_VECTOR upper = lu[iter][iter_3];
+                lu[iter][iter_3] = BATCH_SELECT(swap, lu[iter_2][iter_3], upper);
+                lu[iter_2][iter_3] = BATCH_SELECT(swap, upper, lu[iter_2][iter_3]);
+            }
+        }
+
+        const BATCH_VECTOR pivot = lu[iter][iter];
+        singular |= pivot == (BATCH_VECTOR){0};
+        det *= pivot;
+#pragma GCC unroll 8
+        for (int iter_2 = iter + 1; iter_2 < n; iter_2++) {
+            const BATCH_VECTOR factor = lu[iter_2][iter] / pivot;
+#pragma GCC unroll 8
+            for (int iter_3 = iter + 1; iter_3 < n; iter_3++) {
+                lu[iter_2][iter_3] -= factor * lu[iter][iter_3];
+            }
+        }
+    }
+    *(BATCH_VECTOR *)out = BATCH_SELECT(singular, (BATCH_VECTOR){0}, det);
+}
+
+/** Ветвь switch, вызывающая ядро с порядком-константой */
+#define BATCH_SQUARE_CASE(order, call)                                                             \
+    case order:                                                                                    \
+        for (int block = begin; block < end; block++) {                                            \
+            const size_t lane = (size_t)block * MATRIX_BATCH_LANES;                                \
+            call;                                                                                  \
+        }                                                                                          \
+        break;
+
+/** Ветви switch для всех порядков от 1 до MATRIX_BATCH_MAX_ORDER */
+#define BATCH_SQUARE_CASES(call_for_order)                                                         \
+    BATCH_SQUARE_CASE(1, call_for_order(1))                                                        \
+    BATCH_SQUARE_CASE(2, call_for_order(2))                                                        \
+    BATCH_SQUARE_CASE(3, call_for_order(3))                                                        \
+    BATCH_SQUARE_CASE(4, call_for_order(4))                                                        \
+    BATCH_SQUARE_CASE(5, call_for_order(5))                                                        \
+    BATCH_SQUARE_CASE(6, call_for_order(6))                                                        \
+    BATCH_SQUARE_CASE(7, call_for_order(7))                                                        \
+    BATCH_SQUARE_CASE(8, call_for_order(8))
+
+/**
+ * @brief Произведения блоков [begin, end) пакетов a (m×k) и b (k×n)
+ */
+BATCH_ATTR static void BATCH_NAME(multiply)(int m, int k, int n, int begin, int end,
+                                            const double *a, const double *b, double *c,
+                                            size_t stride) {
+#define BATCH_MULTIPLY_FIXED(order)                                                                \
+    BATCH_NAME(multiply_block)(order, order, order, a + lane, b + lane, c + lane, stride)
+    switch (m == k && k == n ? m : 0) {
+        BATCH_SQUARE_CASES(BATCH_MULTIPLY_FIXED)
+    default:
+        for (int block = begin; block < end; block++) {
+            const size_t lane = (size_t)block * MATRIX_BATCH_LANES;
+            BATCH_NAME(multiply_block)(m, k, n, a + lane, b + lane, c + lane, stride);
+        }
+        break;
+    }
+#undef BATCH_MULTIPLY_FIXED
+}
+
+/**
+ * @brief Определители блоков [begin, end) пакета квадратных матриц порядка n
+ * @note Порядок n не больше MATRIX_BATCH_MAX_ORDER
+ */
+BATCH_ATTR static void BATCH_NAME(determinant)(int n, int begin, int end, const double *a,
+                                               size_t stride, double *out) {
+#define BATCH_DETERMINANT_FIXED(order)                                                             \
+    BATCH_NAME(determinant_block)(order, a + lane, stride, out + lane)
+    switch (n) {
+        BATCH_SQUARE_CASES(BATCH_DETERMINANT_FIXED)
+    default:
+        break;
+    }
+#undef BATCH_DETERMINANT_FIXED
+}
+
+#undef BATCH_SQUARE_CASES
+#undef BATCH_SQUARE_CASE
+#undef BATCH_ABS
+#undef BATCH_SELECT
+#undef BATCH_ELEMENT
+#undef BATCH_MASK
+#undef BATCH_VECTOR
+#undef BATCH_NAME
+#undef BATCH_ATTR
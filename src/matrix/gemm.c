@@ -0,0 +1,97 @@
+/**
+ * @file gemm.c
+ * @brief Реализация блочного умножения матриц
+ * @ingroup Matrix_Operations
+ *
+ * Схема вычислений (по Гото): B разбивается на блоки KC×NC, A - на блоки MC×KC.
+ * Блоки упаковываются в непрерывные микропанели, после чего микроядро
+ * вычисляет блок результата mr×nr, держа аккумуляторы в регистрах.
+ * Микроядро и размеры mr×nr берутся из таблицы векторных ядер (simd_kernels.h).
+ *
+ * При параллельном выполнении C делится на полосы по строкам (или по столбцам,
+ * если столбцов больше), и каждый поток выполняет для своей полосы ту же схему
+ * с собственными буферами упаковки. Порядок суммирования каждого элемента от
+ * разбиения не зависит, поэтому результат не зависит от числа потоков.
+ *
+ * Алгоритм записан один раз в gemm_template.h и порождается для double и float.
+ */
+
+#include "gemm.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/config.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Рабочий буфер потока для упакованных панелей
+ *
+ * Буфер переиспользуется между вызовами и только растет, поэтому повторные
+ * умножения одинакового размера не выделяют память.
+ */
+typedef struct {
+    void *buffer;    /**< Выровненный буфер */
+    size_t capacity; /**< Емкость в байтах */
+} GemmWorkspace;
+
+static pthread_key_t workspace_key;
+static pthread_once_t workspace_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Освобождает рабочий буфер при завершении потока
+ */
+static void free_workspace(void *ptr) {
+    GemmWorkspace *workspace = (GemmWorkspace *)ptr;
+    free(workspace->buffer);
+    free(workspace);
+}
+
+static void create_workspace_key(void) {
+    pthread_key_create(&workspace_key, free_workspace);
+}
+
+/**
+ * @brief Возвращает рабочий буфер текущего потока размером не меньше bytes байт
+ * @param bytes Размер в байтах
+ * @return Указатель на выровненный буфер
+ */
+static void *gemm_workspace(size_t bytes) {
+    pthread_once(&workspace_once, create_workspace_key);
+    GemmWorkspace *workspace = (GemmWorkspace *)pthread_getspecific(workspace_key);
+    if (workspace == NULL) {
+        workspace = (GemmWorkspace *)calloc(1, sizeof(GemmWorkspace));
+        if (workspace == NULL || pthread_setspecific(workspace_key, workspace) != 0) {
+            fprintf(stderr, "Ошибка выделения памяти для умножения матриц!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (workspace->capacity < bytes) {
+        void *ptr = NULL;
+        if (posix_memalign(&ptr, MATRIX_ALIGNMENT, bytes) != 0) {
+            fprintf(stderr, "Ошибка выделения памяти для умножения матриц!\n");
+            exit(EXIT_FAILURE);
+        }
+        free(workspace->buffer);
+        workspace->buffer = ptr;
+        workspace->capacity = bytes;
+    }
+    return workspace->buffer;
+}
+
+#define MATRIX_T double
+#define MATRIX_FN(name) name
+#define MATRIX_KERNELS_T SimdKernels
+#define MATRIX_KERNELS simd_kernels
+#define MATRIX_GEMM_NR_MAX SIMD_GEMM_NR_MAX
+#define MATRIX_GEMM_INIT GemmInit
+#include "gemm_template.h"
+
+#define MATRIX_T float
+#define MATRIX_FN(name) name##_f
+#define MATRIX_KERNELS_T SimdKernelsF
+#define MATRIX_KERNELS simd_kernels_f
+#define MATRIX_GEMM_NR_MAX SIMD_GEMM_NR_MAX_F
+#define MATRIX_GEMM_INIT GemmInitF
+#include "gemm_template.h"
@@ -0,0 +1,133 @@
+/**
+ * @file gemm.h
+ * @brief Блочное умножение матриц (GEMM) с упаковкой операндов
+ * @ingroup Matrix_Operations
+ * @{
+ */
+
+#ifndef MATRIX_GEMM_H
+#define MATRIX_GEMM_H
+
+#include <stddef.h>
+
+/**
+ * @brief Число строк A в упакованном блоке (блок A размером MC×KC должен помещаться в L2)
+ * @note Кратно высоте микроблока всех вариантов ядер (4, 6 и 8)
+ */
+#define GEMM_MC 96
+
+/**
+ * @brief Глубина блока по общей размерности (микропанель B размером KC×NR должна помещаться в L1)
+ */
+#define GEMM_KC 256
+
+/**
+ * @brief Число столбцов B в упакованном блоке (блок B размером KC×NC должен помещаться в L3)
+ */
+#define GEMM_NC 4096
+
+/**
+ * @brief Порог m·n·k, ниже которого используется простой цикл без упаковки
+ */
+#define GEMM_SMALL_THRESHOLD (48 * 48 * 48)
+
+/**
+ * @brief Порог m·n·k, начиная с которого умножение распределяется по пулу потоков
+ */
+#define GEMM_PARALLEL_THRESHOLD (128.0 * 128.0 * 128.0)
+
+/**
+ * @brief Минимальное число микрополос (по mr строк или nr столбцов) на один поток
+ */
+#define GEMM_PARALLEL_MIN_UNITS 4
+
+/**
+ * @brief Вычисляет C = alpha·A·B + beta·C для матриц с произвольными шагами
+ * @param m Число строк A и C
+ * @param n Число столбцов B и C
+ * @param k Общая размерность (столбцы A, строки B)
+ * @param alpha Множитель произведения
+ * @param a Указатель на элемент A(0, 0)
+ * @param rs_a Шаг между строками A в элементах
+ * @param cs_a Шаг между столбцами A в элементах
+ * @param b Указатель на элемент B(0, 0)
+ * @param rs_b Шаг между строками B
+ * @param cs_b Шаг между столбцами B
+ * @param beta Множитель исходного содержимого C (при beta == 0 C не читается)
+ * @param c Указатель на элемент C(0, 0)
+ * @param rs_c Шаг между строками C
+ * @param cs_c Шаг между столбцами C
+ *
+ * @note Транспонированный операнд задается перестановкой шагов строк и столбцов
+ * @note Большие произведения выполняются параллельно в пуле потоков (thread_pool.h)
+ * @warning C не должна пересекаться с A и B
+ */
+void gemm_strided(int m, int n, int k, double alpha, const double *a, ptrdiff_t rs_a,
+                  ptrdiff_t cs_a, const double *b, ptrdiff_t rs_b, ptrdiff_t cs_b, double beta,
+                  double *c, ptrdiff_t rs_c, ptrdiff_t cs_c);
+
+/**
+ * @brief Функция, вычисляющая начальные значения блока C для gemm_strided_init
+ * @param ctx Контекст, переданный в gemm_strided_init
+ * @param row Строка C, соответствующая строке 0 блока
+ * @param col Столбец C, соответствующий столбцу 0 блока
+ * @param rows Число строк блока
+ * @param cols Число столбцов блока
+ * @param tile Буфер блока: элемент (i, j) записывается в tile[i * ld + j]
+ * @param ld Шаг между строками tile
+ *
+ * @note Вызывается из потоков пула параллельно для разных блоков; C читать не должна
+ */
+typedef void (*GemmInit)(void *ctx, int row, int col, int rows, int cols, double *tile, int ld);
+
+/**
+ * @brief Вычисляет C = init + alpha·A·B, где init задается функцией
+ * @param m Число строк A и C
+ * @param n Число столбцов B и C
+ * @param k Общая размерность
+ * @param alpha Множитель произведения
+ * @param a Указатель на элемент A(0, 0)
+ * @param rs_a Шаг между строками A
+ * @param cs_a Шаг между столбцами A
+ * @param b Указатель на элемент B(0, 0)
+ * @param rs_b Шаг между строками B
+ * @param cs_b Шаг между столбцами B
+ * @param init Функция начальных значений (эпилог GEMM)
+ * @param init_ctx Ее контекст
+ * @param c Указатель на элемент C(0, 0)
+ * @param rs_c Шаг между строками C
+ * @param cs_c Шаг между столбцами C
+ *
+ * @note Начальные значения запрашиваются блоками размером с микроблок в момент записи
+ * первого блока по общей размерности, поэтому при k <= GEMM_KC каждый элемент C
+ * записывается ровно один раз и C не читается
+ */
+void gemm_strided_init(int m, int n, int k, double alpha, const double *a, ptrdiff_t rs_a,
+                       ptrdiff_t cs_a, const double *b, ptrdiff_t rs_b, ptrdiff_t cs_b,
+                       GemmInit init, void *init_ctx, double *c, ptrdiff_t rs_c, ptrdiff_t cs_c);
+
+/**
+ * @brief Функция начальных значений блока C для gemm_strided_init_f (см. GemmInit)
+ */
+typedef void (*GemmInitF)(void *ctx, int row, int col, int rows, int cols, float *tile, int ld);
+
+/**
+ * @brief Вычисляет C = alpha·A·B + beta·C для матриц float (см. gemm_strided)
+ *
+ * Порождается из того же шаблона (gemm_template.h), что и gemm_strided, с ядрами
+ * float того же уровня инструкций (simd_kernels_f).
+ */
+void gemm_strided_f(int m, int n, int k, float alpha, const float *a, ptrdiff_t rs_a,
+                    ptrdiff_t cs_a, const float *b, ptrdiff_t rs_b, ptrdiff_t cs_b, float beta,
+                    float *c, ptrdiff_t rs_c, ptrdiff_t cs_c);
+
+/**
+ * @brief Вычисляет C = init + alpha·A·B для матриц float (см. gemm_strided_init)
+ */
+void gemm_strided_init_f(int m, int n, int k, float alpha, const float *a, ptrdiff_t rs_a,
+                         ptrdiff_t cs_a, const float *b, ptrdiff_t rs_b, ptrdiff_t cs_b,
+                         GemmInitF init, void *init_ctx, float *c, ptrdiff_t rs_c, ptrdiff_t cs_c);
+
+#endif
+
+/** @} */
@@ -0,0 +1,309 @@
+/**
+ * @file gemm_template.h
+ * @brief Шаблон блочного умножения матриц для одного типа элементов
+ * @ingroup Matrix_Operations
+ *
+ * Включается в gemm.c для double и float. Перед включением задаются макросы:
+ * - MATRIX_T - тип элементов
+ * - MATRIX_FN(name) - имя функции или типа этого экземпляра
+ * - MATRIX_KERNELS_T, MATRIX_KERNELS() - тип таблицы ядер и функция, возвращающая активную
+ * - MATRIX_GEMM_NR_MAX - наибольшая ширина микроблока среди ядер этого типа
+ * - MATRIX_GEMM_INIT - тип функции начальных значений
+ *
+ * В конце файла все параметры отменяются.
+ */
+
+/**
+ * @brief Упаковывает блок A (mc×kc) в микропанели по mr строк
+ *
+ * Внутри панели элементы идут по столбцам: для каждого p подряд лежат
+ * mr элементов A(i, p). Неполная последняя панель дополняется нулями.
+ */
+static void MATRIX_FN(pack_a)(int mc, int kc, int mr, const MATRIX_T *a, ptrdiff_t rs_a,
+                              ptrdiff_t cs_a, MATRIX_T *packed) {
+    for (int iter = 0; iter < mc; iter += mr) {
+        int rows = mc - iter < mr ? mc - iter : mr;
+        const MATRIX_T *panel = a + iter * rs_a;
+        for (int iter_2 = 0; iter_2 < kc; iter_2++) {
+            int iter_3 = 0;
+            for (; iter_3 < rows; iter_3++) {
+                packed[iter_3] = panel[iter_3 * rs_a + iter_2 * cs_a];
+            }
+            for (; iter_3 < mr; iter_3++) {
+                packed[iter_3] = 0.0;
+            }
+            packed += mr;
+        }
+    }
+}
+
+/**
+ * @brief Упаковывает блок B (kc×nc) в микропанели по nr столбцов
+ *
+ * Внутри панели элементы идут по строкам: для каждого p подряд лежат
+ * nr элементов B(p, j). Неполная последняя панель дополняется нулями.
+ */
+static void MATRIX_FN(pack_b)(int kc, int nc, int nr, const MATRIX_T *b, ptrdiff_t rs_b,
+                              ptrdiff_t cs_b, MATRIX_T *packed) {
+    for (int iter = 0; iter < nc; iter += nr) {
+        int cols = nc - iter < nr ? nc - iter : nr;
+        const MATRIX_T *panel = b + iter * cs_b;
+        for (int iter_2 = 0; iter_2 < kc; iter_2++) {
+            const MATRIX_T *src = panel + iter_2 * rs_b;
+            int iter_3 = 0;
+            if (cs_b == 1) {
+                for (; iter_3 < cols; iter_3++) {
+                    packed[iter_3] = src[iter_3];
+                }
+            } else {
+                for (; iter_3 < cols; iter_3++) {
+                    packed[iter_3] = src[iter_3 * cs_b];
+                }
+            }
+            for (; iter_3 < nr; iter_3++) {
+                packed[iter_3] = 0.0;
+            }
+            packed += nr;
+        }
+    }
+}
+
+/**
+ * @brief Функция начального значения C вместе с ее контекстом и смещением блока
+ */
+typedef struct {
+    MATRIX_GEMM_INIT fn; /**< Функция, заполняющая начальные значения */
+    void *ctx;           /**< Контекст функции */
+    int row;             /**< Строка всей матрицы C, соответствующая строке 0 текущего блока */
+    int col;             /**< Столбец всей матрицы C, соответствующий столбцу 0 текущего блока */
+} MATRIX_FN(GemmInitRef);
+
+/**
+ * @brief Записывает блок ab в C с учетом alpha, beta и обрезки по краям
+ * @param init Начальные значения блока (строки через nr) вместо beta·C или NULL
+ */
+static void MATRIX_FN(store_tile)(int rows, int cols, int nr, MATRIX_T alpha, const MATRIX_T *ab,
+                                  MATRIX_T beta, const MATRIX_T *init, MATRIX_T *c, ptrdiff_t rs_c,
+                                  ptrdiff_t cs_c) {
+    for (int iter = 0; iter < rows; iter++) {
+        MATRIX_T *out = c + iter * rs_c;
+        const MATRIX_T *src = ab + iter * nr;
+        if (init != NULL) {
+            const MATRIX_T *base = init + iter * nr;
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                out[iter_2 * cs_c] = base[iter_2] + alpha * src[iter_2];
+            }
+        } else if (beta == 0.0) {
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                out[iter_2 * cs_c] = alpha * src[iter_2];
+            }
+        } else {
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                out[iter_2 * cs_c] = beta * out[iter_2 * cs_c] + alpha * src[iter_2];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Заполняет C (m×n) начальными значениями init или beta·C (при k == 0 или alpha == 0)
+ */
+static void MATRIX_FN(fill_initial)(int m, int n, MATRIX_T beta, const MATRIX_FN(GemmInitRef) *init,
+                                    MATRIX_T *c, ptrdiff_t rs_c, ptrdiff_t cs_c) {
+    MATRIX_T tile[MATRIX_GEMM_NR_MAX];
+    for (int iter = 0; iter < m; iter++) {
+        MATRIX_T *out = c + iter * rs_c;
+        for (int col = 0; col < n; col += MATRIX_GEMM_NR_MAX) {
+            const int cols = n - col < MATRIX_GEMM_NR_MAX ? n - col : MATRIX_GEMM_NR_MAX;
+            if (init != NULL) {
+                init->fn(init->ctx, init->row + iter, init->col + col, 1, cols, tile,
+                         MATRIX_GEMM_NR_MAX);
+            }
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                MATRIX_T *dst = out + (col + iter_2) * cs_c;
+                if (init != NULL) {
+                    *dst = tile[iter_2];
+                } else {
+                    *dst = beta == 0.0 ? 0.0 : beta * *dst;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Простое умножение для малых размеров (порядок i-p-j, без упаковки)
+ */
+static void MATRIX_FN(gemm_small)(int m, int n, int k, MATRIX_T alpha, const MATRIX_T *a,
+                                  ptrdiff_t rs_a, ptrdiff_t cs_a, const MATRIX_T *b, ptrdiff_t rs_b,
+                                  ptrdiff_t cs_b, MATRIX_T beta, const MATRIX_FN(GemmInitRef) *init,
+                                  MATRIX_T *c, ptrdiff_t rs_c, ptrdiff_t cs_c) {
+    MATRIX_FN(fill_initial)(m, n, beta, init, c, rs_c, cs_c);
+    for (int iter = 0; iter < m; iter++) {
+        MATRIX_T *out = c + iter * rs_c;
+        for (int iter_3 = 0; iter_3 < k; iter_3++) {
+            const MATRIX_T a_val = alpha * a[iter * rs_a + iter_3 * cs_a];
+            const MATRIX_T *row_b = b + iter_3 * rs_b;
+            for (int iter_2 = 0; iter_2 < n; iter_2++) {
+                out[iter_2 * cs_c] += a_val * row_b[iter_2 * cs_b];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Последовательное блочное умножение (основной алгоритм)
+ */
+static void MATRIX_FN(gemm_blocked)(int m, int n, int k, MATRIX_T alpha, const MATRIX_T *a,
+                                    ptrdiff_t rs_a, ptrdiff_t cs_a, const MATRIX_T *b,
+                                    ptrdiff_t rs_b, ptrdiff_t cs_b, MATRIX_T beta,
+                                    const MATRIX_FN(GemmInitRef) *init, MATRIX_T *c, ptrdiff_t rs_c,
+                                    ptrdiff_t cs_c) {
+    const MATRIX_KERNELS_T *kernels = MATRIX_KERNELS();
+    const int mr = kernels->gemm_mr;
+    const int nr = kernels->gemm_nr;
+    const int nc_max = n < GEMM_NC ? n : GEMM_NC;
+    const int kc_max = k < GEMM_KC ? k : GEMM_KC;
+    const int mc_max = m < GEMM_MC ? m : GEMM_MC;
+    const size_t per_line = MATRIX_ALIGNMENT / sizeof(MATRIX_T);
+    const size_t size_b = ((size_t)kc_max * ((nc_max + nr - 1) / nr * nr) + per_line - 1) /
+                          per_line * per_line;
+    const size_t size_a = (size_t)kc_max * ((mc_max + mr - 1) / mr * mr);
+    MATRIX_T *packed_b = (MATRIX_T *)gemm_workspace((size_b + size_a) * sizeof(MATRIX_T));
+    MATRIX_T *packed_a = packed_b + size_b;
+    MATRIX_T ab[SIMD_GEMM_MR_MAX * MATRIX_GEMM_NR_MAX];
+    MATRIX_T base[SIMD_GEMM_MR_MAX * MATRIX_GEMM_NR_MAX];
+
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        const int nc = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            const int kc = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+            const MATRIX_T beta_block = pc == 0 ? beta : 1.0;
+            const int first_block = pc == 0 && init != NULL;
+            MATRIX_FN(pack_b)(kc, nc, nr, b + pc * rs_b + jc * cs_b, rs_b, cs_b, packed_b);
+
+            for (int ic = 0; ic < m; ic += GEMM_MC) {
+                const int mc = m - ic < GEMM_MC ? m - ic : GEMM_MC;
+                MATRIX_FN(pack_a)(mc, kc, mr, a + ic * rs_a + pc * cs_a, rs_a, cs_a, packed_a);
+
+                for (int jr = 0; jr < nc; jr += nr) {
+                    const int cols = nc - jr < nr ? nc - jr : nr;
+                    const MATRIX_T *panel_b = packed_b + (size_t)jr * kc;
+                    for (int ir = 0; ir < mc; ir += mr) {
+                        const int rows = mc - ir < mr ? mc - ir : mr;
+                        kernels->gemm_kernel(kc, packed_a + (size_t)ir * kc, panel_b, ab);
+                        if (first_block) {
+                            init->fn(init->ctx, init->row + ic + ir, init->col + jc + jr, rows,
+                                     cols, base, nr);
+                        }
+                        MATRIX_FN(store_tile)(rows, cols, nr, alpha, ab, beta_block,
+                                              first_block ? base : NULL,
+                                              c + (ic + ir) * rs_c + (jc + jr) * cs_c, rs_c, cs_c);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Параметры параллельного умножения, общие для всех полос
+ */
+typedef struct {
+    int m, n, k;
+    MATRIX_T alpha, beta;
+    const MATRIX_T *a;
+    ptrdiff_t rs_a, cs_a;
+    const MATRIX_T *b;
+    ptrdiff_t rs_b, cs_b;
+    MATRIX_T *c;
+    ptrdiff_t rs_c, cs_c;
+    const MATRIX_FN(GemmInitRef) *init; /**< Начальные значения C или NULL */
+    int split_rows;          /**< 1 - полосы по строкам C, 0 - по столбцам */
+    int unit;                /**< Размер единицы разбиения (mr или nr) */
+} MATRIX_FN(GemmJob);
+
+/**
+ * @brief Задача пула: умножение для полос [begin, end) в единицах job->unit
+ */
+static void MATRIX_FN(gemm_task)(void *ctx, int begin, int end) {
+    const MATRIX_FN(GemmJob) *job = (const MATRIX_FN(GemmJob) *)ctx;
+    int from = begin * job->unit;
+    MATRIX_FN(GemmInitRef) init;
+    if (job->init != NULL) {
+        init = *job->init;
+        if (job->split_rows) {
+            init.row += from;
+        } else {
+            init.col += from;
+        }
+    }
+    const MATRIX_FN(GemmInitRef) *part_init = job->init != NULL ? &init : NULL;
+    if (job->split_rows) {
+        int to = end * job->unit < job->m ? end * job->unit : job->m;
+        MATRIX_FN(gemm_blocked)(to - from, job->n, job->k, job->alpha, job->a + from * job->rs_a,
+                                job->rs_a, job->cs_a, job->b, job->rs_b, job->cs_b, job->beta,
+                                part_init, job->c + from * job->rs_c, job->rs_c, job->cs_c);
+    } else {
+        int to = end * job->unit < job->n ? end * job->unit : job->n;
+        MATRIX_FN(gemm_blocked)(job->m, to - from, job->k, job->alpha, job->a, job->rs_a, job->cs_a,
+                                job->b + from * job->cs_b, job->rs_b, job->cs_b, job->beta,
+                                part_init, job->c + from * job->cs_c, job->rs_c, job->cs_c);
+    }
+}
+
+/**
+ * @brief Общая часть gemm_strided и gemm_strided_init
+ */
+static void MATRIX_FN(gemm_dispatch)(int m, int n, int k, MATRIX_T alpha, const MATRIX_T *a,
+                                     ptrdiff_t rs_a, ptrdiff_t cs_a, const MATRIX_T *b,
+                                     ptrdiff_t rs_b, ptrdiff_t cs_b, MATRIX_T beta,
+                                     const MATRIX_FN(GemmInitRef) *init, MATRIX_T *c,
+                                     ptrdiff_t rs_c, ptrdiff_t cs_c) {
+    if (m <= 0 || n <= 0) {
+        return;
+    }
+    if (k <= 0 || alpha == 0.0) {
+        MATRIX_FN(fill_initial)(m, n, beta, init, c, rs_c, cs_c);
+        return;
+    }
+    if ((double)m * n * k < GEMM_SMALL_THRESHOLD) {
+        MATRIX_FN(gemm_small)(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, beta, init, c, rs_c,
+                              cs_c);
+        return;
+    }
+
+    const MATRIX_KERNELS_T *kernels = MATRIX_KERNELS();
+    MATRIX_FN(GemmJob) job = {.m = m,       .n = n,       .k = k,       .alpha = alpha,
+                              .beta = beta, .a = a,       .rs_a = rs_a, .cs_a = cs_a,
+                              .b = b,       .rs_b = rs_b, .cs_b = cs_b, .c = c,
+                              .rs_c = rs_c, .cs_c = cs_c, .init = init, .split_rows = m >= n};
+    job.unit = job.split_rows ? kernels->gemm_mr : kernels->gemm_nr;
+    int extent = job.split_rows ? m : n;
+    int units = (extent + job.unit - 1) / job.unit;
+    int grain = (double)m * n * k < GEMM_PARALLEL_THRESHOLD ? units : GEMM_PARALLEL_MIN_UNITS;
+    parallel_for(units, grain, MATRIX_FN(gemm_task), &job);
+}
+
+void MATRIX_FN(gemm_strided)(int m, int n, int k, MATRIX_T alpha, const MATRIX_T *a, ptrdiff_t rs_a,
+                             ptrdiff_t cs_a, const MATRIX_T *b, ptrdiff_t rs_b, ptrdiff_t cs_b,
+                             MATRIX_T beta, MATRIX_T *c, ptrdiff_t rs_c, ptrdiff_t cs_c) {
+    MATRIX_FN(gemm_dispatch)(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, beta, NULL, c, rs_c,
+                             cs_c);
+}
+
+void MATRIX_FN(gemm_strided_init)(int m, int n, int k, MATRIX_T alpha, const MATRIX_T *a,
+                                  ptrdiff_t rs_a, ptrdiff_t cs_a, const MATRIX_T *b, ptrdiff_t rs_b,
+                                  ptrdiff_t cs_b, MATRIX_GEMM_INIT init, void *init_ctx,
+                                  MATRIX_T *c, ptrdiff_t rs_c, ptrdiff_t cs_c) {
+    MATRIX_FN(GemmInitRef) ref = {.fn = init, .ctx = init_ctx, .row = 0, .col = 0};
+    MATRIX_FN(gemm_dispatch)(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, 0.0, &ref, c, rs_c,
+                             cs_c);
+}
+
+#undef MATRIX_T
+#undef MATRIX_FN
+#undef MATRIX_KERNELS_T
+#undef MATRIX_KERNELS
+#undef MATRIX_GEMM_NR_MAX
+#undef MATRIX_GEMM_INIT
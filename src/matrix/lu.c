@@ -0,0 +1,304 @@
+/**
+ * @file lu.c
+ * @brief Реализация блочного LU-разложения с частичным выбором ведущего элемента
+ * @ingroup Matrix_Operations
+ */
+
+#include "lu.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "gemm.h"
+#include "matrix_operations.h"
+
+/**
+ * @brief Меняет местами строки r1 и r2 на всю ширину n
+ */
+static void swap_rows(int n, double *a, ptrdiff_t lda, int r1, int r2) {
+    double *row1 = a + r1 * lda;
+    double *row2 = a + r2 * lda;
+    for (int iter = 0; iter < n; iter++) {
+        double tmp = row1[iter];
+        row1[iter] = row2[iter];
+        row2[iter] = tmp;
+    }
+}
+
+/**
+ * @brief Раскладывает панель из столбцов [col0, col0 + width) в строках [col0, n)
+ * @return 0 или номер (с единицы) первого нулевого ведущего элемента
+ */
+static int factor_panel(int n, double *a, ptrdiff_t lda, int col0, int width, int *pivots) {
+    int info = 0;
+    for (int col = col0; col < col0 + width; col++) {
+        int pivot = col;
+        double best = fabs(a[col * lda + col]);
+        for (int row = col + 1; row < n; row++) {
+            double value = fabs(a[row * lda + col]);
+            if (value > best) {
+                best = value;
+                pivot = row;
+            }
+        }
+        pivots[col] = pivot;
+        if (pivot != col) {
+            swap_rows(n, a, lda, col, pivot);
+        }
+
+        const double diag = a[col * lda + col];
+        if (diag == 0.0) {
+            if (info == 0) {
+                info = col + 1;
+            }
+            continue;
+        }
+
+        const double *pivot_row = a + col * lda;
+        for (int row = col + 1; row < n; row++) {
+            double *target = a + row * lda;
+            const double factor = target[col] / diag;
+            target[col] = factor;
+            for (int iter = col + 1; iter < col0 + width; iter++) {
+                target[iter] -= factor * pivot_row[iter];
+            }
+        }
+    }
+    return info;
+}
+
+int lu_factor_inplace(int n, double *a, ptrdiff_t lda, int *pivots) {
+    int info = 0;
+    for (int col0 = 0; col0 < n; col0 += LU_BLOCK) {
+        const int width = n - col0 < LU_BLOCK ? n - col0 : LU_BLOCK;
+        int panel_info = factor_panel(n, a, lda, col0, width, pivots);
+        if (info == 0 && panel_info != 0) {
+            info = panel_info;
+        }
+
+        const int rest = n - col0 - width;
+        if (rest == 0) {
+            continue;
+        }
+
+        /* U12 = L11^-1 · A12 (прямая подстановка с единичной диагональю) */
+        for (int iter = 0; iter < width; iter++) {
+            const double *src = a + (col0 + iter) * lda + col0 + width;
+            for (int row = iter + 1; row < width; row++) {
+                double *dst = a + (col0 + row) * lda + col0 + width;
+                const double factor = a[(col0 + row) * lda + col0 + iter];
+                if (factor == 0.0) {
+                    continue;
+                }
+                for (int iter_2 = 0; iter_2 < rest; iter_2++) {
+                    dst[iter_2] -= factor * src[iter_2];
+                }
+            }
+        }
+
+        /* A22 -= L21 · U12 */
+        double *l21 = a + (col0 + width) * lda + col0;
+        double *u12 = a + col0 * lda + col0 + width;
+        double *a22 = a + (col0 + width) * lda + col0 + width;
+        gemm_strided(rest, rest, width, -1.0, l21, lda, 1, u12, lda, 1, 1.0, a22, lda, 1);
+    }
+    return info;
+}
+
+LuFactorization lu_factor(Matrix mat) {
+    if (mat.rows != mat.cols) {
+        fprintf(stderr, "Для LU-разложения матрица должна быть квадратной!\n");
+        exit(EXIT_FAILURE);
+    }
+    LuFactorization lu;
+    lu.lu = copy_matrix(mat);
+    matrix_make_writable(&lu.lu);
+    lu.pivots = (int *)malloc((size_t)(mat.rows > 0 ? mat.rows : 1) * sizeof(int));
+    if (lu.pivots == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для LU-разложения!\n");
+        exit(EXIT_FAILURE);
+    }
+    lu.info = lu_factor_inplace(mat.rows, lu.lu.data, lu.lu.stride, lu.pivots);
+    return lu;
+}
+
+void free_lu_factorization(LuFactorization lu) {
+    free_matrix(lu.lu);
+    free(lu.pivots);
+}
+
+/**
+ * @brief Вычитает из строки target строку source, умноженную на factor
+ */
+static void subtract_scaled_row(int n, double factor, const double *source, double *target) {
+    for (int iter = 0; iter < n; iter++) {
+        target[iter] -= factor * source[iter];
+    }
+}
+
+/**
+ * @brief Вычитает из строк [dst_row, dst_row + rows) матрицы X произведение блока
+ *        треугольной матрицы (rows×width) на строки [src_row, src_row + width)
+ */
+static void update_rows(int rows, int width, const double *block, ptrdiff_t ld, Matrix x,
+                        int src_row, int dst_row) {
+    if (x.cols >= LU_SOLVE_GEMM_MIN_COLS) {
+        gemm_strided(rows, x.cols, width, -1.0, block, ld, 1, MATRIX_ROW(x, src_row), x.stride, 1,
+                     1.0, MATRIX_ROW(x, dst_row), x.stride, 1);
+        return;
+    }
+    // Узкая правая часть: каждый элемент - скалярное произведение строки блока на столбец X
+    const double *source = MATRIX_ROW(x, src_row);
+    for (int iter = 0; iter < rows; iter++) {
+        const double *factors = block + iter * ld;
+        double *target = MATRIX_ROW(x, dst_row + iter);
+        for (int iter_2 = 0; iter_2 < x.cols; iter_2++) {
+            double sum = 0.0;
+            for (int iter_3 = 0; iter_3 < width; iter_3++) {
+                sum += factors[iter_3] * source[(size_t)iter_3 * (size_t)x.stride + iter_2];
+            }
+            target[iter_2] -= sum;
+        }
+    }
+}
+
+/**
+ * @brief Решает L·X = B на месте для единичной нижнетреугольной L из разложения
+ *
+ * После подстановки в диагональном блоке строки блока X уже окончательны, и их вклад
+ * во все нижележащие строки вычитается одним произведением L21·X1 (update_rows).
+ */
+static void solve_lower_unit(Matrix lu, Matrix x) {
+    const int n = lu.rows;
+    for (int row0 = 0; row0 < n; row0 += LU_BLOCK) {
+        const int width = n - row0 < LU_BLOCK ? n - row0 : LU_BLOCK;
+        for (int iter = row0 + 1; iter < row0 + width; iter++) {
+            for (int iter_2 = row0; iter_2 < iter; iter_2++) {
+                const double factor = MATRIX_AT(lu, iter, iter_2);
+                if (factor != 0.0) {
+                    subtract_scaled_row(x.cols, factor, MATRIX_ROW(x, iter_2), MATRIX_ROW(x, iter));
+                }
+            }
+        }
+        const int rest = n - row0 - width;
+        if (rest > 0) {
+            update_rows(rest, width, MATRIX_ROW(lu, row0 + width) + row0, lu.stride, x, row0,
+                        row0 + width);
+        }
+    }
+}
+
+/**
+ * @brief Решает U·X = B на месте для верхнетреугольной U из разложения
+ *
+ * Блоки обходятся снизу вверх; вклад решенного блока во все вышележащие строки
+ * вычитается одним произведением U01·X1.
+ */
+static void solve_upper(Matrix lu, Matrix x) {
+    const int n = lu.rows;
+    for (int row0 = (n - 1) / LU_BLOCK * LU_BLOCK; row0 >= 0; row0 -= LU_BLOCK) {
+        const int width = n - row0 < LU_BLOCK ? n - row0 : LU_BLOCK;
+        for (int iter = row0 + width - 1; iter >= row0; iter--) {
+            double *target = MATRIX_ROW(x, iter);
+            for (int iter_2 = iter + 1; iter_2 < row0 + width; iter_2++) {
+                const double factor = MATRIX_AT(lu, iter, iter_2);
+                if (factor != 0.0) {
+                    subtract_scaled_row(x.cols, factor, MATRIX_ROW(x, iter_2), target);
+                }
+            }
+            const double diag = MATRIX_AT(lu, iter, iter);
+            for (int iter_2 = 0; iter_2 < x.cols; iter_2++) {
+                target[iter_2] /= diag;
+            }
+        }
+        if (row0 > 0) {
+            update_rows(row0, width, MATRIX_ROW(lu, 0) + row0, lu.stride, x, row0, 0);
+        }
+    }
+}
+
+void lu_solve_into(Matrix *dst, LuFactorization lu, Matrix rhs) {
+    if (rhs.rows != lu.lu.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для решения системы!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (lu.info != 0) {
+        fprintf(stderr, "Матрица системы вырождена: нулевой ведущий элемент %d!\n", lu.info);
+        exit(EXIT_FAILURE);
+    }
+    copy_matrix_into(dst, rhs);
+    if (dst->rows == 0 || dst->cols == 0) {
+        return;
+    }
+
+    // P·B: перестановки применяются в том же порядке, что и при разложении
+    for (int iter = 0; iter < dst->rows; iter++) {
+        if (lu.pivots[iter] != iter) {
+            swap_rows(dst->cols, dst->data, dst->stride, iter, lu.pivots[iter]);
+        }
+    }
+    solve_lower_unit(lu.lu, *dst);
+    solve_upper(lu.lu, *dst);
+}
+
+Matrix lu_solve(LuFactorization lu, Matrix rhs) {
+    Matrix result = create_matrix(rhs.rows, rhs.cols);
+    lu_solve_into(&result, lu, rhs);
+    return result;
+}
+
+Matrix lu_inverse(LuFactorization lu) {
+    const int n = lu.lu.rows;
+    Matrix inverse = create_matrix(n, n);
+    for (int iter = 0; iter < n; iter++) {
+        MATRIX_AT(inverse, iter, iter) = 1.0;
+    }
+    lu_solve_into(&inverse, lu, inverse);
+    return inverse;
+}
+
+double lu_determinant(LuFactorization lu) {
+    if (lu.info != 0) {
+        return 0.0;
+    }
+    double det = 1;
+    for (int iter = 0; iter < lu.lu.rows; iter++) {
+        const double diag = MATRIX_AT(lu.lu, iter, iter);
+        det *= lu.pivots[iter] != iter ? -diag : diag;
+    }
+    return det;
+}
+
+double lu_log_abs_determinant(LuFactorization lu, int *sign) {
+    int det_sign = 1;
+    double log_det = 0;
+    if (lu.info != 0) {
+        det_sign = 0;
+        log_det = -INFINITY;
+    } else {
+        for (int iter = 0; iter < lu.lu.rows; iter++) {
+            const double diag = MATRIX_AT(lu.lu, iter, iter);
+            if ((diag < 0) != (lu.pivots[iter] != iter)) {
+                det_sign = -det_sign;
+            }
+            log_det += log(fabs(diag));
+        }
+    }
+    if (sign != NULL) {
+        *sign = det_sign;
+    }
+    return log_det;
+}
+
+Matrix solve_matrix(Matrix mat, Matrix rhs) {
+    LuFactorization lu = lu_factor(mat);
+    Matrix result = lu_solve(lu, rhs);
+    free_lu_factorization(lu);
+    return result;
+}
+
+Matrix inverse_matrix(Matrix mat) {
+    LuFactorization lu = lu_factor(mat);
+    Matrix result = lu_inverse(lu);
+    free_lu_factorization(lu);
+    return result;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file lu.h
+ * @brief LU-разложение с частичным выбором ведущего элемента
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Разложение (LuFactorization) вычисляется один раз и затем используется для
+ * решения систем с любым числом правых частей, обращения матрицы и вычисления
+ * определителя (determinant и log_abs_determinant используют его же). Треугольные
+ * системы с матричной правой частью решаются по блокам LU_BLOCK строк: внутри
+ * диагонального блока - подстановкой, а обновление остальных строк правой части
+ * выполняется через gemm_strided.
+ */
+
+#ifndef MATRIX_LU_H
+#define MATRIX_LU_H
+
+#include <stddef.h>
+#include "../include/config.h"
+
+/**
+ * @brief Ширина панели блочного LU-разложения
+ *
+ * Матрицы порядка не больше LU_BLOCK раскладываются без разбиения на блоки.
+ */
+#define LU_BLOCK 64
+
+/**
+ * @brief Число столбцов правой части, начиная с которого строки обновляются через GEMM
+ *
+ * Микроядро GEMM всегда вычисляет микроблок целиком, поэтому для узкой правой части
+ * (например, одного вектора) оно выполняло бы в несколько раз больше операций.
+ */
+#define LU_SOLVE_GEMM_MIN_COLS 8
+
+/**
+ * @brief Раскладывает квадратную матрицу на месте: P·A = L·U
+ * @param n Порядок матрицы
+ * @param a Указатель на элемент A(0, 0); на выходе содержит L (ниже диагонали,
+ *          единичная диагональ не хранится) и U (диагональ и выше)
+ * @param lda Шаг между строками a в элементах
+ * @param pivots Массив из n элементов: строка i была переставлена со строкой pivots[i]
+ * @return 0 при успехе, либо k+1, если U(k, k) == 0 для первого такого k
+ *         (разложение при этом доводится до конца)
+ *
+ * @note Для n > LU_BLOCK используется блочный алгоритм: панель шириной LU_BLOCK
+ * раскладывается построчно, а обновление оставшейся подматрицы выполняется через GEMM
+ */
+int lu_factor_inplace(int n, double *a, ptrdiff_t lda, int *pivots);
+
+/**
+ * @brief LU-разложение квадратной матрицы: P·A = L·U
+ */
+typedef struct {
+    Matrix lu;   /**< L ниже диагонали (единичная диагональ не хранится) и U на диагонали и выше */
+    int *pivots; /**< Перестановки строк (см. lu_factor_inplace) */
+    int info;    /**< 0, либо k+1 для первого нулевого ведущего элемента U(k, k) */
+} LuFactorization;
+
+/**
+ * @brief Вычисляет LU-разложение квадратной матрицы
+ * @param mat Квадратная матрица (не изменяется)
+ * @return Разложение (освобождается free_lu_factorization); для вырожденной матрицы
+ *         info != 0, но определитель по нему вычисляется
+ * @warning Для неквадратной матрицы или при нехватке памяти завершает программу с EXIT_FAILURE
+ */
+LuFactorization lu_factor(Matrix mat);
+
+/**
+ * @brief Освобождает память разложения
+ * @param lu Разложение
+ */
+void free_lu_factorization(LuFactorization lu);
+
+/**
+ * @brief Решает систему A·X = B для всех столбцов B
+ * @param lu Разложение матрицы A порядка n
+ * @param rhs Правые части: матрица с n строками
+ * @return Новая матрица решений того же размера, что rhs
+ * @warning Для вырожденной A или несовпадения размеров завершает программу с EXIT_FAILURE
+ */
+Matrix lu_solve(LuFactorization lu, Matrix rhs);
+
+/**
+ * @brief Решает систему A·X = B, записывая X в существующую матрицу
+ * @param dst Матрица решений размера rhs (может совпадать с rhs - решение на месте)
+ * @param lu Разложение матрицы A
+ * @param rhs Правые части
+ */
+void lu_solve_into(Matrix *dst, LuFactorization lu, Matrix rhs);
+
+/**
+ * @brief Вычисляет обратную матрицу по разложению
+ * @param lu Разложение матрицы A
+ * @return A^-1 (решение A·X = I)
+ * @warning Для вырожденной A завершает программу с EXIT_FAILURE
+ */
+Matrix lu_inverse(LuFactorization lu);
+
+/**
+ * @brief Вычисляет определитель по разложению
+ * @param lu Разложение матрицы A
+ * @return det(A) (0 для вырожденной матрицы)
+ */
+double lu_determinant(LuFactorization lu);
+
+/**
+ * @brief Вычисляет логарифм модуля определителя и его знак по разложению
+ * @param lu Разложение матрицы A
+ * @param sign Указатель для записи знака определителя (может быть NULL)
+ * @return ln|det(A)| или -INFINITY для вырожденной матрицы
+ */
+double lu_log_abs_determinant(LuFactorization lu, int *sign);
+
+/**
+ * @brief Решает систему A·X = B (разложение вычисляется и освобождается)
+ * @param mat Квадратная матрица A
+ * @param rhs Правые части
+ * @return Матрица решений
+ * @note Для нескольких систем с одной A выгоднее один раз вызвать lu_factor
+ */
+Matrix solve_matrix(Matrix mat, Matrix rhs);
+
+/**
+ * @brief Вычисляет обратную матрицу
+ * @param mat Квадратная невырожденная матрица
+ * @return Обратная матрица
+ */
+Matrix inverse_matrix(Matrix mat);
+
+#endif
+
+/** @} */
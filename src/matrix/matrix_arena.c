@@ -0,0 +1,84 @@
+/**
+ * @file matrix_arena.c
+ * @brief Реализация арены для временных матриц
+ * @ingroup Matrix_Operations
+ */
+
+#include "matrix_arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_operations.h"
+
+size_t matrix_arena_bytes_for(int rows, int cols) {
+    size_t bytes = (size_t)rows * (size_t)matrix_stride_for(cols) * sizeof(double);
+    return (bytes + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+}
+
+MatrixArena matrix_arena_create(size_t capacity) {
+    MatrixArena arena = {NULL, 0, 0, 0};
+    capacity = (capacity + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+    if (capacity > 0 && posix_memalign((void **)&arena.base, MATRIX_ALIGNMENT, capacity) != 0) {
+        fprintf(stderr, "Ошибка выделения памяти для арены матриц!\n");
+        exit(EXIT_FAILURE);
+    }
+    arena.capacity = capacity;
+    return arena;
+}
+
+void matrix_arena_destroy(MatrixArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    free(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+Matrix matrix_arena_matrix(MatrixArena *arena, int rows, int cols) {
+    if (rows < 0 || cols < 0) {
+        fprintf(stderr, "Недопустимые размеры матрицы!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t bytes = matrix_arena_bytes_for(rows, cols);
+    if (arena == NULL || bytes > arena->capacity - arena->used) {
+        fprintf(stderr, "Недостаточно места в арене для матрицы %dx%d!\n", rows, cols);
+        exit(EXIT_FAILURE);
+    }
+
+    Matrix mat;
+    mat.rows = rows;
+    mat.cols = cols;
+    mat.stride = matrix_stride_for(cols);
+    mat.data = bytes > 0 ? (double *)(arena->base + arena->used) : NULL;
+    mat.flags = MATRIX_BORROWED;
+    if (bytes > 0) {
+        memset(mat.data, 0, bytes);
+    }
+
+    arena->used += bytes;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    return mat;
+}
+
+size_t matrix_arena_mark(const MatrixArena *arena) {
+    return arena->used;
+}
+
+void matrix_arena_rewind(MatrixArena *arena, size_t mark) {
+    if (mark <= arena->used) {
+        arena->used = mark;
+    }
+}
+
+void matrix_arena_reset(MatrixArena *arena) {
+    arena->used = 0;
+}
+
+size_t matrix_arena_high_water(const MatrixArena *arena) {
+    return arena->high_water;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file matrix_arena.h
+ * @brief Арена (линейный распределитель) для временных матриц выражения
+ * @ingroup Matrix_Operations
+ * @{
+ */
+
+#ifndef MATRIX_ARENA_H
+#define MATRIX_ARENA_H
+
+#include <stddef.h>
+#include "../include/config.h"
+
+/**
+ * @brief Арена: один выровненный блок памяти, из которого матрицы выделяются сдвигом указателя
+ *
+ * Матрицы из арены имеют флаг MATRIX_BORROWED: free_matrix для них ничего не делает,
+ * а вся память возвращается одним вызовом matrix_arena_reset или matrix_arena_rewind.
+ */
+typedef struct {
+    char *base;        /**< Начало блока */
+    size_t capacity;   /**< Размер блока в байтах */
+    size_t used;       /**< Занято байт */
+    size_t high_water; /**< Максимум занятых байт за время жизни арены */
+} MatrixArena;
+
+/**
+ * @brief Возвращает число байт арены, необходимое для матрицы заданного размера
+ * @param rows Количество строк
+ * @param cols Количество столбцов
+ * @return Размер с учетом выравнивания
+ */
+size_t matrix_arena_bytes_for(int rows, int cols);
+
+/**
+ * @brief Создает арену заданной емкости
+ * @param capacity Емкость в байтах (см. matrix_arena_bytes_for)
+ * @return Новая арена
+ * @warning При ошибке выделения памяти завершает программу с EXIT_FAILURE
+ */
+MatrixArena matrix_arena_create(size_t capacity);
+
+/**
+ * @brief Освобождает блок арены
+ * @param arena Арена
+ * @warning Все матрицы, выделенные из арены, становятся недействительными
+ */
+void matrix_arena_destroy(MatrixArena *arena);
+
+/**
+ * @brief Выделяет матрицу из арены
+ * @param arena Арена
+ * @param rows Количество строк
+ * @param cols Количество столбцов
+ * @return Матрица с нулевыми элементами и флагом MATRIX_BORROWED
+ * @warning При нехватке емкости арены завершает программу с EXIT_FAILURE
+ */
+Matrix matrix_arena_matrix(MatrixArena *arena, int rows, int cols);
+
+/**
+ * @brief Запоминает текущее заполнение арены
+ * @param arena Арена
+ * @return Отметка для matrix_arena_rewind
+ */
+size_t matrix_arena_mark(const MatrixArena *arena);
+
+/**
+ * @brief Возвращает арену к ранее запомненной отметке
+ * @param arena Арена
+ * @param mark Отметка, полученная из matrix_arena_mark
+ * @note Матрицы, выделенные после отметки, становятся недействительными
+ */
+void matrix_arena_rewind(MatrixArena *arena, size_t mark);
+
+/**
+ * @brief Освобождает все матрицы арены (блок памяти сохраняется)
+ * @param arena Арена
+ */
+void matrix_arena_reset(MatrixArena *arena);
+
+/**
+ * @brief Возвращает максимальное заполнение арены
+ * @param arena Арена
+ * @return Максимум занятых байт с момента создания арены
+ */
+size_t matrix_arena_high_water(const MatrixArena *arena);
+
+#endif
+
+/** @} */
@@ -0,0 +1,301 @@
+/**
+ * @file matrix_batch.c
+ * @brief Реализация пакетных операций над маленькими матрицами
+ * @ingroup Matrix_Operations
+ */
+
+#include "matrix_batch.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_operations.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_X86 1
+#else
+#define BATCH_X86 0
+#endif
+
+#define BATCH_NAME(name) batch_##name##_base
+#define BATCH_ATTR
+#include "batch_template.h"
+
+#if BATCH_X86
+
+#define BATCH_NAME(name) batch_##name##_avx2
+#define BATCH_ATTR __attribute__((target("avx2")))
+#include "batch_template.h"
+
+#define BATCH_NAME(name) batch_##name##_avx512
+#define BATCH_ATTR __attribute__((target("avx512f")))
+#include "batch_template.h"
+
+#endif /* BATCH_X86 */
+
+/**
+ * @brief Ядра пакетных операций одного уровня инструкций
+ */
+typedef struct {
+    void (*multiply)(int m, int k, int n, int begin, int end, const double *a, const double *b,
+                     double *c, size_t stride);
+    void (*determinant)(int n, int begin, int end, const double *a, size_t stride, double *out);
+} BatchKernels;
+
+/**
+ * @brief Ядра для уровня инструкций, выбранного simd_kernels()
+ *
+ * Вектор блока всегда занимает MATRIX_BATCH_LANES элементов; уровень определяет лишь,
+ * сколькими регистрами он представлен. На уровне SSE2 используется базовый экземпляр:
+ * SSE2 входит в базовый набор x86-64.
+ */
+static const BatchKernels *batch_kernels(void) {
+    static const BatchKernels base = {batch_multiply_base, batch_determinant_base};
+#if BATCH_X86
+    static const BatchKernels avx2 = {batch_multiply_avx2, batch_determinant_avx2};
+    static const BatchKernels avx512 = {batch_multiply_avx512, batch_determinant_avx512};
+    switch (simd_kernels()->level) {
+    case SIMD_AVX512:
+        return &avx512;
+    case SIMD_AVX2:
+        return &avx2;
+    default:
+        break;
+    }
+#endif
+    return &base;
+}
+
+/**
+ * @brief Параметры пакетной операции, выполняемой в пуле потоков
+ */
+typedef struct {
+    MatrixBatch src1; /**< Первый операнд */
+    MatrixBatch src2; /**< Второй операнд (для бинарных операций) */
+    MatrixBatch dst;  /**< Результат */
+    double *out;      /**< Определители (выровненный буфер из dst.stride значений) */
+    const BatchKernels *kernels;
+    void (*binary)(int n, const double *a, const double *b, double *out);
+} BatchJob;
+
+/**
+ * @brief Задача пула: поэлементная операция над плоскостями [begin, end)
+ */
+static void plane_task(void *ctx, int begin, int end) {
+    const BatchJob *job = (const BatchJob *)ctx;
+    const size_t stride = (size_t)job->dst.stride;
+    for (int iter = begin; iter < end; iter++) {
+        const size_t offset = (size_t)iter * stride;
+        job->binary(job->dst.stride, job->src1.data + offset, job->src2.data + offset,
+                    job->dst.data + offset);
+    }
+}
+
+/**
+ * @brief Задача пула: перенос плоскостей [begin, end) результата транспонирования
+ */
+static void transpose_task(void *ctx, int begin, int end) {
+    const BatchJob *job = (const BatchJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        const int row = iter / job->dst.cols;
+        const int col = iter % job->dst.cols;
+        memcpy(MATRIX_BATCH_PLANE(job->dst, row, col), MATRIX_BATCH_PLANE(job->src1, col, row),
+               (size_t)job->dst.stride * sizeof(double));
+    }
+}
+
+static void multiply_task(void *ctx, int begin, int end) {
+    const BatchJob *job = (const BatchJob *)ctx;
+    job->kernels->multiply(job->src1.rows, job->src1.cols, job->src2.cols, begin, end,
+                           job->src1.data, job->src2.data, job->dst.data,
+                           (size_t)job->dst.stride);
+}
+
+static void determinant_task(void *ctx, int begin, int end) {
+    const BatchJob *job = (const BatchJob *)ctx;
+    job->kernels->determinant(job->src1.rows, begin, end, job->src1.data,
+                              (size_t)job->src1.stride, job->out);
+}
+
+/**
+ * @brief Минимальное число блоков в одной параллельной части
+ * @param elements Число элементов одной матрицы, обрабатываемых на каждую матрицу блока
+ */
+static int blocks_grain(int elements) {
+    const int per_block = MATRIX_BATCH_LANES * (elements > 0 ? elements : 1);
+    return (PARALLEL_MIN_ELEMENTS + per_block - 1) / per_block;
+}
+
+/**
+ * @brief Минимальное число плоскостей в одной параллельной части
+ */
+static int planes_grain(MatrixBatch batch) {
+    return (PARALLEL_MIN_ELEMENTS + batch.stride - 1) / batch.stride;
+}
+
+/**
+ * @brief Проверяет, что пакеты содержат одинаковое число матриц одного размера
+ */
+static void require_same_shape(MatrixBatch batch1, MatrixBatch batch2, const char *operation) {
+    if (batch1.count != batch2.count || batch1.rows != batch2.rows ||
+        batch1.cols != batch2.cols) {
+        fprintf(stderr, "Размеры пакетов матриц не совпадают для %s!\n", operation);
+        exit(EXIT_FAILURE);
+    }
+}
+
+MatrixBatch create_matrix_batch(int count, int rows, int cols) {
+    if (count < 0 || rows < 0 || cols < 0 || count > INT_MAX - 2 * MATRIX_BATCH_LANES) {
+        fprintf(stderr, "Недопустимые размеры пакета матриц!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    MatrixBatch batch;
+    batch.count = count;
+    batch.rows = rows;
+    batch.cols = cols;
+    // Нечетное число блоков в плоскости: при четном плоскости с шагом, кратным 4 КиБ,
+    // попадают в одни и те же наборы кэша L1, и ядра теряют на конфликтных промахах
+    int blocks = (count + MATRIX_BATCH_LANES - 1) / MATRIX_BATCH_LANES;
+    blocks += blocks > 1 && blocks % 2 == 0;
+    batch.stride = blocks * MATRIX_BATCH_LANES;
+    batch.data = NULL;
+
+    const size_t planes = (size_t)rows * (size_t)cols;
+    if (planes == 0 || batch.stride == 0) {
+        return batch;
+    }
+    if (planes > INT_MAX || (size_t)batch.stride > SIZE_MAX / sizeof(double) / planes ||
+        posix_memalign((void **)&batch.data, MATRIX_ALIGNMENT,
+                       planes * (size_t)batch.stride * sizeof(double)) != 0) {
+        fprintf(stderr, "Ошибка выделения памяти под пакет из %d матриц %dx%d!\n", count, rows,
+                cols);
+        exit(EXIT_FAILURE);
+    }
+    memset(batch.data, 0, planes * (size_t)batch.stride * sizeof(double));
+    return batch;
+}
+
+void free_matrix_batch(MatrixBatch batch) {
+    free(batch.data);
+}
+
+/**
+ * @brief Проверяет номер матрицы пакета
+ */
+static void require_index(MatrixBatch batch, int index) {
+    if (index < 0 || index >= batch.count) {
+        fprintf(stderr, "Номер матрицы %d вне пакета из %d матриц!\n", index, batch.count);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void matrix_batch_set(MatrixBatch batch, int index, Matrix mat) {
+    require_index(batch, index);
+    if (mat.rows != batch.rows || mat.cols != batch.cols) {
+        fprintf(stderr, "Размер матрицы не совпадает с размером матриц пакета!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            MATRIX_BATCH_AT(batch, index, iter, iter_2) = MATRIX_AT(mat, iter, iter_2);
+        }
+    }
+}
+
+Matrix matrix_batch_get(MatrixBatch batch, int index) {
+    require_index(batch, index);
+    Matrix mat = create_matrix(batch.rows, batch.cols);
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            MATRIX_AT(mat, iter, iter_2) = MATRIX_BATCH_AT(batch, index, iter, iter_2);
+        }
+    }
+    return mat;
+}
+
+/**
+ * @brief Поэлементная операция над пакетами: плоскости обрабатываются векторным ядром
+ *        целиком, включая выравнивающие позиции
+ */
+static MatrixBatch elementwise(MatrixBatch batch1, MatrixBatch batch2,
+                               void (*binary)(int n, const double *a, const double *b,
+                                              double *out)) {
+    MatrixBatch result = create_matrix_batch(batch1.count, batch1.rows, batch1.cols);
+    if (result.data == NULL) {
+        return result;
+    }
+    BatchJob job = {.src1 = batch1, .src2 = batch2, .dst = result, .binary = binary};
+    parallel_for(result.rows * result.cols, planes_grain(result), plane_task, &job);
+    return result;
+}
+
+MatrixBatch plus_matrix_batch(MatrixBatch batch1, MatrixBatch batch2) {
+    require_same_shape(batch1, batch2, "сложения");
+    return elementwise(batch1, batch2, simd_kernels()->add);
+}
+
+MatrixBatch subtract_matrix_batch(MatrixBatch batch1, MatrixBatch batch2) {
+    require_same_shape(batch1, batch2, "вычитания");
+    return elementwise(batch1, batch2, simd_kernels()->sub);
+}
+
+MatrixBatch multiply_matrix_batch(MatrixBatch batch1, MatrixBatch batch2) {
+    if (batch1.count != batch2.count || batch1.cols != batch2.rows) {
+        fprintf(stderr, "Размеры пакетов матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    MatrixBatch result = create_matrix_batch(batch1.count, batch1.rows, batch2.cols);
+    if (result.data == NULL) {
+        return result;
+    }
+    BatchJob job = {.src1 = batch1, .src2 = batch2, .dst = result, .kernels = batch_kernels()};
+    parallel_for(result.stride / MATRIX_BATCH_LANES,
+                 blocks_grain(result.rows * result.cols * (batch1.cols > 0 ? batch1.cols : 1)),
+                 multiply_task, &job);
+    return result;
+}
+
+MatrixBatch transpose_matrix_batch(MatrixBatch batch) {
+    MatrixBatch result = create_matrix_batch(batch.count, batch.cols, batch.rows);
+    if (result.data == NULL) {
+        return result;
+    }
+    BatchJob job = {.src1 = batch, .dst = result};
+    parallel_for(result.rows * result.cols, planes_grain(result), transpose_task, &job);
+    return result;
+}
+
+void determinant_matrix_batch(MatrixBatch batch, double *out) {
+    if (batch.rows != batch.cols) {
+        fprintf(stderr, "Для вычисления определителя матрицы пакета должны быть квадратными!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (batch.count == 0) {
+        return;
+    }
+    if (batch.rows == 0 || batch.rows > MATRIX_BATCH_MAX_ORDER) {
+        for (int iter = 0; iter < batch.count; iter++) {
+            Matrix mat = matrix_batch_get(batch, iter);
+            out[iter] = determinant(mat);
+            free_matrix(mat);
+        }
+        return;
+    }
+
+    // Ядра записывают целые блоки, поэтому результат собирается в буфере длины stride
+    double *values;
+    if (posix_memalign((void **)&values, MATRIX_ALIGNMENT,
+                       (size_t)batch.stride * sizeof(double)) != 0) {
+        fprintf(stderr, "Ошибка выделения памяти для определителей пакета!\n");
+        exit(EXIT_FAILURE);
+    }
+    BatchJob job = {.src1 = batch, .out = values, .kernels = batch_kernels()};
+    parallel_for(batch.stride / MATRIX_BATCH_LANES,
+                 blocks_grain(batch.rows * batch.rows * batch.rows), determinant_task, &job);
+    memcpy(out, values, (size_t)batch.count * sizeof(double));
+    free(values);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file matrix_batch.h
+ * @brief Пакетные операции над множеством маленьких матриц одного размера
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Пакет хранит count матриц rows×cols в виде структуры массивов: для каждой
+ * позиции (row, col) все count значений лежат подряд (плоскость элемента).
+ * Поэтому MATRIX_BATCH_LANES соседних матриц образуют один вектор, и ядра
+ * (batch_template.h) обрабатывают по одной матрице в каждой позиции вектора,
+ * без выделения памяти и вызовов на каждую матрицу. Для квадратных матриц
+ * порядка до MATRIX_BATCH_MAX_ORDER умножение и определитель выполняются
+ * полностью развернутыми ядрами фиксированного размера.
+ */
+
+#ifndef MATRIX_BATCH_H
+#define MATRIX_BATCH_H
+
+#include "../include/config.h"
+
+/**
+ * @brief Число матриц, обрабатываемых ядрами за один шаг (одна строка кэша double)
+ */
+#define MATRIX_BATCH_LANES (MATRIX_ALIGNMENT / (int)sizeof(double))
+
+/**
+ * @brief Наибольший порядок квадратных матриц, для которого есть ядра фиксированного размера
+ */
+#define MATRIX_BATCH_MAX_ORDER 8
+
+/**
+ * @brief Пакет матриц одного размера в формате структуры массивов
+ *
+ * Элемент (row, col) матрицы index хранится в data[(row·cols + col)·stride + index].
+ * Позиции от count до stride в каждой плоскости - выравнивающие (нулевые при создании);
+ * число блоков по MATRIX_BATCH_LANES в плоскости нечетно, чтобы одноименные позиции
+ * разных плоскостей не попадали в один набор кэша.
+ */
+typedef struct {
+    int count;    /**< Число матриц */
+    int rows;     /**< Количество строк каждой матрицы */
+    int cols;     /**< Количество столбцов каждой матрицы */
+    int stride;   /**< Длина плоскости: count, округленное до нечетного числа блоков */
+    double *data; /**< Плоскости элементов, выровненные на MATRIX_ALIGNMENT */
+} MatrixBatch;
+
+/**
+ * @brief Указатель на плоскость элемента (row, col): значения этого элемента во всех матрицах
+ */
+#define MATRIX_BATCH_PLANE(batch, row, col)                                                        \
+    ((batch).data + ((size_t)(row) * (size_t)(batch).cols + (size_t)(col)) * (size_t)(batch).stride)
+
+/**
+ * @brief Доступ к элементу (row, col) матрицы index пакета (может использоваться как lvalue)
+ */
+#define MATRIX_BATCH_AT(batch, index, row, col) (MATRIX_BATCH_PLANE(batch, row, col)[(index)])
+
+/**
+ * @brief Создает пакет нулевых матриц
+ * @param count Число матриц
+ * @param rows Количество строк каждой матрицы
+ * @param cols Количество столбцов каждой матрицы
+ * @return Новый пакет
+ * @warning При недопустимых размерах или нехватке памяти завершает программу с EXIT_FAILURE
+ */
+MatrixBatch create_matrix_batch(int count, int rows, int cols);
+
+/**
+ * @brief Освобождает память пакета
+ * @param batch Пакет
+ */
+void free_matrix_batch(MatrixBatch batch);
+
+/**
+ * @brief Записывает матрицу в пакет
+ * @param batch Пакет
+ * @param index Номер матрицы в пакете
+ * @param mat Матрица размера batch.rows×batch.cols
+ * @warning При неверном номере или размере завершает программу с EXIT_FAILURE
+ */
+void matrix_batch_set(MatrixBatch batch, int index, Matrix mat);
+
+/**
+ * @brief Извлекает матрицу из пакета
+ * @param batch Пакет
+ * @param index Номер матрицы в пакете
+ * @return Новая матрица (освобождается free_matrix)
+ * @warning При неверном номере завершает программу с EXIT_FAILURE
+ */
+Matrix matrix_batch_get(MatrixBatch batch, int index);
+
+/**
+ * @brief Складывает пакеты поэлементно: C[i] = A[i] + B[i]
+ * @param batch1 Первый пакет
+ * @param batch2 Второй пакет того же числа и размера матриц
+ * @return Новый пакет сумм
+ */
+MatrixBatch plus_matrix_batch(MatrixBatch batch1, MatrixBatch batch2);
+
+/**
+ * @brief Вычитает пакеты поэлементно: C[i] = A[i] - B[i]
+ * @param batch1 Пакет уменьшаемых
+ * @param batch2 Пакет вычитаемых того же числа и размера матриц
+ * @return Новый пакет разностей
+ */
+MatrixBatch subtract_matrix_batch(MatrixBatch batch1, MatrixBatch batch2);
+
+/**
+ * @brief Умножает пакеты: C[i] = A[i]·B[i]
+ * @param batch1 Пакет матриц m×k
+ * @param batch2 Пакет из того же числа матриц k×n
+ * @return Новый пакет произведений m×n
+ * @note Суммы накапливаются в порядке возрастания k без FMA, поэтому результат не
+ *       зависит от уровня инструкций
+ */
+MatrixBatch multiply_matrix_batch(MatrixBatch batch1, MatrixBatch batch2);
+
+/**
+ * @brief Транспонирует каждую матрицу пакета
+ * @param batch Пакет матриц m×n
+ * @return Новый пакет матриц n×m
+ * @note Транспонирование сводится к перестановке плоскостей элементов
+ */
+MatrixBatch transpose_matrix_batch(MatrixBatch batch);
+
+/**
+ * @brief Вычисляет определители всех матриц пакета
+ * @param batch Пакет квадратных матриц
+ * @param out Массив из batch.count значений
+ * @note Для порядков до MATRIX_BATCH_MAX_ORDER результат совпадает с determinant
+ *       побитово; матрицы большего порядка обрабатываются по одной через determinant
+ * @warning Для неквадратных матриц завершает программу с EXIT_FAILURE
+ */
+void determinant_matrix_batch(MatrixBatch batch, double *out);
+
+#endif
+
+/** @} */
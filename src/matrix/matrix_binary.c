@@ -0,0 +1,297 @@
+/**
+ * @file matrix_binary.c
+ * @brief Реализация загрузки матриц из двоичного файла
+ * @ingroup Matrix_Operations
+ */
+
+#include "matrix_binary.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "matrix_float.h"
+#include "matrix_operations.h"
+
+/**
+ * @brief Метка порядка байт, прочитанная на машине с другим порядком байт
+ */
+#define MATRIX_FILE_ENDIAN_SWAPPED 0x04030201u
+
+int matrix_file_is_binary(FILE *file) {
+    char magic[MATRIX_FILE_MAGIC_SIZE];
+    return fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+           memcmp(magic, MATRIX_FILE_MAGIC, MATRIX_FILE_MAGIC_SIZE) == 0;
+}
+
+/**
+ * @brief Сообщает об ошибке в файле и завершает программу
+ */
+static void binary_fail(int fd, const char *filename, const char *reason) {
+    fprintf(stderr, "Ошибка чтения двоичного файла матрицы %s: %s!\n", filename, reason);
+    if (fd >= 0) {
+        close(fd);
+    }
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Переставляет байты полей заголовка, записанного с другим порядком байт
+ */
+static void swap_header(MatrixFileHeader *header) {
+    header->version = __builtin_bswap32(header->version);
+    header->dtype = __builtin_bswap32(header->dtype);
+    header->endianness = __builtin_bswap32(header->endianness);
+    header->alignment = __builtin_bswap32(header->alignment);
+    header->rows = __builtin_bswap64(header->rows);
+    header->cols = __builtin_bswap64(header->cols);
+    header->stride = __builtin_bswap64(header->stride);
+    header->data_offset = __builtin_bswap64(header->data_offset);
+}
+
+/**
+ * @brief Размер элемента заданного типа в байтах
+ */
+static size_t dtype_size(uint32_t dtype) {
+    return dtype == MATRIX_DTYPE_FLOAT32 ? sizeof(float) : sizeof(double);
+}
+
+/**
+ * @brief Элемент с номером index из прочитанной строки файла
+ */
+static double element_at(const unsigned char *row, size_t index, uint32_t dtype, int swapped) {
+    if (dtype == MATRIX_DTYPE_FLOAT32) {
+        uint32_t bits;
+        float value;
+        memcpy(&bits, row + index * sizeof(bits), sizeof(bits));
+        bits = swapped ? __builtin_bswap32(bits) : bits;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    uint64_t bits;
+    double value;
+    memcpy(&bits, row + index * sizeof(bits), sizeof(bits));
+    bits = swapped ? __builtin_bswap64(bits) : bits;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Читает элементы файла с перестановкой байт и преобразованием типа
+ * @param data Первая строка результата
+ * @param dtype Тип элементов результата
+ * @param stride Шаг строк результата в элементах
+ * @return 0 при успехе, -1 если файл короче, чем указано в заголовке
+ *
+ * Используется, когда файл нельзя отобразить в память как есть: данные записаны
+ * с обратным порядком байт или тип элементов не совпадает с запрошенным.
+ */
+static int read_converted(int fd, const MatrixFileHeader *header, int swapped, void *data,
+                          uint32_t dtype, int stride) {
+    const size_t row_bytes = (size_t)header->cols * dtype_size(header->dtype);
+    unsigned char *buffer = malloc(row_bytes > 0 ? row_bytes : 1);
+    if (buffer == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для чтения матрицы!\n");
+        exit(EXIT_FAILURE);
+    }
+    int status = 0;
+    for (int iter = 0; iter < (int)header->rows && status == 0; iter++) {
+        uint64_t row_offset = (uint64_t)iter * header->stride * dtype_size(header->dtype);
+        off_t offset = (off_t)(header->data_offset + row_offset);
+        if (pread(fd, buffer, row_bytes, offset) != (ssize_t)row_bytes) {
+            status = -1;
+            break;
+        }
+        const size_t first = (size_t)iter * (size_t)stride;
+        for (size_t iter_2 = 0; iter_2 < header->cols; iter_2++) {
+            double value = element_at(buffer, iter_2, header->dtype, swapped);
+            if (dtype == MATRIX_DTYPE_FLOAT32) {
+                ((float *)data)[first + iter_2] = (float)value;
+            } else {
+                ((double *)data)[first + iter_2] = value;
+            }
+        }
+    }
+    free(buffer);
+    return status;
+}
+
+/**
+ * @brief Отображает данные файла в память только для чтения и закрывает fd
+ * @param data Адрес первой строки или NULL для пустой матрицы
+ * @return 0 при успехе, -1 если файл не удалось отобразить
+ */
+static int map_data(int fd, const MatrixFileHeader *header, void **data) {
+    uint64_t data_bytes = header->rows * header->stride * dtype_size(header->dtype);
+    *data = NULL;
+    if (data_bytes == 0) {
+        close(fd);
+        return 0;
+    }
+    size_t length = (size_t)(header->data_offset + data_bytes);
+    void *base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+    *data = (char *)base + header->data_offset;
+    return 0;
+}
+
+/**
+ * @brief Снимает отображение данных, полученных map_data
+ */
+static void unmap_data(void *data, size_t data_bytes) {
+    if (data != NULL) {
+        munmap((char *)data - MATRIX_FILE_HEADER_SIZE, MATRIX_FILE_HEADER_SIZE + data_bytes);
+    }
+}
+
+int matrix_binary_check_header(int fd, MatrixFileHeader *header, const char **error) {
+    if (pread(fd, header, sizeof(*header), 0) != (ssize_t)sizeof(*header) ||
+        memcmp(header->magic, MATRIX_FILE_MAGIC, MATRIX_FILE_MAGIC_SIZE) != 0) {
+        *error = "неверный заголовок";
+        return -1;
+    }
+    int swapped = header->endianness == MATRIX_FILE_ENDIAN_SWAPPED;
+    if (swapped) {
+        swap_header(header);
+    }
+    if (header->endianness != MATRIX_FILE_ENDIAN_MARK) {
+        *error = "неизвестный порядок байт";
+        return -1;
+    }
+    if (header->version != MATRIX_FILE_VERSION) {
+        *error = "неподдерживаемая версия формата";
+        return -1;
+    }
+    if (header->dtype != MATRIX_DTYPE_FLOAT64 && header->dtype != MATRIX_DTYPE_FLOAT32) {
+        *error = "неподдерживаемый тип элементов";
+        return -1;
+    }
+    const size_t size = dtype_size(header->dtype);
+    if (header->rows > INT_MAX || header->cols > INT_MAX || header->stride > INT_MAX ||
+        header->stride < header->cols ||
+        (header->rows > 0 && header->stride > SIZE_MAX / size / header->rows)) {
+        *error = "недопустимые размеры матрицы";
+        return -1;
+    }
+    if (header->data_offset != MATRIX_FILE_HEADER_SIZE) {
+        *error = "неподдерживаемое смещение данных";
+        return -1;
+    }
+    if (header->alignment < size || (header->alignment & (header->alignment - 1)) != 0 ||
+        header->data_offset % header->alignment != 0) {
+        *error = "недопустимое выравнивание данных";
+        return -1;
+    }
+
+    struct stat info;
+    uint64_t data_bytes = header->rows * header->stride * size;
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < header->data_offset + data_bytes) {
+        *error = "файл короче, чем указано в заголовке";
+        return -1;
+    }
+    return swapped;
+}
+
+int matrix_binary_read_header(int fd, const char *filename, MatrixFileHeader *header) {
+    const char *error = NULL;
+    int swapped = matrix_binary_check_header(fd, header, &error);
+    if (swapped < 0) {
+        binary_fail(fd, filename, error);
+    }
+    return swapped;
+}
+
+int matrix_binary_try_load(const char *filename, Matrix *mat, const char **error) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        *error = "невозможно открыть файл";
+        return -1;
+    }
+
+    MatrixFileHeader header;
+    int swapped = matrix_binary_check_header(fd, &header, error);
+    if (swapped < 0) {
+        close(fd);
+        return -1;
+    }
+    if (swapped || header.dtype != MATRIX_DTYPE_FLOAT64) {
+        Matrix result = create_matrix((int)header.rows, (int)header.cols);
+        int status = read_converted(fd, &header, swapped, result.data, MATRIX_DTYPE_FLOAT64,
+                                    result.stride);
+        close(fd);
+        if (status != 0) {
+            free_matrix(result);
+            *error = "файл короче, чем указано в заголовке";
+            return -1;
+        }
+        *mat = result;
+        return 0;
+    }
+
+    void *data;
+    if (map_data(fd, &header, &data) != 0) {
+        *error = "невозможно отобразить файл в память";
+        return -1;
+    }
+    Matrix result = {.rows = (int)header.rows,
+                     .cols = (int)header.cols,
+                     .stride = (int)header.stride,
+                     .data = (double *)data,
+                     .flags = MATRIX_MAPPED | MATRIX_READONLY};
+    *mat = result;
+    return 0;
+}
+
+Matrix load_matrix_from_binary_file(const char *filename) {
+    Matrix mat;
+    const char *error = NULL;
+    if (matrix_binary_try_load(filename, &mat, &error) != 0) {
+        binary_fail(-1, filename, error);
+    }
+    return mat;
+}
+
+MatrixF load_matrix_from_binary_file_f(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Невозможно открыть файл!");
+        exit(EXIT_FAILURE);
+    }
+
+    MatrixFileHeader header;
+    int swapped = matrix_binary_read_header(fd, filename, &header);
+    if (swapped || header.dtype != MATRIX_DTYPE_FLOAT32) {
+        MatrixF mat = create_matrix_f((int)header.rows, (int)header.cols);
+        if (read_converted(fd, &header, swapped, mat.data, MATRIX_DTYPE_FLOAT32, mat.stride) != 0) {
+            free_matrix_f(mat);
+            binary_fail(fd, filename, "файл короче, чем указано в заголовке");
+        }
+        close(fd);
+        return mat;
+    }
+
+    void *data;
+    if (map_data(fd, &header, &data) != 0) {
+        binary_fail(-1, filename, "невозможно отобразить файл в память");
+    }
+    MatrixF mat = {.rows = (int)header.rows,
+                   .cols = (int)header.cols,
+                   .stride = (int)header.stride,
+                   .data = (float *)data,
+                   .flags = MATRIX_MAPPED | MATRIX_READONLY};
+    return mat;
+}
+
+void matrix_binary_unmap(Matrix mat) {
+    unmap_data(mat.data, (size_t)mat.rows * (size_t)mat.stride * sizeof(double));
+}
+
+void matrix_binary_unmap_f(MatrixF mat) {
+    unmap_data(mat.data, (size_t)mat.rows * (size_t)mat.stride * sizeof(float));
+}
@@ -0,0 +1,93 @@
+/**
+ * @file matrix_binary.h
+ * @brief Загрузка матриц из двоичного файла отображением в память
+ * @ingroup Matrix_Operations
+ * @{
+ */
+
+#ifndef MATRIX_BINARY_H
+#define MATRIX_BINARY_H
+
+#include <stdio.h>
+#include "../include/config.h"
+#include "../include/matrix_format.h"
+
+/**
+ * @brief Проверяет, начинается ли файл с сигнатуры двоичного формата
+ * @param file Открытый файл (позиция чтения сдвигается)
+ * @return 1 для двоичного файла, 0 иначе
+ */
+int matrix_file_is_binary(FILE *file);
+
+/**
+ * @brief Читает и проверяет заголовок двоичного файла матрицы без завершения программы
+ * @param fd Открытый файл (не закрывается)
+ * @param header Заголовок в порядке байт текущей машины
+ * @param error Описание ошибки при неверном заголовке или слишком коротком файле
+ * @return 1, если данные записаны с обратным порядком байт, 0 иначе, -1 при ошибке
+ */
+int matrix_binary_check_header(int fd, MatrixFileHeader *header, const char **error);
+
+/**
+ * @brief Читает и проверяет заголовок двоичного файла матрицы
+ * @param fd Открытый файл
+ * @param filename Имя файла для сообщений об ошибках
+ * @param header Заголовок в порядке байт текущей машины
+ * @return 1, если данные записаны с обратным порядком байт, 0 иначе
+ * @warning При неверном заголовке или слишком коротком файле закрывает fd и
+ *          завершает программу с EXIT_FAILURE
+ */
+int matrix_binary_read_header(int fd, const char *filename, MatrixFileHeader *header);
+
+/**
+ * @brief Загружает матрицу из двоичного файла без копирования данных
+ * @param filename Путь к файлу (формат описан в matrix_format.h)
+ * @return Матрица с флагами MATRIX_MAPPED и MATRIX_READONLY, элементы которой
+ *         указывают прямо в отображенный файл
+ *
+ * @note Страницы файла читаются с диска при первом обращении к ним
+ * @note Файл с обратным порядком байт или с элементами float читается с преобразованием
+ *       в обычную матрицу
+ * @note Для изменения элементов нужна копия (copy_matrix)
+ * @warning При ошибке чтения или неверном заголовке завершает программу с EXIT_FAILURE
+ */
+Matrix load_matrix_from_binary_file(const char *filename);
+
+/**
+ * @brief Загружает матрицу из двоичного файла, возвращая ошибку вместо завершения программы
+ * @param filename Путь к файлу
+ * @param mat Загруженная матрица (как у load_matrix_from_binary_file)
+ * @param error Описание ошибки, если файл не открывается, заголовок неверен, файл
+ *              короче, чем указано в заголовке, или не отображается в память
+ * @return 0 при успехе, -1 при ошибке (mat не изменяется)
+ * @note Используется там, где поврежденный файл не должен завершать программу:
+ *       элементы кэша (matrix_cache.h) и команда load сервера (matrix_server.h)
+ */
+int matrix_binary_try_load(const char *filename, Matrix *mat, const char **error);
+
+/**
+ * @brief Снимает отображение матрицы, загруженной load_matrix_from_binary_file
+ * @param mat Матрица с флагом MATRIX_MAPPED
+ * @note Вызывается из free_matrix
+ */
+void matrix_binary_unmap(Matrix mat);
+
+/**
+ * @brief Загружает матрицу float из двоичного файла без копирования данных
+ * @param filename Путь к файлу
+ * @return Матрица с флагами MATRIX_MAPPED и MATRIX_READONLY для файла с элементами float;
+ *         файл с элементами double читается с округлением до float в обычную матрицу
+ * @warning При ошибке чтения или неверном заголовке завершает программу с EXIT_FAILURE
+ */
+MatrixF load_matrix_from_binary_file_f(const char *filename);
+
+/**
+ * @brief Снимает отображение матрицы, загруженной load_matrix_from_binary_file_f
+ * @param mat Матрица с флагом MATRIX_MAPPED
+ * @note Вызывается из free_matrix_f
+ */
+void matrix_binary_unmap_f(MatrixF mat);
+
+#endif
+
+/** @} */
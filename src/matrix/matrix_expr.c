@@ -0,0 +1,386 @@
+/**
+ * @file matrix_expr.c
+ * @brief Реализация ленивых матричных выражений
+ * @ingroup Matrix_Operations
+ *
+ * Перед вычислением дерево раскрывается в список слагаемых: каждое слагаемое -
+ * лист или произведение со знаком ±1 и признаком транспонирования (транспонирование
+ * суммы распределяется по слагаемым). Первое произведение вычисляется через
+ * gemm_strided_init, которой сумма листовых слагаемых передается как начальное
+ * значение C; транспонированное произведение записывается с переставленными
+ * шагами результата. Без произведений сумма вычисляется поблочно за один проход.
+ */
+
+#include "matrix_expr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "gemm.h"
+#include "matrix_operations.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Сторона квадратного блока при поэлементном вычислении суммы
+ *
+ * Блок из транспонированного слагаемого читается по столбцам, поэтому
+ * он должен целиком помещаться в L1.
+ */
+#define EXPR_TILE 32
+
+/**
+ * @brief Вид узла выражения
+ */
+typedef enum { EXPR_LEAF, EXPR_PLUS, EXPR_SUBTRACT, EXPR_MULTIPLY, EXPR_TRANSPOSE } ExprKind;
+
+struct MatrixExpr {
+    ExprKind kind;   /**< Вид узла */
+    int rows;        /**< Число строк результата узла */
+    int cols;        /**< Число столбцов результата узла */
+    Matrix mat;      /**< Матрица листа */
+    MatrixExpr *lhs; /**< Левый (единственный для транспонирования) операнд */
+    MatrixExpr *rhs; /**< Правый операнд */
+};
+
+/**
+ * @brief Слагаемое раскрытого выражения: sign · node или sign · node^T
+ */
+typedef struct {
+    double sign;            /**< Знак (+1 или -1) */
+    int transposed;         /**< 1, если слагаемое транспонировано */
+    const MatrixExpr *node; /**< Лист или произведение */
+} ExprTerm;
+
+/**
+ * @brief Динамический список слагаемых
+ */
+typedef struct {
+    ExprTerm *items; /**< Слагаемые */
+    int count;       /**< Количество слагаемых */
+    int capacity;    /**< Емкость массива */
+} TermList;
+
+/**
+ * @brief Операнд произведения, заданный указателем и шагами
+ */
+typedef struct {
+    const double *data; /**< Указатель на элемент (0, 0) */
+    ptrdiff_t rs;       /**< Шаг между строками */
+    ptrdiff_t cs;       /**< Шаг между столбцами */
+    Matrix temp;        /**< Временная матрица, если операнд пришлось вычислить */
+    int owned;          /**< 1, если temp нужно освободить */
+} ExprOperand;
+
+/**
+ * @brief Параметры заполнения результата суммой листовых слагаемых
+ */
+typedef struct {
+    const ExprTerm *terms; /**< Листовые слагаемые */
+    int count;             /**< Их количество */
+    int transposed;        /**< Для эпилога GEMM: произведение записывается транспонированным */
+    Matrix dst;            /**< Результат (для поэлементного вычисления) */
+} FillJob;
+
+/**
+ * @brief Создает узел, завершая программу при ошибке выделения памяти
+ */
+static MatrixExpr *new_node(ExprKind kind, int rows, int cols, MatrixExpr *lhs, MatrixExpr *rhs) {
+    MatrixExpr *node = (MatrixExpr *)calloc(1, sizeof(MatrixExpr));
+    if (node == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для узла выражения!\n");
+        exit(EXIT_FAILURE);
+    }
+    node->kind = kind;
+    node->rows = rows;
+    node->cols = cols;
+    node->lhs = lhs;
+    node->rhs = rhs;
+    return node;
+}
+
+MatrixExpr *matrix_expr_leaf(Matrix mat) {
+    MatrixExpr *node = new_node(EXPR_LEAF, mat.rows, mat.cols, NULL, NULL);
+    node->mat = mat;
+    return node;
+}
+
+MatrixExpr *matrix_expr_plus(MatrixExpr *lhs, MatrixExpr *rhs) {
+    if (lhs->rows != rhs->rows || lhs->cols != rhs->cols) {
+        fprintf(stderr, "Размеры матриц не совпадают для сложения!\n");
+        exit(EXIT_FAILURE);
+    }
+    return new_node(EXPR_PLUS, lhs->rows, lhs->cols, lhs, rhs);
+}
+
+MatrixExpr *matrix_expr_subtract(MatrixExpr *lhs, MatrixExpr *rhs) {
+    if (lhs->rows != rhs->rows || lhs->cols != rhs->cols) {
+        fprintf(stderr, "Размеры матриц не совпадают для вычитания!\n");
+        exit(EXIT_FAILURE);
+    }
+    return new_node(EXPR_SUBTRACT, lhs->rows, lhs->cols, lhs, rhs);
+}
+
+MatrixExpr *matrix_expr_multiply(MatrixExpr *lhs, MatrixExpr *rhs) {
+    if (lhs->cols != rhs->rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    return new_node(EXPR_MULTIPLY, lhs->rows, rhs->cols, lhs, rhs);
+}
+
+MatrixExpr *matrix_expr_transpose(MatrixExpr *operand) {
+    return new_node(EXPR_TRANSPOSE, operand->cols, operand->rows, operand, NULL);
+}
+
+int matrix_expr_rows(const MatrixExpr *expr) {
+    return expr->rows;
+}
+
+int matrix_expr_cols(const MatrixExpr *expr) {
+    return expr->cols;
+}
+
+void matrix_expr_free(MatrixExpr *expr) {
+    if (expr == NULL) {
+        return;
+    }
+    matrix_expr_free(expr->lhs);
+    matrix_expr_free(expr->rhs);
+    free(expr);
+}
+
+/**
+ * @brief Добавляет слагаемое в список
+ */
+static void push_term(TermList *terms, double sign, int transposed, const MatrixExpr *node) {
+    if (terms->count == terms->capacity) {
+        int capacity = terms->capacity > 0 ? terms->capacity * 2 : 8;
+        ExprTerm *items = (ExprTerm *)realloc(terms->items, (size_t)capacity * sizeof(ExprTerm));
+        if (items == NULL) {
+            fprintf(stderr, "Ошибка выделения памяти для вычисления выражения!\n");
+            exit(EXIT_FAILURE);
+        }
+        terms->items = items;
+        terms->capacity = capacity;
+    }
+    terms->items[terms->count++] =
+        (ExprTerm){.sign = sign, .transposed = transposed, .node = node};
+}
+
+/**
+ * @brief Раскрывает сумму в список слагаемых
+ * @param node Узел выражения
+ * @param sign Знак, с которым узел входит в сумму
+ * @param transposed 1, если узел находится под нечетным числом транспонирований
+ * @param terms Список слагаемых
+ */
+static void collect_terms(const MatrixExpr *node, double sign, int transposed, TermList *terms) {
+    switch (node->kind) {
+    case EXPR_PLUS:
+        collect_terms(node->lhs, sign, transposed, terms);
+        collect_terms(node->rhs, sign, transposed, terms);
+        break;
+    case EXPR_SUBTRACT:
+        collect_terms(node->lhs, sign, transposed, terms);
+        collect_terms(node->rhs, -sign, transposed, terms);
+        break;
+    case EXPR_TRANSPOSE:
+        collect_terms(node->lhs, sign, !transposed, terms);
+        break;
+    default:
+        push_term(terms, sign, transposed, node);
+        break;
+    }
+}
+
+/**
+ * @brief Проверяет, читает ли выражение память матрицы mat
+ */
+static int expr_reads(const MatrixExpr *node, Matrix mat) {
+    if (node == NULL) {
+        return 0;
+    }
+    if (node->kind == EXPR_LEAF) {
+        return matrices_overlap(node->mat, mat);
+    }
+    return expr_reads(node->lhs, mat) || expr_reads(node->rhs, mat);
+}
+
+/**
+ * @brief Заполняет блок rows×cols суммой листовых слагаемых
+ * @param terms Листовые слагаемые
+ * @param count Их количество
+ * @param row Строка результата, соответствующая строке 0 блока
+ * @param col Столбец результата, соответствующий столбцу 0 блока
+ * @param rows Число строк блока
+ * @param cols Число столбцов блока
+ * @param tile Указатель на элемент (0, 0) блока
+ * @param rs_t Шаг между строками блока
+ * @param cs_t Шаг между столбцами блока
+ */
+static void fill_terms(const ExprTerm *terms, int count, int row, int col, int rows, int cols,
+                       double *tile, ptrdiff_t rs_t, ptrdiff_t cs_t) {
+    if (count == 0) {
+        for (int iter = 0; iter < rows; iter++) {
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                tile[iter * rs_t + iter_2 * cs_t] = 0.0;
+            }
+        }
+        return;
+    }
+    for (int term = 0; term < count; term++) {
+        const Matrix mat = terms[term].node->mat;
+        const double sign = terms[term].sign;
+        for (int iter = 0; iter < rows; iter++) {
+            double *out = tile + iter * rs_t;
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                double value = terms[term].transposed ? MATRIX_AT(mat, col + iter_2, row + iter)
+                                                      : MATRIX_AT(mat, row + iter, col + iter_2);
+                if (term == 0) {
+                    out[iter_2 * cs_t] = sign * value;
+                } else {
+                    out[iter_2 * cs_t] += sign * value;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Эпилог GEMM: начальные значения блока произведения из листовых слагаемых
+ *
+ * Координаты блока заданы в системе произведения; если произведение входит
+ * в сумму транспонированным, блок соответствует транспонированному блоку результата.
+ */
+static void product_init(void *ctx, int row, int col, int rows, int cols, double *tile, int ld) {
+    const FillJob *job = (const FillJob *)ctx;
+    if (job->transposed) {
+        fill_terms(job->terms, job->count, col, row, cols, rows, tile, 1, ld);
+    } else {
+        fill_terms(job->terms, job->count, row, col, rows, cols, tile, ld, 1);
+    }
+}
+
+/**
+ * @brief Задача пула: вычисляет сумму для полос [begin, end) по EXPR_TILE строк
+ */
+static void fill_task(void *ctx, int begin, int end) {
+    const FillJob *job = (const FillJob *)ctx;
+    const Matrix dst = job->dst;
+    for (int block = begin; block < end; block++) {
+        const int row = block * EXPR_TILE;
+        const int rows = dst.rows - row < EXPR_TILE ? dst.rows - row : EXPR_TILE;
+        for (int col = 0; col < dst.cols; col += EXPR_TILE) {
+            const int cols = dst.cols - col < EXPR_TILE ? dst.cols - col : EXPR_TILE;
+            fill_terms(job->terms, job->count, row, col, rows, cols, &MATRIX_AT(dst, row, col),
+                       dst.stride, 1);
+        }
+    }
+}
+
+/**
+ * @brief Готовит множитель произведения: матрица или ее транспонирование
+ *        используются напрямую, остальное вычисляется во временную матрицу
+ */
+static ExprOperand resolve_operand(const MatrixExpr *node) {
+    int transposed = 0;
+    while (node->kind == EXPR_TRANSPOSE) {
+        transposed = !transposed;
+        node = node->lhs;
+    }
+
+    ExprOperand operand = {.owned = 0};
+    Matrix mat = node->mat;
+    if (node->kind != EXPR_LEAF) {
+        operand.temp = matrix_expr_evaluate(node);
+        operand.owned = 1;
+        mat = operand.temp;
+    }
+    operand.data = mat.data;
+    operand.rs = transposed ? 1 : mat.stride;
+    operand.cs = transposed ? mat.stride : 1;
+    return operand;
+}
+
+/**
+ * @brief Вычисляет слагаемое-произведение
+ * @param term Слагаемое
+ * @param dst Результат
+ * @param fill Начальные значения (первое произведение) или NULL (добавление к dst)
+ */
+static void evaluate_product(const ExprTerm *term, Matrix *dst, FillJob *fill) {
+    const MatrixExpr *node = term->node;
+    ExprOperand lhs = resolve_operand(node->lhs);
+    ExprOperand rhs = resolve_operand(node->rhs);
+    const ptrdiff_t rs_c = term->transposed ? 1 : dst->stride;
+    const ptrdiff_t cs_c = term->transposed ? dst->stride : 1;
+
+    if (fill != NULL) {
+        fill->transposed = term->transposed;
+        gemm_strided_init(node->rows, node->cols, node->lhs->cols, term->sign, lhs.data, lhs.rs,
+                          lhs.cs, rhs.data, rhs.rs, rhs.cs, product_init, fill, dst->data, rs_c,
+                          cs_c);
+    } else {
+        gemm_strided(node->rows, node->cols, node->lhs->cols, term->sign, lhs.data, lhs.rs,
+                     lhs.cs, rhs.data, rhs.rs, rhs.cs, 1.0, dst->data, rs_c, cs_c);
+    }
+
+    if (lhs.owned) {
+        free_matrix(lhs.temp);
+    }
+    if (rhs.owned) {
+        free_matrix(rhs.temp);
+    }
+}
+
+Matrix matrix_expr_evaluate(const MatrixExpr *expr) {
+    Matrix result = create_matrix(expr->rows, expr->cols);
+    matrix_expr_evaluate_into(&result, expr);
+    return result;
+}
+
+void matrix_expr_evaluate_into(Matrix *dst, const MatrixExpr *expr) {
+    if (dst == NULL || dst->rows != expr->rows || dst->cols != expr->cols) {
+        fprintf(stderr, "Размеры матрицы-результата не подходят для выражения!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (dst->flags & MATRIX_READONLY) {
+        fprintf(stderr, "Матрица-результат выражения доступна только для чтения!\n");
+        exit(EXIT_FAILURE);
+    }
+    /* Результат полностью перезаписывается, поэтому старые элементы не копируются */
+    matrix_prepare_overwrite(dst);
+    if (expr_reads(expr, *dst)) {
+        Matrix temp = matrix_expr_evaluate(expr);
+        copy_matrix_into(dst, temp);
+        free_matrix(temp);
+        return;
+    }
+
+    TermList terms = {.items = NULL, .count = 0, .capacity = 0};
+    collect_terms(expr, 1.0, 0, &terms);
+
+    /* Листовые слагаемые переносятся в начало списка, произведения - в конец */
+    int leaves = 0;
+    for (int iter = 0; iter < terms.count; iter++) {
+        if (terms.items[iter].node->kind == EXPR_LEAF) {
+            ExprTerm term = terms.items[iter];
+            for (int iter_2 = iter; iter_2 > leaves; iter_2--) {
+                terms.items[iter_2] = terms.items[iter_2 - 1];
+            }
+            terms.items[leaves++] = term;
+        }
+    }
+
+    FillJob fill = {.terms = terms.items, .count = leaves, .transposed = 0, .dst = *dst};
+    if (leaves == terms.count) {
+        int blocks = (dst->rows + EXPR_TILE - 1) / EXPR_TILE;
+        long long block_elements = (long long)EXPR_TILE * (dst->cols > 0 ? dst->cols : 1);
+        int grain = (int)((PARALLEL_MIN_ELEMENTS + block_elements - 1) / block_elements);
+        parallel_for(blocks, grain, fill_task, &fill);
+    } else {
+        evaluate_product(&terms.items[leaves], dst, &fill);
+        for (int iter = leaves + 1; iter < terms.count; iter++) {
+            evaluate_product(&terms.items[iter], dst, NULL);
+        }
+    }
+    free(terms.items);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file matrix_expr.h
+ * @brief Ленивые матричные выражения с вычислением за один проход
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Выражение строится из узлов сложения, вычитания, умножения и транспонирования
+ * над существующими матрицами и вычисляется одним вызовом matrix_expr_evaluate_into.
+ * При вычислении выражение приводится к сумме слагаемых вида ±M или ±M^T и
+ * не более чем одного произведения; сложение, вычитание и транспонирование
+ * выполняются в эпилоге GEMM (gemm_strided_init), поэтому, например,
+ * A - (B + C·D)^T вычисляется без промежуточных матриц, а каждый элемент
+ * результата записывается один раз.
+ *
+ * Пример:
+ * @code
+ * MatrixExpr *expr = matrix_expr_subtract(
+ *     matrix_expr_leaf(A),
+ *     matrix_expr_transpose(matrix_expr_plus(
+ *         matrix_expr_leaf(B), matrix_expr_multiply(matrix_expr_leaf(C), matrix_expr_leaf(D)))));
+ * matrix_expr_evaluate_into(&result, expr);
+ * matrix_expr_free(expr);
+ * @endcode
+ */
+
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include "../include/config.h"
+
+/**
+ * @brief Узел выражения (непрозрачный тип)
+ */
+typedef struct MatrixExpr MatrixExpr;
+
+/**
+ * @brief Создает лист выражения, ссылающийся на матрицу
+ * @param mat Матрица (не копируется и должна оставаться доступной до вычисления)
+ * @return Новый узел
+ */
+MatrixExpr *matrix_expr_leaf(Matrix mat);
+
+/**
+ * @brief Создает узел суммы lhs + rhs
+ * @param lhs Левый операнд (узел переходит во владение нового узла)
+ * @param rhs Правый операнд (узел переходит во владение нового узла)
+ * @return Новый узел
+ * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
+ */
+MatrixExpr *matrix_expr_plus(MatrixExpr *lhs, MatrixExpr *rhs);
+
+/**
+ * @brief Создает узел разности lhs - rhs
+ * @param lhs Уменьшаемое (узел переходит во владение нового узла)
+ * @param rhs Вычитаемое (узел переходит во владение нового узла)
+ * @return Новый узел
+ * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
+ */
+MatrixExpr *matrix_expr_subtract(MatrixExpr *lhs, MatrixExpr *rhs);
+
+/**
+ * @brief Создает узел произведения lhs · rhs
+ * @param lhs Левый множитель (узел переходит во владение нового узла)
+ * @param rhs Правый множитель (узел переходит во владение нового узла)
+ * @return Новый узел
+ * @warning При несовместимых размерах завершает программу с EXIT_FAILURE
+ */
+MatrixExpr *matrix_expr_multiply(MatrixExpr *lhs, MatrixExpr *rhs);
+
+/**
+ * @brief Создает узел транспонирования operand^T
+ * @param operand Операнд (узел переходит во владение нового узла)
+ * @return Новый узел
+ */
+MatrixExpr *matrix_expr_transpose(MatrixExpr *operand);
+
+/**
+ * @brief Возвращает число строк результата выражения
+ */
+int matrix_expr_rows(const MatrixExpr *expr);
+
+/**
+ * @brief Возвращает число столбцов результата выражения
+ */
+int matrix_expr_cols(const MatrixExpr *expr);
+
+/**
+ * @brief Вычисляет выражение в новую матрицу
+ * @param expr Выражение
+ * @return Результат (освобождается через free_matrix)
+ */
+Matrix matrix_expr_evaluate(const MatrixExpr *expr);
+
+/**
+ * @brief Вычисляет выражение в существующую матрицу
+ * @param dst Матрица-результат размера matrix_expr_rows×matrix_expr_cols
+ * @param expr Выражение
+ *
+ * @note Множители произведения, которые сами являются составными выражениями
+ * (кроме транспонирования матрицы), вычисляются во временные матрицы.
+ * Второе и последующие произведения в одной сумме добавляются к результату
+ * отдельными проходами GEMM.
+ * @note dst может совпадать с матрицами выражения: тогда результат вычисляется
+ * во временную матрицу и копируется
+ */
+void matrix_expr_evaluate_into(Matrix *dst, const MatrixExpr *expr);
+
+/**
+ * @brief Освобождает дерево выражения (матрицы листьев не освобождаются)
+ * @param expr Корень выражения (может быть NULL)
+ */
+void matrix_expr_free(MatrixExpr *expr);
+
+#endif
+
+/** @} */
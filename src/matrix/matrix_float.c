@@ -0,0 +1,202 @@
+/**
+ * @file matrix_float.c
+ * @brief Реализация операций над матрицами одинарной точности
+ * @ingroup Matrix_Operations
+ */
+
+#include "matrix_float.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gemm.h"
+#include "matrix_binary.h"
+#include "matrix_operations.h"
+#include "matrix_stats.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+#include "transpose.h"
+
+#define MATRIX_T float
+#define MATRIX_TYPE MatrixF
+#define MATRIX_FN(name) name##_f
+#define MATRIX_COPY_ON_WRITE() 0
+#define MATRIX_STAT_CREATE_ID MATRIX_STAT_CREATE_F
+#include "matrix_template.h"
+
+/**
+ * @brief Параметры преобразования типа между матрицами float и double
+ */
+typedef struct {
+    MatrixF narrow; /**< Матрица float */
+    Matrix wide;    /**< Матрица double того же размера */
+    int to_float;   /**< 1 - narrow = (float)wide, иначе wide = narrow */
+} ConvertJob;
+
+/**
+ * @brief Задача пула: преобразует строки [begin, end)
+ */
+static void convert_task(void *ctx, int begin, int end) {
+    const ConvertJob *job = (const ConvertJob *)ctx;
+    const int cols = job->narrow.cols;
+    for (int iter = begin; iter < end; iter++) {
+        float *narrow = MATRIX_ROW(job->narrow, iter);
+        double *wide = MATRIX_ROW(job->wide, iter);
+        if (job->to_float) {
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                narrow[iter_2] = (float)wide[iter_2];
+            }
+        } else {
+            for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+                wide[iter_2] = narrow[iter_2];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Преобразует все строки с той же минимальной частью, что и построчные операции
+ */
+static void run_convert(ConvertJob *job) {
+    parallel_for(job->narrow.rows, rows_grain_f(job->narrow.cols), convert_task, job);
+}
+
+/**
+ * @brief Проверяет совпадение размеров операндов поэлементной операции
+ */
+static void require_same_size(MatrixF mat1, MatrixF mat2, const char *operation) {
+    if (mat1.rows != mat2.rows || mat1.cols != mat2.cols) {
+        fprintf(stderr, "Размеры матриц не совпадают для %s!\n", operation);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void free_matrix_f(MatrixF mat) {
+    if (mat.flags & MATRIX_BORROWED) {
+        return;
+    }
+    const uint64_t stats = matrix_stats_begin();
+    if (mat.flags & MATRIX_MAPPED) {
+        matrix_binary_unmap_f(mat);
+    } else {
+        free(mat.data);
+    }
+    matrix_stats_end(MATRIX_STAT_FREE_F, stats, (double)mat.rows * mat.cols, 0, 0);
+}
+
+MatrixF matrix_to_float(Matrix mat) {
+    const uint64_t stats = matrix_stats_begin();
+    MatrixF result = create_matrix_f(mat.rows, mat.cols);
+    ConvertJob job = {.narrow = result, .wide = mat, .to_float = 1};
+    run_convert(&job);
+    matrix_stats_end(MATRIX_STAT_TO_FLOAT, stats, (double)mat.rows * mat.cols, 0,
+                     (double)result.rows * result.stride * sizeof(float));
+    return result;
+}
+
+Matrix matrix_to_double(MatrixF mat) {
+    const uint64_t stats = matrix_stats_begin();
+    Matrix result = create_matrix(mat.rows, mat.cols);
+    ConvertJob job = {.narrow = mat, .wide = result, .to_float = 0};
+    run_convert(&job);
+    matrix_stats_end(MATRIX_STAT_TO_DOUBLE, stats, (double)mat.rows * mat.cols, 0,
+                     (double)result.rows * result.stride * sizeof(double));
+    return result;
+}
+
+MatrixF load_matrix_from_file_f(const char *filename) {
+    const uint64_t stats = matrix_stats_begin();
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        perror("Невозможно открыть файл!");
+        exit(EXIT_FAILURE);
+    }
+    int binary = matrix_file_is_binary(file);
+    fclose(file);
+    MatrixF mat;
+    if (binary) {
+        mat = load_matrix_from_binary_file_f(filename);
+    } else {
+        Matrix wide = load_matrix_from_file(filename);
+        mat = matrix_to_float(wide);
+        free_matrix(wide);
+    }
+    /* Отображенный файл не считается выделенной памятью */
+    double allocated = mat.flags & MATRIX_MAPPED
+                           ? 0.0
+                           : (double)mat.rows * mat.stride * sizeof(float);
+    matrix_stats_end(MATRIX_STAT_LOAD_F, stats, (double)mat.rows * mat.cols, 0, allocated);
+    return mat;
+}
+
+MatrixF copy_matrix_f(MatrixF mat) {
+    const uint64_t stats = matrix_stats_begin();
+    MatrixF copy = create_matrix_f(mat.rows, mat.cols);
+    RowJob_f job = {.src1 = mat, .dst = copy, .unary = simd_kernels_f()->copy};
+    run_rows_f(&job);
+    matrix_stats_end(MATRIX_STAT_COPY_F, stats, (double)mat.rows * mat.cols, 0,
+                     (double)copy.rows * copy.stride * sizeof(float));
+    return copy;
+}
+
+MatrixF plus_matrices_f(MatrixF mat1, MatrixF mat2) {
+    require_same_size(mat1, mat2, "сложения");
+    const uint64_t stats = matrix_stats_begin();
+    MatrixF result = create_matrix_f(mat1.rows, mat1.cols);
+    RowJob_f job = {.src1 = mat1, .src2 = mat2, .dst = result, .binary = simd_kernels_f()->add};
+    run_rows_f(&job);
+    matrix_stats_end(MATRIX_STAT_PLUS_F, stats, (double)result.rows * result.cols,
+                     (double)result.rows * result.cols,
+                     (double)result.rows * result.stride * sizeof(float));
+    return result;
+}
+
+MatrixF subtract_matrices_f(MatrixF mat1, MatrixF mat2) {
+    require_same_size(mat1, mat2, "вычитания");
+    const uint64_t stats = matrix_stats_begin();
+    MatrixF result = create_matrix_f(mat1.rows, mat1.cols);
+    RowJob_f job = {.src1 = mat1, .src2 = mat2, .dst = result, .binary = simd_kernels_f()->sub};
+    run_rows_f(&job);
+    matrix_stats_end(MATRIX_STAT_SUBTRACT_F, stats, (double)result.rows * result.cols,
+                     (double)result.rows * result.cols,
+                     (double)result.rows * result.stride * sizeof(float));
+    return result;
+}
+
+MatrixF multiply_matrices_f(MatrixF mat1, MatrixF mat2) {
+    if (mat1.cols != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint64_t stats = matrix_stats_begin();
+    MatrixF result = create_matrix_f(mat1.rows, mat2.cols);
+    gemm_strided_f(mat1.rows, mat2.cols, mat1.cols, 1.0f, mat1.data, mat1.stride, 1, mat2.data,
+                   mat2.stride, 1, 0.0f, result.data, result.stride, 1);
+    matrix_stats_end(MATRIX_STAT_MULTIPLY_F, stats, (double)result.rows * result.cols,
+                     2.0 * result.rows * result.cols * mat1.cols,
+                     (double)result.rows * result.stride * sizeof(float));
+    return result;
+}
+
+MatrixF transpose_matrix_f(MatrixF mat) {
+    const uint64_t stats = matrix_stats_begin();
+    MatrixF result = create_matrix_f(mat.cols, mat.rows);
+    transpose_strided_f(mat.rows, mat.cols, mat.data, mat.stride, result.data, result.stride);
+    matrix_stats_end(MATRIX_STAT_TRANSPOSE_F, stats, (double)mat.rows * mat.cols, 0,
+                     (double)result.rows * result.stride * sizeof(float));
+    return result;
+}
+
+double determinant_f(MatrixF mat) {
+    if (mat.rows != mat.cols) {
+        fprintf(stderr, "Для вычисления определителя матрица должна быть квадратной!\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint64_t stats = matrix_stats_begin();
+    Matrix wide = matrix_to_double(mat);
+    double det = determinant(wide);
+    free_matrix(wide);
+    matrix_stats_end(MATRIX_STAT_DETERMINANT_F, stats, (double)mat.rows * mat.cols, 0,
+                     (double)wide.rows * wide.stride * sizeof(double));
+    return det;
+}
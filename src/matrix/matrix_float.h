@@ -0,0 +1,120 @@
+/**
+ * @file matrix_float.h
+ * @brief Операции над матрицами одинарной точности (float)
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Матрица float (MatrixF, config.h) занимает вдвое меньше памяти, чем Matrix, а в
+ * векторный регистр помещается вдвое больше ее элементов. Размещение матриц,
+ * построчные операции, векторные ядра, умножение и транспонирование порождаются
+ * из тех же шаблонов, что и для double (matrix_template.h, simd_template.h,
+ * gemm_template.h, transpose_template.h), поэтому алгоритмы для двух типов
+ * совпадают. Ошибки обрабатываются так же, как в matrix_operations.h, а вызовы
+ * учитываются счетчиками matrix_stats.h.
+ */
+
+#ifndef MATRIX_FLOAT_H
+#define MATRIX_FLOAT_H
+
+#include "../include/config.h"
+
+/**
+ * @brief Вычисляет ведущую размерность матрицы float для заданного числа столбцов
+ * @param cols Количество столбцов
+ * @return Число элементов между началами соседних строк
+ */
+int matrix_stride_for_f(int cols);
+
+/**
+ * @brief Создает матрицу float, заполненную нулями
+ * @param rows Количество строк
+ * @param cols Количество столбцов
+ * @return Созданная матрица
+ * @warning При недопустимых размерах или нехватке памяти завершает программу с EXIT_FAILURE
+ */
+MatrixF create_matrix_f(int rows, int cols);
+
+/**
+ * @brief Освобождает память, занятую матрицей float
+ * @param mat Матрица для освобождения (учитываются флаги MATRIX_BORROWED и MATRIX_MAPPED)
+ */
+void free_matrix_f(MatrixF mat);
+
+/**
+ * @brief Преобразует матрицу double в матрицу float с округлением к ближайшему
+ * @param mat Исходная матрица
+ * @return Новая матрица float
+ */
+MatrixF matrix_to_float(Matrix mat);
+
+/**
+ * @brief Преобразует матрицу float в матрицу double (без потери точности)
+ * @param mat Исходная матрица
+ * @return Новая матрица double
+ */
+Matrix matrix_to_double(MatrixF mat);
+
+/**
+ * @brief Загружает матрицу float из файла
+ * @param filename Имя файла
+ * @return Загруженная матрица
+ * @note Текстовый файл разбирается как для load_matrix_from_file и округляется до float;
+ *       двоичный файл с элементами float отображается в память без копирования
+ * @warning При ошибке открытия или чтения файла завершает программу с EXIT_FAILURE
+ */
+MatrixF load_matrix_from_file_f(const char *filename);
+
+/**
+ * @brief Создает копию матрицы float
+ * @param mat Исходная матрица
+ * @return Копия матрицы
+ */
+MatrixF copy_matrix_f(MatrixF mat);
+
+/**
+ * @brief Складывает две матрицы float
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица того же размера
+ * @return Результат сложения
+ * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
+ */
+MatrixF plus_matrices_f(MatrixF mat1, MatrixF mat2);
+
+/**
+ * @brief Вычитает вторую матрицу float из первой
+ * @param mat1 Уменьшаемое
+ * @param mat2 Вычитаемое того же размера
+ * @return Результат вычитания
+ * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
+ */
+MatrixF subtract_matrices_f(MatrixF mat1, MatrixF mat2);
+
+/**
+ * @brief Умножает две матрицы float
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица (число строк равно числу столбцов mat1)
+ * @return Результат умножения (блочный алгоритм gemm_strided_f)
+ * @warning При несогласованных размерах завершает программу с EXIT_FAILURE
+ */
+MatrixF multiply_matrices_f(MatrixF mat1, MatrixF mat2);
+
+/**
+ * @brief Транспонирует матрицу float
+ * @param mat Исходная матрица
+ * @return Транспонированная матрица
+ */
+MatrixF transpose_matrix_f(MatrixF mat);
+
+/**
+ * @brief Вычисляет определитель квадратной матрицы float
+ * @param mat Квадратная матрица
+ * @return Значение определителя
+ * @note Разложение выполняется в double: при накоплении произведения ведущих элементов
+ *       в float определитель переполняется уже для матриц порядка нескольких десятков
+ * @warning Для неквадратной матрицы завершает программу с EXIT_FAILURE
+ */
+double determinant_f(MatrixF mat);
+
+#endif
+
+/** @} */
@@ -6,33 +6,137 @@
  */
 
 #include "matrix_operations.h"
+#include "gemm.h"
+#include "lu.h"
+#include "matrix_binary.h"
+#include "matrix_stats.h"
+#include "matrix_text.h"
+#include "simd_kernels.h"
+#include "strassen.h"
+#include "thread_pool.h"
+#include "transpose.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MATRIX_T double
+#define MATRIX_TYPE Matrix
+#define MATRIX_FN(name) name
+#define MATRIX_COPY_ON_WRITE() matrix_copy_on_write_enabled()
+#define MATRIX_STAT_CREATE_ID MATRIX_STAT_CREATE
+#include "matrix_template.h"
+
+/**
+ * @brief Проверяет, что две матрицы описывают одни и те же элементы в памяти
+ */
+static int same_storage(Matrix mat1, Matrix mat2) {
+    return mat1.data == mat2.data && mat1.stride == mat2.stride && mat1.rows == mat2.rows &&
+           mat1.cols == mat2.cols;
+}
+
+/**
+ * @brief Режим копирования при записи: -1 - не задан, 0 - выключен, 1 - включен
+ */
+static int copy_on_write_state = -1;
+static pthread_once_t copy_on_write_once = PTHREAD_ONCE_INIT;
 
 /**
- * @brief Создает матрицу заданного размера
- * @param rows Количество строк
- * @param cols Количество столбцов
- * @return Созданная матрица
+ * @brief Читает MATRIX_COPY_ON_WRITE (однократно)
  */
-Matrix create_matrix(int rows, int cols) {
-    Matrix mat;
-    mat.rows = rows;
-    mat.cols = cols;
-    mat.data = (double **)calloc(rows, sizeof(double *));
-    for (int iter = 0; iter < rows; iter++) {
-        mat.data[iter] = (double *)calloc(cols, sizeof(double));
+static void read_copy_on_write_config(void) {
+    const char *env = getenv("MATRIX_COPY_ON_WRITE");
+    int enabled = env != NULL && strcmp(env, "1") == 0;
+    if (env != NULL && !enabled && strcmp(env, "0") != 0 && env[0] != '\0') {
+        fprintf(stderr, "Неверное значение MATRIX_COPY_ON_WRITE: %s\n", env);
     }
-    return mat;
+    /* Явный вызов matrix_set_copy_on_write имеет приоритет */
+    if (copy_on_write_state < 0) {
+        copy_on_write_state = enabled;
+    }
+}
+
+static SharedHeader *shared_header(Matrix mat) {
+    return (SharedHeader *)((char *)mat.data - MATRIX_ALIGNMENT);
+}
+
+/**
+ * @brief Освобождает буфер элементов (для MATRIX_SHARED - одну ссылку на него)
+ */
+static void release_elements(Matrix mat) {
+    if (!(mat.flags & MATRIX_SHARED)) {
+        free(mat.data);
+        return;
+    }
+    SharedHeader *header = shared_header(mat);
+    if (__atomic_sub_fetch(&header->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(header);
+    }
+}
+
+/**
+ * @brief Дает матрице собственный буфер, если ее буфер разделяют другие копии
+ * @param mat Матрица
+ * @param keep_elements 1 - скопировать элементы, 0 - буфер будет полностью перезаписан
+ *
+ * Если счетчик равен 1, других владельцев нет и появиться они могут только через
+ * copy_matrix этой же матрицы, поэтому буфер можно изменять на месте.
+ */
+static void detach_shared(Matrix *mat, int keep_elements) {
+    if (!(mat->flags & MATRIX_SHARED) ||
+        __atomic_load_n(&shared_header(*mat)->references, __ATOMIC_ACQUIRE) == 1) {
+        return;
+    }
+    Matrix own = *mat;
+    own.data = allocate_elements((size_t)mat->rows * (size_t)mat->stride, 1, mat->rows,
+                                 mat->cols);
+    if (keep_elements) {
+        RowJob job = {.src1 = *mat, .dst = own, .unary = simd_kernels()->copy};
+        run_rows(&job);
+    }
+    release_elements(*mat);
+    *mat = own;
+}
+
+/**
+ * @brief Проверяет размеры матрицы-результата, иначе завершает программу
+ * @param dst Матрица-результат (буфер, разделяемый с копиями, заменяется собственным)
+ * @param rows Ожидаемое число строк
+ * @param cols Ожидаемое число столбцов
+ * @param operation Название операции в родительном падеже (для сообщения)
+ *
+ * Результат полностью перезаписывается, поэтому собственный буфер не заполняется
+ * старыми элементами; операнды, разделявшие буфер с dst, продолжают читать общий.
+ */
+static void require_destination(Matrix *dst, int rows, int cols, const char *operation) {
+    if (dst == NULL || dst->rows != rows || dst->cols != cols) {
+        fprintf(stderr, "Размеры матрицы-результата не подходят для %s!\n", operation);
+        exit(EXIT_FAILURE);
+    }
+    if (dst->flags & MATRIX_READONLY) {
+        fprintf(stderr, "Матрица-результат %s доступна только для чтения!\n", operation);
+        exit(EXIT_FAILURE);
+    }
+    detach_shared(dst, 0);
 }
 
 /**
  * @brief Освобождает память, занятую матрицей
  * @param mat Матрица для освобождения
+ * @note Для матриц с флагом MATRIX_BORROWED ничего не делает, для MATRIX_MAPPED снимает
+ *       отображение файла, для MATRIX_SHARED освобождает одну ссылку на буфер
  */
 void free_matrix(Matrix mat) {
-    for (int iter = 0; iter < mat.rows; iter++) {
-        free(mat.data[iter]);
+    if (mat.flags & MATRIX_BORROWED) {
+        return;
     }
-    free(mat.data);
+    const uint64_t stats = matrix_stats_begin();
+    if (mat.flags & MATRIX_MAPPED) {
+        matrix_binary_unmap(mat);
+    } else {
+        release_elements(mat);
+    }
+    matrix_stats_end(MATRIX_STAT_FREE, stats, (double)mat.rows * mat.cols, 0, 0);
 }
 
 /**
@@ -40,36 +144,62 @@ void free_matrix(Matrix mat) {
  * @param filename Имя файла для загрузки
  * @return Загруженная матрица
  * @note Формат файла: первые два числа - размеры матрицы, затем элементы построчно
+ * @note Двоичные файлы (matrix_format.h) распознаются по сигнатуре и отображаются в память
  */
 Matrix load_matrix_from_file(const char *filename) {
+    const uint64_t stats = matrix_stats_begin();
     FILE *file = fopen(filename, "r");
     if (!file) {
         perror("Невозможно открыть файл!");
         exit(EXIT_FAILURE);
     }
+    int binary = matrix_file_is_binary(file);
+    fclose(file);
+    Matrix mat = binary ? load_matrix_from_binary_file(filename)
+                        : load_matrix_from_text_file(filename);
+    /* Отображенный файл не считается выделенной памятью */
+    double allocated = mat.flags & MATRIX_MAPPED
+                           ? 0.0
+                           : (double)mat.rows * mat.stride * sizeof(double);
+    matrix_stats_end(MATRIX_STAT_LOAD, stats, (double)mat.rows * mat.cols, 0, allocated);
+    return mat;
+}
 
-    int rows, cols;
-    if (fscanf(file, "%d %d", &rows, &cols) != 2) {
-        fprintf(stderr, "Ошибка чтения размеров матрицы!\n");
-        fclose(file);
-        exit(EXIT_FAILURE);
+int matrix_try_load_file(const char *filename, Matrix *mat, char *error, size_t error_size) {
+    const uint64_t stats = matrix_stats_begin();
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        snprintf(error, error_size, "Невозможно открыть файл %s: %s", filename, strerror(errno));
+        return -1;
     }
-
-    Matrix mat = create_matrix(rows, cols);
-
-    for (int iter = 0; iter < rows; iter++) {
-        for (int iter_2 = 0; iter_2 < cols; iter_2++) {
-            if (fscanf(file, "%lf", &mat.data[iter][iter_2]) != 1) {
-                fprintf(stderr, "Ошибка чтения матричных данных!\n");
-                fclose(file);
-                free_matrix(mat);
-                exit(EXIT_FAILURE);
-            }
+    int binary = matrix_file_is_binary(file);
+    fclose(file);
+    if (binary) {
+        const char *reason = NULL;
+        if (matrix_binary_try_load(filename, mat, &reason) != 0) {
+            snprintf(error, error_size, "Ошибка чтения двоичного файла матрицы %s: %s",
+                     filename, reason);
+            return -1;
+        }
+    } else {
+        TextFile text;
+        if (text_file_try_open(filename, &text) != 0) {
+            snprintf(error, error_size, "Невозможно прочитать файл %s: %s", filename,
+                     strerror(errno));
+            return -1;
+        }
+        int status = matrix_try_parse_text(text.text, text.length, filename, mat, error,
+                                           error_size);
+        text_file_close(&text);
+        if (status != 0) {
+            return -1;
         }
     }
-
-    fclose(file);
-    return mat;
+    double allocated = mat->flags & MATRIX_MAPPED
+                           ? 0.0
+                           : (double)mat->rows * mat->stride * sizeof(double);
+    matrix_stats_end(MATRIX_STAT_LOAD, stats, (double)mat->rows * mat->cols, 0, allocated);
+    return 0;
 }
 
 /**
@@ -78,13 +208,36 @@ Matrix load_matrix_from_file(const char *filename) {
  * @return Копия матрицы
  */
 Matrix copy_matrix(Matrix mat) {
+    const uint64_t stats = matrix_stats_begin();
+    if ((mat.flags & MATRIX_SHARED) && mat.data != NULL) {
+        __atomic_add_fetch(&shared_header(mat)->references, 1, __ATOMIC_RELAXED);
+        matrix_stats_end(MATRIX_STAT_COPY, stats, (double)mat.rows * mat.cols, 0, 0);
+        return mat;
+    }
     Matrix copy = create_matrix(mat.rows, mat.cols);
-    for (int iter = 0; iter < mat.rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
-            copy.data[iter][iter_2] = mat.data[iter][iter_2];
+    copy_matrix_into(&copy, mat);
+    matrix_stats_end(MATRIX_STAT_COPY, stats, (double)mat.rows * mat.cols, 0,
+                     (double)copy.rows * copy.stride * sizeof(double));
+    return copy;
+}
+
+/**
+ * @brief Копирует элементы матрицы в существующую матрицу
+ * @param dst Матрица-результат того же размера
+ * @param mat Исходная матрица
+ */
+void copy_matrix_into(Matrix *dst, Matrix mat) {
+    const uint64_t stats = matrix_stats_begin();
+    require_destination(dst, mat.rows, mat.cols, "копирования");
+    if (!same_storage(*dst, mat)) {
+        if (matrices_overlap(*dst, mat)) {
+            fprintf(stderr, "Матрица-результат частично перекрывает исходную при копировании!\n");
+            exit(EXIT_FAILURE);
         }
+        RowJob job = {.src1 = mat, .dst = *dst, .unary = simd_kernels()->copy};
+        run_rows(&job);
     }
-    return copy;
+    matrix_stats_end(MATRIX_STAT_COPY_INTO, stats, (double)mat.rows * mat.cols, 0, 0);
 }
 
 /**
@@ -100,21 +253,55 @@ Matrix plus_matrices(Matrix mat1, Matrix mat2) {
         exit(EXIT_FAILURE);
     }
 
+    const uint64_t stats = matrix_stats_begin();
     Matrix result = create_matrix(mat1.rows, mat1.cols);
-    for (int iter = 0; iter < mat1.rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat1.cols; iter_2++) {
-            result.data[iter][iter_2] = mat1.data[iter][iter_2] + mat2.data[iter][iter_2];
-        }
-    }
+    plus_matrices_into(&result, mat1, mat2);
+    matrix_stats_end(MATRIX_STAT_PLUS, stats, (double)result.rows * result.cols,
+                     (double)result.rows * result.cols,
+                     (double)result.rows * result.stride * sizeof(double));
     return result;
 }
 
+/**
+ * @brief Проверяет, что результат поэлементной операции совпадает с операндом или не
+ *        пересекается с ним
+ */
+static void require_elementwise_alias(Matrix dst, Matrix src, const char *operation) {
+    if (!same_storage(dst, src) && matrices_overlap(dst, src)) {
+        fprintf(stderr, "Матрица-результат частично перекрывает операнд %s!\n", operation);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Складывает две матрицы, записывая результат в существующую матрицу
+ * @param dst Матрица-результат того же размера (может совпадать с mat1 или mat2)
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ */
+void plus_matrices_into(Matrix *dst, Matrix mat1, Matrix mat2) {
+    if (mat1.rows != mat2.rows || mat1.cols != mat2.cols) {
+        fprintf(stderr, "Размеры матриц не совпадают для сложения!\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint64_t stats = matrix_stats_begin();
+    require_destination(dst, mat1.rows, mat1.cols, "сложения");
+    require_elementwise_alias(*dst, mat1, "сложения");
+    require_elementwise_alias(*dst, mat2, "сложения");
+
+    RowJob job = {.src1 = mat1, .src2 = mat2, .dst = *dst, .binary = simd_kernels()->add};
+    run_rows(&job);
+    const double elements = (double)mat1.rows * mat1.cols;
+    matrix_stats_end(MATRIX_STAT_PLUS_INTO, stats, elements, elements, 0);
+}
+
 /**
  * @brief Умножает две матрицы
  * @param mat1 Первая матрица
  * @param mat2 Вторая матрица
  * @return Результат умножения
  * @note Количество столбцов первой матрицы должно совпадать с количеством строк второй
+ * @note Для больших размеров используется блочный алгоритм с упаковкой (см. gemm.h)
  */
 Matrix multiply_matrices(Matrix mat1, Matrix mat2) {
     if (mat1.cols != mat2.rows) {
@@ -122,72 +309,210 @@ Matrix multiply_matrices(Matrix mat1, Matrix mat2) {
         exit(EXIT_FAILURE);
     }
 
+    const uint64_t stats = matrix_stats_begin();
     Matrix result = create_matrix(mat1.rows, mat2.cols);
-    for (int iter = 0; iter < mat1.rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat2.cols; iter_2++) {
-            result.data[iter][iter_2] = 0;
-            for (int iter_3 = 0; iter_3 < mat1.cols; iter_3++) {
-                result.data[iter][iter_2] += mat1.data[iter][iter_3] * mat2.data[iter_3][iter_2];
-            }
-        }
+    multiply_matrices_into(&result, mat1, mat2);
+    matrix_stats_end(MATRIX_STAT_MULTIPLY, stats, (double)result.rows * result.cols,
+                     2.0 * result.rows * result.cols * mat1.cols,
+                     (double)result.rows * result.stride * sizeof(double));
+    return result;
+}
+
+/**
+ * @brief Умножает две матрицы, записывая результат в существующую матрицу
+ * @param dst Матрица-результат размера mat1.rows×mat2.cols (не должна пересекаться с операндами)
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ */
+void multiply_matrices_into(Matrix *dst, Matrix mat1, Matrix mat2) {
+    if (mat1.cols != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint64_t stats = matrix_stats_begin();
+    require_destination(dst, mat1.rows, mat2.cols, "умножения");
+    if (matrices_overlap(*dst, mat1) || matrices_overlap(*dst, mat2)) {
+        fprintf(stderr, "Матрица-результат умножения не может совпадать с операндом!\n");
+        exit(EXIT_FAILURE);
     }
+
+    gemm_strided(mat1.rows, mat2.cols, mat1.cols, 1.0, mat1.data, mat1.stride, 1, mat2.data,
+                 mat2.stride, 1, 0.0, dst->data, dst->stride, 1);
+    matrix_stats_end(MATRIX_STAT_MULTIPLY_INTO, stats, (double)mat1.rows * mat2.cols,
+                     2.0 * mat1.rows * mat2.cols * mat1.cols, 0);
+}
+
+/**
+ * @brief Умножает две матрицы по схеме Штрассена-Винограда
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ * @return Результат умножения
+ */
+Matrix multiply_matrices_strassen(Matrix mat1, Matrix mat2) {
+    if (mat1.cols != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const uint64_t stats = matrix_stats_begin();
+    Matrix result = create_matrix(mat1.rows, mat2.cols);
+    multiply_matrices_strassen_into(&result, mat1, mat2);
+    matrix_stats_end(MATRIX_STAT_MULTIPLY_STRASSEN, stats, (double)result.rows * result.cols,
+                     2.0 * result.rows * result.cols * mat1.cols,
+                     (double)result.rows * result.stride * sizeof(double));
     return result;
 }
 
+/**
+ * @brief Умножает две матрицы по схеме Штрассена-Винограда в существующую матрицу
+ * @param dst Матрица-результат размера mat1.rows×mat2.cols (не должна пересекаться с операндами)
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ * @note В счетчиках учитывается число операций обычного умножения (2mnk)
+ */
+void multiply_matrices_strassen_into(Matrix *dst, Matrix mat1, Matrix mat2) {
+    if (mat1.cols != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint64_t stats = matrix_stats_begin();
+    require_destination(dst, mat1.rows, mat2.cols, "умножения");
+    if (matrices_overlap(*dst, mat1) || matrices_overlap(*dst, mat2)) {
+        fprintf(stderr, "Матрица-результат умножения не может совпадать с операндом!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const size_t workspace =
+        strassen_workspace_size(mat1.rows, mat2.cols, mat1.cols, STRASSEN_CROSSOVER);
+    strassen_multiply(mat1.rows, mat2.cols, mat1.cols, mat1.data, mat1.stride, mat2.data,
+                      mat2.stride, dst->data, dst->stride, STRASSEN_CROSSOVER, NULL);
+    matrix_stats_end(MATRIX_STAT_MULTIPLY_STRASSEN_INTO, stats, (double)mat1.rows * mat2.cols,
+                     2.0 * mat1.rows * mat2.cols * mat1.cols, (double)workspace * sizeof(double));
+}
+
 /**
  * @brief Транспонирует матрицу
  * @param mat Исходная матрица
  * @return Транспонированная матрица
  */
 Matrix transpose_matrix(Matrix mat) {
+    const uint64_t stats = matrix_stats_begin();
     Matrix result = create_matrix(mat.cols, mat.rows);
-    for (int iter = 0; iter < mat.rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
-            result.data[iter_2][iter] = mat.data[iter][iter_2];
+    transpose_matrix_into(&result, mat);
+    matrix_stats_end(MATRIX_STAT_TRANSPOSE, stats, (double)mat.rows * mat.cols, 0,
+                     (double)result.rows * result.stride * sizeof(double));
+    return result;
+}
+
+/**
+ * @brief Транспонирует матрицу, записывая результат в существующую матрицу
+ * @param dst Матрица-результат размера mat.cols×mat.rows
+ * @param mat Исходная матрица
+ * @note Для квадратной матрицы dst может совпадать с mat (транспонирование на месте)
+ */
+void transpose_matrix_into(Matrix *dst, Matrix mat) {
+    const uint64_t stats = matrix_stats_begin();
+    require_destination(dst, mat.cols, mat.rows, "транспонирования");
+    if (same_storage(*dst, mat)) {
+        transpose_square_inplace(mat.rows, mat.data, mat.stride);
+    } else {
+        if (matrices_overlap(*dst, mat)) {
+            fprintf(stderr,
+                    "Матрица-результат частично перекрывает исходную при транспонировании!\n");
+            exit(EXIT_FAILURE);
         }
+        transpose_strided(mat.rows, mat.cols, mat.data, mat.stride, dst->data, dst->stride);
     }
-    return result;
+    matrix_stats_end(MATRIX_STAT_TRANSPOSE_INTO, stats, (double)mat.rows * mat.cols, 0, 0);
 }
 
 /**
- * @brief Вычисляет определитель матрицы
- * @param mat Квадратная матрица
- * @return Значение определителя
- * @note Используется рекурсивный метод разложения по первой строке
+ * @brief Проверяет, что матрица квадратная, иначе завершает программу
  */
-double determinant(Matrix mat) {
+static void require_square(Matrix mat) {
     if (mat.rows != mat.cols) {
         fprintf(stderr, "Для вычисления определителя матрица должна быть квадратной!\n");
         exit(EXIT_FAILURE);
     }
+}
+
+/**
+ * @brief Число операций LU-разложения матрицы порядка n
+ */
+static double lu_flops(int n) {
+    return 2.0 / 3.0 * n * (double)n * n;
+}
+
+/**
+ * @brief Память, выделяемая lu_factor для квадратной матрицы mat
+ */
+static double lu_bytes(Matrix mat) {
+    return (double)mat.rows * matrix_stride_for(mat.cols) * sizeof(double) +
+           (double)mat.rows * sizeof(int);
+}
+
+/**
+ * @brief Вычисляет определитель квадратной матрицы (без учета в счетчиках)
+ */
+static double determinant_value(Matrix mat) {
+    if (mat.rows == 0) {
+        return 1.0;
+    }
 
     if (mat.rows == 1) {
-        return mat.data[0][0];
+        return MATRIX_AT(mat, 0, 0);
     }
 
     if (mat.rows == 2) {
-        return mat.data[0][0] * mat.data[1][1] - mat.data[0][1] * mat.data[1][0];
-    }
-
-    double det = 0;
-    for (int col = 0; col < mat.cols; col++) {
-        Matrix submat = create_matrix(mat.rows - 1, mat.cols - 1);
-        for (int iter = 1; iter < mat.rows; iter++) {
-            int subcol = 0;
-            for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
-                if (iter_2 == col)
-                    continue;
-                submat.data[iter - 1][subcol] = mat.data[iter][iter_2];
-                subcol++;
-            }
-        }
-        double subdet = determinant(submat);
-        det += (col % 2 == 0 ? 1 : -1) * mat.data[0][col] * subdet;
-        free_matrix(submat);
+        return MATRIX_AT(mat, 0, 0) * MATRIX_AT(mat, 1, 1) -
+               MATRIX_AT(mat, 0, 1) * MATRIX_AT(mat, 1, 0);
     }
+
+    LuFactorization lu = lu_factor(mat);
+    double det = lu_determinant(lu);
+    free_lu_factorization(lu);
+    return det;
+}
+
+/**
+ * @brief Вычисляет определитель матрицы
+ * @param mat Квадратная матрица
+ * @return Значение определителя
+ * @note Используется LU-разложение с частичным выбором ведущего элемента, O(n^3)
+ */
+double determinant(Matrix mat) {
+    require_square(mat);
+    const uint64_t stats = matrix_stats_begin();
+    double det = determinant_value(mat);
+    const int factored = mat.rows > 2;
+    matrix_stats_end(MATRIX_STAT_DETERMINANT, stats, (double)mat.rows * mat.cols,
+                     factored ? lu_flops(mat.rows) : 0.0, factored ? lu_bytes(mat) : 0.0);
     return det;
 }
 
+/**
+ * @brief Вычисляет логарифм модуля определителя и его знак
+ * @param mat Квадратная матрица
+ * @param sign Указатель для записи знака определителя (может быть NULL)
+ * @return ln|det(mat)| или -INFINITY для вырожденной матрицы
+ */
+double log_abs_determinant(Matrix mat, int *sign) {
+    require_square(mat);
+    const uint64_t stats = matrix_stats_begin();
+
+    double log_det = 0;
+    if (mat.rows > 0) {
+        LuFactorization lu = lu_factor(mat);
+        log_det = lu_log_abs_determinant(lu, sign);
+        free_lu_factorization(lu);
+    } else if (sign != NULL) {
+        *sign = 1;
+    }
+    matrix_stats_end(MATRIX_STAT_LOG_DETERMINANT, stats, (double)mat.rows * mat.cols,
+                     lu_flops(mat.rows), mat.rows > 0 ? lu_bytes(mat) : 0.0);
+    return log_det;
+}
+
 /**
  * @brief Вычитает две матрицы
  * @param mat1 Первая матрица
@@ -201,11 +526,172 @@ Matrix subtract_matrices(Matrix mat1, Matrix mat2) {
         exit(EXIT_FAILURE);
     }
 
+    const uint64_t stats = matrix_stats_begin();
     Matrix result = create_matrix(mat1.rows, mat1.cols);
-    for (int iter = 0; iter < mat1.rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat1.cols; iter_2++) {
-            result.data[iter][iter_2] = mat1.data[iter][iter_2] - mat2.data[iter][iter_2];
-        }
-    }
+    subtract_matrices_into(&result, mat1, mat2);
+    matrix_stats_end(MATRIX_STAT_SUBTRACT, stats, (double)result.rows * result.cols,
+                     (double)result.rows * result.cols,
+                     (double)result.rows * result.stride * sizeof(double));
     return result;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Вычитает две матрицы, записывая результат в существующую матрицу
+ * @param dst Матрица-результат того же размера (может совпадать с mat1 или mat2)
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ */
+void subtract_matrices_into(Matrix *dst, Matrix mat1, Matrix mat2) {
+    if (mat1.rows != mat2.rows || mat1.cols != mat2.cols) {
+        fprintf(stderr, "Размеры матриц не совпадают для вычитания!\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint64_t stats = matrix_stats_begin();
+    require_destination(dst, mat1.rows, mat1.cols, "вычитания");
+    require_elementwise_alias(*dst, mat1, "вычитания");
+    require_elementwise_alias(*dst, mat2, "вычитания");
+
+    RowJob job = {.src1 = mat1, .src2 = mat2, .dst = *dst, .binary = simd_kernels()->sub};
+    run_rows(&job);
+    const double elements = (double)mat1.rows * mat1.cols;
+    matrix_stats_end(MATRIX_STAT_SUBTRACT_INTO, stats, elements, elements, 0);
+}
+
+/**
+ * @brief Создает представление блока матрицы без копирования
+ * @param mat Исходная матрица
+ * @param row Первая строка блока
+ * @param col Первый столбец блока
+ * @param rows Число строк блока
+ * @param cols Число столбцов блока
+ * @return Представление блока
+ */
+Matrix matrix_view(Matrix mat, int row, int col, int rows, int cols) {
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 || row > mat.rows - rows ||
+        col > mat.cols - cols) {
+        fprintf(stderr, "Блок %dx%d с началом (%d, %d) выходит за границы матрицы %dx%d!\n", rows,
+                cols, row, col, mat.rows, mat.cols);
+        exit(EXIT_FAILURE);
+    }
+    Matrix view = {.rows = rows,
+                   .cols = cols,
+                   .stride = mat.stride,
+                   .data = mat.data,
+                   .flags = MATRIX_VIEW | MATRIX_BORROWED | (mat.flags & MATRIX_READONLY)};
+    // Копия исходной матрицы может появиться и после создания представления, а запись
+    // через представление обошла бы отделение буфера, поэтому разделяемый буфер
+    // доступен через представления только для чтения
+    if (mat.flags & MATRIX_SHARED) {
+        view.flags |= MATRIX_READONLY;
+    }
+    if (view.data != NULL && rows > 0 && cols > 0) {
+        view.data = MATRIX_ROW(mat, row) + col;
+    }
+    return view;
+}
+
+/**
+ * @brief Создает представление строки матрицы
+ * @param mat Исходная матрица
+ * @param row Номер строки
+ * @return Представление 1×cols
+ */
+Matrix matrix_row_view(Matrix mat, int row) {
+    return matrix_view(mat, row, 0, 1, mat.cols);
+}
+
+/**
+ * @brief Создает представление столбца матрицы
+ * @param mat Исходная матрица
+ * @param col Номер столбца
+ * @return Представление rows×1
+ */
+Matrix matrix_col_view(Matrix mat, int col) {
+    return matrix_view(mat, 0, col, mat.rows, 1);
+}
+
+/**
+ * @brief Проверяет, есть ли у двух матриц общие элементы в памяти
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ * @return 1 при пересечении
+ *
+ * Если диапазоны адресов пересекаются, а ведущие размерности совпадают, вторая
+ * матрица рассматривается как блок в решетке строк первой: ее строки занимают
+ * столбцы [col, col + cols) решетки, причем часть, выходящая за stride, переносится
+ * на следующую строку решетки. Иначе пересечение диапазонов считается пересечением.
+ */
+int matrices_overlap(Matrix mat1, Matrix mat2) {
+    if (mat1.data == NULL || mat2.data == NULL || mat1.rows == 0 || mat2.rows == 0 ||
+        mat1.cols == 0 || mat2.cols == 0) {
+        return 0;
+    }
+    uintptr_t begin1 = (uintptr_t)mat1.data;
+    uintptr_t end1 = (uintptr_t)(MATRIX_ROW(mat1, mat1.rows - 1) + mat1.cols);
+    uintptr_t begin2 = (uintptr_t)mat2.data;
+    uintptr_t end2 = (uintptr_t)(MATRIX_ROW(mat2, mat2.rows - 1) + mat2.cols);
+    if (begin1 >= end2 || begin2 >= end1) {
+        return 0;
+    }
+    if (begin2 < begin1) {
+        const Matrix swap = mat1;
+        mat1 = mat2;
+        mat2 = swap;
+        begin2 = begin1;
+        begin1 = (uintptr_t)mat1.data;
+    }
+    if (mat1.stride != mat2.stride || (begin2 - begin1) % sizeof(double) != 0) {
+        return 1;
+    }
+
+    const size_t stride = (size_t)mat1.stride;
+    const size_t offset = (begin2 - begin1) / sizeof(double);
+    const size_t row = offset / stride;
+    const size_t col = offset % stride;
+    if (row < (size_t)mat1.rows && col < (size_t)mat1.cols) {
+        return 1;
+    }
+    return col + (size_t)mat2.cols > stride && row + 1 < (size_t)mat1.rows;
+}
+
+/**
+ * @brief Включает или выключает режим копирования при записи
+ * @param enabled 1 - включить, 0 - выключить
+ */
+void matrix_set_copy_on_write(int enabled) {
+    copy_on_write_state = enabled ? 1 : 0;
+    pthread_once(&copy_on_write_once, read_copy_on_write_config);
+}
+
+/**
+ * @brief Проверяет, включен ли режим копирования при записи
+ * @return 1, если включен
+ */
+int matrix_copy_on_write_enabled(void) {
+    pthread_once(&copy_on_write_once, read_copy_on_write_config);
+    return copy_on_write_state > 0;
+}
+
+/**
+ * @brief Делает буфер матрицы изменяемым перед записью элементов
+ * @param mat Матрица
+ */
+void matrix_make_writable(Matrix *mat) {
+    detach_shared(mat, 1);
+}
+
+void matrix_prepare_overwrite(Matrix *mat) {
+    detach_shared(mat, 0);
+}
+
+/**
+ * @brief Возвращает число копий, разделяющих буфер матрицы
+ * @param mat Матрица
+ * @return Значение счетчика ссылок
+ */
+int matrix_reference_count(Matrix mat) {
+    if (!(mat.flags & MATRIX_SHARED) || mat.data == NULL) {
+        return 1;
+    }
+    return __atomic_load_n(&shared_header(mat)->references, __ATOMIC_ACQUIRE);
+}
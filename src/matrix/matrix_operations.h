@@ -11,6 +11,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "../include/config.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Вычисляет ведущую размерность (stride) для матрицы с заданным числом столбцов
+ * @param cols Количество столбцов
+ * @return Расстояние между началами соседних строк в элементах
+ * @note Широкие строки дополняются до границы MATRIX_ALIGNMENT байт
+ */
+int matrix_stride_for(int cols);
 
 /**
  * @brief Создает матрицу заданного размера
@@ -18,12 +27,16 @@
  * @param cols Количество столбцов
  * @return Новая матрица с выделенной памятью
  * @note Все элементы инициализируются нулями
+ * @note Данные размещаются одним выровненным блоком, строки идут подряд с шагом stride
+ * @warning При ошибке выделения памяти завершает программу с EXIT_FAILURE
  */
 Matrix create_matrix(int rows, int cols);
 
 /**
  * @brief Освобождает память, занятую матрицей
  * @param mat Матрица для освобождения
+ * @note Матрицы, не владеющие буфером (MATRIX_BORROWED, например из арены), не освобождаются
+ * @note Для матриц, отображенных из файла (MATRIX_MAPPED), снимается отображение
  */
 void free_matrix(Matrix mat);
 
@@ -32,63 +45,262 @@ void free_matrix(Matrix mat);
  * @param filename Путь к файлу с матрицей
  * @return Загруженная матрица
  * @note Формат файла: первые два числа - размеры, затем элементы построчно
+ * @note Файл в двоичном формате (matrix_format.h) распознается по сигнатуре и
+ *       загружается без копирования (см. load_matrix_from_binary_file)
  * @warning В случае ошибки чтения завершает программу с EXIT_FAILURE
  */
 Matrix load_matrix_from_file(const char *filename);
 
 /**
- * @brief Создает глубокую копию матрицы
+ * @brief Загружает матрицу из файла, возвращая ошибку вместо завершения программы
+ * @param filename Имя файла для загрузки
+ * @param mat Загруженная матрица (как у load_matrix_from_file; при ошибке не изменяется)
+ * @param error Буфер для сообщения об ошибке
+ * @param error_size Размер буфера
+ * @return 0 при успехе, -1 если файл не открывается, поврежден или содержит неверные данные
+ * @note Для долгоживущих процессов (matrix_server.h), которые не должны завершаться
+ *       из-за одного неверного файла
+ */
+int matrix_try_load_file(const char *filename, Matrix *mat, char *error, size_t error_size);
+
+/**
+ * @brief Создает копию матрицы
  * @param mat Исходная матрица
  * @return Независимая копия матрицы
+ * @note Большие матрицы копируются параллельно (см. matrix_set_num_threads)
+ * @note Для матрицы с флагом MATRIX_SHARED копия разделяет ее буфер и создается за O(1);
+ *       элементы копируются только при первой записи (matrix_make_writable)
  */
 Matrix copy_matrix(Matrix mat);
 
+/**
+ * @brief Копирует элементы матрицы в существующую матрицу без выделения памяти
+ * @param dst Матрица-результат того же размера
+ * @param mat Исходная матрица
+ * @note При dst, совпадающей с mat, ничего не делает
+ * @warning При несовпадении размеров или частичном перекрытии завершает программу с EXIT_FAILURE
+ */
+void copy_matrix_into(Matrix *dst, Matrix mat);
+
 /**
  * @brief Складывает две матрицы
  * @param mat1 Первая матрица
  * @param mat2 Вторая матрица
  * @return Результат сложения
  * @note Матрицы должны быть одинакового размера
+ * @note Результат побитово не зависит от числа потоков
  * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
  */
 Matrix plus_matrices(Matrix mat1, Matrix mat2);
 
+/**
+ * @brief Складывает две матрицы, записывая результат в существующую матрицу
+ * @param dst Матрица-результат того же размера
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ * @note Допускается сложение на месте: dst может совпадать с mat1 или mat2
+ * @warning При несовпадении размеров или частичном перекрытии завершает программу с EXIT_FAILURE
+ */
+void plus_matrices_into(Matrix *dst, Matrix mat1, Matrix mat2);
+
 /**
  * @brief Умножает две матрицы
  * @param mat1 Первая матрица (m×n)
  * @param mat2 Вторая матрица (n×k)
  * @return Результат умножения (m×k)
  * @note Число столбцов mat1 должно совпадать с числом строк mat2
+ * @note Большие произведения вычисляются параллельно в пуле потоков библиотеки
  * @warning При несовместимых размерах завершает программу с EXIT_FAILURE
  */
 Matrix multiply_matrices(Matrix mat1, Matrix mat2);
 
+/**
+ * @brief Умножает две матрицы, записывая результат в существующую матрицу
+ * @param dst Матрица-результат размера (m×k)
+ * @param mat1 Первая матрица (m×n)
+ * @param mat2 Вторая матрица (n×k)
+ * @note Рабочие буферы умножения переиспользуются, поэтому повторные вызовы не выделяют память
+ * @warning dst не может пересекаться с операндами; при нарушении этого условия или
+ * несовместимых размерах завершает программу с EXIT_FAILURE
+ */
+void multiply_matrices_into(Matrix *dst, Matrix mat1, Matrix mat2);
+
+/**
+ * @brief Умножает две матрицы по схеме Штрассена-Винограда
+ * @param mat1 Первая матрица (m×n)
+ * @param mat2 Вторая матрица (n×k)
+ * @return Результат умножения (m×k)
+ * @note Для больших матриц (все размеры не меньше 2·STRASSEN_CROSSOVER) быстрее
+ * multiply_matrices, для меньших совпадает с ним. Погрешность оценивается по норме
+ * и растет с числом уровней рекурсии (см. strassen.h)
+ * @warning При несовместимых размерах завершает программу с EXIT_FAILURE
+ */
+Matrix multiply_matrices_strassen(Matrix mat1, Matrix mat2);
+
+/**
+ * @brief Умножает две матрицы по схеме Штрассена-Винограда в существующую матрицу
+ * @param dst Матрица-результат размера (m×k)
+ * @param mat1 Первая матрица (m×n)
+ * @param mat2 Вторая матрица (n×k)
+ * @note Временные блоки всех уровней рекурсии размещаются в одном буфере,
+ *       выделяемом на время вызова
+ * @warning dst не может пересекаться с операндами; при нарушении этого условия или
+ * несовместимых размерах завершает программу с EXIT_FAILURE
+ */
+void multiply_matrices_strassen_into(Matrix *dst, Matrix mat1, Matrix mat2);
+
 /**
  * @brief Транспонирует матрицу
  * @param mat Исходная матрица (m×n)
  * @return Транспонированная матрица (n×m)
+ * @note Выполняется блоками с транспонированием подблоков в регистрах (см. transpose.h)
  */
 Matrix transpose_matrix(Matrix mat);
 
+/**
+ * @brief Транспонирует матрицу, записывая результат в существующую матрицу
+ * @param dst Матрица-результат (n×m)
+ * @param mat Исходная матрица (m×n)
+ * @note Для квадратной матрицы допускается транспонирование на месте (dst совпадает с mat),
+ *       дополнительный буфер при этом не выделяется
+ * @warning При несовпадении размеров или частичном перекрытии завершает программу с EXIT_FAILURE
+ */
+void transpose_matrix_into(Matrix *dst, Matrix mat);
+
 /**
  * @brief Вычисляет определитель матрицы
  * @param mat Квадратная матрица
  * @return Значение определителя
- * @note Используется рекурсивный метод разложения
+ * @note Используется LU-разложение с частичным выбором ведущего элемента (O(n^3));
+ * для больших n разложение блочное, обновление подматриц выполняется через GEMM
+ * @note Для больших матриц произведение диагонали может переполниться - используйте
+ * log_abs_determinant
  * @warning Для неквадратных матриц завершает программу с EXIT_FAILURE
  */
 double determinant(Matrix mat);
 
+/**
+ * @brief Вычисляет натуральный логарифм модуля определителя и его знак
+ * @param mat Квадратная матрица
+ * @param sign Указатель для записи знака: 1, -1 или 0 для вырожденной матрицы (может быть NULL)
+ * @return ln|det(mat)|, либо -INFINITY для вырожденной матрицы
+ * @note Не переполняется и не теряет значащие разряды для матриц любого порядка:
+ * определитель равен sign * exp(результат)
+ * @warning Для неквадратных матриц завершает программу с EXIT_FAILURE
+ */
+double log_abs_determinant(Matrix mat, int *sign);
+
 /**
  * @brief Вычитает две матрицы
  * @param mat1 Первая матрица
  * @param mat2 Вторая матрица
  * @return Результат вычитания
  * @note Матрицы должны быть одинакового размера
+ * @note Результат побитово не зависит от числа потоков
  * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
  */
 Matrix subtract_matrices(Matrix mat1, Matrix mat2);
 
+/**
+ * @brief Вычитает две матрицы, записывая результат в существующую матрицу
+ * @param dst Матрица-результат того же размера
+ * @param mat1 Уменьшаемое
+ * @param mat2 Вычитаемое
+ * @note Допускается вычитание на месте: dst может совпадать с mat1 или mat2
+ * @warning При несовпадении размеров или частичном перекрытии завершает программу с EXIT_FAILURE
+ */
+void subtract_matrices_into(Matrix *dst, Matrix mat1, Matrix mat2);
+
+/**
+ * @brief Создает представление блока матрицы без копирования
+ * @param mat Исходная матрица
+ * @param row Первая строка блока
+ * @param col Первый столбец блока
+ * @param rows Число строк блока
+ * @param cols Число столбцов блока
+ * @return Матрица rows×cols с буфером и ведущей размерностью mat и флагами
+ *         MATRIX_VIEW и MATRIX_BORROWED (флаг MATRIX_READONLY наследуется; представление
+ *         матрицы с флагом MATRIX_SHARED всегда доступно только для чтения, так как
+ *         копии mat могут появиться и после создания представления)
+ * @note Выполняется за O(1). Представление принимается всеми операциями, в том числе
+ *       как результат операций *_into, и остается действительным, пока существует mat;
+ *       free_matrix для него ничего не делает
+ * @warning При выходе блока за границы mat завершает программу с EXIT_FAILURE
+ */
+Matrix matrix_view(Matrix mat, int row, int col, int rows, int cols);
+
+/**
+ * @brief Создает представление строки матрицы (матрица 1×cols)
+ * @param mat Исходная матрица
+ * @param row Номер строки
+ * @return Представление строки (см. matrix_view)
+ */
+Matrix matrix_row_view(Matrix mat, int row);
+
+/**
+ * @brief Создает представление столбца матрицы (матрица rows×1)
+ * @param mat Исходная матрица
+ * @param col Номер столбца
+ * @return Представление столбца (см. matrix_view)
+ */
+Matrix matrix_col_view(Matrix mat, int col);
+
+/**
+ * @brief Проверяет, есть ли у двух матриц общие элементы в памяти
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица
+ * @return 1, если хотя бы один элемент одной матрицы совпадает с элементом другой
+ * @note Непересекающиеся блоки одной матрицы (например, ее левая и правая половины)
+ *       не считаются пересекающимися, хотя их диапазоны адресов чередуются
+ */
+int matrices_overlap(Matrix mat1, Matrix mat2);
+
+/**
+ * @brief Включает или выключает режим копирования при записи (copy-on-write)
+ * @param enabled 1 - включить, 0 - выключить
+ *
+ * Во включенном режиме create_matrix выделяет буфер со счетчиком ссылок (флаг
+ * MATRIX_SHARED), copy_matrix для такой матрицы лишь увеличивает счетчик, а
+ * free_matrix уменьшает его и освобождает буфер вместе с последней ссылкой.
+ * Счетчик изменяется атомарно, поэтому копии можно освобождать и изменять в
+ * разных потоках. Режим влияет только на вновь создаваемые матрицы.
+ *
+ * @note Без вызова этой функции режим задается переменной окружения
+ *       MATRIX_COPY_ON_WRITE=1, по умолчанию выключен
+ */
+void matrix_set_copy_on_write(int enabled);
+
+/**
+ * @brief Проверяет, включен ли режим копирования при записи
+ * @return 1, если включен
+ */
+int matrix_copy_on_write_enabled(void);
+
+/**
+ * @brief Делает буфер матрицы изменяемым перед записью элементов
+ * @param mat Матрица
+ * @note Если буфер с флагом MATRIX_SHARED разделяют несколько копий, матрица получает
+ *       собственную копию элементов, а ссылка на общий буфер освобождается; для
+ *       остальных матриц ничего не делает
+ */
+void matrix_make_writable(Matrix *mat);
+
+/**
+ * @brief Делает буфер матрицы изменяемым перед полной перезаписью ее элементов
+ * @param mat Матрица
+ * @note В отличие от matrix_make_writable, собственный буфер не заполняется старыми
+ *       элементами: так готовят матрицу-результат операции *_into, а копии,
+ *       разделявшие буфер, продолжают читать общий
+ */
+void matrix_prepare_overwrite(Matrix *mat);
+
+/**
+ * @brief Возвращает число копий, разделяющих буфер матрицы
+ * @param mat Матрица
+ * @return Значение счетчика ссылок для MATRIX_SHARED, иначе 1
+ */
+int matrix_reference_count(Matrix mat);
+
 #endif
 
 /** @} */
\ No newline at end of file
@@ -0,0 +1,455 @@
+/**
+ * @file matrix_out_of_core.c
+ * @brief Реализация блочного умножения матриц из файлов
+ * @ingroup Matrix_Operations
+ *
+ * Блоки обходятся в порядке (строка блоков C, столбец блоков C, шаг по общему
+ * измерению), поэтому каждый блок C накапливается в памяти целиком и
+ * записывается один раз. Чтение блоков двойной буферизацией перекрывается с
+ * вычислениями: на шаге s постоянный поток чтения заполняет свободные буферы
+ * блоками шага s + 1.
+ */
+
+#include "matrix_out_of_core.h"
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/matrix_format.h"
+#include "gemm.h"
+#include "matrix_binary.h"
+#include "matrix_operations.h"
+
+/**
+ * @brief Открытый файл матрицы
+ */
+typedef struct {
+    int fd;               /**< Дескриптор файла */
+    const char *filename; /**< Имя для сообщений об ошибках */
+    int swapped;          /**< Данные записаны с обратным порядком байт */
+    int rows, cols;       /**< Размеры матрицы */
+    uint64_t stride;      /**< Шаг между строками в файле */
+} TileFile;
+
+/**
+ * @brief Операнд с двумя буферами блоков
+ */
+typedef struct {
+    TileFile file;
+    double *buffers[2];  /**< Буферы T×T */
+    int tile_row[2];     /**< Номер строки блоков в буфере, -1 - пуст */
+    int tile_col[2];     /**< Номер столбца блоков в буфере */
+    int current;         /**< Буфер с блоком текущего шага */
+} TiledOperand;
+
+/**
+ * @brief Запрос на чтение блока
+ */
+typedef struct {
+    const TileFile *file;
+    double *data;
+    int row, col;   /**< Первый элемент блока */
+    int rows, cols; /**< Размеры блока */
+} TileRead;
+
+/**
+ * @brief Блоки, читаемые потоком чтения за один шаг
+ */
+typedef struct {
+    TileRead reads[2];
+    int count;
+    const char *failed; /**< Файл, при чтении которого произошла ошибка, или NULL */
+} TileReadJob;
+
+/**
+ * @brief Поток чтения, живущий все время умножения
+ *
+ * Один поток на все шаги: создание потока на каждом шаге при малом бюджете памяти
+ * (маленьких блоках) обходится дороже самого чтения.
+ */
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond; /**< Появился запрос или пора завершаться */
+    pthread_cond_t done_cond; /**< Запрос выполнен */
+    TileReadJob *job;         /**< Запрос, читаемый сейчас, или NULL */
+    int stopping;             /**< Поток должен завершиться */
+    int running;              /**< Поток создан; иначе чтение выполняется синхронно */
+} TilePrefetcher;
+
+/**
+ * @brief Сообщает об ошибке и завершает программу
+ */
+static void out_of_core_fail(const char *filename, const char *reason) {
+    fprintf(stderr, "Ошибка умножения матриц из файлов (%s): %s!\n", filename, reason);
+    exit(EXIT_FAILURE);
+}
+
+static void open_tile_file(TileFile *file, const char *filename) {
+    file->fd = open(filename, O_RDONLY);
+    if (file->fd < 0) {
+        perror("Невозможно открыть файл!");
+        exit(EXIT_FAILURE);
+    }
+    MatrixFileHeader header;
+    file->filename = filename;
+    file->swapped = matrix_binary_read_header(file->fd, filename, &header);
+    if (header.dtype != MATRIX_DTYPE_FLOAT64) {
+        close(file->fd);
+        out_of_core_fail(filename, "поддерживаются только файлы с элементами double");
+    }
+    file->rows = (int)header.rows;
+    file->cols = (int)header.cols;
+    file->stride = header.stride;
+}
+
+/**
+ * @brief Читает блок построчно в плотный буфер с шагом cols
+ * @return 0 при успехе, -1 при ошибке чтения
+ */
+static int read_tile(const TileRead *read) {
+    const TileFile *file = read->file;
+    const size_t row_bytes = (size_t)read->cols * sizeof(double);
+    for (int iter = 0; iter < read->rows; iter++) {
+        double *row = read->data + (size_t)iter * read->cols;
+        uint64_t element = (uint64_t)(read->row + iter) * file->stride + (uint64_t)read->col;
+        off_t offset = (off_t)(MATRIX_FILE_HEADER_SIZE + element * sizeof(double));
+        if (pread(file->fd, row, row_bytes, offset) != (ssize_t)row_bytes) {
+            return -1;
+        }
+        if (file->swapped) {
+            uint64_t *bits = (uint64_t *)row;
+            for (int iter_2 = 0; iter_2 < read->cols; iter_2++) {
+                bits[iter_2] = __builtin_bswap64(bits[iter_2]);
+            }
+        }
+    }
+    return 0;
+}
+
+static void *read_task(void *arg) {
+    TileReadJob *job = arg;
+    for (int iter = 0; iter < job->count; iter++) {
+        if (read_tile(&job->reads[iter]) != 0) {
+            job->failed = job->reads[iter].file->filename;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Цикл потока чтения: выполняет запросы до остановки
+ */
+static void *prefetch_main(void *arg) {
+    TilePrefetcher *prefetcher = arg;
+    pthread_mutex_lock(&prefetcher->lock);
+    for (;;) {
+        while (prefetcher->job == NULL && !prefetcher->stopping) {
+            pthread_cond_wait(&prefetcher->work_cond, &prefetcher->lock);
+        }
+        if (prefetcher->job == NULL) {
+            break;
+        }
+        TileReadJob *job = prefetcher->job;
+        pthread_mutex_unlock(&prefetcher->lock);
+
+        read_task(job);
+
+        pthread_mutex_lock(&prefetcher->lock);
+        prefetcher->job = NULL;
+        pthread_cond_signal(&prefetcher->done_cond);
+    }
+    pthread_mutex_unlock(&prefetcher->lock);
+    return NULL;
+}
+
+static void prefetch_start(TilePrefetcher *prefetcher) {
+    pthread_mutex_init(&prefetcher->lock, NULL);
+    pthread_cond_init(&prefetcher->work_cond, NULL);
+    pthread_cond_init(&prefetcher->done_cond, NULL);
+    prefetcher->job = NULL;
+    prefetcher->stopping = 0;
+    prefetcher->running = pthread_create(&prefetcher->thread, NULL, prefetch_main, prefetcher) == 0;
+}
+
+/**
+ * @brief Передает запрос потоку чтения (без потока - выполняет его сразу)
+ */
+static void prefetch_submit(TilePrefetcher *prefetcher, TileReadJob *job) {
+    if (job->count == 0) {
+        return;
+    }
+    if (!prefetcher->running) {
+        read_task(job);
+        return;
+    }
+    pthread_mutex_lock(&prefetcher->lock);
+    prefetcher->job = job;
+    pthread_cond_signal(&prefetcher->work_cond);
+    pthread_mutex_unlock(&prefetcher->lock);
+}
+
+/**
+ * @brief Ожидает завершения запроса, переданного prefetch_submit
+ */
+static void prefetch_wait(TilePrefetcher *prefetcher) {
+    if (!prefetcher->running) {
+        return;
+    }
+    pthread_mutex_lock(&prefetcher->lock);
+    while (prefetcher->job != NULL) {
+        pthread_cond_wait(&prefetcher->done_cond, &prefetcher->lock);
+    }
+    pthread_mutex_unlock(&prefetcher->lock);
+}
+
+static void prefetch_stop(TilePrefetcher *prefetcher) {
+    if (prefetcher->running) {
+        pthread_mutex_lock(&prefetcher->lock);
+        prefetcher->stopping = 1;
+        pthread_cond_signal(&prefetcher->work_cond);
+        pthread_mutex_unlock(&prefetcher->lock);
+        pthread_join(prefetcher->thread, NULL);
+    }
+    pthread_cond_destroy(&prefetcher->done_cond);
+    pthread_cond_destroy(&prefetcher->work_cond);
+    pthread_mutex_destroy(&prefetcher->lock);
+}
+
+/**
+ * @brief Выбирает буфер для блока (tile_row, tile_col) следующего шага
+ *
+ * Если блок уже загружен, используется его буфер, иначе в запрос чтения
+ * добавляется загрузка в буфер, не занятый текущим шагом.
+ * @return Номер буфера
+ */
+static int plan_tile(TiledOperand *operand, int tile_row, int tile_col, int tile,
+                     TileReadJob *job) {
+    for (int iter = 0; iter < 2; iter++) {
+        int index = (operand->current + iter) & 1;
+        if (operand->tile_row[index] == tile_row && operand->tile_col[index] == tile_col) {
+            return index;
+        }
+    }
+    int index = operand->current ^ 1;
+    TileRead *read = &job->reads[job->count++];
+    read->file = &operand->file;
+    read->data = operand->buffers[index];
+    read->row = tile_row * tile;
+    read->col = tile_col * tile;
+    read->rows = operand->file.rows - read->row < tile ? operand->file.rows - read->row : tile;
+    read->cols = operand->file.cols - read->col < tile ? operand->file.cols - read->col : tile;
+    operand->tile_row[index] = tile_row;
+    operand->tile_col[index] = tile_col;
+    return index;
+}
+
+/**
+ * @brief Выделяет выровненный буфер блока
+ */
+static double *tile_alloc(size_t bytes) {
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, MATRIX_ALIGNMENT, bytes) != 0) {
+        fprintf(stderr, "Ошибка выделения памяти для умножения матриц из файлов!\n");
+        exit(EXIT_FAILURE);
+    }
+    return (double *)ptr;
+}
+
+int out_of_core_tile_size(size_t memory_budget) {
+    double side = sqrt((double)memory_budget / (5.0 * sizeof(double)));
+    if (side > INT32_MAX) {
+        side = INT32_MAX;
+    }
+    int tile = (int)side / OUT_OF_CORE_TILE_MIN * OUT_OF_CORE_TILE_MIN;
+    return tile < OUT_OF_CORE_TILE_MIN ? OUT_OF_CORE_TILE_MIN : tile;
+}
+
+/**
+ * @brief Завершает программу, если файл результата - это файл одного из операндов
+ *
+ * Файл результата открывается с усечением до чтения операндов, поэтому совпадение
+ * (в том числе через другой путь или жесткую ссылку) проверяется по устройству и
+ * номеру inode до открытия.
+ */
+static void require_distinct_result(const char *filename, const TileFile *a, const TileFile *b) {
+    struct stat result;
+    if (stat(filename, &result) != 0) {
+        return;
+    }
+    const TileFile *operands[2] = {a, b};
+    for (int iter = 0; iter < 2; iter++) {
+        struct stat operand;
+        if (fstat(operands[iter]->fd, &operand) == 0 && operand.st_dev == result.st_dev &&
+            operand.st_ino == result.st_ino) {
+            out_of_core_fail(filename, "файл результата совпадает с файлом операнда");
+        }
+    }
+}
+
+/**
+ * @brief Создает файл результата с заголовком и дополненными строками
+ * @return Дескриптор файла
+ */
+static int create_result_file(const char *filename, int rows, int cols, int stride) {
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("Ошибка открытя файла!");
+        exit(EXIT_FAILURE);
+    }
+    MatrixFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MATRIX_FILE_MAGIC, MATRIX_FILE_MAGIC_SIZE);
+    header.version = MATRIX_FILE_VERSION;
+    header.dtype = MATRIX_DTYPE_FLOAT64;
+    header.endianness = MATRIX_FILE_ENDIAN_MARK;
+    header.alignment = MATRIX_ALIGNMENT;
+    header.rows = (uint64_t)rows;
+    header.cols = (uint64_t)cols;
+    header.stride = (uint64_t)stride;
+    header.data_offset = MATRIX_FILE_HEADER_SIZE;
+
+    /* Дополнение строк остается нулевым: ftruncate заполняет файл нулями */
+    off_t length = (off_t)(MATRIX_FILE_HEADER_SIZE +
+                           (uint64_t)rows * (uint64_t)stride * sizeof(double));
+    if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        ftruncate(fd, length) != 0) {
+        close(fd);
+        out_of_core_fail(filename, "не удалось записать заголовок");
+    }
+    return fd;
+}
+
+/**
+ * @brief Записывает блок результата построчно
+ * @return 0 при успехе, -1 при ошибке записи
+ */
+static int write_tile(int fd, int stride, int row, int col, int rows, int cols,
+                      const double *tile) {
+    const size_t row_bytes = (size_t)cols * sizeof(double);
+    for (int iter = 0; iter < rows; iter++) {
+        uint64_t element = (uint64_t)(row + iter) * (uint64_t)stride + (uint64_t)col;
+        off_t offset = (off_t)(MATRIX_FILE_HEADER_SIZE + element * sizeof(double));
+        if (pwrite(fd, tile + (size_t)iter * cols, row_bytes, offset) != (ssize_t)row_bytes) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void multiply_matrix_files(const char *a_filename, const char *b_filename,
+                           const char *result_filename, size_t memory_budget) {
+    if (a_filename == NULL || b_filename == NULL || result_filename == NULL) {
+        fprintf(stderr, "Ошибка: Неверные входные параметры!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    TiledOperand a = {.tile_row = {-1, -1}, .tile_col = {-1, -1}};
+    TiledOperand b = {.tile_row = {-1, -1}, .tile_col = {-1, -1}};
+    open_tile_file(&a.file, a_filename);
+    open_tile_file(&b.file, b_filename);
+    if (a.file.cols != b.file.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    const int m = a.file.rows;
+    const int n = b.file.cols;
+    const int k = a.file.cols;
+    const int stride = matrix_stride_for(n);
+    require_distinct_result(result_filename, &a.file, &b.file);
+    int fd = create_result_file(result_filename, m, n, stride);
+
+    int tile = out_of_core_tile_size(memory_budget ? memory_budget : OUT_OF_CORE_DEFAULT_BUDGET);
+    int largest = m > n ? m : n;
+    largest = largest > k ? largest : k;
+    if (tile > largest) {
+        tile = (largest + OUT_OF_CORE_TILE_MIN - 1) / OUT_OF_CORE_TILE_MIN * OUT_OF_CORE_TILE_MIN;
+    }
+    const int tiles_m = (m + tile - 1) / tile;
+    const int tiles_n = (n + tile - 1) / tile;
+    const int tiles_k = (k + tile - 1) / tile;
+    /* При k == 0 шагов нет: результат нулевой, файл уже заполнен нулями */
+    const long long steps = (long long)tiles_m * tiles_n * tiles_k;
+
+    const size_t tile_bytes = (size_t)tile * (size_t)tile * sizeof(double);
+    double *c_tile = NULL;
+    if (steps > 0) {
+        c_tile = tile_alloc(tile_bytes);
+        for (int iter = 0; iter < 2; iter++) {
+            a.buffers[iter] = tile_alloc(tile_bytes);
+            b.buffers[iter] = tile_alloc(tile_bytes);
+        }
+    }
+
+    /* Блоки первого шага читаются синхронно */
+    TileReadJob job = {.count = 0};
+    TilePrefetcher prefetcher = {.running = 0};
+    if (steps > 0) {
+        a.current = plan_tile(&a, 0, 0, tile, &job);
+        b.current = plan_tile(&b, 0, 0, tile, &job);
+        read_task(&job);
+        if (job.failed) {
+            out_of_core_fail(job.failed, "ошибка чтения блока");
+        }
+        if (steps > 1) {
+            prefetch_start(&prefetcher);
+        }
+    }
+
+    for (long long step = 0; step < steps; step++) {
+        const int ti = (int)(step / ((long long)tiles_n * tiles_k));
+        const int tj = (int)(step / tiles_k % tiles_n);
+        const int tp = (int)(step % tiles_k);
+
+        /* Чтение блоков следующего шага в фоне */
+        job.count = 0;
+        job.failed = NULL;
+        int next_a = a.current;
+        int next_b = b.current;
+        if (step + 1 < steps) {
+            const int next_ti = (int)((step + 1) / ((long long)tiles_n * tiles_k));
+            const int next_tj = (int)((step + 1) / tiles_k % tiles_n);
+            const int next_tp = (int)((step + 1) % tiles_k);
+            next_a = plan_tile(&a, next_ti, next_tp, tile, &job);
+            next_b = plan_tile(&b, next_tp, next_tj, tile, &job);
+        }
+        prefetch_submit(&prefetcher, &job);
+
+        const int rows = m - ti * tile < tile ? m - ti * tile : tile;
+        const int cols = n - tj * tile < tile ? n - tj * tile : tile;
+        const int depth = k - tp * tile < tile ? k - tp * tile : tile;
+        gemm_strided(rows, cols, depth, 1.0, a.buffers[a.current], depth, 1,
+                     b.buffers[b.current], cols, 1, tp == 0 ? 0.0 : 1.0, c_tile, cols, 1);
+        int write_failed = tp == tiles_k - 1 &&
+                           write_tile(fd, stride, ti * tile, tj * tile, rows, cols, c_tile) != 0;
+
+        prefetch_wait(&prefetcher);
+        if (write_failed) {
+            out_of_core_fail(result_filename, "ошибка записи блока");
+        }
+        if (job.failed) {
+            out_of_core_fail(job.failed, "ошибка чтения блока");
+        }
+        a.current = next_a;
+        b.current = next_b;
+    }
+    if (steps > 1) {
+        prefetch_stop(&prefetcher);
+    }
+
+    if (close(fd) != 0) {
+        out_of_core_fail(result_filename, "ошибка записи файла");
+    }
+    close(a.file.fd);
+    close(b.file.fd);
+    free(c_tile);
+    for (int iter = 0; iter < 2; iter++) {
+        free(a.buffers[iter]);
+        free(b.buffers[iter]);
+    }
+}
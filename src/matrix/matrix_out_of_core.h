@@ -0,0 +1,60 @@
+/**
+ * @file matrix_out_of_core.h
+ * @brief Умножение матриц, не помещающихся в оперативную память
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Операнды и результат хранятся в двоичных файлах (matrix_format.h) и
+ * рассматриваются как сетки квадратных блоков. В памяти одновременно находятся
+ * только блок результата и по два блока каждого операнда: пока текущие блоки
+ * перемножаются, следующие читаются с диска отдельным потоком.
+ */
+
+#ifndef MATRIX_OUT_OF_CORE_H
+#define MATRIX_OUT_OF_CORE_H
+
+#include <stddef.h>
+
+/**
+ * @brief Бюджет памяти по умолчанию в байтах (256 МБ)
+ */
+#define OUT_OF_CORE_DEFAULT_BUDGET ((size_t)256 << 20)
+
+/**
+ * @brief Наименьшая сторона блока; сторона блока всегда кратна ей
+ */
+#define OUT_OF_CORE_TILE_MIN 8
+
+/**
+ * @brief Сторона блока для заданного бюджета памяти
+ * @param memory_budget Бюджет в байтах
+ * @return Наибольшая сторона T, кратная OUT_OF_CORE_TILE_MIN, при которой пять
+ *         блоков T×T (два блока A, два блока B и блок C) занимают не больше бюджета,
+ *         но не меньше OUT_OF_CORE_TILE_MIN
+ */
+int out_of_core_tile_size(size_t memory_budget);
+
+/**
+ * @brief Умножает матрицы из двоичных файлов и записывает результат в файл
+ * @param a_filename Файл левого операнда (m×k)
+ * @param b_filename Файл правого операнда (k×n)
+ * @param result_filename Файл результата (m×n), создается или перезаписывается; не должен
+ *                        быть файлом одного из операндов
+ * @param memory_budget Память под блоки в байтах, 0 - OUT_OF_CORE_DEFAULT_BUDGET
+ *
+ * @note Для каждого блока результата блоки A и B по общему измерению читаются
+ * последовательно; следующая пара блоков читается (pread) в отдельном потоке во
+ * время умножения текущей пары (gemm_strided). Блок, совпадающий с уже
+ * загруженным, повторно не читается. Готовый блок результата записывается сразу.
+ * @note Результат записывается в том же формате, что и save_matrix_to_binary_file,
+ * и загружается load_matrix_from_file. Текстовые матрицы нужно предварительно
+ * сохранить в двоичном формате.
+ * @warning При несовместимых размерах, совпадении файла результата с файлом операнда,
+ *          ошибке чтения или записи завершает программу с EXIT_FAILURE
+ */
+void multiply_matrix_files(const char *a_filename, const char *b_filename,
+                           const char *result_filename, size_t memory_budget);
+
+#endif
+
+/** @} */
@@ -0,0 +1,171 @@
+/**
+ * @file matrix_stats.c
+ * @brief Реализация счетчиков производительности
+ * @ingroup Matrix_Operations
+ *
+ * Счетчики и matrix_stats_state обновляются атомарными операциями, поэтому функции библиотеки
+ * можно вызывать из нескольких потоков одновременно.
+ */
+
+#include "matrix_stats.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int matrix_stats_state = -1;
+
+/** Счетчики всех функций */
+static MatrixStatCounters counters_table[MATRIX_STAT_COUNT];
+
+/** Однократное чтение MATRIX_STATS */
+static pthread_once_t config_once = PTHREAD_ONCE_INIT;
+
+/** Имена функций в порядке MatrixStatId */
+static const char *const stat_names[MATRIX_STAT_COUNT] = {
+    "create_matrix",
+    "free_matrix",
+    "load_matrix_from_file",
+    "copy_matrix",
+    "copy_matrix_into",
+    "plus_matrices",
+    "plus_matrices_into",
+    "multiply_matrices",
+    "multiply_matrices_into",
+    "multiply_matrices_strassen",
+    "multiply_matrices_strassen_into",
+    "transpose_matrix",
+    "transpose_matrix_into",
+    "determinant",
+    "log_abs_determinant",
+    "subtract_matrices",
+    "subtract_matrices_into",
+    "print_matrix",
+    "print_matrix_formatted",
+    "write_matrix_text",
+    "save_matrix_to_file",
+    "save_matrix_to_binary_file",
+    "create_matrix_f",
+    "free_matrix_f",
+    "load_matrix_from_file_f",
+    "copy_matrix_f",
+    "matrix_to_float",
+    "matrix_to_double",
+    "plus_matrices_f",
+    "subtract_matrices_f",
+    "multiply_matrices_f",
+    "transpose_matrix_f",
+    "determinant_f",
+    "print_matrix_f",
+    "write_matrix_text_f",
+    "save_matrix_to_file_f",
+    "save_matrix_to_binary_file_f",
+};
+
+/**
+ * @brief Выводит сводку при завершении, если счетчики не выключены
+ *        matrix_stats_set_enabled(0)
+ */
+static void print_at_exit(void) {
+    if (__atomic_load_n(&matrix_stats_state, __ATOMIC_RELAXED) > 0) {
+        matrix_stats_print(stderr);
+    }
+}
+
+/**
+ * @brief Читает MATRIX_STATS (однократно), при значении 1 включает счетчики и
+ *        регистрирует вывод сводки при завершении
+ */
+static void read_config(void) {
+    const char *env = getenv("MATRIX_STATS");
+    int enabled = env != NULL && strcmp(env, "1") == 0;
+    if (env != NULL && !enabled && strcmp(env, "0") != 0 && env[0] != '\0') {
+        fprintf(stderr, "Неверное значение MATRIX_STATS: %s\n", env);
+    }
+    if (enabled) {
+        atexit(print_at_exit);
+    }
+    /* Явный вызов matrix_stats_set_enabled до первого замера имеет приоритет */
+    int unset = -1;
+    __atomic_compare_exchange_n(&matrix_stats_state, &unset, enabled, 0, __ATOMIC_RELAXED,
+                                __ATOMIC_RELAXED);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    return now ? now : 1;
+}
+
+uint64_t matrix_stats_start(void) {
+    pthread_once(&config_once, read_config);
+    return __atomic_load_n(&matrix_stats_state, __ATOMIC_RELAXED) > 0 ? now_ns() : 0;
+}
+
+void matrix_stats_record(MatrixStatId id, uint64_t start, double elements, double flops,
+                         double bytes_allocated) {
+    uint64_t elapsed = now_ns() - start;
+    MatrixStatCounters *counters = &counters_table[id];
+    __atomic_fetch_add(&counters->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counters->total_ns, elapsed, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counters->elements, (uint64_t)elements, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counters->flops, (uint64_t)flops, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counters->bytes_allocated, (uint64_t)bytes_allocated, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&counters->max_ns, __ATOMIC_RELAXED);
+    while (elapsed > max && !__atomic_compare_exchange_n(&counters->max_ns, &max, elapsed, 1,
+                                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void matrix_stats_set_enabled(int enabled) {
+    __atomic_store_n(&matrix_stats_state, enabled ? 1 : 0, __ATOMIC_RELAXED);
+    pthread_once(&config_once, read_config);
+}
+
+int matrix_stats_enabled(void) {
+    pthread_once(&config_once, read_config);
+    return __atomic_load_n(&matrix_stats_state, __ATOMIC_RELAXED) > 0;
+}
+
+void matrix_stats_get(MatrixStatId id, MatrixStatCounters *counters) {
+    const MatrixStatCounters *source = &counters_table[id];
+    counters->calls = __atomic_load_n(&source->calls, __ATOMIC_RELAXED);
+    counters->total_ns = __atomic_load_n(&source->total_ns, __ATOMIC_RELAXED);
+    counters->max_ns = __atomic_load_n(&source->max_ns, __ATOMIC_RELAXED);
+    counters->elements = __atomic_load_n(&source->elements, __ATOMIC_RELAXED);
+    counters->flops = __atomic_load_n(&source->flops, __ATOMIC_RELAXED);
+    counters->bytes_allocated = __atomic_load_n(&source->bytes_allocated, __ATOMIC_RELAXED);
+}
+
+void matrix_stats_reset(void) {
+    for (int iter = 0; iter < MATRIX_STAT_COUNT; iter++) {
+        MatrixStatCounters *counters = &counters_table[iter];
+        __atomic_store_n(&counters->calls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&counters->total_ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&counters->max_ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&counters->elements, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&counters->flops, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&counters->bytes_allocated, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void matrix_stats_print(FILE *stream) {
+    fprintf(stream, "\nСчетчики матричных операций:\n");
+    fprintf(stream, "%-31s %9s %12s %12s %12s %14s %10s %10s %12s\n", "function", "calls",
+            "total, ms", "mean, us", "max, us", "elements", "GFLOP", "GFLOP/s", "alloc, MB");
+    for (int iter = 0; iter < MATRIX_STAT_COUNT; iter++) {
+        MatrixStatCounters counters;
+        matrix_stats_get((MatrixStatId)iter, &counters);
+        if (counters.calls == 0) {
+            continue;
+        }
+        double total_ns = (double)counters.total_ns;
+        fprintf(stream, "%-31s %9llu %12.3f %12.3f %12.3f %14llu %10.3f %10.3f %12.3f\n",
+                stat_names[iter], (unsigned long long)counters.calls, total_ns / 1e6,
+                total_ns / 1e3 / (double)counters.calls, (double)counters.max_ns / 1e3,
+                (unsigned long long)counters.elements, (double)counters.flops / 1e9,
+                total_ns > 0 ? (double)counters.flops / total_ns : 0.0,
+                (double)counters.bytes_allocated / (1024.0 * 1024.0));
+    }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file matrix_stats.h
+ * @brief Счетчики производительности публичных функций библиотеки
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Для каждой функции из matrix_operations.c, matrix_float.c и output.c накапливаются число
+ * вызовов, суммарное и наибольшее время, число обработанных элементов,
+ * число операций с плавающей точкой и объем выделенной памяти. Время функции
+ * включает время вложенных вызовов (например, plus_matrices включает
+ * create_matrix и plus_matrices_into).
+ *
+ * Счетчики включаются переменной окружения MATRIX_STATS=1 (тогда сводка
+ * выводится в stderr при завершении программы) или функцией
+ * matrix_stats_set_enabled. В выключенном состоянии каждая функция выполняет
+ * лишь одну проверку флага.
+ */
+
+#ifndef MATRIX_STATS_H
+#define MATRIX_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Инструментированные функции
+ */
+typedef enum {
+    MATRIX_STAT_CREATE = 0,
+    MATRIX_STAT_FREE,
+    MATRIX_STAT_LOAD,
+    MATRIX_STAT_COPY,
+    MATRIX_STAT_COPY_INTO,
+    MATRIX_STAT_PLUS,
+    MATRIX_STAT_PLUS_INTO,
+    MATRIX_STAT_MULTIPLY,
+    MATRIX_STAT_MULTIPLY_INTO,
+    MATRIX_STAT_MULTIPLY_STRASSEN,
+    MATRIX_STAT_MULTIPLY_STRASSEN_INTO,
+    MATRIX_STAT_TRANSPOSE,
+    MATRIX_STAT_TRANSPOSE_INTO,
+    MATRIX_STAT_DETERMINANT,
+    MATRIX_STAT_LOG_DETERMINANT,
+    MATRIX_STAT_SUBTRACT,
+    MATRIX_STAT_SUBTRACT_INTO,
+    MATRIX_STAT_PRINT,
+    MATRIX_STAT_PRINT_FORMATTED,
+    MATRIX_STAT_WRITE_TEXT,
+    MATRIX_STAT_SAVE_TEXT,
+    MATRIX_STAT_SAVE_BINARY,
+    MATRIX_STAT_CREATE_F,
+    MATRIX_STAT_FREE_F,
+    MATRIX_STAT_LOAD_F,
+    MATRIX_STAT_COPY_F,
+    MATRIX_STAT_TO_FLOAT,
+    MATRIX_STAT_TO_DOUBLE,
+    MATRIX_STAT_PLUS_F,
+    MATRIX_STAT_SUBTRACT_F,
+    MATRIX_STAT_MULTIPLY_F,
+    MATRIX_STAT_TRANSPOSE_F,
+    MATRIX_STAT_DETERMINANT_F,
+    MATRIX_STAT_PRINT_F,
+    MATRIX_STAT_WRITE_TEXT_F,
+    MATRIX_STAT_SAVE_TEXT_F,
+    MATRIX_STAT_SAVE_BINARY_F,
+    MATRIX_STAT_COUNT /**< Число счетчиков */
+} MatrixStatId;
+
+/**
+ * @brief Значения счетчиков одной функции
+ */
+typedef struct {
+    uint64_t calls;           /**< Число вызовов */
+    uint64_t total_ns;        /**< Суммарное время, нс */
+    uint64_t max_ns;          /**< Наибольшее время одного вызова, нс */
+    uint64_t elements;        /**< Обработано элементов */
+    uint64_t flops;           /**< Операций с плавающей точкой */
+    uint64_t bytes_allocated; /**< Выделено памяти, байт */
+} MatrixStatCounters;
+
+/**
+ * @brief Состояние счетчиков: -1 - переменная окружения еще не прочитана, 0 - выключены,
+ *        1 - включены
+ * @note Используется встроенными функциями ниже; напрямую не изменять. Читается потоками
+ *       пула и записывается при первом замере, поэтому доступ только через __atomic_*
+ */
+extern int matrix_stats_state;
+
+/**
+ * @brief Начало замера при включенных счетчиках (см. matrix_stats_begin)
+ */
+uint64_t matrix_stats_start(void);
+
+/**
+ * @brief Учет вызова при включенных счетчиках (см. matrix_stats_end)
+ */
+void matrix_stats_record(MatrixStatId id, uint64_t start, double elements, double flops,
+                         double bytes_allocated);
+
+/**
+ * @brief Начинает замер вызова функции
+ * @return Момент начала в наносекундах или 0, если счетчики выключены
+ */
+static inline uint64_t matrix_stats_begin(void) {
+    if (__builtin_expect(__atomic_load_n(&matrix_stats_state, __ATOMIC_RELAXED) == 0, 1)) {
+        return 0;
+    }
+    return matrix_stats_start();
+}
+
+/**
+ * @brief Завершает замер и добавляет вызов к счетчикам функции
+ * @param id Функция
+ * @param start Результат matrix_stats_begin
+ * @param elements Обработано элементов
+ * @param flops Операций с плавающей точкой
+ * @param bytes_allocated Выделено памяти, байт
+ */
+static inline void matrix_stats_end(MatrixStatId id, uint64_t start, double elements,
+                                    double flops, double bytes_allocated) {
+    if (__builtin_expect(start != 0, 0)) {
+        matrix_stats_record(id, start, elements, flops, bytes_allocated);
+    }
+}
+
+/**
+ * @brief Включает или выключает счетчики
+ * @param enabled 1 - включить, 0 - выключить
+ * @note Переопределяет MATRIX_STATS; накопленные значения сохраняются. Сводка по
+ *       MATRIX_STATS=1 выводится при завершении, только если счетчики в этот момент включены
+ */
+void matrix_stats_set_enabled(int enabled);
+
+/**
+ * @brief Проверяет, включены ли счетчики
+ * @return 1, если включены
+ */
+int matrix_stats_enabled(void);
+
+/**
+ * @brief Возвращает счетчики функции
+ * @param id Функция
+ * @param counters Результат
+ */
+void matrix_stats_get(MatrixStatId id, MatrixStatCounters *counters);
+
+/**
+ * @brief Обнуляет все счетчики
+ */
+void matrix_stats_reset(void);
+
+/**
+ * @brief Выводит сводную таблицу по функциям, которые вызывались хотя бы раз
+ * @param stream Поток для вывода (обычно stderr)
+ */
+void matrix_stats_print(FILE *stream);
+
+#endif
+
+/** @} */
@@ -0,0 +1,148 @@
+/**
+ * @file matrix_template.h
+ * @brief Шаблон размещения матриц и построчных операций для одного типа элементов
+ * @ingroup Matrix_Operations
+ *
+ * Включается в matrix_operations.c для double и в matrix_float.c для float, поэтому
+ * выравнивание строк, выделение памяти и разбиение построчных операций на части
+ * у двух типов совпадают. Перед включением задаются макросы:
+ * - MATRIX_T - тип элементов
+ * - MATRIX_TYPE - тип матрицы (Matrix или MatrixF)
+ * - MATRIX_FN(name) - имя функции или типа этого экземпляра
+ * - MATRIX_COPY_ON_WRITE() - 1, если create_matrix создает буфер со счетчиком ссылок
+ *   (флаг MATRIX_SHARED)
+ * - MATRIX_STAT_CREATE_ID - счетчик matrix_stats.h для create_matrix
+ *
+ * В конце файла все параметры отменяются.
+ */
+
+/**
+ * @brief Вычисляет ведущую размерность для заданного числа столбцов
+ * @param cols Количество столбцов
+ * @return Число элементов между началами соседних строк
+ */
+int MATRIX_FN(matrix_stride_for)(int cols) {
+    if (cols < MATRIX_PAD_MIN_COLS) {
+        return cols;
+    }
+    const int per_line = MATRIX_ALIGNMENT / (int)sizeof(MATRIX_T);
+    return (cols + per_line - 1) / per_line * per_line;
+}
+
+/**
+ * @brief Параметры построчной операции, выполняемой в пуле потоков
+ *
+ * Задается либо binary (dst = src1 op src2), либо unary (dst = src1).
+ */
+typedef struct {
+    MATRIX_TYPE src1; /**< Первый операнд */
+    MATRIX_TYPE src2; /**< Второй операнд (для бинарных операций) */
+    MATRIX_TYPE dst;  /**< Результат */
+    void (*binary)(int n, const MATRIX_T *a, const MATRIX_T *b, MATRIX_T *out);
+    void (*unary)(int n, const MATRIX_T *src, MATRIX_T *out);
+} MATRIX_FN(RowJob);
+
+/**
+ * @brief Задача пула: применяет ядро к строкам [begin, end)
+ */
+static void MATRIX_FN(row_task)(void *ctx, int begin, int end) {
+    const MATRIX_FN(RowJob) *job = (const MATRIX_FN(RowJob) *)ctx;
+    const int cols = job->dst.cols;
+    for (int iter = begin; iter < end; iter++) {
+        if (job->binary != NULL) {
+            job->binary(cols, MATRIX_ROW(job->src1, iter), MATRIX_ROW(job->src2, iter),
+                        MATRIX_ROW(job->dst, iter));
+        } else {
+            job->unary(cols, MATRIX_ROW(job->src1, iter), MATRIX_ROW(job->dst, iter));
+        }
+    }
+}
+
+/**
+ * @brief Минимальное число строк в одной параллельной части
+ * @param cols Количество столбцов
+ * @return Число строк, содержащее не меньше PARALLEL_MIN_ELEMENTS элементов
+ *
+ * Матрицы меньше PARALLEL_MIN_ELEMENTS элементов обрабатываются последовательно.
+ */
+static int MATRIX_FN(rows_grain)(int cols) {
+    return cols > 0 ? (PARALLEL_MIN_ELEMENTS + cols - 1) / cols : 1;
+}
+
+/**
+ * @brief Выполняет построчную операцию над всеми строками результата
+ */
+static void MATRIX_FN(run_rows)(MATRIX_FN(RowJob) *job) {
+    parallel_for(job->dst.rows, MATRIX_FN(rows_grain)(job->dst.cols), MATRIX_FN(row_task), job);
+}
+
+/**
+ * @brief Заголовок буфера с флагом MATRIX_SHARED, расположенный за MATRIX_ALIGNMENT байт
+ *        до первого элемента
+ *
+ * Отступ в целую строку кэша сохраняет выравнивание элементов, а счетчик, который
+ * изменяют разные потоки, не делит строку кэша с элементами.
+ */
+typedef struct {
+    int references; /**< Число матриц, разделяющих буфер */
+} MATRIX_FN(SharedHeader);
+
+/**
+ * @brief Выделяет выровненный буфер из count нулевых элементов матрицы rows×cols
+ * @param shared 1 - буфер со счетчиком ссылок (равным 1) для флага MATRIX_SHARED
+ * @warning При нехватке памяти завершает программу с EXIT_FAILURE
+ */
+static MATRIX_T *MATRIX_FN(allocate_elements)(size_t count, int shared, int rows, int cols) {
+    const size_t header = shared ? MATRIX_ALIGNMENT : 0;
+    char *block;
+    if (count > (SIZE_MAX - header) / sizeof(MATRIX_T) ||
+        posix_memalign((void **)&block, MATRIX_ALIGNMENT, header + count * sizeof(MATRIX_T)) !=
+            0) {
+        fprintf(stderr, "Ошибка выделения памяти под матрицу %dx%d!\n", rows, cols);
+        exit(EXIT_FAILURE);
+    }
+    if (shared) {
+        ((MATRIX_FN(SharedHeader) *)block)->references = 1;
+    }
+    memset(block + header, 0, count * sizeof(MATRIX_T));
+    return (MATRIX_T *)(block + header);
+}
+
+/**
+ * @brief Создает матрицу заданного размера, заполненную нулями
+ * @param rows Количество строк
+ * @param cols Количество столбцов
+ * @return Созданная матрица
+ */
+MATRIX_TYPE MATRIX_FN(create_matrix)(int rows, int cols) {
+    const uint64_t stats = matrix_stats_begin();
+    if (rows < 0 || cols < 0) {
+        fprintf(stderr, "Недопустимые размеры матрицы!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    MATRIX_TYPE mat;
+    mat.rows = rows;
+    mat.cols = cols;
+    mat.stride = MATRIX_FN(matrix_stride_for)(cols);
+    mat.data = NULL;
+    mat.flags = 0;
+
+    size_t count = (size_t)rows * (size_t)mat.stride;
+    if (count == 0) {
+        matrix_stats_end(MATRIX_STAT_CREATE_ID, stats, 0, 0, 0);
+        return mat;
+    }
+    const int shared = MATRIX_COPY_ON_WRITE();
+    mat.data = MATRIX_FN(allocate_elements)(count, shared, rows, cols);
+    mat.flags = shared ? MATRIX_SHARED : 0;
+    matrix_stats_end(MATRIX_STAT_CREATE_ID, stats, (double)rows * cols, 0,
+                     (double)count * sizeof(MATRIX_T));
+    return mat;
+}
+
+#undef MATRIX_T
+#undef MATRIX_TYPE
+#undef MATRIX_FN
+#undef MATRIX_COPY_ON_WRITE
+#undef MATRIX_STAT_CREATE_ID
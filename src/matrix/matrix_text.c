@@ -0,0 +1,524 @@
+/**
+ * @file matrix_text.c
+ * @brief Реализация быстрого разбора текстового формата матриц
+ * @ingroup Matrix_Operations
+ *
+ * Разбор выполняется в два параллельных прохода по частям текста: сначала
+ * в каждой части подсчитываются токены, затем по префиксным суммам каждая часть
+ * узнает номер своего первого элемента и разбирает числа прямо в матрицу.
+ * Границы частей сдвигаются к ближайшему переводу строки, поэтому токен
+ * никогда не разрезается.
+ */
+
+#include "matrix_text.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "matrix_operations.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Наибольшая мантисса, точно представимая в double (2^53)
+ */
+#define EXACT_MANTISSA_MAX (UINT64_C(1) << 53)
+
+/**
+ * @brief Число значащих цифр, накапливаемых в 64-битной мантиссе без переполнения
+ */
+#define MANTISSA_DIGITS_MAX 19
+
+/**
+ * @brief Максимальная длина токена, передаваемого strtod через буфер на стеке
+ */
+#define SLOW_TOKEN_MAX 128
+
+/** Точные степени десяти, представимые в double */
+static const double exact_powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * @brief Проверяет, является ли символ пробельным (как isspace в локали "C")
+ */
+static int is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * @brief Возвращает конец токена, начинающегося в begin
+ */
+static const char *token_end(const char *begin, const char *end) {
+    while (begin < end && !is_space(*begin)) {
+        begin++;
+    }
+    return begin;
+}
+
+/**
+ * @brief Разбирает токен через strtod (редкие и трудные для округления случаи)
+ */
+static const char *parse_double_slow(const char *begin, const char *end, double *value) {
+    const char *stop = token_end(begin, end);
+    size_t length = (size_t)(stop - begin);
+    char local[SLOW_TOKEN_MAX];
+    char *buffer = length < sizeof(local) ? local : (char *)malloc(length + 1);
+    if (buffer == NULL || length == 0) {
+        return NULL;
+    }
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char *parsed = NULL;
+    *value = strtod(buffer, &parsed);
+    int complete = parsed == buffer + length;
+    if (buffer != local) {
+        free(buffer);
+    }
+    return complete ? stop : NULL;
+}
+
+const char *matrix_parse_double(const char *begin, const char *end, double *value) {
+    const char *cursor = begin;
+    int negative = 0;
+    if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+        negative = *cursor == '-';
+        cursor++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    int truncated = 0;
+    int seen_digit = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        int digit = *cursor++ - '0';
+        seen_digit = 1;
+        if (digits < MANTISSA_DIGITS_MAX) {
+            mantissa = mantissa * 10 + (uint64_t)digit;
+            digits += mantissa != 0;
+        } else {
+            exponent++;
+            truncated |= digit != 0;
+        }
+    }
+    if (cursor < end && *cursor == '.') {
+        cursor++;
+        while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+            int digit = *cursor++ - '0';
+            seen_digit = 1;
+            if (digits < MANTISSA_DIGITS_MAX) {
+                mantissa = mantissa * 10 + (uint64_t)digit;
+                digits += mantissa != 0;
+                exponent--;
+            } else {
+                truncated |= digit != 0;
+            }
+        }
+    }
+    if (!seen_digit) {
+        return parse_double_slow(begin, end, value);
+    }
+    if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+        cursor++;
+        int exp_negative = 0;
+        if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+            exp_negative = *cursor == '-';
+            cursor++;
+        }
+        if (cursor == end || *cursor < '0' || *cursor > '9') {
+            return parse_double_slow(begin, end, value);
+        }
+        int exp_value = 0;
+        while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+            if (exp_value < 100000) {
+                exp_value = exp_value * 10 + (*cursor - '0');
+            }
+            cursor++;
+        }
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+    if (cursor < end && !is_space(*cursor)) {
+        return parse_double_slow(begin, end, value);
+    }
+
+    /*
+     * Быстрый путь (Клингер): мантисса и степень десяти точно представимы,
+     * поэтому единственная операция округляется корректно
+     */
+    double result;
+    if (mantissa == 0) {
+        result = 0.0;
+    } else if (truncated || mantissa > EXACT_MANTISSA_MAX) {
+        return parse_double_slow(begin, end, value);
+    } else if (exponent >= 0 && exponent <= 22) {
+        result = (double)mantissa * exact_powers[exponent];
+    } else if (exponent < 0 && exponent >= -22) {
+        result = (double)mantissa / exact_powers[-exponent];
+    } else if (exponent > 22 && exponent <= 22 + 15) {
+        /* 1234e25 = 1234000e22: лишние нули переносятся в мантиссу, пока она точна */
+        for (; exponent > 22 && mantissa <= EXACT_MANTISSA_MAX / 10; exponent--) {
+            mantissa *= 10;
+        }
+        if (exponent > 22) {
+            return parse_double_slow(begin, end, value);
+        }
+        result = (double)mantissa * exact_powers[exponent];
+    } else {
+        return parse_double_slow(begin, end, value);
+    }
+    *value = negative ? -result : result;
+    return cursor;
+}
+
+/**
+ * @brief Часть текста для параллельного разбора
+ */
+typedef struct {
+    const char *begin; /**< Начало части (не внутри токена) */
+    const char *end;   /**< Конец части */
+    long long tokens;  /**< Число токенов в части (первый проход) */
+    long long first;   /**< Номер первого элемента части (префиксная сумма) */
+    const char *error; /**< Первый неверный токен части или NULL */
+} TextChunk;
+
+/**
+ * @brief Параметры параллельного разбора
+ */
+typedef struct {
+    TextChunk *chunks; /**< Части текста */
+    Matrix mat;        /**< Матрица-результат */
+    long long total;   /**< Число элементов матрицы */
+} TextJob;
+
+/**
+ * @brief Задача пула: подсчет токенов в частях [begin, end)
+ */
+static void count_task(void *ctx, int begin, int end) {
+    TextJob *job = (TextJob *)ctx;
+    for (int chunk = begin; chunk < end; chunk++) {
+        TextChunk *part = &job->chunks[chunk];
+        long long tokens = 0;
+        int in_space = 1;
+        for (const char *cursor = part->begin; cursor < part->end; cursor++) {
+            int space = is_space(*cursor);
+            tokens += in_space && !space;
+            in_space = space;
+        }
+        part->tokens = tokens;
+    }
+}
+
+/**
+ * @brief Задача пула: разбор чисел частей [begin, end) в матрицу
+ */
+static void parse_task(void *ctx, int begin, int end) {
+    TextJob *job = (TextJob *)ctx;
+    const Matrix mat = job->mat;
+    for (int chunk = begin; chunk < end; chunk++) {
+        TextChunk *part = &job->chunks[chunk];
+        long long index = part->first;
+        if (index >= job->total) {
+            continue;
+        }
+        int row = (int)(index / mat.cols);
+        int col = (int)(index % mat.cols);
+        double *out = MATRIX_ROW(mat, row);
+        const char *cursor = part->begin;
+        while (index < job->total) {
+            while (cursor < part->end && is_space(*cursor)) {
+                cursor++;
+            }
+            if (cursor == part->end) {
+                break;
+            }
+            const char *next = matrix_parse_double(cursor, part->end, &out[col]);
+            if (next == NULL) {
+                part->error = cursor;
+                break;
+            }
+            cursor = next;
+            index++;
+            if (++col == mat.cols) {
+                col = 0;
+                if (++row < mat.rows) {
+                    out = MATRIX_ROW(mat, row);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Записывает сообщение об ошибке с номером строки и столбца позиции в тексте
+ */
+static void format_error(const char *text, const char *position, const char *name,
+                         const char *what, char *error, size_t error_size) {
+    int line = 1;
+    const char *line_start = text;
+    for (const char *cursor = text; cursor < position; cursor++) {
+        if (*cursor == '\n') {
+            line++;
+            line_start = cursor + 1;
+        }
+    }
+    snprintf(error, error_size, "%s (%s: строка %d, столбец %d)", what, name, line,
+             (int)(position - line_start) + 1);
+}
+
+void matrix_text_fail(const char *text, const char *position, const char *name,
+                      const char *what) {
+    char error[MATRIX_TEXT_ERROR_MAX];
+    format_error(text, position, name, what, error, sizeof(error));
+    fprintf(stderr, "%s!\n", error);
+    exit(EXIT_FAILURE);
+}
+
+const char *matrix_parse_int(const char *begin, const char *end, int *value) {
+    const char *cursor = begin;
+    int negative = 0;
+    if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+        negative = *cursor == '-';
+        cursor++;
+    }
+    long long result = 0;
+    const char *digits = cursor;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        result = result * 10 + (*cursor++ - '0');
+        if (result > INT_MAX) {
+            return NULL;
+        }
+    }
+    if (cursor == digits || (cursor < end && !is_space(*cursor))) {
+        return NULL;
+    }
+    *value = negative ? -(int)result : (int)result;
+    return cursor;
+}
+
+/**
+ * @brief Пропускает пробельные символы
+ */
+static const char *skip_spaces(const char *cursor, const char *end) {
+    while (cursor < end && is_space(*cursor)) {
+        cursor++;
+    }
+    return cursor;
+}
+
+/**
+ * @brief Разбирает матрицу из текста, возвращая позицию и описание ошибки
+ * @param mat Результат (при ошибке не изменяется)
+ * @param position Позиция ошибки
+ * @param what Описание ошибки
+ * @return 0 при успехе, -1 при ошибке
+ */
+static int parse_text(const char *text, size_t length, Matrix *mat, const char **position,
+                      const char **what) {
+    const char *end = text + length;
+    int dims[2];
+    const char *cursor = text;
+    for (int iter = 0; iter < 2; iter++) {
+        cursor = skip_spaces(cursor, end);
+        const char *next = matrix_parse_int(cursor, end, &dims[iter]);
+        if (next == NULL || dims[iter] < 0) {
+            *position = cursor;
+            *what = "Ошибка чтения размеров матрицы";
+            return -1;
+        }
+        cursor = next;
+    }
+
+    /*
+     * Каждый элемент, кроме последнего, занимает хотя бы два символа (цифру и
+     * разделитель), поэтому размеры, которым не хватит текста, отвергаются до
+     * выделения памяти
+     */
+    const long long total = (long long)dims[0] * dims[1];
+    if (total > (long long)((size_t)(end - cursor) / 2 + 1)) {
+        *position = end;
+        *what = "Ошибка чтения матричных данных: недостаточно элементов";
+        return -1;
+    }
+    Matrix result = create_matrix(dims[0], dims[1]);
+    if (total == 0) {
+        *mat = result;
+        return 0;
+    }
+
+    /* Деление на части с границами на переводах строк */
+    const size_t body = (size_t)(end - cursor);
+    int parts = (int)(body / TEXT_PARSE_CHUNK_MIN);
+    int threads = matrix_get_num_threads();
+    if (parts > threads * 4) {
+        parts = threads * 4;
+    }
+    if (parts < 1) {
+        parts = 1;
+    }
+    TextChunk *chunks = (TextChunk *)calloc((size_t)parts, sizeof(TextChunk));
+    if (chunks == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для чтения матрицы!\n");
+        exit(EXIT_FAILURE);
+    }
+    const char *start = cursor;
+    for (int iter = 0; iter < parts; iter++) {
+        const char *stop = end;
+        if (iter + 1 < parts) {
+            stop = cursor + body * (size_t)(iter + 1) / (size_t)parts;
+            stop = stop < start ? start : stop;
+            const char *newline = (const char *)memchr(stop, '\n', (size_t)(end - stop));
+            if (newline != NULL) {
+                stop = newline + 1;
+            } else {
+                stop = token_end(stop, end);
+            }
+        }
+        chunks[iter].begin = start;
+        chunks[iter].end = stop;
+        start = stop;
+    }
+
+    TextJob job = {.chunks = chunks, .mat = result, .total = total};
+    parallel_for(parts, 1, count_task, &job);
+    long long first = 0;
+    for (int iter = 0; iter < parts; iter++) {
+        chunks[iter].first = first;
+        first += chunks[iter].tokens;
+    }
+    parallel_for(parts, 1, parse_task, &job);
+
+    const char *error = NULL;
+    for (int iter = 0; iter < parts && error == NULL; iter++) {
+        error = chunks[iter].error;
+    }
+    free(chunks);
+    if (error != NULL || first < total) {
+        free_matrix(result);
+        *position = error != NULL ? error : end;
+        *what = error != NULL ? "Ошибка чтения матричных данных"
+                              : "Ошибка чтения матричных данных: недостаточно элементов";
+        return -1;
+    }
+    *mat = result;
+    return 0;
+}
+
+Matrix matrix_parse_text(const char *text, size_t length, const char *name) {
+    Matrix mat;
+    const char *position = NULL;
+    const char *what = NULL;
+    if (parse_text(text, length, &mat, &position, &what) != 0) {
+        matrix_text_fail(text, position, name, what);
+    }
+    return mat;
+}
+
+int matrix_try_parse_text(const char *text, size_t length, const char *name, Matrix *mat,
+                          char *error, size_t error_size) {
+    const char *position = NULL;
+    const char *what = NULL;
+    if (parse_text(text, length, mat, &position, &what) != 0) {
+        format_error(text, position, name, what, error, error_size);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Читает поток целиком в буфер (для файлов, которые нельзя отобразить)
+ */
+static char *read_all(int fd, size_t *length) {
+    size_t capacity = 1 << 16;
+    size_t used = 0;
+    char *buffer = (char *)malloc(capacity);
+    while (buffer != NULL) {
+        if (used == capacity) {
+            char *grown = (char *)realloc(buffer, capacity * 2);
+            if (grown == NULL) {
+                free(buffer);
+                return NULL;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+        ssize_t count = read(fd, buffer + used, capacity - used);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            if (count < 0) {
+                free(buffer);
+                return NULL;
+            }
+            break;
+        }
+        used += (size_t)count;
+    }
+    *length = used;
+    return buffer;
+}
+
+int text_file_try_open(const char *filename, TextFile *file) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t length = (size_t)info.st_size;
+        void *text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (text != MAP_FAILED) {
+            close(fd);
+            posix_madvise(text, length, POSIX_MADV_SEQUENTIAL);
+            file->text = (const char *)text;
+            file->length = length;
+            file->mapped = 1;
+            return 0;
+        }
+    }
+
+    size_t length = 0;
+    char *text = read_all(fd, &length);
+    const int saved_errno = errno;
+    close(fd);
+    if (text == NULL) {
+        errno = saved_errno;
+        return -1;
+    }
+    file->text = text;
+    file->length = length;
+    file->mapped = 0;
+    return 0;
+}
+
+void text_file_open(const char *filename, TextFile *file) {
+    if (text_file_try_open(filename, file) != 0) {
+        perror("Невозможно прочитать файл матрицы!");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void text_file_close(TextFile *file) {
+    if (file->mapped) {
+        munmap((void *)file->text, file->length);
+    } else {
+        free((void *)file->text);
+    }
+    file->text = NULL;
+    file->length = 0;
+}
+
+Matrix load_matrix_from_text_file(const char *filename) {
+    TextFile file;
+    text_file_open(filename, &file);
+    Matrix mat = matrix_parse_text(file.text, file.length, filename);
+    text_file_close(&file);
+    return mat;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file matrix_text.h
+ * @brief Быстрый разбор текстового формата матриц
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Текстовый формат: два целых числа (строки и столбцы), затем элементы построчно,
+ * разделенные любыми пробельными символами. Файл читается целиком (отображением
+ * в память или блочным чтением), числа разбираются без scanf, а большие файлы
+ * делятся по границам строк на части, разбираемые параллельно.
+ */
+
+#ifndef MATRIX_TEXT_H
+#define MATRIX_TEXT_H
+
+#include <stddef.h>
+#include "../include/config.h"
+
+/**
+ * @brief Минимальный размер части текста в байтах при параллельном разборе
+ */
+#define TEXT_PARSE_CHUNK_MIN (256 * 1024)
+
+/**
+ * @brief Размер буфера для сообщения об ошибке разбора (см. matrix_try_parse_text)
+ */
+#define MATRIX_TEXT_ERROR_MAX 512
+
+/**
+ * @brief Разбирает число с плавающей точкой в диапазоне [begin, end)
+ * @param begin Начало числа (пробелы перед числом не пропускаются)
+ * @param end Конец доступного текста
+ * @param value Результат
+ * @return Указатель на символ после числа или NULL, если токен не является числом
+ *
+ * @note Число должно заканчиваться пробельным символом или концом текста.
+ * Результат округляется корректно (совпадает с strtod): до 19 значащих цифр при
+ * точно представимой мантиссе и небольшом порядке вычисляются одной точной
+ * операцией умножения или деления, остальные случаи (включая inf, nan и
+ * шестнадцатеричную запись) передаются strtod.
+ */
+const char *matrix_parse_double(const char *begin, const char *end, double *value);
+
+/**
+ * @brief Разбирает целое число в диапазоне [begin, end)
+ * @param begin Начало числа (пробелы перед числом не пропускаются)
+ * @param end Конец доступного текста
+ * @param value Результат
+ * @return Указатель на символ после числа или NULL, если токен не является целым числом
+ *         типа int
+ */
+const char *matrix_parse_int(const char *begin, const char *end, int *value);
+
+/**
+ * @brief Сообщает об ошибке с позицией в тексте и завершает программу с EXIT_FAILURE
+ * @param text Начало текста
+ * @param position Позиция ошибки
+ * @param name Имя источника
+ * @param what Описание ошибки
+ */
+void matrix_text_fail(const char *text, const char *position, const char *name,
+                      const char *what);
+
+/**
+ * @brief Разбирает матрицу из текста в памяти
+ * @param text Текст (не обязан заканчиваться нулевым символом)
+ * @param length Длина текста в байтах
+ * @param name Имя источника для сообщений об ошибках
+ * @return Новая матрица
+ * @warning При ошибке выводит строку и столбец неверного токена и завершает программу
+ *          с EXIT_FAILURE
+ */
+Matrix matrix_parse_text(const char *text, size_t length, const char *name);
+
+/**
+ * @brief Разбирает матрицу из текста, возвращая ошибку вместо завершения программы
+ * @param text Текст (не обязан заканчиваться нулевым символом)
+ * @param length Длина текста в байтах
+ * @param name Имя источника для сообщения об ошибке
+ * @param mat Результат (при ошибке не изменяется)
+ * @param error Буфер для сообщения со строкой и столбцом неверного токена
+ * @param error_size Размер буфера (достаточно MATRIX_TEXT_ERROR_MAX)
+ * @return 0 при успехе, -1 при ошибке
+ */
+int matrix_try_parse_text(const char *text, size_t length, const char *name, Matrix *mat,
+                          char *error, size_t error_size);
+
+/**
+ * @brief Содержимое текстового файла, прочитанное целиком
+ */
+typedef struct {
+    const char *text; /**< Текст (не заканчивается нулевым символом) */
+    size_t length;    /**< Длина текста в байтах */
+    int mapped;       /**< 1, если текст отображен в память, 0 - если прочитан в буфер */
+} TextFile;
+
+/**
+ * @brief Открывает текстовый файл для разбора
+ * @param filename Путь к файлу
+ * @param file Результат
+ * @note Обычные файлы отображаются в память, остальные (каналы, устройства)
+ *       читаются блоками в буфер
+ * @warning В случае ошибки чтения завершает программу с EXIT_FAILURE
+ */
+void text_file_open(const char *filename, TextFile *file);
+
+/**
+ * @brief Открывает текстовый файл для разбора без завершения программы при ошибке
+ * @param filename Путь к файлу
+ * @param file Результат
+ * @return 0 при успехе, -1 при ошибке открытия или чтения (причина в errno)
+ */
+int text_file_try_open(const char *filename, TextFile *file);
+
+/**
+ * @brief Освобождает текст, открытый text_file_open
+ * @param file Открытый файл
+ */
+void text_file_close(TextFile *file);
+
+/**
+ * @brief Загружает матрицу из текстового файла
+ * @param filename Путь к файлу
+ * @return Загруженная матрица
+ * @warning В случае ошибки чтения завершает программу с EXIT_FAILURE
+ */
+Matrix load_matrix_from_text_file(const char *filename);
+
+#endif
+
+/** @} */
@@ -0,0 +1,257 @@
+/**
+ * @file packed_matrix.c
+ * @brief Реализация операций с упакованными симметричными и треугольными матрицами
+ * @ingroup Matrix_Operations
+ *
+ * Произведения выполняются полосами по PACKED_PANEL_ROWS строк. Для SYRK полоса
+ * строк X умножается на Xᵀ до конца диагонального блока (Xᵀ задается перестановкой
+ * шагов, без копирования), и в результат переносится только нижний треугольник.
+ * Для произведения упакованной матрицы на плотную полоса строк разворачивается в
+ * плотный буфер только в пределах ненулевых столбцов и умножается через gemm_strided
+ * на соответствующие строки плотной матрицы.
+ */
+
+#include "packed_matrix.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gemm.h"
+#include "matrix_operations.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Смещение первого хранимого элемента строки row
+ */
+static size_t row_offset(PackedMatrix mat, int row) {
+    if (mat.kind == PACKED_UPPER) {
+        return (size_t)row * (2 * (size_t)mat.order - (size_t)row + 1) / 2;
+    }
+    return PACKED_SIZE(row);
+}
+
+/**
+ * @brief Номер столбца первого хранимого элемента строки row
+ */
+static int first_col(PackedMatrix mat, int row) {
+    return mat.kind == PACKED_UPPER ? row : 0;
+}
+
+/**
+ * @brief Число хранимых элементов строки row
+ */
+static int row_length(PackedMatrix mat, int row) {
+    return mat.kind == PACKED_UPPER ? mat.order - row : row + 1;
+}
+
+/**
+ * @brief Проверяет, что (row, col) лежит в хранимом треугольнике
+ */
+static int is_stored(PackedMatrix mat, int row, int col) {
+    return mat.kind == PACKED_UPPER ? col >= row : col <= row;
+}
+
+/**
+ * @brief Проверяет номера строки и столбца элемента
+ */
+static void require_position(PackedMatrix mat, int row, int col) {
+    if (row < 0 || row >= mat.order || col < 0 || col >= mat.order) {
+        fprintf(stderr, "Элемент (%d, %d) вне матрицы порядка %d!\n", row, col, mat.order);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Минимальное число строк в одной параллельной части
+ */
+static int rows_grain(int order) {
+    return order > 0 ? (PARALLEL_MIN_ELEMENTS + order - 1) / order : 1;
+}
+
+PackedMatrix create_packed_matrix(int order, PackedKind kind) {
+    if (order < 0 || (kind != PACKED_SYMMETRIC && kind != PACKED_LOWER && kind != PACKED_UPPER)) {
+        fprintf(stderr, "Недопустимые параметры упакованной матрицы!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    PackedMatrix mat = {.order = order, .kind = kind, .data = NULL};
+    const size_t count = PACKED_SIZE(order);
+    if (count == 0) {
+        return mat;
+    }
+    if (count > SIZE_MAX / sizeof(double) ||
+        posix_memalign((void **)&mat.data, MATRIX_ALIGNMENT, count * sizeof(double)) != 0) {
+        fprintf(stderr, "Ошибка выделения памяти под упакованную матрицу порядка %d!\n", order);
+        exit(EXIT_FAILURE);
+    }
+    memset(mat.data, 0, count * sizeof(double));
+    return mat;
+}
+
+void free_packed_matrix(PackedMatrix mat) {
+    free(mat.data);
+}
+
+double packed_matrix_get(PackedMatrix mat, int row, int col) {
+    require_position(mat, row, col);
+    if (!is_stored(mat, row, col)) {
+        if (mat.kind != PACKED_SYMMETRIC) {
+            return 0.0;
+        }
+        const int swap = row;
+        row = col;
+        col = swap;
+    }
+    return mat.data[row_offset(mat, row) + (size_t)(col - first_col(mat, row))];
+}
+
+void packed_matrix_set(PackedMatrix mat, int row, int col, double value) {
+    require_position(mat, row, col);
+    if (!is_stored(mat, row, col)) {
+        if (mat.kind != PACKED_SYMMETRIC) {
+            fprintf(stderr, "Элемент (%d, %d) вне хранимого треугольника матрицы!\n", row, col);
+            exit(EXIT_FAILURE);
+        }
+        const int swap = row;
+        row = col;
+        col = swap;
+    }
+    mat.data[row_offset(mat, row) + (size_t)(col - first_col(mat, row))] = value;
+}
+
+/**
+ * @brief Параметры преобразования между плотной и упакованной матрицами
+ */
+typedef struct {
+    Matrix dense;        /**< Плотная матрица */
+    PackedMatrix packed; /**< Упакованная матрица */
+} PackedJob;
+
+/**
+ * @brief Задача пула: переносит хранимый треугольник строк [begin, end) в упакованную матрицу
+ */
+static void pack_task(void *ctx, int begin, int end) {
+    const PackedJob *job = (const PackedJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        memcpy(job->packed.data + row_offset(job->packed, iter),
+               MATRIX_ROW(job->dense, iter) + first_col(job->packed, iter),
+               (size_t)row_length(job->packed, iter) * sizeof(double));
+    }
+}
+
+/**
+ * @brief Задача пула: заполняет строки [begin, end) плотной матрицы
+ *
+ * Отраженная часть строки симметричной матрицы - это столбец хранимого треугольника,
+ * поэтому она собирается из элементов с шагом, растущим вместе с номером строки.
+ */
+static void unpack_task(void *ctx, int begin, int end) {
+    const PackedJob *job = (const PackedJob *)ctx;
+    const PackedMatrix mat = job->packed;
+    for (int iter = begin; iter < end; iter++) {
+        double *row = MATRIX_ROW(job->dense, iter);
+        memcpy(row + first_col(mat, iter), mat.data + row_offset(mat, iter),
+               (size_t)row_length(mat, iter) * sizeof(double));
+        if (mat.kind == PACKED_SYMMETRIC) {
+            for (int iter_2 = iter + 1; iter_2 < mat.order; iter_2++) {
+                row[iter_2] = mat.data[PACKED_SIZE(iter_2) + (size_t)iter];
+            }
+        }
+    }
+}
+
+PackedMatrix dense_to_packed(Matrix mat, PackedKind kind) {
+    if (mat.rows != mat.cols) {
+        fprintf(stderr, "Упаковать можно только квадратную матрицу!\n");
+        exit(EXIT_FAILURE);
+    }
+    PackedJob job = {.dense = mat, .packed = create_packed_matrix(mat.rows, kind)};
+    parallel_for(mat.rows, rows_grain(mat.rows), pack_task, &job);
+    return job.packed;
+}
+
+Matrix packed_to_dense(PackedMatrix mat) {
+    PackedJob job = {.dense = create_matrix(mat.order, mat.order), .packed = mat};
+    parallel_for(mat.order, rows_grain(mat.order), unpack_task, &job);
+    return job.dense;
+}
+
+PackedMatrix syrk_matrix(Matrix mat) {
+    PackedMatrix result = create_packed_matrix(mat.rows, PACKED_SYMMETRIC);
+    if (mat.rows == 0 || mat.cols == 0) {
+        return result;
+    }
+
+    const int height = mat.rows < PACKED_PANEL_ROWS ? mat.rows : PACKED_PANEL_ROWS;
+    Matrix panel = create_matrix(height, mat.rows);
+    for (int row0 = 0; row0 < mat.rows; row0 += PACKED_PANEL_ROWS) {
+        const int rows = mat.rows - row0 < PACKED_PANEL_ROWS ? mat.rows - row0 : PACKED_PANEL_ROWS;
+        // Полоса X[row0:row0+rows, :]·Xᵀ[:, 0:row0+rows]: Xᵀ - та же X с переставленными шагами
+        gemm_strided(rows, row0 + rows, mat.cols, 1.0, MATRIX_ROW(mat, row0), mat.stride, 1,
+                     mat.data, 1, mat.stride, 0.0, panel.data, panel.stride, 1);
+        for (int iter = 0; iter < rows; iter++) {
+            memcpy(result.data + PACKED_SIZE(row0 + iter), MATRIX_ROW(panel, iter),
+                   (size_t)(row0 + iter + 1) * sizeof(double));
+        }
+    }
+    free_matrix(panel);
+    return result;
+}
+
+/**
+ * @brief Разворачивает строки [row0, row0 + rows) упакованной матрицы в плотный буфер
+ * @param mat Упакованная матрица
+ * @param row0 Первая строка полосы
+ * @param rows Число строк полосы
+ * @param col0 Столбец матрицы, соответствующий столбцу 0 буфера
+ * @param width Число столбцов буфера
+ * @param panel Буфер (rows×width); нулевой треугольник треугольной матрицы заполняется нулями
+ */
+static void unpack_panel(PackedMatrix mat, int row0, int rows, int col0, int width,
+                         Matrix panel) {
+    for (int iter = 0; iter < rows; iter++) {
+        const int row = row0 + iter;
+        double *out = MATRIX_ROW(panel, iter);
+        memset(out, 0, (size_t)width * sizeof(double));
+        memcpy(out + first_col(mat, row) - col0, mat.data + row_offset(mat, row),
+               (size_t)row_length(mat, row) * sizeof(double));
+    }
+    if (mat.kind != PACKED_SYMMETRIC) {
+        return;
+    }
+    // Элементы над диагональью: строка iter_2 хранимого треугольника дает столбец полосы
+    for (int iter_2 = row0 + 1; iter_2 < mat.order; iter_2++) {
+        const double *source = mat.data + PACKED_SIZE(iter_2);
+        const int last = iter_2 < row0 + rows ? iter_2 : row0 + rows;
+        for (int iter = row0; iter < last; iter++) {
+            MATRIX_AT(panel, iter - row0, iter_2) = source[iter];
+        }
+    }
+}
+
+Matrix multiply_packed_dense(PackedMatrix mat1, Matrix mat2) {
+    if (mat1.order != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    Matrix result = create_matrix(mat1.order, mat2.cols);
+    if (mat1.order == 0 || mat2.cols == 0) {
+        return result;
+    }
+
+    const int height = mat1.order < PACKED_PANEL_ROWS ? mat1.order : PACKED_PANEL_ROWS;
+    Matrix panel = create_matrix(height, mat1.order);
+    for (int row0 = 0; row0 < mat1.order; row0 += PACKED_PANEL_ROWS) {
+        const int rows =
+            mat1.order - row0 < PACKED_PANEL_ROWS ? mat1.order - row0 : PACKED_PANEL_ROWS;
+        // Ненулевые столбцы полосы: [0, row0 + rows) нижней, [row0, n) верхней, все симметричной
+        const int col0 = mat1.kind == PACKED_UPPER ? row0 : 0;
+        const int col_end = mat1.kind == PACKED_LOWER ? row0 + rows : mat1.order;
+        unpack_panel(mat1, row0, rows, col0, col_end - col0, panel);
+        gemm_strided(rows, mat2.cols, col_end - col0, 1.0, panel.data, panel.stride, 1,
+                     MATRIX_ROW(mat2, col0), mat2.stride, 1, 0.0, MATRIX_ROW(result, row0),
+                     result.stride, 1);
+    }
+    free_matrix(panel);
+    return result;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file packed_matrix.h
+ * @brief Симметричные и треугольные матрицы в упакованном хранении
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Упакованная матрица (PackedMatrix, config.h) хранит только один треугольник,
+ * поэтому занимает вдвое меньше памяти, чем плотная. Произведение X·Xᵀ (SYRK)
+ * вычисляет только нижний треугольник результата и не создает транспонированную
+ * копию X, а произведение треугольной матрицы на плотную не читает и не умножает
+ * нулевой треугольник. Обе операции выполняются полосами строк через gemm_strided.
+ * Ошибки обрабатываются так же, как в matrix_operations.h.
+ */
+
+#ifndef MATRIX_PACKED_MATRIX_H
+#define MATRIX_PACKED_MATRIX_H
+
+#include "../include/config.h"
+
+/**
+ * @brief Высота полосы строк, на которые делятся произведения упакованных матриц
+ *
+ * Лишняя работа на диагональных блоках составляет около PACKED_PANEL_ROWS/n от
+ * полезной, а более узкие полосы уменьшают эффективность gemm_strided.
+ */
+#define PACKED_PANEL_ROWS 128
+
+/**
+ * @brief Создает упакованную матрицу, заполненную нулями
+ * @param order Порядок матрицы
+ * @param kind Вид матрицы
+ * @return Новая матрица
+ * @warning При недопустимых параметрах или нехватке памяти завершает программу с EXIT_FAILURE
+ */
+PackedMatrix create_packed_matrix(int order, PackedKind kind);
+
+/**
+ * @brief Освобождает память упакованной матрицы
+ * @param mat Матрица для освобождения
+ */
+void free_packed_matrix(PackedMatrix mat);
+
+/**
+ * @brief Возвращает элемент (row, col) упакованной матрицы
+ * @param mat Матрица
+ * @param row Номер строки
+ * @param col Номер столбца
+ * @return Значение элемента: для симметричной матрицы элемент над диагональю берется
+ *         из нижнего треугольника, для треугольной вне хранимого треугольника равен нулю
+ */
+double packed_matrix_get(PackedMatrix mat, int row, int col);
+
+/**
+ * @brief Записывает элемент (row, col) упакованной матрицы
+ * @param mat Матрица
+ * @param row Номер строки
+ * @param col Номер столбца
+ * @param value Значение (для симметричной матрицы задает и элемент (col, row))
+ * @warning Для элемента вне хранимого треугольника треугольной матрицы завершает
+ *          программу с EXIT_FAILURE
+ */
+void packed_matrix_set(PackedMatrix mat, int row, int col, double value);
+
+/**
+ * @brief Упаковывает квадратную плотную матрицу
+ * @param mat Плотная квадратная матрица
+ * @param kind Вид результата
+ * @return Упакованная матрица из треугольника mat, соответствующего kind
+ * @note Для PACKED_SYMMETRIC берется нижний треугольник; симметричность mat не проверяется
+ */
+PackedMatrix dense_to_packed(Matrix mat, PackedKind kind);
+
+/**
+ * @brief Разворачивает упакованную матрицу в плотную
+ * @param mat Упакованная матрица
+ * @return Новая плотная матрица: симметричная дополняется отражением, треугольная - нулями
+ */
+Matrix packed_to_dense(PackedMatrix mat);
+
+/**
+ * @brief Вычисляет произведение X·Xᵀ (матрицу Грама строк X)
+ * @param mat Матрица X размера m×k
+ * @return Симметричная упакованная матрица порядка m
+ * @note Вычисляется только нижний треугольник: примерно m²·k операций вместо 2·m²·k
+ *       у transpose_matrix и multiply_matrices, без копии Xᵀ
+ */
+PackedMatrix syrk_matrix(Matrix mat);
+
+/**
+ * @brief Умножает упакованную матрицу на плотную
+ * @param mat1 Упакованная матрица порядка n
+ * @param mat2 Плотная матрица с n строками
+ * @return Новая плотная матрица произведения
+ * @note Для треугольной mat1 нулевой треугольник не участвует в умножении, кроме
+ *       диагональных блоков полос
+ */
+Matrix multiply_packed_dense(PackedMatrix mat1, Matrix mat2);
+
+#endif
+
+/** @} */
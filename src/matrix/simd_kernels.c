@@ -0,0 +1,252 @@
+/**
+ * @file simd_kernels.c
+ * @brief Скалярные и векторные (SSE2/AVX2/AVX-512) ядра и их выбор во время выполнения
+ * @ingroup Matrix_Operations
+ *
+ * Векторные варианты компилируются с атрибутом target, поэтому сборка не требует
+ * -march: один исполняемый файл использует самый широкий набор инструкций,
+ * доступный на конкретной машине.
+ */
+
+#include "simd_kernels.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+/* ---------------------------------------------------------------------------------------------
+ * Ядра double: шаблон simd_template.h; скалярные ядра - векторы из одного элемента
+ * ------------------------------------------------------------------------------------------- */
+
+#define SIMD_T double
+#define SIMD_INDEX_T long long
+#define SIMD_NAME(name) name##_scalar
+#define SIMD_ATTR
+#define SIMD_BYTES 8
+#define SIMD_MR 4
+#define SIMD_NR_VECTORS 4
+#define SIMD_NB 4
+#define SIMD_LEVEL SIMD_SCALAR
+#define SIMD_LEVEL_NAME "scalar"
+#define SIMD_TABLE_T SimdKernels
+#include "simd_template.h"
+
+#if SIMD_X86
+
+/*
+ * Векторные уровни - тот же шаблон с векторами ширины регистра. При -std=c99 GCC
+ * не объединяет умножение и сложение, поэтому для уровней с FMA объединение
+ * включается атрибутом, и микроядро GEMM выполняет vfmadd.
+ */
+
+/* SSE2: 2 элемента double на регистр, микроблок 4×4 (8 аккумуляторов) */
+#define SIMD_T double
+#define SIMD_INDEX_T long long
+#define SIMD_NAME(name) name##_sse2
+#define SIMD_ATTR __attribute__((target("sse2")))
+#define SIMD_BYTES 16
+#define SIMD_MR 4
+#define SIMD_NR_VECTORS 2
+#define SIMD_NB 4
+#define SIMD_LEVEL SIMD_SSE2
+#define SIMD_LEVEL_NAME "sse2"
+#define SIMD_TABLE_T SimdKernels
+#include "simd_template.h"
+
+/* AVX2 + FMA: 4 элемента на регистр, микроблок 6×8 (12 аккумуляторов) */
+#define SIMD_T double
+#define SIMD_INDEX_T long long
+#define SIMD_NAME(name) name##_avx2
+#define SIMD_ATTR __attribute__((target("avx2,fma"), optimize("fp-contract=fast")))
+#define SIMD_BYTES 32
+#define SIMD_MR 6
+#define SIMD_NR_VECTORS 2
+#define SIMD_NB 4
+#define SIMD_LEVEL SIMD_AVX2
+#define SIMD_LEVEL_NAME "avx2"
+#define SIMD_TABLE_T SimdKernels
+#include "simd_template.h"
+
+/* AVX-512F: 8 элементов на регистр, микроблок 8×16 (16 аккумуляторов) */
+#define SIMD_T double
+#define SIMD_INDEX_T long long
+#define SIMD_NAME(name) name##_avx512
+#define SIMD_ATTR __attribute__((target("avx512f"), optimize("fp-contract=fast")))
+#define SIMD_BYTES 64
+#define SIMD_MR 8
+#define SIMD_NR_VECTORS 2
+#define SIMD_NB 8
+#define SIMD_LEVEL SIMD_AVX512
+#define SIMD_LEVEL_NAME "avx512"
+#define SIMD_TABLE_T SimdKernels
+#include "simd_template.h"
+
+#endif /* SIMD_X86 */
+
+/* ---------------------------------------------------------------------------------------------
+ * Ядра float: тот же шаблон с вдвое большим числом элементов в векторе
+ * ------------------------------------------------------------------------------------------- */
+
+#define SIMD_T float
+#define SIMD_INDEX_T int
+#define SIMD_NAME(name) name##_scalar_f
+#define SIMD_ATTR
+#define SIMD_BYTES 4
+#define SIMD_MR 4
+#define SIMD_NR_VECTORS 4
+#define SIMD_NB 4
+#define SIMD_LEVEL SIMD_SCALAR
+#define SIMD_LEVEL_NAME "scalar"
+#define SIMD_TABLE_T SimdKernelsF
+#include "simd_template.h"
+
+#if SIMD_X86
+
+#define SIMD_T float
+#define SIMD_INDEX_T int
+#define SIMD_NAME(name) name##_sse2_f
+#define SIMD_ATTR __attribute__((target("sse2")))
+#define SIMD_BYTES 16
+#define SIMD_MR 4
+#define SIMD_NR_VECTORS 2
+#define SIMD_NB 8
+#define SIMD_LEVEL SIMD_SSE2
+#define SIMD_LEVEL_NAME "sse2"
+#define SIMD_TABLE_T SimdKernelsF
+#include "simd_template.h"
+
+#define SIMD_T float
+#define SIMD_INDEX_T int
+#define SIMD_NAME(name) name##_avx2_f
+#define SIMD_ATTR __attribute__((target("avx2,fma"), optimize("fp-contract=fast")))
+#define SIMD_BYTES 32
+#define SIMD_MR 6
+#define SIMD_NR_VECTORS 2
+#define SIMD_NB 8
+#define SIMD_LEVEL SIMD_AVX2
+#define SIMD_LEVEL_NAME "avx2"
+#define SIMD_TABLE_T SimdKernelsF
+#include "simd_template.h"
+
+#define SIMD_T float
+#define SIMD_INDEX_T int
+#define SIMD_NAME(name) name##_avx512_f
+#define SIMD_ATTR __attribute__((target("avx512f"), optimize("fp-contract=fast")))
+#define SIMD_BYTES 64
+#define SIMD_MR 8
+#define SIMD_NR_VECTORS 2
+#define SIMD_NB 16
+#define SIMD_LEVEL SIMD_AVX512
+#define SIMD_LEVEL_NAME "avx512"
+#define SIMD_TABLE_T SimdKernelsF
+#include "simd_template.h"
+
+#endif /* SIMD_X86 */
+
+/* ---------------------------------------------------------------------------------------------
+ * Выбор ядер
+ * ------------------------------------------------------------------------------------------- */
+
+static const SimdKernels *active_kernels = NULL;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+SimdLevel simd_detect_level(void) {
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SIMD_SSE2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+/**
+ * @brief Возвращает таблицу ядер для заданного уровня
+ */
+static const SimdKernels *kernels_for(SimdLevel level) {
+#if SIMD_X86
+    switch (level) {
+    case SIMD_AVX512:
+        return &kernels_avx512;
+    case SIMD_AVX2:
+        return &kernels_avx2;
+    case SIMD_SSE2:
+        return &kernels_sse2;
+    default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return &kernels_scalar;
+}
+
+/**
+ * @brief Устанавливает активные ядра, понижая уровень до поддерживаемого
+ */
+static void apply_level(SimdLevel level) {
+    SimdLevel supported = simd_detect_level();
+    if (level > supported) {
+        level = supported;
+    }
+    active_kernels = kernels_for(level);
+}
+
+/**
+ * @brief Выбирает ядра при первом обращении с учетом MATRIX_SIMD
+ */
+static void select_kernels(void) {
+    SimdLevel level = SIMD_AVX512;
+    const char *env = getenv("MATRIX_SIMD");
+    if (env != NULL) {
+        if (strcmp(env, "scalar") == 0) {
+            level = SIMD_SCALAR;
+        } else if (strcmp(env, "sse2") == 0) {
+            level = SIMD_SSE2;
+        } else if (strcmp(env, "avx2") == 0) {
+            level = SIMD_AVX2;
+        } else if (strcmp(env, "avx512") != 0) {
+            fprintf(stderr, "Неизвестное значение MATRIX_SIMD: %s\n", env);
+        }
+    }
+    apply_level(level);
+}
+
+const SimdKernels *simd_kernels(void) {
+    pthread_once(&kernels_once, select_kernels);
+    return active_kernels;
+}
+
+const SimdKernelsF *simd_kernels_f(void) {
+#if SIMD_X86
+    switch (simd_kernels()->level) {
+    case SIMD_AVX512:
+        return &kernels_avx512_f;
+    case SIMD_AVX2:
+        return &kernels_avx2_f;
+    case SIMD_SSE2:
+        return &kernels_sse2_f;
+    default:
+        break;
+    }
+#endif
+    return &kernels_scalar_f;
+}
+
+SimdLevel simd_set_level(SimdLevel level) {
+    pthread_once(&kernels_once, select_kernels);
+    apply_level(level);
+    return active_kernels->level;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file simd_kernels.h
+ * @brief Векторные ядра операций над строками матриц с выбором по возможностям процессора
+ * @ingroup Matrix_Operations
+ * @{
+ */
+
+#ifndef MATRIX_SIMD_KERNELS_H
+#define MATRIX_SIMD_KERNELS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Максимальная высота микроблока GEMM среди всех вариантов ядер
+ */
+#define SIMD_GEMM_MR_MAX 8
+
+/**
+ * @brief Максимальная ширина микроблока GEMM среди всех вариантов ядер
+ */
+#define SIMD_GEMM_NR_MAX 16
+
+/**
+ * @brief Максимальная ширина микроблока GEMM среди ядер float
+ */
+#define SIMD_GEMM_NR_MAX_F 32
+
+/**
+ * @brief Максимальная сторона блока ядра транспонирования среди всех вариантов ядер
+ */
+#define SIMD_TRANSPOSE_NB_MAX 8
+
+/**
+ * @brief Уровень набора векторных инструкций
+ */
+typedef enum {
+    SIMD_SCALAR = 0, /**< Переносимый скалярный код (эталон для проверки) */
+    SIMD_SSE2,       /**< SSE2, 128 бит */
+    SIMD_AVX2,       /**< AVX2 + FMA, 256 бит */
+    SIMD_AVX512      /**< AVX-512F, 512 бит */
+} SimdLevel;
+
+/**
+ * @brief Таблица ядер для одного уровня инструкций
+ */
+typedef struct {
+    SimdLevel level;  /**< Уровень инструкций */
+    const char *name; /**< Название уровня для диагностики */
+    int gemm_mr;      /**< Высота микроблока GEMM */
+    int gemm_nr;      /**< Ширина микроблока GEMM */
+    int transpose_nb; /**< Сторона блока ядра транспонирования */
+
+    /** out[i] = a[i] + b[i], i < n */
+    void (*add)(int n, const double *a, const double *b, double *out);
+    /** out[i] = a[i] - b[i], i < n */
+    void (*sub)(int n, const double *a, const double *b, double *out);
+    /** out[i] = src[i], i < n */
+    void (*copy)(int n, const double *src, double *out);
+    /**
+     * Микроядро GEMM: ab = Ã·B̃ для упакованных панелей глубины kc.
+     * Ã содержит по gemm_mr элементов на шаг, B̃ - по gemm_nr,
+     * ab - блок gemm_mr×gemm_nr, хранящийся построчно.
+     */
+    void (*gemm_kernel)(int kc, const double *a, const double *b, double *ab);
+    /**
+     * Транспонирование блока transpose_nb×transpose_nb в регистрах:
+     * dst[j * ldd + i] = src[i * lds + j]. Блоки не должны пересекаться.
+     */
+    void (*transpose_kernel)(const double *src, ptrdiff_t lds, double *dst, ptrdiff_t ldd);
+} SimdKernels;
+
+/**
+ * @brief Таблица ядер float для одного уровня инструкций
+ *
+ * Поля совпадают с SimdKernels; ядра всех уровней порождаются из одного
+ * шаблона (simd_template.h), как и скалярные ядра double.
+ */
+typedef struct {
+    SimdLevel level;  /**< Уровень инструкций */
+    const char *name; /**< Название уровня для диагностики */
+    int gemm_mr;      /**< Высота микроблока GEMM */
+    int gemm_nr;      /**< Ширина микроблока GEMM */
+    int transpose_nb; /**< Сторона блока ядра транспонирования */
+
+    /** out[i] = a[i] + b[i], i < n */
+    void (*add)(int n, const float *a, const float *b, float *out);
+    /** out[i] = a[i] - b[i], i < n */
+    void (*sub)(int n, const float *a, const float *b, float *out);
+    /** out[i] = src[i], i < n */
+    void (*copy)(int n, const float *src, float *out);
+    /** Микроядро GEMM для упакованных панелей (см. SimdKernels::gemm_kernel) */
+    void (*gemm_kernel)(int kc, const float *a, const float *b, float *ab);
+    /** Транспонирование блока transpose_nb×transpose_nb */
+    void (*transpose_kernel)(const float *src, ptrdiff_t lds, float *dst, ptrdiff_t ldd);
+} SimdKernelsF;
+
+/**
+ * @brief Возвращает активную таблицу ядер
+ * @return Таблица, выбранная при первом вызове
+ *
+ * @note При первом вызове определяется максимальный поддерживаемый процессором уровень.
+ * Переменная окружения MATRIX_SIMD (scalar, sse2, avx2, avx512) может понизить его.
+ */
+const SimdKernels *simd_kernels(void);
+
+/**
+ * @brief Возвращает активную таблицу ядер float
+ * @return Таблица того же уровня инструкций, что и simd_kernels()
+ */
+const SimdKernelsF *simd_kernels_f(void);
+
+/**
+ * @brief Принудительно выбирает уровень инструкций
+ * @param level Желаемый уровень
+ * @return Фактически установленный уровень (не выше поддерживаемого процессором)
+ * @warning Не должна вызываться одновременно с выполнением операций
+ */
+SimdLevel simd_set_level(SimdLevel level);
+
+/**
+ * @brief Определяет максимальный уровень инструкций, поддерживаемый процессором
+ * @return Уровень инструкций
+ */
+SimdLevel simd_detect_level(void);
+
+#endif
+
+/** @} */
@@ -0,0 +1,201 @@
+/**
+ * @file simd_template.h
+ * @brief Шаблон переносимых векторных ядер для одного типа элементов и уровня инструкций
+ * @ingroup Matrix_Operations
+ *
+ * Файл не имеет защиты от повторного включения: каждое включение порождает
+ * статические ядра и таблицу SIMD_TABLE_T для параметров, заданных макросами:
+ * - SIMD_T - тип элементов (double или float)
+ * - SIMD_INDEX_T - целый тип того же размера (элемент маски перестановки)
+ * - SIMD_NAME(name) - имя функции или таблицы этого экземпляра
+ * - SIMD_ATTR - атрибут target уровня инструкций (пусто для скалярного кода)
+ * - SIMD_BYTES - ширина вектора в байтах (sizeof(SIMD_T) для скалярного кода)
+ * - SIMD_MR, SIMD_NR_VECTORS - высота микроблока GEMM и его ширина в векторах
+ * - SIMD_NB - сторона блока ядра транспонирования, кратная числу элементов в векторе
+ * - SIMD_LEVEL, SIMD_LEVEL_NAME, SIMD_TABLE_T - уровень, его название и тип таблицы
+ *
+ * Векторы задаются расширением GCC vector_size, поэтому один исходный текст дает
+ * ядра любой ширины: число элементов в векторе для float вдвое больше, чем для
+ * double. В конце файла все параметры отменяются.
+ */
+
+/** Вектор экземпляра; выравнивание понижено до элемента для невыровненного доступа */
+typedef SIMD_T SIMD_NAME(vector)
+    __attribute__((vector_size(SIMD_BYTES), aligned(sizeof(SIMD_T)), may_alias));
+
+/** Маска перестановки __builtin_shuffle: целые числа размера элемента */
+typedef SIMD_INDEX_T SIMD_NAME(index)
+    __attribute__((vector_size(SIMD_BYTES), aligned(sizeof(SIMD_INDEX_T)), may_alias));
+
+/** Число элементов в векторе */
+#define SIMD_LANES ((int)(SIMD_BYTES / sizeof(SIMD_T)))
+
+/** Ширина микроблока GEMM в элементах */
+#define SIMD_NR (SIMD_LANES * SIMD_NR_VECTORS)
+
+SIMD_ATTR static void SIMD_NAME(add)(int n, const SIMD_T *a, const SIMD_T *b, SIMD_T *out) {
+    int iter = 0;
+    for (; iter + SIMD_LANES <= n; iter += SIMD_LANES) {
+        *(SIMD_NAME(vector) *)(out + iter) =
+            *(const SIMD_NAME(vector) *)(a + iter) + *(const SIMD_NAME(vector) *)(b + iter);
+    }
+    for (; iter < n; iter++) {
+        out[iter] = a[iter] + b[iter];
+    }
+}
+
+SIMD_ATTR static void SIMD_NAME(sub)(int n, const SIMD_T *a, const SIMD_T *b, SIMD_T *out) {
+    int iter = 0;
+    for (; iter + SIMD_LANES <= n; iter += SIMD_LANES) {
+        *(SIMD_NAME(vector) *)(out + iter) =
+            *(const SIMD_NAME(vector) *)(a + iter) - *(const SIMD_NAME(vector) *)(b + iter);
+    }
+    for (; iter < n; iter++) {
+        out[iter] = a[iter] - b[iter];
+    }
+}
+
+static void SIMD_NAME(copy)(int n, const SIMD_T *src, SIMD_T *out) {
+    memmove(out, src, (size_t)n * sizeof(SIMD_T));
+}
+
+/*
+ * Микроблок SIMD_MR×SIMD_NR: аккумуляторы - SIMD_MR·SIMD_NR_VECTORS векторов,
+ * на каждом шаге строка панели B загружается один раз, элемент A размножается.
+ */
+SIMD_ATTR static void SIMD_NAME(gemm_kernel)(int kc, const SIMD_T *a, const SIMD_T *b,
+                                             SIMD_T *ab) {
+    SIMD_NAME(vector) acc[SIMD_MR][SIMD_NR_VECTORS];
+#pragma GCC unroll 8
+    for (int iter = 0; iter < SIMD_MR; iter++) {
+#pragma GCC unroll 4
+        for (int iter_2 = 0; iter_2 < SIMD_NR_VECTORS; iter_2++) {
+            acc[iter][iter_2] = (SIMD_NAME(vector)){0};
+        }
+    }
+    for (int iter = 0; iter < kc; iter++) {
+        SIMD_NAME(vector) row[SIMD_NR_VECTORS];
+#pragma GCC unroll 4
+        for (int iter_2 = 0; iter_2 < SIMD_NR_VECTORS; iter_2++) {
+            row[iter_2] = *(const SIMD_NAME(vector) *)(b + iter_2 * SIMD_LANES);
+        }
+#pragma GCC unroll 8
+        for (int iter_2 = 0; iter_2 < SIMD_MR; iter_2++) {
+            const SIMD_T a_val = a[iter_2];
+#pragma GCC unroll 4
+            for (int iter_3 = 0; iter_3 < SIMD_NR_VECTORS; iter_3++) {
+                acc[iter_2][iter_3] += row[iter_3] * a_val;
+            }
+        }
+        a += SIMD_MR;
+        b += SIMD_NR;
+    }
+#pragma GCC unroll 8
+    for (int iter = 0; iter < SIMD_MR; iter++) {
+#pragma GCC unroll 4
+        for (int iter_2 = 0; iter_2 < SIMD_NR_VECTORS; iter_2++) {
+            *(SIMD_NAME(vector) *)(ab + iter * SIMD_NR + iter_2 * SIMD_LANES) = acc[iter][iter_2];
+        }
+    }
+}
+
+/*
+ * Маски шагов транспонирования: на шаге step строки row и row + step обмениваются
+ * внедиагональными частями по step элементов. Строка с индексом 0 (low) оставляет
+ * элементы lane без бита step и берет на их место элементы второй строки; маска high
+ * - наоборот. Таблицы рассчитаны на 16 элементов, лишние элементы не используются.
+ */
+#define SIMD_LOW(step, lane) (((lane) & (step)) ? SIMD_LANES + (lane) - (step) : (lane))
+#define SIMD_HIGH(step, lane) (((lane) & (step)) ? SIMD_LANES + (lane) : (lane) + (step))
+#define SIMD_MASK(fn, step)                                                                  \
+    {fn(step, 0),  fn(step, 1),  fn(step, 2),  fn(step, 3),  fn(step, 4),  fn(step, 5),      \
+     fn(step, 6),  fn(step, 7),  fn(step, 8),  fn(step, 9),  fn(step, 10), fn(step, 11),     \
+     fn(step, 12), fn(step, 13), fn(step, 14), fn(step, 15)}
+
+static const SIMD_INDEX_T SIMD_NAME(shuffle_masks)[4][2][16] = {
+    {SIMD_MASK(SIMD_LOW, 1), SIMD_MASK(SIMD_HIGH, 1)},
+    {SIMD_MASK(SIMD_LOW, 2), SIMD_MASK(SIMD_HIGH, 2)},
+    {SIMD_MASK(SIMD_LOW, 4), SIMD_MASK(SIMD_HIGH, 4)},
+    {SIMD_MASK(SIMD_LOW, 8), SIMD_MASK(SIMD_HIGH, 8)},
+};
+
+#undef SIMD_MASK
+#undef SIMD_HIGH
+#undef SIMD_LOW
+
+/*
+ * Блок SIMD_NB×SIMD_NB транспонируется блоками SIMD_LANES×SIMD_LANES в регистрах:
+ * после log2(SIMD_LANES) шагов обмена (__builtin_shuffle двух векторов) блок
+ * транспонирован. Маски - константы, поэтому перестановки компилируются в
+ * unpack/shuffle/permute уровня инструкций. Скалярный экземпляр копирует поэлементно.
+ */
+SIMD_ATTR static void SIMD_NAME(transpose_kernel)(const SIMD_T *src, ptrdiff_t lds, SIMD_T *dst,
+                                                  ptrdiff_t ldd) {
+    if (SIMD_LANES == 1) {
+#pragma GCC unroll 16
+        for (int iter = 0; iter < SIMD_NB; iter++) {
+#pragma GCC unroll 16
+            for (int iter_2 = 0; iter_2 < SIMD_NB; iter_2++) {
+                dst[iter_2 * ldd + iter] = src[iter * lds + iter_2];
+            }
+        }
+        return;
+    }
+#pragma GCC unroll 4
+    for (int iter = 0; iter < SIMD_NB; iter += SIMD_LANES) {
+#pragma GCC unroll 4
+        for (int iter_2 = 0; iter_2 < SIMD_NB; iter_2 += SIMD_LANES) {
+            SIMD_NAME(vector) rows[SIMD_LANES];
+#pragma GCC unroll 16
+            for (int iter_3 = 0; iter_3 < SIMD_LANES; iter_3++) {
+                rows[iter_3] = *(const SIMD_NAME(vector) *)(src + (iter + iter_3) * lds + iter_2);
+            }
+#pragma GCC unroll 4
+            for (int level = 0; level < __builtin_ctz(SIMD_LANES); level++) {
+                const int step = 1 << level;
+                const SIMD_INDEX_T(*masks)[16] = SIMD_NAME(shuffle_masks)[level];
+                const SIMD_NAME(index) low = *(const SIMD_NAME(index) *)masks[0];
+                const SIMD_NAME(index) high = *(const SIMD_NAME(index) *)masks[1];
+#pragma GCC unroll 16
+                for (int row = 0; row < SIMD_LANES; row++) {
+                    if ((row & step) == 0) {
+                        const SIMD_NAME(vector) upper = rows[row];
+                        rows[row] = __builtin_shuffle(upper, rows[row + step], low);
+                        rows[row + step] = __builtin_shuffle(upper, rows[row + step], high);
+                    }
+                }
+            }
+#pragma GCC unroll 16
+            for (int iter_3 = 0; iter_3 < SIMD_LANES; iter_3++) {
+                *(SIMD_NAME(vector) *)(dst + (iter_2 + iter_3) * ldd + iter) = rows[iter_3];
+            }
+        }
+    }
+}
+
+static const SIMD_TABLE_T SIMD_NAME(kernels) = {
+    .level = SIMD_LEVEL,
+    .name = SIMD_LEVEL_NAME,
+    .gemm_mr = SIMD_MR,
+    .gemm_nr = SIMD_NR,
+    .transpose_nb = SIMD_NB,
+    .add = SIMD_NAME(add),
+    .sub = SIMD_NAME(sub),
+    .copy = SIMD_NAME(copy),
+    .gemm_kernel = SIMD_NAME(gemm_kernel),
+    .transpose_kernel = SIMD_NAME(transpose_kernel),
+};
+
+#undef SIMD_NR
+#undef SIMD_LANES
+#undef SIMD_T
+#undef SIMD_INDEX_T
+#undef SIMD_NAME
+#undef SIMD_ATTR
+#undef SIMD_BYTES
+#undef SIMD_MR
+#undef SIMD_NR_VECTORS
+#undef SIMD_NB
+#undef SIMD_LEVEL
+#undef SIMD_LEVEL_NAME
+#undef SIMD_TABLE_T
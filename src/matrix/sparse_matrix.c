@@ -0,0 +1,699 @@
+/**
+ * @file sparse_matrix.c
+ * @brief Реализация операций с разреженными матрицами
+ * @ingroup Matrix_Operations
+ *
+ * Операции, создающие новую матрицу, выполняются в два параллельных прохода по
+ * линиям основного измерения: сначала каждая линия подсчитывает число своих
+ * элементов, затем по префиксным суммам узнает свое место в результате и
+ * заполняет его. Смена формата и транспонирование - сортировка подсчетом;
+ * матрица в формате CSC рассматривается как транспонированная матрица в
+ * формате CSR с теми же массивами.
+ */
+
+#include "sparse_matrix.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_operations.h"
+#include "matrix_text.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Строка результата умножения сортируется просмотром всего аккумулятора, если
+ *        в ней больше 1/SPARSE_DENSE_ROW_RATIO от числа столбцов
+ */
+#define SPARSE_DENSE_ROW_RATIO 16
+
+/**
+ * @brief Выделяет память под массив или завершает программу
+ */
+static void *sparse_alloc(size_t count, size_t size) {
+    if (count == 0) {
+        count = 1;
+    }
+    void *data = count > SIZE_MAX / size ? NULL : malloc(count * size);
+    if (data == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти под разреженную матрицу!\n");
+        exit(EXIT_FAILURE);
+    }
+    return data;
+}
+
+/**
+ * @brief Создает матрицу с нулевыми offsets и без массивов элементов
+ */
+static SparseMatrix sparse_shell(int rows, int cols, SparseFormat format) {
+    if (rows < 0 || cols < 0 || (format != SPARSE_CSR && format != SPARSE_CSC)) {
+        fprintf(stderr, "Недопустимые размеры матрицы!\n");
+        exit(EXIT_FAILURE);
+    }
+    SparseMatrix mat = {.rows = rows, .cols = cols, .format = format};
+    const size_t lines = (size_t)SPARSE_MAJOR(mat) + 1;
+    mat.offsets = (size_t *)sparse_alloc(lines, sizeof(size_t));
+    memset(mat.offsets, 0, lines * sizeof(size_t));
+    return mat;
+}
+
+/**
+ * @brief Выделяет indices и values на capacity элементов
+ */
+static void allocate_entries(SparseMatrix *mat, size_t capacity) {
+    mat->indices = (int *)sparse_alloc(capacity, sizeof(int));
+    mat->values = (double *)sparse_alloc(capacity, sizeof(double));
+}
+
+/**
+ * @brief Превращает длины линий в offsets[i + 1] в начала линий
+ */
+static void prefix_offsets(SparseMatrix *mat) {
+    const int lines = SPARSE_MAJOR(*mat);
+    for (int iter = 0; iter < lines; iter++) {
+        mat->offsets[iter + 1] += mat->offsets[iter];
+    }
+}
+
+/**
+ * @brief Минимальное число линий в одной параллельной части
+ * @param work Оценка общей работы в элементах
+ * @param lines Число линий
+ * @return Число линий, на которые приходится не меньше PARALLEL_MIN_ELEMENTS элементов работы
+ */
+static int lines_grain(double work, int lines) {
+    if (lines <= 0) {
+        return 1;
+    }
+    const double per_line = work / lines + 1.0;
+    const double grain = PARALLEL_MIN_ELEMENTS / per_line;
+    return grain < 1.0 ? 1 : grain > lines ? lines : (int)grain;
+}
+
+/**
+ * @brief Представляет матрицу как транспонированную без копирования
+ *
+ * Массивы CSR матрицы A совпадают с массивами CSC матрицы Aᵀ, и наоборот.
+ */
+static SparseMatrix transposed_view(SparseMatrix mat) {
+    SparseMatrix view = mat;
+    view.rows = mat.cols;
+    view.cols = mat.rows;
+    view.format = mat.format == SPARSE_CSR ? SPARSE_CSC : SPARSE_CSR;
+    return view;
+}
+
+SparseMatrix create_sparse_matrix(int rows, int cols, SparseFormat format, size_t capacity) {
+    SparseMatrix mat = sparse_shell(rows, cols, format);
+    allocate_entries(&mat, capacity);
+    return mat;
+}
+
+void free_sparse_matrix(SparseMatrix mat) {
+    free(mat.offsets);
+    free(mat.indices);
+    free(mat.values);
+}
+
+/**
+ * @brief Параметры преобразования между плотной и разреженной матрицами
+ */
+typedef struct {
+    Matrix dense;        /**< Плотная матрица */
+    SparseMatrix sparse; /**< Разреженная матрица */
+} DenseJob;
+
+/**
+ * @brief Задача пула: подсчитывает ненулевые элементы строк [begin, end)
+ */
+static void dense_count_task(void *ctx, int begin, int end) {
+    const DenseJob *job = (const DenseJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        const double *row = MATRIX_ROW(job->dense, iter);
+        size_t count = 0;
+        for (int iter_2 = 0; iter_2 < job->dense.cols; iter_2++) {
+            count += row[iter_2] != 0.0;
+        }
+        job->sparse.offsets[iter + 1] = count;
+    }
+}
+
+/**
+ * @brief Задача пула: переносит ненулевые элементы строк [begin, end)
+ */
+static void dense_fill_task(void *ctx, int begin, int end) {
+    const DenseJob *job = (const DenseJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        const double *row = MATRIX_ROW(job->dense, iter);
+        size_t position = job->sparse.offsets[iter];
+        for (int iter_2 = 0; iter_2 < job->dense.cols; iter_2++) {
+            if (row[iter_2] != 0.0) {
+                job->sparse.indices[position] = iter_2;
+                job->sparse.values[position++] = row[iter_2];
+            }
+        }
+    }
+}
+
+SparseMatrix dense_to_sparse(Matrix mat, SparseFormat format) {
+    DenseJob job = {.dense = mat, .sparse = sparse_shell(mat.rows, mat.cols, SPARSE_CSR)};
+    const int grain = lines_grain((double)mat.rows * mat.cols, mat.rows);
+    parallel_for(mat.rows, grain, dense_count_task, &job);
+    prefix_offsets(&job.sparse);
+    allocate_entries(&job.sparse, SPARSE_NNZ(job.sparse));
+    parallel_for(mat.rows, grain, dense_fill_task, &job);
+    if (format == SPARSE_CSR) {
+        return job.sparse;
+    }
+    SparseMatrix result = convert_sparse(job.sparse, format);
+    free_sparse_matrix(job.sparse);
+    return result;
+}
+
+/**
+ * @brief Задача пула: расставляет элементы линий [begin, end) в плотной матрице
+ */
+static void dense_scatter_task(void *ctx, int begin, int end) {
+    const DenseJob *job = (const DenseJob *)ctx;
+    const SparseMatrix mat = job->sparse;
+    for (int iter = begin; iter < end; iter++) {
+        for (size_t iter_2 = mat.offsets[iter]; iter_2 < mat.offsets[iter + 1]; iter_2++) {
+            if (mat.format == SPARSE_CSR) {
+                MATRIX_AT(job->dense, iter, mat.indices[iter_2]) = mat.values[iter_2];
+            } else {
+                MATRIX_AT(job->dense, mat.indices[iter_2], iter) = mat.values[iter_2];
+            }
+        }
+    }
+}
+
+Matrix sparse_to_dense(SparseMatrix mat) {
+    DenseJob job = {.dense = create_matrix(mat.rows, mat.cols), .sparse = mat};
+    const int lines = SPARSE_MAJOR(mat);
+    parallel_for(lines, lines_grain((double)SPARSE_NNZ(mat), lines), dense_scatter_task, &job);
+    return job.dense;
+}
+
+SparseMatrix convert_sparse(SparseMatrix mat, SparseFormat format) {
+    const size_t nnz = SPARSE_NNZ(mat);
+    SparseMatrix result = sparse_shell(mat.rows, mat.cols, format);
+    allocate_entries(&result, nnz);
+    const int lines = SPARSE_MAJOR(mat);
+    if (mat.format == format) {
+        memcpy(result.offsets, mat.offsets, ((size_t)lines + 1) * sizeof(size_t));
+        memcpy(result.indices, mat.indices, nnz * sizeof(int));
+        memcpy(result.values, mat.values, nnz * sizeof(double));
+        return result;
+    }
+
+    const int result_lines = SPARSE_MAJOR(result);
+    for (size_t iter = 0; iter < nnz; iter++) {
+        result.offsets[mat.indices[iter] + 1]++;
+    }
+    prefix_offsets(&result);
+    size_t *next = (size_t *)sparse_alloc((size_t)result_lines, sizeof(size_t));
+    memcpy(next, result.offsets, (size_t)result_lines * sizeof(size_t));
+    for (int iter = 0; iter < lines; iter++) {
+        for (size_t iter_2 = mat.offsets[iter]; iter_2 < mat.offsets[iter + 1]; iter_2++) {
+            const size_t position = next[mat.indices[iter_2]]++;
+            result.indices[position] = iter;
+            result.values[position] = mat.values[iter_2];
+        }
+    }
+    free(next);
+    return result;
+}
+
+SparseMatrix transpose_sparse(SparseMatrix mat) {
+    return convert_sparse(transposed_view(mat), mat.format);
+}
+
+/**
+ * @brief Параметры поэлементного слияния двух разреженных матриц
+ */
+typedef struct {
+    SparseMatrix a; /**< Первый операнд */
+    SparseMatrix b; /**< Второй операнд (в формате первого) */
+    SparseMatrix c; /**< Результат */
+    double sign;    /**< Знак второго операнда: 1 для сложения, -1 для вычитания */
+} MergeJob;
+
+/**
+ * @brief Задача пула: подсчитывает объединение структур линий [begin, end)
+ */
+static void merge_count_task(void *ctx, int begin, int end) {
+    const MergeJob *job = (const MergeJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        size_t pa = job->a.offsets[iter];
+        size_t pb = job->b.offsets[iter];
+        const size_t end_a = job->a.offsets[iter + 1];
+        const size_t end_b = job->b.offsets[iter + 1];
+        size_t count = 0;
+        while (pa < end_a && pb < end_b) {
+            const int ia = job->a.indices[pa];
+            const int ib = job->b.indices[pb];
+            pa += ia <= ib;
+            pb += ib <= ia;
+            count++;
+        }
+        job->c.offsets[iter + 1] = count + (end_a - pa) + (end_b - pb);
+    }
+}
+
+/**
+ * @brief Задача пула: вычисляет линии [begin, end) суммы или разности
+ */
+static void merge_fill_task(void *ctx, int begin, int end) {
+    const MergeJob *job = (const MergeJob *)ctx;
+    const SparseMatrix a = job->a;
+    const SparseMatrix b = job->b;
+    for (int iter = begin; iter < end; iter++) {
+        size_t pa = a.offsets[iter];
+        size_t pb = b.offsets[iter];
+        size_t position = job->c.offsets[iter];
+        while (pa < a.offsets[iter + 1] || pb < b.offsets[iter + 1]) {
+            const int ia = pa < a.offsets[iter + 1] ? a.indices[pa] : INT_MAX;
+            const int ib = pb < b.offsets[iter + 1] ? b.indices[pb] : INT_MAX;
+            double value = 0.0;
+            if (ia <= ib) {
+                value += a.values[pa++];
+            }
+            if (ib <= ia) {
+                value += job->sign * b.values[pb++];
+            }
+            job->c.indices[position] = ia < ib ? ia : ib;
+            job->c.values[position++] = value;
+        }
+    }
+}
+
+/**
+ * @brief Складывает или вычитает разреженные матрицы
+ * @param operation Название операции в родительном падеже (для сообщения)
+ */
+static SparseMatrix merge_sparse(SparseMatrix mat1, SparseMatrix mat2, double sign,
+                                 const char *operation) {
+    if (mat1.rows != mat2.rows || mat1.cols != mat2.cols) {
+        fprintf(stderr, "Размеры матриц не совпадают для %s!\n", operation);
+        exit(EXIT_FAILURE);
+    }
+    MergeJob job = {.a = mat1,
+                    .b = mat2.format == mat1.format ? mat2 : convert_sparse(mat2, mat1.format),
+                    .c = sparse_shell(mat1.rows, mat1.cols, mat1.format),
+                    .sign = sign};
+    const int lines = SPARSE_MAJOR(mat1);
+    const int grain = lines_grain((double)SPARSE_NNZ(job.a) + SPARSE_NNZ(job.b), lines);
+    parallel_for(lines, grain, merge_count_task, &job);
+    prefix_offsets(&job.c);
+    allocate_entries(&job.c, SPARSE_NNZ(job.c));
+    parallel_for(lines, grain, merge_fill_task, &job);
+    if (mat2.format != mat1.format) {
+        free_sparse_matrix(job.b);
+    }
+    return job.c;
+}
+
+SparseMatrix plus_sparse(SparseMatrix mat1, SparseMatrix mat2) {
+    return merge_sparse(mat1, mat2, 1.0, "сложения");
+}
+
+SparseMatrix subtract_sparse(SparseMatrix mat1, SparseMatrix mat2) {
+    return merge_sparse(mat1, mat2, -1.0, "вычитания");
+}
+
+/**
+ * @brief Параметры умножения разреженной матрицы на вектор или плотную матрицу
+ */
+typedef struct {
+    SparseMatrix a;  /**< Разреженная матрица в формате CSR */
+    const double *x; /**< Вектор-множитель (для умножения на вектор) */
+    double *y;       /**< Вектор-результат (для умножения на вектор) */
+    Matrix b;        /**< Плотный множитель (для умножения на матрицу) */
+    Matrix c;        /**< Плотный результат (для умножения на матрицу) */
+} ProductJob;
+
+/**
+ * @brief Задача пула: вычисляет элементы [begin, end) произведения A·x
+ */
+static void vector_task(void *ctx, int begin, int end) {
+    const ProductJob *job = (const ProductJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        double sum = 0.0;
+        for (size_t iter_2 = job->a.offsets[iter]; iter_2 < job->a.offsets[iter + 1]; iter_2++) {
+            sum += job->a.values[iter_2] * job->x[job->a.indices[iter_2]];
+        }
+        job->y[iter] = sum;
+    }
+}
+
+void sparse_multiply_vector(SparseMatrix mat, const double *x, double *y) {
+    if (mat.format == SPARSE_CSC) {
+        memset(y, 0, (size_t)mat.rows * sizeof(double));
+        for (int iter = 0; iter < mat.cols; iter++) {
+            const double scale = x[iter];
+            for (size_t iter_2 = mat.offsets[iter]; iter_2 < mat.offsets[iter + 1]; iter_2++) {
+                y[mat.indices[iter_2]] += mat.values[iter_2] * scale;
+            }
+        }
+        return;
+    }
+    ProductJob job = {.a = mat, .x = x, .y = y};
+    parallel_for(mat.rows, lines_grain((double)SPARSE_NNZ(mat), mat.rows), vector_task, &job);
+}
+
+/**
+ * @brief Задача пула: вычисляет строки [begin, end) произведения разреженной и плотной матриц
+ */
+static void dense_product_task(void *ctx, int begin, int end) {
+    const ProductJob *job = (const ProductJob *)ctx;
+    const int cols = job->c.cols;
+    for (int iter = begin; iter < end; iter++) {
+        double *out = MATRIX_ROW(job->c, iter);
+        for (size_t iter_2 = job->a.offsets[iter]; iter_2 < job->a.offsets[iter + 1]; iter_2++) {
+            const double scale = job->a.values[iter_2];
+            const double *row = MATRIX_ROW(job->b, job->a.indices[iter_2]);
+            for (int iter_3 = 0; iter_3 < cols; iter_3++) {
+                out[iter_3] += scale * row[iter_3];
+            }
+        }
+    }
+}
+
+Matrix multiply_sparse_dense(SparseMatrix mat1, Matrix mat2) {
+    if (mat1.cols != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    ProductJob job = {.a = mat1.format == SPARSE_CSR ? mat1 : convert_sparse(mat1, SPARSE_CSR),
+                      .b = mat2,
+                      .c = create_matrix(mat1.rows, mat2.cols)};
+    const int grain = lines_grain((double)SPARSE_NNZ(job.a) * mat2.cols, mat1.rows);
+    parallel_for(mat1.rows, grain, dense_product_task, &job);
+    if (mat1.format != SPARSE_CSR) {
+        free_sparse_matrix(job.a);
+    }
+    return job.c;
+}
+
+/**
+ * @brief Параметры умножения двух разреженных матриц в формате CSR
+ */
+typedef struct {
+    SparseMatrix a; /**< Первый множитель */
+    SparseMatrix b; /**< Второй множитель */
+    SparseMatrix c; /**< Результат */
+} SparseProductJob;
+
+/**
+ * @brief Создает массив меток столбцов, заполненный -1
+ */
+static int *create_markers(int count) {
+    int *markers = (int *)sparse_alloc((size_t)count, sizeof(int));
+    for (int iter = 0; iter < count; iter++) {
+        markers[iter] = -1;
+    }
+    return markers;
+}
+
+/**
+ * @brief Задача пула: подсчитывает элементы строк [begin, end) произведения
+ */
+static void sparse_count_task(void *ctx, int begin, int end) {
+    const SparseProductJob *job = (const SparseProductJob *)ctx;
+    const SparseMatrix a = job->a;
+    const SparseMatrix b = job->b;
+    int *markers = create_markers(b.cols);
+    for (int iter = begin; iter < end; iter++) {
+        size_t count = 0;
+        for (size_t iter_2 = a.offsets[iter]; iter_2 < a.offsets[iter + 1]; iter_2++) {
+            const int line = a.indices[iter_2];
+            for (size_t iter_3 = b.offsets[line]; iter_3 < b.offsets[line + 1]; iter_3++) {
+                const int col = b.indices[iter_3];
+                if (markers[col] != iter) {
+                    markers[col] = iter;
+                    count++;
+                }
+            }
+        }
+        job->c.offsets[iter + 1] = count;
+    }
+    free(markers);
+}
+
+/**
+ * @brief Сравнивает номера столбцов для qsort
+ */
+static int compare_indices(const void *left, const void *right) {
+    const int a = *(const int *)left;
+    const int b = *(const int *)right;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Задача пула: вычисляет строки [begin, end) произведения
+ *
+ * Строка накапливается в плотном векторе, номера ее столбцов собираются в
+ * порядке появления и затем упорядочиваются: сортировкой, если их мало, или
+ * просмотром меток всех столбцов, если строка заполнена плотно.
+ */
+static void sparse_fill_task(void *ctx, int begin, int end) {
+    const SparseProductJob *job = (const SparseProductJob *)ctx;
+    const SparseMatrix a = job->a;
+    const SparseMatrix b = job->b;
+    int *markers = create_markers(b.cols);
+    double *accumulator = (double *)sparse_alloc((size_t)b.cols, sizeof(double));
+    for (int iter = begin; iter < end; iter++) {
+        const size_t first = job->c.offsets[iter];
+        int *indices = job->c.indices + first;
+        size_t count = 0;
+        for (size_t iter_2 = a.offsets[iter]; iter_2 < a.offsets[iter + 1]; iter_2++) {
+            const int line = a.indices[iter_2];
+            const double scale = a.values[iter_2];
+            for (size_t iter_3 = b.offsets[line]; iter_3 < b.offsets[line + 1]; iter_3++) {
+                const int col = b.indices[iter_3];
+                if (markers[col] != iter) {
+                    markers[col] = iter;
+                    indices[count++] = col;
+                    accumulator[col] = scale * b.values[iter_3];
+                } else {
+                    accumulator[col] += scale * b.values[iter_3];
+                }
+            }
+        }
+        if (count * SPARSE_DENSE_ROW_RATIO > (size_t)b.cols) {
+            count = 0;
+            for (int iter_2 = 0; iter_2 < b.cols; iter_2++) {
+                if (markers[iter_2] == iter) {
+                    indices[count++] = iter_2;
+                }
+            }
+        } else {
+            qsort(indices, count, sizeof(int), compare_indices);
+        }
+        for (size_t iter_2 = 0; iter_2 < count; iter_2++) {
+            job->c.values[first + iter_2] = accumulator[indices[iter_2]];
+        }
+    }
+    free(accumulator);
+    free(markers);
+}
+
+/**
+ * @brief Умножает матрицы в формате CSR
+ */
+static SparseMatrix multiply_csr(SparseMatrix mat1, SparseMatrix mat2) {
+    SparseProductJob job = {.a = mat1,
+                            .b = mat2,
+                            .c = sparse_shell(mat1.rows, mat2.cols, SPARSE_CSR)};
+    const double per_entry = (double)SPARSE_NNZ(mat2) / (mat2.rows > 0 ? mat2.rows : 1) + 1.0;
+    const int grain = lines_grain((double)SPARSE_NNZ(mat1) * per_entry, mat1.rows);
+    parallel_for(mat1.rows, grain, sparse_count_task, &job);
+    prefix_offsets(&job.c);
+    allocate_entries(&job.c, SPARSE_NNZ(job.c));
+    parallel_for(mat1.rows, grain, sparse_fill_task, &job);
+    return job.c;
+}
+
+SparseMatrix multiply_sparse(SparseMatrix mat1, SparseMatrix mat2) {
+    if (mat1.cols != mat2.rows) {
+        fprintf(stderr, "Размеры матриц не совпадают для умножения!\n");
+        exit(EXIT_FAILURE);
+    }
+    SparseMatrix right = mat2.format == mat1.format ? mat2 : convert_sparse(mat2, mat1.format);
+    SparseMatrix result;
+    if (mat1.format == SPARSE_CSR) {
+        result = multiply_csr(mat1, right);
+    } else {
+        /* (A·B)ᵀ = Bᵀ·Aᵀ: массивы CSC множителей - это CSR их транспонированных */
+        result = transposed_view(multiply_csr(transposed_view(right), transposed_view(mat1)));
+    }
+    if (mat2.format != mat1.format) {
+        free_sparse_matrix(right);
+    }
+    return result;
+}
+
+/**
+ * @brief Пропускает пробельные символы и комментарии до конца строки, начинающиеся с '%'
+ */
+static const char *skip_blank(const char *cursor, const char *end) {
+    for (;;) {
+        while (cursor < end && (*cursor == ' ' || (*cursor >= '\t' && *cursor <= '\r'))) {
+            cursor++;
+        }
+        if (cursor == end || *cursor != '%') {
+            return cursor;
+        }
+        const char *newline = (const char *)memchr(cursor, '\n', (size_t)(end - cursor));
+        cursor = newline != NULL ? newline + 1 : end;
+    }
+}
+
+/**
+ * @brief Проверяет, встречается ли слово в строке [begin, end)
+ */
+static int line_contains(const char *begin, const char *end, const char *word) {
+    const size_t length = strlen(word);
+    for (const char *cursor = begin; cursor + length <= end; cursor++) {
+        if (memcmp(cursor, word, length) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Собирает матрицу из списка координат
+ *
+ * Элементы раскладываются по столбцам, затем перевод в CSR упорядочивает
+ * каждую строку по столбцам, и повторяющиеся координаты, оказавшиеся рядом,
+ * суммируются.
+ */
+static SparseMatrix from_triplets(int rows, int cols, size_t count, const int *row_indices,
+                                  const int *col_indices, const double *values,
+                                  SparseFormat format) {
+    SparseMatrix by_cols = sparse_shell(rows, cols, SPARSE_CSC);
+    allocate_entries(&by_cols, count);
+    for (size_t iter = 0; iter < count; iter++) {
+        by_cols.offsets[col_indices[iter] + 1]++;
+    }
+    prefix_offsets(&by_cols);
+    size_t *next = (size_t *)sparse_alloc((size_t)cols, sizeof(size_t));
+    memcpy(next, by_cols.offsets, (size_t)cols * sizeof(size_t));
+    for (size_t iter = 0; iter < count; iter++) {
+        const size_t position = next[col_indices[iter]]++;
+        by_cols.indices[position] = row_indices[iter];
+        by_cols.values[position] = values[iter];
+    }
+    free(next);
+
+    SparseMatrix result = convert_sparse(by_cols, SPARSE_CSR);
+    free_sparse_matrix(by_cols);
+    size_t written = 0;
+    size_t begin = 0;
+    for (int iter = 0; iter < rows; iter++) {
+        const size_t stop = result.offsets[iter + 1];
+        const size_t line_start = written;
+        for (size_t iter_2 = begin; iter_2 < stop; iter_2++) {
+            if (written > line_start && result.indices[written - 1] == result.indices[iter_2]) {
+                result.values[written - 1] += result.values[iter_2];
+            } else {
+                result.indices[written] = result.indices[iter_2];
+                result.values[written++] = result.values[iter_2];
+            }
+        }
+        begin = stop;
+        result.offsets[iter + 1] = written;
+    }
+    if (format == SPARSE_CSR) {
+        return result;
+    }
+    SparseMatrix converted = convert_sparse(result, format);
+    free_sparse_matrix(result);
+    return converted;
+}
+
+SparseMatrix sparse_parse_text(const char *text, size_t length, const char *name,
+                               SparseFormat format) {
+    const char *end = text + length;
+    const char *cursor = text;
+    int symmetric = 0;
+    static const char banner[] = "%%MatrixMarket";
+    if (length >= sizeof(banner) - 1 && memcmp(text, banner, sizeof(banner) - 1) == 0) {
+        const char *newline = (const char *)memchr(text, '\n', length);
+        const char *line_end = newline != NULL ? newline : end;
+        symmetric = line_contains(text, line_end, "symmetric");
+        if (!line_contains(text, line_end, "coordinate") ||
+            line_contains(text, line_end, "complex") || line_contains(text, line_end, "pattern") ||
+            line_contains(text, line_end, "skew") || line_contains(text, line_end, "hermitian")) {
+            matrix_text_fail(text, text, name, "Неподдерживаемый вариант формата Matrix Market");
+        }
+    }
+
+    int dims[3];
+    for (int iter = 0; iter < 3; iter++) {
+        cursor = skip_blank(cursor, end);
+        const char *next = matrix_parse_int(cursor, end, &dims[iter]);
+        if (next == NULL || dims[iter] < 0) {
+            matrix_text_fail(text, cursor, name, "Ошибка чтения размеров матрицы");
+        }
+        cursor = next;
+    }
+    if (symmetric && dims[0] != dims[1]) {
+        matrix_text_fail(text, text, name, "Симметричная матрица должна быть квадратной");
+    }
+
+    /*
+     * Каждый элемент занимает хотя бы шесть символов (три числа и разделители перед
+     * ними), поэтому число элементов, которому не хватит текста, отвергается до
+     * выделения памяти
+     */
+    if ((size_t)dims[2] > (size_t)(end - cursor) / 6) {
+        matrix_text_fail(text, end, name, "Ошибка чтения матричных данных: недостаточно элементов");
+    }
+    const size_t capacity = (size_t)dims[2] * (symmetric ? 2 : 1);
+    int *row_indices = (int *)sparse_alloc(capacity, sizeof(int));
+    int *col_indices = (int *)sparse_alloc(capacity, sizeof(int));
+    double *values = (double *)sparse_alloc(capacity, sizeof(double));
+    size_t count = 0;
+    for (int iter = 0; iter < dims[2]; iter++) {
+        int coordinates[2];
+        for (int iter_2 = 0; iter_2 < 2; iter_2++) {
+            cursor = skip_blank(cursor, end);
+            const char *next = matrix_parse_int(cursor, end, &coordinates[iter_2]);
+            if (next == NULL || coordinates[iter_2] < 1 || coordinates[iter_2] > dims[iter_2]) {
+                matrix_text_fail(text, cursor < end ? cursor : end, name,
+                                 "Ошибка чтения координат элемента разреженной матрицы");
+            }
+            cursor = next;
+        }
+        cursor = skip_blank(cursor, end);
+        const char *next = matrix_parse_double(cursor, end, &values[count]);
+        if (cursor == end || next == NULL) {
+            matrix_text_fail(text, cursor, name, "Ошибка чтения матричных данных");
+        }
+        cursor = next;
+        row_indices[count] = coordinates[0] - 1;
+        col_indices[count++] = coordinates[1] - 1;
+        if (symmetric && coordinates[0] != coordinates[1]) {
+            values[count] = values[count - 1];
+            row_indices[count] = coordinates[1] - 1;
+            col_indices[count++] = coordinates[0] - 1;
+        }
+    }
+
+    SparseMatrix mat =
+        from_triplets(dims[0], dims[1], count, row_indices, col_indices, values, format);
+    free(values);
+    free(col_indices);
+    free(row_indices);
+    return mat;
+}
+
+SparseMatrix load_sparse_matrix_from_file(const char *filename, SparseFormat format) {
+    TextFile file;
+    text_file_open(filename, &file);
+    SparseMatrix mat = sparse_parse_text(file.text, file.length, filename, format);
+    text_file_close(&file);
+    return mat;
+}
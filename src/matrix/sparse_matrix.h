@@ -0,0 +1,147 @@
+/**
+ * @file sparse_matrix.h
+ * @brief Разреженные матрицы в форматах CSR и CSC
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Разреженная матрица (SparseMatrix, config.h) хранит только ненулевые элементы,
+ * поэтому память и время операций пропорциональны их числу, а не rows·cols.
+ * Результаты операций всегда имеют упорядоченные номера внутри линий. Элементы,
+ * ставшие нулем в результате сложения или умножения, остаются в структуре
+ * (структурные нули), как в большинстве библиотек разреженной алгебры.
+ *
+ * Текстовый формат координат (совместим с Matrix Market coordinate):
+ * строки, начинающиеся с '%', - комментарии; первая строка данных содержит
+ * число строк, столбцов и элементов, каждая следующая - номер строки, номер
+ * столбца (с единицы) и значение. Повторяющиеся координаты суммируются. Заголовок
+ * "%%MatrixMarket matrix coordinate real symmetric" задает симметричную матрицу,
+ * у которой записан только нижний треугольник.
+ */
+
+#ifndef MATRIX_SPARSE_MATRIX_H
+#define MATRIX_SPARSE_MATRIX_H
+
+#include <stddef.h>
+#include "../include/config.h"
+
+/**
+ * @brief Создает пустую разреженную матрицу
+ * @param rows Количество строк
+ * @param cols Количество столбцов
+ * @param format Формат хранения
+ * @param capacity Число элементов, под которое выделяются indices и values
+ * @return Матрица без ненулевых элементов (offsets заполнен нулями)
+ * @warning При недопустимых размерах или нехватке памяти завершает программу с EXIT_FAILURE
+ */
+SparseMatrix create_sparse_matrix(int rows, int cols, SparseFormat format, size_t capacity);
+
+/**
+ * @brief Освобождает память, занятую разреженной матрицей
+ * @param mat Матрица для освобождения
+ */
+void free_sparse_matrix(SparseMatrix mat);
+
+/**
+ * @brief Преобразует плотную матрицу в разреженную
+ * @param mat Плотная матрица
+ * @param format Формат результата
+ * @return Разреженная матрица с ненулевыми элементами mat
+ */
+SparseMatrix dense_to_sparse(Matrix mat, SparseFormat format);
+
+/**
+ * @brief Преобразует разреженную матрицу в плотную
+ * @param mat Разреженная матрица
+ * @return Новая плотная матрица
+ */
+Matrix sparse_to_dense(SparseMatrix mat);
+
+/**
+ * @brief Переводит разреженную матрицу в заданный формат
+ * @param mat Исходная матрица
+ * @param format Формат результата
+ * @return Новая матрица (копия, если формат совпадает)
+ * @note Выполняется сортировкой подсчетом за O(nnz + rows + cols)
+ */
+SparseMatrix convert_sparse(SparseMatrix mat, SparseFormat format);
+
+/**
+ * @brief Транспонирует разреженную матрицу
+ * @param mat Исходная матрица (m×n)
+ * @return Транспонированная матрица (n×m) в том же формате
+ */
+SparseMatrix transpose_sparse(SparseMatrix mat);
+
+/**
+ * @brief Складывает две разреженные матрицы
+ * @param mat1 Первая матрица
+ * @param mat2 Вторая матрица (приводится к формату первой)
+ * @return Сумма в формате mat1
+ * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
+ */
+SparseMatrix plus_sparse(SparseMatrix mat1, SparseMatrix mat2);
+
+/**
+ * @brief Вычитает вторую разреженную матрицу из первой
+ * @param mat1 Уменьшаемое
+ * @param mat2 Вычитаемое (приводится к формату первой)
+ * @return Разность в формате mat1
+ * @warning При несовпадении размеров завершает программу с EXIT_FAILURE
+ */
+SparseMatrix subtract_sparse(SparseMatrix mat1, SparseMatrix mat2);
+
+/**
+ * @brief Умножает разреженную матрицу на вектор: y = A·x
+ * @param mat Матрица A (m×n)
+ * @param x Вектор из n элементов
+ * @param y Результат из m элементов (не должен пересекаться с x)
+ */
+void sparse_multiply_vector(SparseMatrix mat, const double *x, double *y);
+
+/**
+ * @brief Умножает разреженную матрицу на плотную
+ * @param mat1 Разреженная матрица (m×n)
+ * @param mat2 Плотная матрица (n×k)
+ * @return Плотная матрица (m×k)
+ * @note Строка результата - сумма строк mat2 с коэффициентами из строки mat1;
+ *       матрица в формате CSC предварительно переводится в CSR
+ * @warning При несовместимых размерах завершает программу с EXIT_FAILURE
+ */
+Matrix multiply_sparse_dense(SparseMatrix mat1, Matrix mat2);
+
+/**
+ * @brief Умножает две разреженные матрицы (алгоритм Густавсона)
+ * @param mat1 Первая матрица (m×n)
+ * @param mat2 Вторая матрица (n×k), приводится к формату первой
+ * @return Произведение (m×k) в формате mat1
+ * @note Выполняется в два прохода по строкам: подсчет элементов результата и
+ *       накопление значений в плотном векторе-аккумуляторе
+ * @warning При несовместимых размерах завершает программу с EXIT_FAILURE
+ */
+SparseMatrix multiply_sparse(SparseMatrix mat1, SparseMatrix mat2);
+
+/**
+ * @brief Разбирает разреженную матрицу из текста в формате координат
+ * @param text Текст (не обязан заканчиваться нулевым символом)
+ * @param length Длина текста в байтах
+ * @param name Имя источника для сообщений об ошибках
+ * @param format Формат результата
+ * @return Новая разреженная матрица
+ * @warning При ошибке выводит строку и столбец неверного токена и завершает программу
+ *          с EXIT_FAILURE
+ */
+SparseMatrix sparse_parse_text(const char *text, size_t length, const char *name,
+                               SparseFormat format);
+
+/**
+ * @brief Загружает разреженную матрицу из текстового файла в формате координат
+ * @param filename Путь к файлу
+ * @param format Формат результата
+ * @return Загруженная матрица
+ * @warning В случае ошибки чтения завершает программу с EXIT_FAILURE
+ */
+SparseMatrix load_sparse_matrix_from_file(const char *filename, SparseFormat format);
+
+#endif
+
+/** @} */
@@ -0,0 +1,164 @@
+/**
+ * @file strassen.c
+ * @brief Реализация умножения по схеме Штрассена-Винограда
+ * @ingroup Matrix_Operations
+ *
+ * Порядок операций одного уровня взят из работы Boyer, Dumas, Pernet, Zhou
+ * "Memory efficient scheduling of Strassen-Winograd's matrix multiplication
+ * algorithm" (2009): кроме четвертей C нужны лишь два временных блока, X
+ * размером m/2×max(k/2, n/2) и Y размером k/2×n/2.
+ *
+ *     S1 = A21 + A22   S2 = S1 - A11   S3 = A11 - A21   S4 = A12 - S2
+ *     T1 = B12 - B11   T2 = B22 - T1   T3 = B22 - B12   T4 = T2 - B21
+ *     P1 = A11·B11  P2 = A12·B21  P3 = S4·B22  P4 = A22·T4
+ *     P5 = S1·T1    P6 = S2·T2    P7 = S3·T3
+ *     C11 = P1 + P2            C12 = P1 + P6 + P5 + P3
+ *     C21 = P1 + P6 + P7 - P4  C22 = P1 + P6 + P7 + P5
+ */
+
+#include "strassen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/config.h"
+#include "gemm.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Ядро построчной операции: out[i] = a[i] op b[i]
+ */
+typedef void (*RowKernel)(int n, const double *a, const double *b, double *out);
+
+/**
+ * @brief Параметры поэлементной операции над блоками
+ */
+typedef struct {
+    RowKernel kernel;
+    int cols;
+    const double *a;
+    ptrdiff_t lda;
+    const double *b;
+    ptrdiff_t ldb;
+    double *out;
+    ptrdiff_t ldo;
+} CombineJob;
+
+static void combine_task(void *ctx, int begin, int end) {
+    const CombineJob *job = (const CombineJob *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        job->kernel(job->cols, job->a + iter * job->lda, job->b + iter * job->ldb,
+                    job->out + iter * job->ldo);
+    }
+}
+
+/**
+ * @brief out = a op b для блоков rows×cols; out может совпадать с a или b
+ */
+static void combine(RowKernel kernel, int rows, int cols, const double *a, ptrdiff_t lda,
+                    const double *b, ptrdiff_t ldb, double *out, ptrdiff_t ldo) {
+    CombineJob job = {kernel, cols, a, lda, b, ldb, out, ldo};
+    if ((long long)rows * cols >= PARALLEL_MIN_ELEMENTS) {
+        int grain = cols > 0 ? (PARALLEL_MIN_ELEMENTS / 4 + cols - 1) / cols : rows;
+        parallel_for(rows, grain, combine_task, &job);
+    } else {
+        combine_task(&job, 0, rows);
+    }
+}
+
+static int should_recurse(int m, int n, int k, int crossover) {
+    int smallest = m < n ? m : n;
+    smallest = smallest < k ? smallest : k;
+    return smallest >= crossover && smallest >= 2;
+}
+
+size_t strassen_workspace_size(int m, int n, int k, int crossover) {
+    if (crossover <= 0) {
+        crossover = STRASSEN_CROSSOVER;
+    }
+    size_t total = 0;
+    while (should_recurse(m, n, k, crossover)) {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        total += (size_t)m * (size_t)(k > n ? k : n) + (size_t)k * (size_t)n;
+    }
+    return total;
+}
+
+/**
+ * @brief Один уровень рекурсии: C = A·B
+ */
+static void winograd(const SimdKernels *kernels, int m, int n, int k, const double *a,
+                     ptrdiff_t lda, const double *b, ptrdiff_t ldb, double *c, ptrdiff_t ldc,
+                     int crossover, double *work) {
+    if (!should_recurse(m, n, k, crossover)) {
+        gemm_strided(m, n, k, 1.0, a, lda, 1, b, ldb, 1, 0.0, c, ldc, 1);
+        return;
+    }
+
+    const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    const double *a11 = a, *a12 = a + k2, *a21 = a + m2 * lda, *a22 = a21 + k2;
+    const double *b11 = b, *b12 = b + n2, *b21 = b + k2 * ldb, *b22 = b21 + n2;
+    double *c11 = c, *c12 = c + n2, *c21 = c + m2 * ldc, *c22 = c21 + n2;
+    const ptrdiff_t ldx = k2 > n2 ? k2 : n2;
+    const ptrdiff_t ldy = n2;
+    double *x = work;
+    double *y = x + (size_t)m2 * ldx;
+    double *next = y + (size_t)k2 * n2;
+    RowKernel add = kernels->add;
+    RowKernel sub = kernels->sub;
+
+    combine(sub, m2, k2, a11, lda, a21, lda, x, ldx);                          /* X = S3 */
+    combine(sub, k2, n2, b22, ldb, b12, ldb, y, ldy);                          /* Y = T3 */
+    winograd(kernels, m2, n2, k2, x, ldx, y, ldy, c21, ldc, crossover, next);  /* C21 = P7 */
+    combine(add, m2, k2, a21, lda, a22, lda, x, ldx);                          /* X = S1 */
+    combine(sub, k2, n2, b12, ldb, b11, ldb, y, ldy);                          /* Y = T1 */
+    winograd(kernels, m2, n2, k2, x, ldx, y, ldy, c22, ldc, crossover, next);  /* C22 = P5 */
+    combine(sub, k2, n2, b22, ldb, y, ldy, y, ldy);                            /* Y = T2 */
+    combine(sub, m2, k2, x, ldx, a11, lda, x, ldx);                            /* X = S2 */
+    winograd(kernels, m2, n2, k2, x, ldx, y, ldy, c12, ldc, crossover, next);  /* C12 = P6 */
+    combine(sub, m2, k2, a12, lda, x, ldx, x, ldx);                            /* X = S4 */
+    winograd(kernels, m2, n2, k2, x, ldx, b22, ldb, c11, ldc, crossover, next); /* C11 = P3 */
+    winograd(kernels, m2, n2, k2, a11, lda, b11, ldb, x, ldx, crossover, next); /* X = P1 */
+    combine(add, m2, n2, x, ldx, c12, ldc, c12, ldc);                          /* C12 = U2 */
+    combine(add, m2, n2, c12, ldc, c21, ldc, c21, ldc);                        /* C21 = U3 */
+    combine(add, m2, n2, c12, ldc, c22, ldc, c12, ldc);                        /* C12 = U4 */
+    combine(add, m2, n2, c21, ldc, c22, ldc, c22, ldc);                        /* C22 = U7 */
+    combine(add, m2, n2, c12, ldc, c11, ldc, c12, ldc);                        /* C12 = U5 */
+    combine(sub, k2, n2, y, ldy, b21, ldb, y, ldy);                            /* Y = T4 */
+    winograd(kernels, m2, n2, k2, a22, lda, y, ldy, c11, ldc, crossover, next); /* C11 = P4 */
+    combine(sub, m2, n2, c21, ldc, c11, ldc, c21, ldc);                        /* C21 = U6 */
+    winograd(kernels, m2, n2, k2, a12, lda, b21, ldb, c11, ldc, crossover, next); /* C11 = P2 */
+    combine(add, m2, n2, x, ldx, c11, ldc, c11, ldc);                          /* C11 = U1 */
+
+    /* Отщепление нечетных размеров */
+    if (k & 1) {
+        gemm_strided(2 * m2, 2 * n2, 1, 1.0, a + (k - 1), lda, 1, b + (k - 1) * ldb, ldb, 1,
+                     1.0, c, ldc, 1);
+    }
+    if (n & 1) {
+        gemm_strided(2 * m2, 1, k, 1.0, a, lda, 1, b + (n - 1), ldb, 1, 0.0, c + (n - 1), ldc, 1);
+    }
+    if (m & 1) {
+        gemm_strided(1, n, k, 1.0, a + (m - 1) * lda, lda, 1, b, ldb, 1, 0.0, c + (m - 1) * ldc,
+                     ldc, 1);
+    }
+}
+
+void strassen_multiply(int m, int n, int k, const double *a, ptrdiff_t lda, const double *b,
+                       ptrdiff_t ldb, double *c, ptrdiff_t ldc, int crossover, double *workspace) {
+    if (crossover <= 0) {
+        crossover = STRASSEN_CROSSOVER;
+    }
+    size_t size = strassen_workspace_size(m, n, k, crossover);
+    double *owned = NULL;
+    if (workspace == NULL && size > 0) {
+        if (posix_memalign((void **)&owned, MATRIX_ALIGNMENT, size * sizeof(double)) != 0) {
+            fprintf(stderr, "Ошибка выделения памяти для умножения Штрассена!\n");
+            exit(EXIT_FAILURE);
+        }
+        workspace = owned;
+    }
+    winograd(simd_kernels(), m, n, k, a, lda, b, ldb, c, ldc, crossover, workspace);
+    free(owned);
+}
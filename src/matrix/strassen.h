@@ -0,0 +1,67 @@
+/**
+ * @file strassen.h
+ * @brief Умножение матриц по схеме Штрассена-Винограда
+ * @ingroup Matrix_Operations
+ * @{
+ *
+ * Вариант Винограда алгоритма Штрассена: 7 умножений и 15 сложений блоков
+ * половинного размера вместо 8 умножений, сложность O(n^2.81). Рекурсия
+ * продолжается, пока все размеры не меньше порога перехода, после чего блоки
+ * перемножаются обычным блочным алгоритмом (gemm.h).
+ */
+
+#ifndef MATRIX_STRASSEN_H
+#define MATRIX_STRASSEN_H
+
+#include <stddef.h>
+
+/**
+ * @brief Порог перехода к обычному умножению по умолчанию
+ *
+ * Подобран по времени умножения квадратных матриц порядка 2048 и 4096 с ядрами
+ * AVX-512: на блоках меньше 512 экономия одного умножения из восьми не
+ * окупает 15 проходов сложения по памяти.
+ */
+#define STRASSEN_CROSSOVER 512
+
+/**
+ * @brief Размер рабочего буфера для strassen_multiply
+ * @param m Число строк A и C
+ * @param n Число столбцов B и C
+ * @param k Число столбцов A и строк B
+ * @param crossover Порог перехода (0 - STRASSEN_CROSSOVER)
+ * @return Число элементов double
+ */
+size_t strassen_workspace_size(int m, int n, int k, int crossover);
+
+/**
+ * @brief Вычисляет C = A·B по схеме Штрассена-Винограда
+ * @param m Число строк A и C
+ * @param n Число столбцов B и C
+ * @param k Число столбцов A и строк B
+ * @param a Матрица A m×k (по строкам, шаг lda)
+ * @param lda Шаг между строками A
+ * @param b Матрица B k×n (по строкам, шаг ldb)
+ * @param ldb Шаг между строками B
+ * @param c Матрица C m×n (по строкам, шаг ldc)
+ * @param ldc Шаг между строками C
+ * @param crossover Порог перехода к обычному умножению (0 - STRASSEN_CROSSOVER)
+ * @param workspace Буфер из strassen_workspace_size элементов или NULL (тогда буфер
+ *                  выделяется на время вызова)
+ *
+ * @note Нечетные размеры обрабатываются отщеплением: четная часть вычисляется
+ * рекурсивно, последние строка, столбец и слагаемое по общему измерению -
+ * обычным умножением. Все временные блоки всех уровней рекурсии размещаются в
+ * одном буфере; кроме него используются только четверти самой C.
+ * @note Оценка погрешности хуже, чем у обычного умножения (Хайэм, теорема 23.3):
+ * |C - Ĉ| <= ((n/n0)^log2(18) · (n0^2 + 6·n0) - 6n) · u · max|A| · max|B|,
+ * где n0 - порог перехода, u - единица округления. Ошибка ограничена по норме
+ * матрицы, а не поэлементно.
+ * @warning C не должна пересекаться с A и B
+ */
+void strassen_multiply(int m, int n, int k, const double *a, ptrdiff_t lda, const double *b,
+                       ptrdiff_t ldb, double *c, ptrdiff_t ldc, int crossover, double *workspace);
+
+#endif
+
+/** @} */
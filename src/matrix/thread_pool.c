@@ -0,0 +1,227 @@
+/**
+ * @file thread_pool.c
+ * @brief Реализация постоянного пула потоков на pthread
+ * @ingroup Matrix_Operations
+ *
+ * Рабочие потоки создаются при первом параллельном вызове и ждут на условной
+ * переменной. Каждый вызов parallel_for делит диапазон на части со статическими
+ * границами: часть 0 выполняет вызывающий поток, часть i - рабочий поток i-1.
+ */
+
+#include "thread_pool.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** Захвачен, пока выполняется параллельный участок (защищает от вложенных вызовов) */
+static pthread_mutex_t region_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Защищает состояние пула и описание текущей задачи */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_once_t config_once = PTHREAD_ONCE_INIT;
+static int configured_threads = 1;
+
+static pthread_t *workers = NULL;
+static int worker_count = 0;
+static int stopping = 0;
+static int exit_handler_registered = 0;
+static unsigned long generation = 0;
+/** Поколение задач на момент запуска рабочих потоков (читается ими при старте) */
+static unsigned long spawn_generation = 0;
+
+/**
+ * @brief Описание текущей параллельной задачи
+ */
+static struct {
+    ParallelTask task; /**< Выполняемая функция */
+    void *ctx;         /**< Ее контекст */
+    int count;         /**< Размер диапазона */
+    int parts;         /**< Число частей */
+    int pending;       /**< Число рабочих потоков, еще не завершивших текущее поколение */
+} job;
+
+/**
+ * @brief Возвращает число доступных ядер процессора
+ */
+static int detect_cores(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+/**
+ * @brief Читает MATRIX_NUM_THREADS (однократно)
+ */
+static void read_config(void) {
+    configured_threads = detect_cores();
+    const char *env = getenv("MATRIX_NUM_THREADS");
+    if (env != NULL) {
+        int threads = atoi(env);
+        if (threads > 0) {
+            configured_threads = threads;
+        } else {
+            fprintf(stderr, "Неверное значение MATRIX_NUM_THREADS: %s\n", env);
+        }
+    }
+}
+
+/**
+ * @brief Выполняет часть part из job.parts
+ */
+static void run_part(ParallelTask task, void *ctx, int count, int parts, int part) {
+    int begin = (int)((long long)count * part / parts);
+    int end = (int)((long long)count * (part + 1) / parts);
+    if (begin < end) {
+        task(ctx, begin, end);
+    }
+}
+
+/**
+ * @brief Цикл рабочего потока
+ * @param arg Номер рабочего потока (0..worker_count-1)
+ */
+static void *worker_main(void *arg) {
+    const int index = (int)(intptr_t)arg;
+    unsigned long seen = spawn_generation;
+
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (generation == seen && !stopping) {
+            pthread_cond_wait(&work_cond, &pool_lock);
+        }
+        if (stopping) {
+            break;
+        }
+        seen = generation;
+        ParallelTask task = job.task;
+        void *ctx = job.ctx;
+        int count = job.count;
+        int parts = job.parts;
+        pthread_mutex_unlock(&pool_lock);
+
+        if (index + 1 < parts) {
+            run_part(task, ctx, count, parts, index + 1);
+        }
+
+        pthread_mutex_lock(&pool_lock);
+        if (--job.pending == 0) {
+            pthread_cond_signal(&done_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return NULL;
+}
+
+/**
+ * @brief Останавливает рабочие потоки (region_lock должен быть захвачен)
+ */
+static void stop_workers(void) {
+    pthread_mutex_lock(&pool_lock);
+    stopping = 1;
+    pthread_cond_broadcast(&work_cond);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (int iter = 0; iter < worker_count; iter++) {
+        pthread_join(workers[iter], NULL);
+    }
+    free(workers);
+    workers = NULL;
+    worker_count = 0;
+    stopping = 0;
+}
+
+/**
+ * @brief Запускает рабочие потоки, если их число не соответствует настройке
+ *        (region_lock должен быть захвачен)
+ */
+static void ensure_workers(int threads) {
+    if (worker_count == threads - 1) {
+        return;
+    }
+    if (worker_count > 0) {
+        stop_workers();
+    }
+    if (!exit_handler_registered) {
+        atexit(thread_pool_shutdown);
+        exit_handler_registered = 1;
+    }
+
+    workers = (pthread_t *)malloc((size_t)(threads - 1) * sizeof(pthread_t));
+    if (workers == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для пула потоков!\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_lock(&pool_lock);
+    spawn_generation = generation;
+    pthread_mutex_unlock(&pool_lock);
+    for (int iter = 0; iter < threads - 1; iter++) {
+        if (pthread_create(&workers[iter], NULL, worker_main, (void *)(intptr_t)iter) != 0) {
+            break;
+        }
+        worker_count++;
+    }
+}
+
+void matrix_set_num_threads(int threads) {
+    pthread_once(&config_once, read_config);
+    configured_threads = threads > 0 ? threads : detect_cores();
+}
+
+int matrix_get_num_threads(void) {
+    pthread_once(&config_once, read_config);
+    return configured_threads;
+}
+
+void parallel_for(int count, int grain, ParallelTask task, void *ctx) {
+    if (count <= 0) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+    int threads = matrix_get_num_threads();
+    int parts = count / grain < threads ? count / grain : threads;
+    if (parts <= 1 || pthread_mutex_trylock(&region_lock) != 0) {
+        task(ctx, 0, count);
+        return;
+    }
+
+    ensure_workers(threads);
+    if (parts > worker_count + 1) {
+        parts = worker_count + 1;
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    job.task = task;
+    job.ctx = ctx;
+    job.count = count;
+    job.parts = parts;
+    job.pending = worker_count;
+    generation++;
+    pthread_cond_broadcast(&work_cond);
+    pthread_mutex_unlock(&pool_lock);
+
+    run_part(task, ctx, count, parts, 0);
+
+    pthread_mutex_lock(&pool_lock);
+    while (job.pending > 0) {
+        pthread_cond_wait(&done_cond, &pool_lock);
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    pthread_mutex_unlock(&region_lock);
+}
+
+void thread_pool_shutdown(void) {
+    /* Завершение программы из параллельного участка (exit при ошибке) не должно зависать */
+    if (pthread_mutex_trylock(&region_lock) != 0) {
+        return;
+    }
+    if (worker_count > 0) {
+        stop_workers();
+    }
+    pthread_mutex_unlock(&region_lock);
+}
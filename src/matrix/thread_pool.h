@@ -0,0 +1,61 @@
+/**
+ * @file thread_pool.h
+ * @brief Постоянный пул потоков библиотеки для параллельного выполнения операций
+ * @ingroup Matrix_Operations
+ * @{
+ */
+
+#ifndef MATRIX_THREAD_POOL_H
+#define MATRIX_THREAD_POOL_H
+
+/**
+ * @brief Минимальное число элементов, начиная с которого поэлементные операции распараллеливаются
+ *
+ * Для меньших матриц накладные расходы на пробуждение потоков превышают выигрыш.
+ */
+#define PARALLEL_MIN_ELEMENTS (1 << 16)
+
+/**
+ * @brief Функция-задача: обрабатывает полуинтервал [begin, end) общего диапазона работы
+ */
+typedef void (*ParallelTask)(void *ctx, int begin, int end);
+
+/**
+ * @brief Задает число потоков, используемых операциями библиотеки
+ * @param threads Число потоков (1 - последовательное выполнение, 0 - по числу ядер)
+ *
+ * @note Без вызова этой функции число потоков берется из переменной окружения
+ * MATRIX_NUM_THREADS, а при ее отсутствии - по числу доступных ядер
+ * @warning Не должна вызываться одновременно с выполнением операций в других потоках
+ */
+void matrix_set_num_threads(int threads);
+
+/**
+ * @brief Возвращает текущее число потоков
+ * @return Число потоков, используемых операциями библиотеки
+ */
+int matrix_get_num_threads(void);
+
+/**
+ * @brief Разбивает диапазон [0, count) на непрерывные части и выполняет их в пуле
+ * @param count Размер диапазона
+ * @param grain Минимальный размер одной части (части меньше grain не создаются)
+ * @param task Функция, вызываемая для каждой части
+ * @param ctx Контекст, передаваемый в task
+ *
+ * @note Разбиение статическое: одна часть на поток, границы частей детерминированы
+ * @note Вложенные вызовы и вызовы во время занятости пула выполняются последовательно
+ */
+void parallel_for(int count, int grain, ParallelTask task, void *ctx);
+
+/**
+ * @brief Останавливает рабочие потоки пула и освобождает его ресурсы
+ *
+ * @note Вызывается автоматически при завершении программы; после вызова
+ * пул пересоздается при следующем параллельном вызове
+ */
+void thread_pool_shutdown(void);
+
+#endif
+
+/** @} */
@@ -0,0 +1,28 @@
+/**
+ * @file transpose.c
+ * @brief Реализация блочного транспонирования
+ * @ingroup Matrix_Operations
+ *
+ * Наивный цикл пишет каждый следующий элемент результата в новую строку, поэтому
+ * для широких матриц каждая запись попадает на другую страницу памяти. Здесь
+ * матрица обходится квадратными блоками: за время обработки блока используются
+ * лишь TRANSPOSE_TILE строк источника и столько же строк результата.
+ *
+ * Алгоритм записан один раз в transpose_template.h и порождается для double и float.
+ */
+
+#include "transpose.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+
+#define MATRIX_T double
+#define MATRIX_FN(name) name
+#define MATRIX_KERNELS_T SimdKernels
+#define MATRIX_KERNELS simd_kernels
+#include "transpose_template.h"
+
+#define MATRIX_T float
+#define MATRIX_FN(name) name##_f
+#define MATRIX_KERNELS_T SimdKernelsF
+#define MATRIX_KERNELS simd_kernels_f
+#include "transpose_template.h"
@@ -0,0 +1,63 @@
+/**
+ * @file transpose.h
+ * @brief Блочное транспонирование матриц (в новый буфер и на месте)
+ * @ingroup Matrix_Operations
+ * @{
+ */
+
+#ifndef MATRIX_TRANSPOSE_H
+#define MATRIX_TRANSPOSE_H
+
+#include <stddef.h>
+
+/**
+ * @brief Сторона квадратного блока транспонирования
+ *
+ * Блок источника и блок результата (2 · 32 · 32 · 8 = 16 КБ) помещаются в L1,
+ * а 64 строки, которых касается обработка блока, - в TLB первого уровня.
+ * Кратна стороне блока всех ядер транспонирования (4 и 8).
+ */
+#define TRANSPOSE_TILE 32
+
+/**
+ * @brief Записывает в dst транспонированную матрицу src
+ * @param rows Число строк src (столбцов dst)
+ * @param cols Число столбцов src (строк dst)
+ * @param src Указатель на элемент src(0, 0)
+ * @param lds Шаг между строками src
+ * @param dst Указатель на элемент dst(0, 0)
+ * @param ldd Шаг между строками dst
+ *
+ * @note Матрица обходится блоками TRANSPOSE_TILE×TRANSPOSE_TILE, внутри блока
+ * подблоки транспонируются в регистрах векторным ядром (simd_kernels.h).
+ * Большие матрицы обрабатываются параллельно по полосам строк dst.
+ * @warning src и dst не должны пересекаться
+ */
+void transpose_strided(int rows, int cols, const double *src, ptrdiff_t lds, double *dst,
+                       ptrdiff_t ldd);
+
+/**
+ * @brief Транспонирует квадратную матрицу на месте
+ * @param n Порядок матрицы
+ * @param a Указатель на элемент A(0, 0)
+ * @param lda Шаг между строками a
+ *
+ * @note Блоки (I, J) и (J, I) меняются местами через буфер размером в один блок
+ * на стеке, поэтому дополнительная память под матрицу не нужна
+ */
+void transpose_square_inplace(int n, double *a, ptrdiff_t lda);
+
+/**
+ * @brief Записывает в dst транспонированную матрицу float (см. transpose_strided)
+ */
+void transpose_strided_f(int rows, int cols, const float *src, ptrdiff_t lds, float *dst,
+                         ptrdiff_t ldd);
+
+/**
+ * @brief Транспонирует квадратную матрицу float на месте (см. transpose_square_inplace)
+ */
+void transpose_square_inplace_f(int n, float *a, ptrdiff_t lda);
+
+#endif
+
+/** @} */
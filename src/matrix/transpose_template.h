@@ -0,0 +1,150 @@
+/**
+ * @file transpose_template.h
+ * @brief Шаблон блочного транспонирования для одного типа элементов
+ * @ingroup Matrix_Operations
+ *
+ * Включается в transpose.c для double и float. Перед включением задаются макросы
+ * MATRIX_T (тип элементов), MATRIX_FN(name) (имя функции или типа экземпляра),
+ * MATRIX_KERNELS_T и MATRIX_KERNELS() (тип таблицы ядер и функция, возвращающая
+ * активную). В конце файла все параметры отменяются.
+ */
+
+/**
+ * @brief Транспонирует блок rows×cols (rows, cols <= TRANSPOSE_TILE)
+ *
+ * Полные подблоки обрабатываются ядром, остатки по краям - поэлементно.
+ */
+static void MATRIX_FN(transpose_tile)(const MATRIX_KERNELS_T *kernels, int rows, int cols,
+                                      const MATRIX_T *src, ptrdiff_t lds, MATRIX_T *dst,
+                                      ptrdiff_t ldd) {
+    const int nb = kernels->transpose_nb;
+    const int full_rows = rows / nb * nb;
+    const int full_cols = cols / nb * nb;
+    for (int iter = 0; iter < full_rows; iter += nb) {
+        for (int iter_2 = 0; iter_2 < full_cols; iter_2 += nb) {
+            kernels->transpose_kernel(src + iter * lds + iter_2, lds, dst + iter_2 * ldd + iter,
+                                      ldd);
+        }
+    }
+    for (int iter = 0; iter < rows; iter++) {
+        for (int iter_2 = iter < full_rows ? full_cols : 0; iter_2 < cols; iter_2++) {
+            dst[iter_2 * ldd + iter] = src[iter * lds + iter_2];
+        }
+    }
+}
+
+/**
+ * @brief Параметры параллельного транспонирования
+ */
+typedef struct {
+    int rows, cols;
+    const MATRIX_T *src;
+    ptrdiff_t lds;
+    MATRIX_T *dst;
+    ptrdiff_t ldd;
+} MATRIX_FN(TransposeJob);
+
+/**
+ * @brief Задача пула: заполняет полосы строк dst [begin, end) по TRANSPOSE_TILE строк
+ *
+ * Каждая часть пишет только в свои строки результата.
+ */
+static void MATRIX_FN(transpose_task)(void *ctx, int begin, int end) {
+    const MATRIX_FN(TransposeJob) *job = (const MATRIX_FN(TransposeJob) *)ctx;
+    const MATRIX_KERNELS_T *kernels = MATRIX_KERNELS();
+    for (int band = begin; band < end; band++) {
+        const int col = band * TRANSPOSE_TILE;
+        const int cols = job->cols - col < TRANSPOSE_TILE ? job->cols - col : TRANSPOSE_TILE;
+        for (int row = 0; row < job->rows; row += TRANSPOSE_TILE) {
+            const int rows = job->rows - row < TRANSPOSE_TILE ? job->rows - row : TRANSPOSE_TILE;
+            MATRIX_FN(transpose_tile)(kernels, rows, cols, job->src + row * job->lds + col,
+                                      job->lds, job->dst + col * job->ldd + row, job->ldd);
+        }
+    }
+}
+
+void MATRIX_FN(transpose_strided)(int rows, int cols, const MATRIX_T *src, ptrdiff_t lds,
+                                  MATRIX_T *dst, ptrdiff_t ldd) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    MATRIX_FN(TransposeJob) job = {.rows = rows, .cols = cols, .src = src,
+                                   .lds = lds,   .dst = dst,   .ldd = ldd};
+    const int bands = (cols + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    const long long band_elements = (long long)TRANSPOSE_TILE * rows;
+    const int grain = (int)((PARALLEL_MIN_ELEMENTS + band_elements - 1) / band_elements);
+    parallel_for(bands, grain, MATRIX_FN(transpose_task), &job);
+}
+
+/**
+ * @brief Параметры транспонирования на месте
+ */
+typedef struct {
+    int n;
+    MATRIX_T *a;
+    ptrdiff_t lda;
+} MATRIX_FN(InplaceJob);
+
+/**
+ * @brief Транспонирует на месте все пары блоков (I, J), (J, I) с J >= I для одной полосы I
+ */
+static void MATRIX_FN(transpose_band_inplace)(const MATRIX_KERNELS_T *kernels,
+                                              const MATRIX_FN(InplaceJob) *job, int band) {
+    MATRIX_T buffer[TRANSPOSE_TILE * TRANSPOSE_TILE];
+    const int row = band * TRANSPOSE_TILE;
+    const int rows = job->n - row < TRANSPOSE_TILE ? job->n - row : TRANSPOSE_TILE;
+    MATRIX_T *diag = job->a + row * job->lda + row;
+
+    /* Диагональный блок: через буфер */
+    MATRIX_FN(transpose_tile)(kernels, rows, rows, diag, job->lda, buffer, TRANSPOSE_TILE);
+    for (int iter = 0; iter < rows; iter++) {
+        kernels->copy(rows, buffer + iter * TRANSPOSE_TILE, diag + iter * job->lda);
+    }
+
+    for (int col = row + TRANSPOSE_TILE; col < job->n; col += TRANSPOSE_TILE) {
+        const int cols = job->n - col < TRANSPOSE_TILE ? job->n - col : TRANSPOSE_TILE;
+        MATRIX_T *upper = job->a + row * job->lda + col; /* rows×cols */
+        MATRIX_T *lower = job->a + col * job->lda + row; /* cols×rows */
+        /* buffer = upper^T, upper = lower^T, lower = buffer */
+        MATRIX_FN(transpose_tile)(kernels, rows, cols, upper, job->lda, buffer, TRANSPOSE_TILE);
+        MATRIX_FN(transpose_tile)(kernels, cols, rows, lower, job->lda, upper, job->lda);
+        for (int iter = 0; iter < cols; iter++) {
+            kernels->copy(rows, buffer + iter * TRANSPOSE_TILE, lower + iter * job->lda);
+        }
+    }
+}
+
+/**
+ * @brief Задача пула: единица u обрабатывает полосы u и bands-1-u
+ *
+ * Полоса I содержит bands - I пар блоков, поэтому объединение полос с обоих
+ * концов дает единицы одинаковой стоимости и равномерное статическое разбиение.
+ */
+static void MATRIX_FN(inplace_task)(void *ctx, int begin, int end) {
+    const MATRIX_FN(InplaceJob) *job = (const MATRIX_FN(InplaceJob) *)ctx;
+    const MATRIX_KERNELS_T *kernels = MATRIX_KERNELS();
+    const int bands = (job->n + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    for (int unit = begin; unit < end; unit++) {
+        MATRIX_FN(transpose_band_inplace)(kernels, job, unit);
+        if (bands - 1 - unit != unit) {
+            MATRIX_FN(transpose_band_inplace)(kernels, job, bands - 1 - unit);
+        }
+    }
+}
+
+void MATRIX_FN(transpose_square_inplace)(int n, MATRIX_T *a, ptrdiff_t lda) {
+    if (n <= 1) {
+        return;
+    }
+    MATRIX_FN(InplaceJob) job = {.n = n, .a = a, .lda = lda};
+    const int bands = (n + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    const int units = (bands + 1) / 2;
+    const long long unit_elements = (long long)TRANSPOSE_TILE * n;
+    const int grain = (int)((PARALLEL_MIN_ELEMENTS + unit_elements - 1) / unit_elements);
+    parallel_for(units, grain, MATRIX_FN(inplace_task), &job);
+}
+
+#undef MATRIX_T
+#undef MATRIX_FN
+#undef MATRIX_KERNELS_T
+#undef MATRIX_KERNELS
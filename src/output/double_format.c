@@ -0,0 +1,448 @@
+/**
+ * @file double_format.c
+ * @brief Реализация форматирования чисел double
+ * @ingroup Matrix_Output-Input
+ *
+ * Кратчайшая запись строится алгоритмом Grisu2 (Ф. Лойч, 2010): значение и
+ * границы интервала округления умножаются на кэшированную степень десяти,
+ * представленную 64-битной мантиссой, после чего цифры генерируются
+ * целочисленными операциями. Результат всегда лежит внутри интервала
+ * округления, поэтому strtod восстанавливает исходное число точно. Для float
+ * интервал округления шире (24-битная мантисса), и цифр получается не больше девяти.
+ */
+
+#include "double_format.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Число с плавающей точкой "своего" формата: f · 2^e
+ */
+typedef struct {
+    uint64_t f; /**< Мантисса */
+    int e;      /**< Двоичный порядок */
+} DiyFp;
+
+#define DP_SIGNIFICAND_MASK UINT64_C(0x000FFFFFFFFFFFFF)
+#define DP_HIDDEN_BIT UINT64_C(0x0010000000000000)
+#define DP_EXPONENT_BIAS (0x3FF + 52)
+#define DP_MIN_EXPONENT (-DP_EXPONENT_BIAS)
+
+#define SP_SIGNIFICAND_MASK UINT32_C(0x007FFFFF)
+#define SP_HIDDEN_BIT UINT64_C(0x00800000)
+#define SP_EXPONENT_BIAS (0x7F + 23)
+#define SP_MIN_EXPONENT (-SP_EXPONENT_BIAS)
+
+/** Мантиссы степеней 10^(-348 + 8i), округленные до 64 бит */
+static const uint64_t cached_powers_f[] = {
+    UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+    UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+    UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+    UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+    UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+    UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+    UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+    UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+    UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+    UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+    UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+    UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+    UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+    UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+    UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+    UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+    UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+    UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+    UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+    UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+    UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+    UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+    UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+    UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+    UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+    UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+    UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+    UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+    UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+/** Двоичные порядки степеней из cached_powers_f */
+static const int16_t cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066
+};
+
+static const uint64_t powers_of_ten[] = {1ull,
+                                         10ull,
+                                         100ull,
+                                         1000ull,
+                                         10000ull,
+                                         100000ull,
+                                         1000000ull,
+                                         10000000ull,
+                                         100000000ull,
+                                         1000000000ull,
+                                         10000000000ull,
+                                         100000000000ull,
+                                         1000000000000ull,
+                                         10000000000000ull,
+                                         100000000000000ull,
+                                         1000000000000000ull,
+                                         10000000000000000ull,
+                                         100000000000000000ull,
+                                         1000000000000000000ull,
+                                         10000000000000000000ull};
+
+static DiyFp diy_from_double(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t significand = bits & DP_SIGNIFICAND_MASK;
+    DiyFp result;
+    if (biased != 0) {
+        result.f = significand + DP_HIDDEN_BIT;
+        result.e = biased - DP_EXPONENT_BIAS;
+    } else {
+        result.f = significand;
+        result.e = DP_MIN_EXPONENT + 1;
+    }
+    return result;
+}
+
+static DiyFp diy_from_float(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased = (int)((bits >> 23) & 0xFF);
+    uint64_t significand = bits & SP_SIGNIFICAND_MASK;
+    DiyFp result;
+    if (biased != 0) {
+        result.f = significand + SP_HIDDEN_BIT;
+        result.e = biased - SP_EXPONENT_BIAS;
+    } else {
+        result.f = significand;
+        result.e = SP_MIN_EXPONENT + 1;
+    }
+    return result;
+}
+
+/**
+ * @brief Старшие 64 бита произведения мантисс (с округлением)
+ */
+static DiyFp diy_multiply(DiyFp lhs, DiyFp rhs) {
+    unsigned __int128 product = (unsigned __int128)lhs.f * rhs.f;
+    uint64_t high = (uint64_t)(product >> 64);
+    high += (uint64_t)(product >> 63) & 1u;
+    DiyFp result = {.f = high, .e = lhs.e + rhs.e + 64};
+    return result;
+}
+
+static DiyFp diy_normalize(DiyFp value) {
+    int shift = __builtin_clzll(value.f);
+    value.f <<= shift;
+    value.e -= shift;
+    return value;
+}
+
+/**
+ * @brief Границы интервала округления m- и m+ с общим порядком
+ * @param value Число
+ * @param hidden Скрытый бит мантиссы формата (DP_HIDDEN_BIT или SP_HIDDEN_BIT)
+ */
+static void normalized_boundaries(DiyFp value, uint64_t hidden, DiyFp *minus, DiyFp *plus) {
+    DiyFp upper = {.f = (value.f << 1) + 1, .e = value.e - 1};
+    upper = diy_normalize(upper);
+
+    DiyFp lower;
+    if (value.f == hidden) {
+        lower.f = (value.f << 2) - 1;
+        lower.e = value.e - 2;
+    } else {
+        lower.f = (value.f << 1) - 1;
+        lower.e = value.e - 1;
+    }
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+    *minus = lower;
+    *plus = upper;
+}
+
+/**
+ * @brief Кэшированная степень 10^-K, приводящая порядок e в диапазон [-60, -32]
+ */
+static DiyFp cached_power(int e, int *k) {
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ceil_k = (int)dk;
+    if (dk - ceil_k > 0.0) {
+        ceil_k++;
+    }
+    unsigned index = (unsigned)((ceil_k >> 3) + 1);
+    *k = -(-348 + (int)index * 8);
+    DiyFp result = {.f = cached_powers_f[index], .e = cached_powers_e[index]};
+    return result;
+}
+
+static int count_digits(uint32_t value) {
+    int digits = 1;
+    while (digits < 10 && value >= powers_of_ten[digits]) {
+        digits++;
+    }
+    return digits;
+}
+
+/**
+ * @brief Сдвигает последнюю цифру к точному значению, пока это допускает интервал
+ */
+static void grisu_round(char *buffer, int length, uint64_t delta, uint64_t rest,
+                        uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/**
+ * @brief Генерирует цифры из интервала (Mp - delta, Mp]
+ */
+static int digit_gen(DiyFp w, DiyFp mp, uint64_t delta, char *buffer, int *k) {
+    const int shift = -mp.e;
+    const uint64_t one = UINT64_C(1) << shift;
+    const uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+    int kappa = count_digits(p1);
+    int length = 0;
+
+    while (kappa > 0) {
+        uint32_t divisor = (uint32_t)powers_of_ten[kappa - 1];
+        uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+        if (digit || length) {
+            buffer[length++] = (char)('0' + digit);
+        }
+        kappa--;
+        uint64_t rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, length, delta, rest, powers_of_ten[kappa] << shift, wp_w);
+            return length;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char digit = (char)(p2 >> shift);
+        if (digit || length) {
+            buffer[length++] = (char)('0' + digit);
+        }
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            int index = -kappa;
+            uint64_t scaled_wp_w = wp_w * (index < 20 ? powers_of_ten[index] : 0);
+            grisu_round(buffer, length, delta, p2, one, scaled_wp_w);
+            return length;
+        }
+    }
+}
+
+/**
+ * @brief Цифры числа v > 0: v ≈ digits · 10^k
+ * @param hidden Скрытый бит мантиссы формата, задающий ширину интервала округления
+ * @return Число цифр
+ */
+static int grisu2(DiyFp v, uint64_t hidden, char *digits, int *k) {
+    DiyFp minus, plus;
+    normalized_boundaries(v, hidden, &minus, &plus);
+    DiyFp c_mk = cached_power(plus.e, k);
+    DiyFp w = diy_multiply(diy_normalize(v), c_mk);
+    DiyFp wp = diy_multiply(plus, c_mk);
+    DiyFp wm = diy_multiply(minus, c_mk);
+    wm.f++;
+    wp.f--;
+    return digit_gen(w, wp, wp.f - wm.f, digits, k);
+}
+
+/**
+ * @brief Записывает десятичный порядок
+ */
+static int write_exponent(int exponent, char *out) {
+    int length = 0;
+    out[length++] = 'e';
+    if (exponent < 0) {
+        out[length++] = '-';
+        exponent = -exponent;
+    }
+    char digits[4];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + exponent % 10);
+        exponent /= 10;
+    } while (exponent > 0);
+    while (count > 0) {
+        out[length++] = digits[--count];
+    }
+    return length;
+}
+
+/**
+ * @brief Кратчайшая запись числа; single - число типа float, записанное в value точно
+ */
+static int format_shortest(double value, int single, char *out) {
+    if (!isfinite(value)) {
+        const char *text = isnan(value) ? "nan" : value < 0 ? "-inf" : "inf";
+        size_t length = strlen(text);
+        memcpy(out, text, length + 1);
+        return (int)length;
+    }
+
+    int length = 0;
+    if (signbit(value)) {
+        out[length++] = '-';
+        value = -value;
+    }
+    if (value == 0.0) {
+        out[length++] = '0';
+        out[length] = '\0';
+        return length;
+    }
+
+    char digits[20];
+    int k = 0;
+    int count = single ? grisu2(diy_from_float((float)value), SP_HIDDEN_BIT, digits, &k)
+                       : grisu2(diy_from_double(value), DP_HIDDEN_BIT, digits, &k);
+    int point = count + k; /* положение десятичной точки относительно первой цифры */
+
+    if (k >= 0 && point <= DOUBLE_FORMAT_PLAIN_DIGITS) {
+        /* Целое: 1200 */
+        memcpy(out + length, digits, (size_t)count);
+        length += count;
+        memset(out + length, '0', (size_t)k);
+        length += k;
+    } else if (point > 0 && point <= DOUBLE_FORMAT_PLAIN_DIGITS) {
+        /* 12.34 */
+        memcpy(out + length, digits, (size_t)point);
+        length += point;
+        out[length++] = '.';
+        memcpy(out + length, digits + point, (size_t)(count - point));
+        length += count - point;
+    } else if (point <= 0 && point > -DOUBLE_FORMAT_LEADING_ZEROS) {
+        /* 0.001234 */
+        out[length++] = '0';
+        out[length++] = '.';
+        memset(out + length, '0', (size_t)-point);
+        length += -point;
+        memcpy(out + length, digits, (size_t)count);
+        length += count;
+    } else {
+        /* 1.234e-7 */
+        out[length++] = digits[0];
+        if (count > 1) {
+            out[length++] = '.';
+            memcpy(out + length, digits + 1, (size_t)(count - 1));
+            length += count - 1;
+        }
+        length += write_exponent(point - 1, out + length);
+    }
+    out[length] = '\0';
+    return length;
+}
+
+int format_double_shortest(double value, char *out) {
+    return format_shortest(value, 0, out);
+}
+
+int format_float_shortest(float value, char *out) {
+    return format_shortest(value, 1, out);
+}
+
+/**
+ * @brief Записывает целое без знака в десятичной записи
+ */
+static int write_unsigned(uint64_t value, char *out) {
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (int iter = 0; iter < count; iter++) {
+        out[iter] = digits[count - 1 - iter];
+    }
+    return count;
+}
+
+int format_double_fixed(double value, int precision, char *out) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const int biased = (int)((bits >> 52) & 0x7FF);
+    const int exponent = biased - DP_EXPONENT_BIAS;
+    const uint64_t mantissa = (bits & DP_SIGNIFICAND_MASK) | (biased ? DP_HIDDEN_BIT : 0);
+
+    /*
+     * Точный путь: |value| < 2^63, а дробная часть имеет не более 64 двоичных
+     * знаков, поэтому дробь · 10^precision вычисляется в 128 битах без ошибок
+     * и округляется к ближайшему (при равенстве - к четному, как printf)
+     */
+    if (precision < 0 || precision > 17 || biased == 0x7FF || exponent >= 63 - 52 ||
+        (biased != 0 && exponent < -64) || (biased == 0 && mantissa != 0)) {
+        return snprintf(out, DOUBLE_FORMAT_FIXED_MAX(precision), "%.*f", precision, value);
+    }
+
+    uint64_t integer;
+    uint64_t fraction;
+    int shift = exponent < 0 ? -exponent : 0;
+    if (exponent >= 0) {
+        integer = mantissa << exponent;
+        fraction = 0;
+    } else if (shift < 64) {
+        integer = mantissa >> shift;
+        fraction = mantissa & ((UINT64_C(1) << shift) - 1);
+    } else {
+        integer = 0;
+        fraction = mantissa;
+    }
+
+    const uint64_t scale = powers_of_ten[precision];
+    uint64_t decimals = 0;
+    if (fraction != 0) {
+        unsigned __int128 product = (unsigned __int128)fraction * scale;
+        decimals = (uint64_t)(product >> shift);
+        unsigned __int128 rest = product - ((unsigned __int128)decimals << shift);
+        unsigned __int128 half = (unsigned __int128)1 << (shift - 1);
+        /* Четность последней выводимой цифры: при precision == 0 это цифра целой части */
+        uint64_t odd = (precision == 0 ? integer : decimals) & 1;
+        if (rest > half || (rest == half && odd)) {
+            decimals++;
+        }
+    }
+    if (decimals >= scale) {
+        integer++;
+        decimals -= scale;
+    }
+
+    int length = 0;
+    if (bits >> 63) {
+        out[length++] = '-';
+    }
+    length += write_unsigned(integer, out + length);
+    if (precision > 0) {
+        out[length++] = '.';
+        for (int iter = precision - 1; iter >= 0; iter--) {
+            out[length + iter] = (char)('0' + decimals % 10);
+            decimals /= 10;
+        }
+        length += precision;
+    }
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file double_format.h
+ * @brief Быстрое форматирование чисел double без printf
+ * @ingroup Matrix_Output-Input
+ * @{
+ */
+
+#ifndef DOUBLE_FORMAT_H
+#define DOUBLE_FORMAT_H
+
+/**
+ * @brief Размер буфера для format_double_shortest (включая нулевой символ)
+ */
+#define DOUBLE_FORMAT_SHORTEST_MAX 32
+
+/**
+ * @brief Размер буфера для format_double_fixed с заданной точностью
+ */
+#define DOUBLE_FORMAT_FIXED_MAX(precision) (320 + (precision))
+
+/**
+ * @brief Наибольшее число цифр до точки, записываемое без порядка
+ */
+#define DOUBLE_FORMAT_PLAIN_DIGITS 16
+
+/**
+ * @brief Наибольшее число нулей после точки, записываемое без порядка
+ */
+#define DOUBLE_FORMAT_LEADING_ZEROS 5
+
+/**
+ * @brief Записывает кратчайшую строку, из которой strtod восстанавливает value точно
+ * @param value Число
+ * @param out Буфер размером не меньше DOUBLE_FORMAT_SHORTEST_MAX
+ * @return Длина записанной строки
+ *
+ * @note Используется алгоритм Grisu2: результат всегда читается обратно без
+ * потерь и в подавляющем большинстве случаев (более 99.9%) является кратчайшим.
+ * Большие и малые по модулю числа записываются с порядком: 1.5e-7, 1e22.
+ */
+int format_double_shortest(double value, char *out);
+
+/**
+ * @brief Записывает кратчайшую строку, из которой strtof восстанавливает value точно
+ * @param value Число
+ * @param out Буфер размером не меньше DOUBLE_FORMAT_SHORTEST_MAX
+ * @return Длина записанной строки
+ *
+ * @note Тот же алгоритм, что и в format_double_shortest, с интервалом округления float:
+ * например, 0.1f записывается как 0.1, а не как 0.10000000149011612.
+ */
+int format_float_shortest(float value, char *out);
+
+/**
+ * @brief Записывает число с фиксированным числом знаков после точки, как "%.*f"
+ * @param value Число
+ * @param precision Число знаков после точки
+ * @param out Буфер размером не меньше DOUBLE_FORMAT_FIXED_MAX(precision)
+ * @return Длина записанной строки
+ *
+ * @note Результат совпадает с printf: при |value| < 2^63 и precision <= 17
+ * округление выполняется точно в целочисленной арифметике, остальные случаи
+ * передаются snprintf.
+ */
+int format_double_fixed(double value, int precision, char *out);
+
+#endif
+
+/** @} */
@@ -0,0 +1,554 @@
+/**
+ * @file matrix_cache.c
+ * @brief Реализация дискового кэша матриц
+ * @ingroup Matrix_Output-Input
+ *
+ * Содержимое файлов и ключи операндов хэшируются по схеме xxHash64: четыре
+ * независимых 64-битных накопителя на блоках по 32 байта, поэтому хэширование
+ * входного файла занимает малую долю времени его разбора. Вытеснение выполняется
+ * после каждой записи просмотром каталога кэша; записи редки по сравнению с
+ * вычислениями, которые они заменяют.
+ */
+
+#include "matrix_cache.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/matrix_format.h"
+#include "../matrix/matrix_binary.h"
+#include "../matrix/matrix_operations.h"
+#include "../matrix/matrix_stats.h"
+#include "../matrix/matrix_text.h"
+#include "output.h"
+
+/**
+ * @brief Версия формата ключей: при изменении ключей или элементов старые элементы
+ *        перестают находиться
+ */
+#define MATRIX_CACHE_VERSION 1u
+
+/**
+ * @brief Длина имени элемента: 16 шестнадцатеричных цифр ключа и ".bin"
+ */
+#define MATRIX_CACHE_NAME_LENGTH 20
+
+/**
+ * @brief Размер буфера пути файла в каталоге кэша: каталог, '/' и имя файла до 255 байт
+ */
+#define ENTRY_PATH_MAX (MATRIX_CACHE_PATH_MAX + 320)
+
+/** Простые числа xxHash64 */
+#define HASH_PRIME1 11400714785092566791ULL
+#define HASH_PRIME2 14029467366897019727ULL
+#define HASH_PRIME3 1609587929392839161ULL
+#define HASH_PRIME4 9650029242287828579ULL
+#define HASH_PRIME5 2870177450012600261ULL
+
+/** Каталог кэша */
+static char cache_directory[MATRIX_CACHE_PATH_MAX];
+
+/** -1 - не задан, 0 - кэш выключен, 1 - каталог задан */
+static int directory_state = -1;
+
+/** Ограничение суммарного размера элементов */
+static size_t cache_limit = MATRIX_CACHE_DEFAULT_LIMIT;
+
+/** 1, если ограничение задано matrix_cache_set_limit */
+static int limit_set = 0;
+
+/** Счетчики кэша */
+static MatrixCacheStats cache_stats;
+
+/** Однократное чтение MATRIX_CACHE_DIR и MATRIX_CACHE_LIMIT */
+static pthread_once_t config_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Копирует путь каталога кэша без завершающих '/'
+ * @return 1 при успехе, 0 для пустого или слишком длинного пути
+ */
+static int set_directory(const char *directory) {
+    size_t length = strlen(directory);
+    while (length > 1 && directory[length - 1] == '/') {
+        length--;
+    }
+    if (length == 0 || length >= MATRIX_CACHE_PATH_MAX) {
+        return 0;
+    }
+    memcpy(cache_directory, directory, length);
+    cache_directory[length] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Разбирает размер в байтах с необязательным суффиксом K, M или G
+ * @return 1 при успехе, 0 при неверной записи
+ */
+static int parse_size(const char *text, size_t *bytes) {
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || errno != 0) {
+        return 0;
+    }
+    int shift = 0;
+    switch (*end) {
+    case 'K':
+    case 'k':
+        shift = 10;
+        break;
+    case 'M':
+    case 'm':
+        shift = 20;
+        break;
+    case 'G':
+    case 'g':
+        shift = 30;
+        break;
+    case '\0':
+        break;
+    default:
+        return 0;
+    }
+    if (shift != 0 && end[1] != '\0') {
+        return 0;
+    }
+    if (value > (SIZE_MAX >> shift)) {
+        return 0;
+    }
+    *bytes = (size_t)value << shift;
+    return 1;
+}
+
+/**
+ * @brief Выводит счетчики кэша при завершении программы
+ */
+static void print_at_exit(void) {
+    matrix_cache_print_stats(stderr);
+}
+
+/**
+ * @brief Читает MATRIX_CACHE_DIR и MATRIX_CACHE_LIMIT (однократно)
+ */
+static void read_config(void) {
+    const char *directory = getenv("MATRIX_CACHE_DIR");
+    /* Явный вызов matrix_cache_set_directory имеет приоритет */
+    if (directory_state < 0) {
+        directory_state = directory != NULL && directory[0] != '\0' && set_directory(directory);
+        if (directory != NULL && directory[0] != '\0' && !directory_state) {
+            fprintf(stderr, "Неверное значение MATRIX_CACHE_DIR: %s\n", directory);
+        }
+        if (directory_state && matrix_stats_enabled()) {
+            atexit(print_at_exit);
+        }
+    }
+
+    const char *limit = getenv("MATRIX_CACHE_LIMIT");
+    size_t bytes;
+    if (limit != NULL && limit[0] != '\0' && !limit_set) {
+        if (parse_size(limit, &bytes)) {
+            cache_limit = bytes;
+        } else {
+            fprintf(stderr, "Неверное значение MATRIX_CACHE_LIMIT: %s\n", limit);
+        }
+    }
+}
+
+void matrix_cache_set_directory(const char *directory) {
+    pthread_once(&config_once, read_config);
+    if (directory == NULL) {
+        directory_state = 0;
+        return;
+    }
+    directory_state = set_directory(directory);
+    if (!directory_state) {
+        fprintf(stderr, "Недопустимый каталог кэша матриц: %s\n", directory);
+    }
+}
+
+void matrix_cache_set_limit(size_t bytes) {
+    pthread_once(&config_once, read_config);
+    cache_limit = bytes;
+    limit_set = 1;
+}
+
+int matrix_cache_enabled(void) {
+    pthread_once(&config_once, read_config);
+    return directory_state > 0;
+}
+
+/**
+ * @brief Читает 64-битное слово с невыровненного адреса
+ */
+static uint64_t read_u64(const unsigned char *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Читает 32-битное слово с невыровненного адреса
+ */
+static uint32_t read_u32(const unsigned char *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * @brief Добавляет 64-битное слово в накопитель
+ */
+static uint64_t hash_round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * HASH_PRIME2;
+    return rotate_left(accumulator, 31) * HASH_PRIME1;
+}
+
+/**
+ * @brief Вливает накопитель в итоговый хэш
+ */
+static uint64_t hash_merge(uint64_t hash, uint64_t accumulator) {
+    hash ^= hash_round(0, accumulator);
+    return hash * HASH_PRIME1 + HASH_PRIME4;
+}
+
+/**
+ * @brief 64-битный хэш последовательности байт (xxHash64)
+ * @param data Данные
+ * @param length Длина в байтах
+ * @param seed Начальное значение
+ */
+static uint64_t hash_bytes(const void *data, size_t length, uint64_t seed) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    const unsigned char *end = bytes + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        uint64_t acc1 = seed + HASH_PRIME1 + HASH_PRIME2;
+        uint64_t acc2 = seed + HASH_PRIME2;
+        uint64_t acc3 = seed;
+        uint64_t acc4 = seed - HASH_PRIME1;
+        const unsigned char *limit = end - 32;
+        do {
+            acc1 = hash_round(acc1, read_u64(bytes));
+            acc2 = hash_round(acc2, read_u64(bytes + 8));
+            acc3 = hash_round(acc3, read_u64(bytes + 16));
+            acc4 = hash_round(acc4, read_u64(bytes + 24));
+            bytes += 32;
+        } while (bytes <= limit);
+        hash = rotate_left(acc1, 1) + rotate_left(acc2, 7) + rotate_left(acc3, 12) +
+               rotate_left(acc4, 18);
+        hash = hash_merge(hash, acc1);
+        hash = hash_merge(hash, acc2);
+        hash = hash_merge(hash, acc3);
+        hash = hash_merge(hash, acc4);
+    } else {
+        hash = seed + HASH_PRIME5;
+    }
+    hash += (uint64_t)length;
+
+    for (; bytes + 8 <= end; bytes += 8) {
+        hash ^= hash_round(0, read_u64(bytes));
+        hash = rotate_left(hash, 27) * HASH_PRIME1 + HASH_PRIME4;
+    }
+    if (bytes + 4 <= end) {
+        hash ^= (uint64_t)read_u32(bytes) * HASH_PRIME1;
+        hash = rotate_left(hash, 23) * HASH_PRIME2 + HASH_PRIME3;
+        bytes += 4;
+    }
+    for (; bytes < end; bytes++) {
+        hash ^= (uint64_t)*bytes * HASH_PRIME5;
+        hash = rotate_left(hash, 11) * HASH_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+MatrixHash matrix_cache_key(const char *operation, const MatrixHash *operands, int count) {
+    uint64_t hash = hash_bytes(operation, strlen(operation) + 1, MATRIX_CACHE_VERSION);
+    for (int iter = 0; iter < count; iter++) {
+        hash = hash_bytes(&operands[iter], sizeof(operands[iter]), hash);
+    }
+    return hash;
+}
+
+/**
+ * @brief Путь элемента кэша с ключом key
+ */
+static void entry_path(MatrixHash key, char *path, size_t size) {
+    snprintf(path, size, "%s/%016" PRIx64 ".bin", cache_directory, key);
+}
+
+/**
+ * @brief Проверяет, что имя файла - имя элемента кэша
+ */
+static int is_entry_name(const char *name) {
+    if (strlen(name) != MATRIX_CACHE_NAME_LENGTH || strcmp(name + 16, ".bin") != 0) {
+        return 0;
+    }
+    for (int iter = 0; iter < 16; iter++) {
+        if (strchr("0123456789abcdef", name[iter]) == NULL) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int matrix_cache_lookup(MatrixHash key, Matrix *mat) {
+    if (!matrix_cache_enabled()) {
+        return 0;
+    }
+    char path[ENTRY_PATH_MAX];
+    entry_path(key, path, sizeof(path));
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISREG(info.st_mode)) {
+        __atomic_fetch_add(&cache_stats.misses, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    const char *error = NULL;
+    if (matrix_binary_try_load(path, mat, &error) != 0) {
+        /* Поврежденный или недописанный элемент удаляется и считается промахом */
+        unlink(path);
+        __atomic_fetch_add(&cache_stats.misses, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    /* Время изменения файла служит временем последнего использования для вытеснения */
+    utimensat(AT_FDCWD, path, NULL, 0);
+    __atomic_fetch_add(&cache_stats.hits, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cache_stats.bytes_read, (uint64_t)info.st_size, __ATOMIC_RELAXED);
+    return 1;
+}
+
+/**
+ * @brief Элемент каталога кэша при вытеснении
+ */
+typedef struct {
+    struct timespec used;                       /**< Время последнего использования */
+    off_t size;                                 /**< Размер файла */
+    char name[MATRIX_CACHE_NAME_LENGTH + 1];    /**< Имя файла */
+} CacheEntry;
+
+/**
+ * @brief Сравнивает элементы по времени последнего использования (давние - первыми)
+ */
+static int compare_entries(const void *lhs, const void *rhs) {
+    const CacheEntry *entry1 = (const CacheEntry *)lhs;
+    const CacheEntry *entry2 = (const CacheEntry *)rhs;
+    if (entry1->used.tv_sec != entry2->used.tv_sec) {
+        return entry1->used.tv_sec < entry2->used.tv_sec ? -1 : 1;
+    }
+    if (entry1->used.tv_nsec != entry2->used.tv_nsec) {
+        return entry1->used.tv_nsec < entry2->used.tv_nsec ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Удаляет давно не использованные элементы, пока их размер больше ограничения
+ * @param keep Имя только что записанного элемента, который не удаляется
+ */
+static void evict_entries(const char *keep) {
+    DIR *dir = opendir(cache_directory);
+    if (dir == NULL) {
+        return;
+    }
+    CacheEntry *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    uint64_t total = 0;
+    char path[ENTRY_PATH_MAX];
+    struct dirent *item;
+    while ((item = readdir(dir)) != NULL) {
+        struct stat info;
+        snprintf(path, sizeof(path), "%s/%s", cache_directory, item->d_name);
+        if (!is_entry_name(item->d_name) || stat(path, &info) != 0) {
+            continue;
+        }
+        total += (uint64_t)info.st_size;
+        if (strcmp(item->d_name, keep) == 0) {
+            continue;
+        }
+        if (count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            CacheEntry *grown = (CacheEntry *)realloc(entries, capacity * sizeof(CacheEntry));
+            if (grown == NULL) {
+                break;
+            }
+            entries = grown;
+        }
+        entries[count].used = info.st_mtim;
+        entries[count].size = info.st_size;
+        strcpy(entries[count].name, item->d_name);
+        count++;
+    }
+    closedir(dir);
+
+    if (total > cache_limit) {
+        qsort(entries, count, sizeof(CacheEntry), compare_entries);
+        for (size_t iter = 0; iter < count && total > cache_limit; iter++) {
+            snprintf(path, sizeof(path), "%s/%s", cache_directory, entries[iter].name);
+            if (unlink(path) == 0) {
+                total -= (uint64_t)entries[iter].size;
+                __atomic_fetch_add(&cache_stats.evictions, 1, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    free(entries);
+}
+
+void matrix_cache_store(MatrixHash key, const Matrix *mat) {
+    if (!matrix_cache_enabled() || mat == NULL || mat->data == NULL) {
+        return;
+    }
+    const uint64_t bytes = MATRIX_FILE_HEADER_SIZE + (uint64_t)mat->rows *
+                                                         (uint64_t)matrix_stride_for(mat->cols) *
+                                                         sizeof(double);
+    if (bytes > cache_limit) {
+        return;
+    }
+    if (mkdir(cache_directory, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Невозможно создать каталог кэша матриц %s: %s\n", cache_directory,
+                strerror(errno));
+        return;
+    }
+
+    // Элемент пишется во временный файл и появляется под своим именем только целиком
+    char path[ENTRY_PATH_MAX];
+    char temp[ENTRY_PATH_MAX];
+    entry_path(key, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s/%016" PRIx64 ".tmp.%ld", cache_directory, key,
+             (long)getpid());
+    if (save_matrix_to_binary_file(mat, temp) != 0) {
+        unlink(temp);
+        return;
+    }
+    if (rename(temp, path) != 0) {
+        fprintf(stderr, "Невозможно записать элемент кэша матриц %s: %s\n", path,
+                strerror(errno));
+        unlink(temp);
+        return;
+    }
+    __atomic_fetch_add(&cache_stats.stores, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cache_stats.bytes_written, bytes, __ATOMIC_RELAXED);
+    evict_entries(strrchr(path, '/') + 1);
+}
+
+int matrix_cache_try_load_file(const char *filename, Matrix *mat, MatrixHash *hash, char *error,
+                               size_t error_size) {
+    *hash = 0;
+    if (!matrix_cache_enabled()) {
+        return matrix_try_load_file(filename, mat, error, error_size);
+    }
+    TextFile text;
+    if (text_file_try_open(filename, &text) != 0) {
+        snprintf(error, error_size, "Невозможно открыть файл %s: %s", filename, strerror(errno));
+        return -1;
+    }
+    const int binary = text.length >= MATRIX_FILE_MAGIC_SIZE &&
+                       memcmp(text.text, MATRIX_FILE_MAGIC, MATRIX_FILE_MAGIC_SIZE) == 0;
+    const MatrixHash content = hash_bytes(text.text, text.length, MATRIX_CACHE_VERSION);
+    const MatrixHash key = matrix_cache_key("load", &content, 1);
+    int status = 0;
+    if (binary) {
+        status = matrix_try_load_file(filename, mat, error, error_size);
+    } else if (!matrix_cache_lookup(key, mat)) {
+        status = matrix_try_parse_text(text.text, text.length, filename, mat, error, error_size);
+        if (status == 0) {
+            matrix_cache_store(key, mat);
+        }
+    }
+    text_file_close(&text);
+    if (status == 0) {
+        *hash = key;
+    }
+    return status;
+}
+
+Matrix matrix_cache_load_file(const char *filename, MatrixHash *hash) {
+    Matrix mat;
+    char error[MATRIX_TEXT_ERROR_MAX + MATRIX_CACHE_PATH_MAX];
+    if (matrix_cache_try_load_file(filename, &mat, hash, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s!\n", error);
+        exit(EXIT_FAILURE);
+    }
+    return mat;
+}
+
+Matrix matrix_cache_multiply(Matrix mat1, MatrixHash hash1, Matrix mat2, MatrixHash hash2,
+                             MatrixHash *hash) {
+    *hash = 0;
+    if (!matrix_cache_enabled()) {
+        return multiply_matrices(mat1, mat2);
+    }
+    const MatrixHash operands[2] = {hash1, hash2};
+    *hash = matrix_cache_key("multiply", operands, 2);
+    Matrix result;
+    if (!matrix_cache_lookup(*hash, &result)) {
+        result = multiply_matrices(mat1, mat2);
+        matrix_cache_store(*hash, &result);
+    }
+    return result;
+}
+
+void matrix_cache_clear(void) {
+    if (!matrix_cache_enabled()) {
+        return;
+    }
+    DIR *dir = opendir(cache_directory);
+    if (dir == NULL) {
+        return;
+    }
+    char path[ENTRY_PATH_MAX];
+    struct dirent *item;
+    while ((item = readdir(dir)) != NULL) {
+        if (is_entry_name(item->d_name)) {
+            snprintf(path, sizeof(path), "%s/%s", cache_directory, item->d_name);
+            unlink(path);
+        }
+    }
+    closedir(dir);
+}
+
+void matrix_cache_get_stats(MatrixCacheStats *stats) {
+    stats->hits = __atomic_load_n(&cache_stats.hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&cache_stats.misses, __ATOMIC_RELAXED);
+    stats->stores = __atomic_load_n(&cache_stats.stores, __ATOMIC_RELAXED);
+    stats->evictions = __atomic_load_n(&cache_stats.evictions, __ATOMIC_RELAXED);
+    stats->bytes_read = __atomic_load_n(&cache_stats.bytes_read, __ATOMIC_RELAXED);
+    stats->bytes_written = __atomic_load_n(&cache_stats.bytes_written, __ATOMIC_RELAXED);
+}
+
+void matrix_cache_reset_stats(void) {
+    __atomic_store_n(&cache_stats.hits, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache_stats.misses, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache_stats.stores, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache_stats.evictions, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache_stats.bytes_read, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&cache_stats.bytes_written, 0, __ATOMIC_RELAXED);
+}
+
+void matrix_cache_print_stats(FILE *stream) {
+    MatrixCacheStats stats;
+    matrix_cache_get_stats(&stats);
+    const uint64_t lookups = stats.hits + stats.misses;
+    fprintf(stream, "\nКэш матриц (%s):\n", directory_state > 0 ? cache_directory : "выключен");
+    fprintf(stream, "%9s %9s %8s %9s %10s %12s %12s\n", "hits", "misses", "hit, %", "stores",
+            "evictions", "read, MB", "written, MB");
+    fprintf(stream, "%9" PRIu64 " %9" PRIu64 " %8.1f %9" PRIu64 " %10" PRIu64 " %12.3f %12.3f\n",
+            stats.hits, stats.misses, lookups > 0 ? 100.0 * (double)stats.hits / lookups : 0.0,
+            stats.stores, stats.evictions, (double)stats.bytes_read / 1e6,
+            (double)stats.bytes_written / 1e6);
+}
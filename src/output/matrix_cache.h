@@ -0,0 +1,169 @@
+/**
+ * @file matrix_cache.h
+ * @brief Дисковый кэш загруженных матриц и результатов операций по хэшу содержимого
+ * @ingroup Matrix_Output-Input
+ * @{
+ *
+ * Элемент кэша - двоичный файл матрицы (matrix_format.h) в каталоге кэша с именем
+ * по 64-битному ключу. Ключ загруженной матрицы вычисляется по хэшу содержимого
+ * файла, ключ результата операции - по имени операции и ключам операндов, поэтому
+ * неизменившийся входной файл не разбирается повторно, а произведение неизменившихся
+ * операндов (например, C·D) не вычисляется заново, даже если изменились другие входы.
+ * Найденный элемент отображается в память без копирования (load_matrix_from_binary_file).
+ *
+ * Кэш включается переменной окружения MATRIX_CACHE_DIR (каталог кэша) или функцией
+ * matrix_cache_set_directory; выключенный кэш не хэширует данные, и функции
+ * matrix_cache_load_file и matrix_cache_multiply просто загружают и умножают.
+ * Суммарный размер элементов ограничен MATRIX_CACHE_LIMIT байт (суффиксы K, M, G)
+ * или matrix_cache_set_limit: при превышении удаляются давно не использованные
+ * элементы (время последнего использования - время изменения файла, которое
+ * обновляется при каждом попадании). При MATRIX_STATS=1 счетчики попаданий и
+ * промахов выводятся в stderr при завершении программы.
+ *
+ * Элемент записывается во временный файл и переименовывается, поэтому
+ * одновременно работающие процессы не видят недописанных элементов. Ошибки
+ * записи кэша не прерывают вычисление: результат просто не сохраняется.
+ */
+
+#ifndef MATRIX_CACHE_H
+#define MATRIX_CACHE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../include/config.h"
+
+/**
+ * @brief Ограничение суммарного размера элементов кэша по умолчанию, байт
+ */
+#define MATRIX_CACHE_DEFAULT_LIMIT ((size_t)256 << 20)
+
+/**
+ * @brief Наибольшая длина пути каталога кэша
+ */
+#define MATRIX_CACHE_PATH_MAX 1024
+
+/**
+ * @brief Ключ элемента кэша (хэш содержимого или операции над операндами)
+ */
+typedef uint64_t MatrixHash;
+
+/**
+ * @brief Счетчики кэша текущего процесса
+ */
+typedef struct {
+    uint64_t hits;          /**< Найденные элементы */
+    uint64_t misses;        /**< Отсутствующие элементы */
+    uint64_t stores;        /**< Записанные элементы */
+    uint64_t evictions;     /**< Удаленные при вытеснении элементы */
+    uint64_t bytes_read;    /**< Размер найденных элементов, байт */
+    uint64_t bytes_written; /**< Размер записанных элементов, байт */
+} MatrixCacheStats;
+
+/**
+ * @brief Задает каталог кэша (приоритетнее MATRIX_CACHE_DIR)
+ * @param directory Каталог (создается при первой записи) или NULL, чтобы выключить кэш
+ * @warning Не должна вызываться одновременно с другими функциями кэша
+ */
+void matrix_cache_set_directory(const char *directory);
+
+/**
+ * @brief Задает ограничение суммарного размера элементов (приоритетнее MATRIX_CACHE_LIMIT)
+ * @param bytes Ограничение в байтах
+ */
+void matrix_cache_set_limit(size_t bytes);
+
+/**
+ * @brief Проверяет, включен ли кэш
+ * @return 1, если каталог кэша задан, 0 иначе
+ */
+int matrix_cache_enabled(void);
+
+/**
+ * @brief Вычисляет ключ результата операции
+ * @param operation Имя операции (например, "multiply")
+ * @param operands Ключи операндов в порядке операции
+ * @param count Число операндов
+ * @return Ключ элемента
+ */
+MatrixHash matrix_cache_key(const char *operation, const MatrixHash *operands, int count);
+
+/**
+ * @brief Ищет элемент кэша
+ * @param key Ключ элемента
+ * @param mat Найденная матрица (флаги MATRIX_MAPPED и MATRIX_READONLY, освобождается
+ *            через free_matrix)
+ * @return 1 при попадании, 0 при промахе или выключенном кэше
+ * @note Элемент с неверным заголовком или короче, чем указано в заголовке, удаляется
+ *       и считается промахом
+ */
+int matrix_cache_lookup(MatrixHash key, Matrix *mat);
+
+/**
+ * @brief Записывает элемент кэша и вытесняет старые элементы сверх ограничения размера
+ * @param key Ключ элемента
+ * @param mat Матрица
+ * @note Матрица больше ограничения размера не записывается
+ */
+void matrix_cache_store(MatrixHash key, const Matrix *mat);
+
+/**
+ * @brief Загружает матрицу из файла через кэш
+ * @param filename Путь к текстовому или двоичному файлу матрицы
+ * @param hash Ключ загруженной матрицы (0 при выключенном кэше)
+ * @return Матрица: при попадании - элемент кэша, отображенный в память, иначе
+ *         результат load_matrix_from_file; освобождается через free_matrix
+ * @note Разобранный текстовый файл сохраняется в кэш; двоичный файл загружается
+ *       напрямую, так как он и так не разбирается
+ * @warning При ошибке чтения файла выводит сообщение и завершает программу с EXIT_FAILURE
+ */
+Matrix matrix_cache_load_file(const char *filename, MatrixHash *hash);
+
+/**
+ * @brief Загружает матрицу из файла через кэш, возвращая ошибку вместо завершения программы
+ * @param filename Путь к текстовому или двоичному файлу матрицы
+ * @param mat Матрица (как у matrix_cache_load_file; при ошибке не изменяется)
+ * @param hash Ключ загруженной матрицы (0 при выключенном кэше или ошибке)
+ * @param error Буфер для сообщения об ошибке
+ * @param error_size Размер буфера
+ * @return 0 при успехе, -1 если файл не открывается, поврежден или содержит неверные данные
+ */
+int matrix_cache_try_load_file(const char *filename, Matrix *mat, MatrixHash *hash, char *error,
+                               size_t error_size);
+
+/**
+ * @brief Умножает матрицы через кэш
+ * @param mat1 Первая матрица
+ * @param hash1 Ключ первой матрицы
+ * @param mat2 Вторая матрица
+ * @param hash2 Ключ второй матрицы
+ * @param hash Ключ произведения (0 при выключенном кэше)
+ * @return Произведение: элемент кэша при попадании, иначе результат multiply_matrices
+ */
+Matrix matrix_cache_multiply(Matrix mat1, MatrixHash hash1, Matrix mat2, MatrixHash hash2,
+                             MatrixHash *hash);
+
+/**
+ * @brief Удаляет все элементы кэша
+ */
+void matrix_cache_clear(void);
+
+/**
+ * @brief Возвращает счетчики кэша
+ * @param stats Результат
+ */
+void matrix_cache_get_stats(MatrixCacheStats *stats);
+
+/**
+ * @brief Обнуляет счетчики кэша
+ */
+void matrix_cache_reset_stats(void);
+
+/**
+ * @brief Выводит счетчики кэша
+ * @param stream Поток вывода
+ */
+void matrix_cache_print_stats(FILE *stream);
+
+#endif
+
+/** @} */
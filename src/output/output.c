@@ -7,6 +7,212 @@
 #include "output.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "../include/matrix_format.h"
+#include "../matrix/matrix_float.h"
+#include "../matrix/matrix_operations.h"
+#include "../matrix/matrix_stats.h"
+#include "../matrix/thread_pool.h"
+#include "double_format.h"
+
+/**
+ * @brief Текст части строк пакета
+ */
+typedef struct {
+    char *data;      /**< Буфер */
+    size_t length;   /**< Занятая длина */
+    size_t capacity; /**< Размер буфера */
+    int failed;      /**< Не удалось выделить память */
+} OutputChunk;
+
+/**
+ * @brief Параметры форматирования пакета строк
+ */
+typedef struct {
+    const Matrix *mat;    /**< Выводимая матрица или NULL */
+    const MatrixF *mat_f; /**< Выводимая матрица float, если mat равна NULL */
+    int precision;        /**< Знаков после точки или OUTPUT_PRECISION_SHORTEST */
+    const char *format;   /**< Формат printf для элемента или NULL */
+    int first_row;        /**< Первая строка пакета */
+    int rows;             /**< Строк в пакете */
+    int parts;            /**< Частей пакета */
+    OutputChunk *chunks;  /**< Текст каждой части */
+} OutputJob;
+
+/**
+ * @brief Обеспечивает место еще для extra байт
+ */
+static int chunk_reserve(OutputChunk *chunk, size_t extra) {
+    if (chunk->length + extra <= chunk->capacity) {
+        return 1;
+    }
+    size_t capacity = chunk->capacity ? chunk->capacity : 4096;
+    while (capacity < chunk->length + extra) {
+        capacity *= 2;
+    }
+    char *data = realloc(chunk->data, capacity);
+    if (data == NULL) {
+        chunk->failed = 1;
+        return 0;
+    }
+    chunk->data = data;
+    chunk->capacity = capacity;
+    return 1;
+}
+
+/**
+ * @brief Дописывает элемент в формате printf
+ */
+static int chunk_append_formatted(OutputChunk *chunk, const char *format, double value) {
+    if (!chunk_reserve(chunk, 64)) {
+        return 0;
+    }
+    size_t room = chunk->capacity - chunk->length;
+    int length = snprintf(chunk->data + chunk->length, room, format, value);
+    if (length < 0) {
+        chunk->failed = 1;
+        return 0;
+    }
+    if ((size_t)length >= room) {
+        if (!chunk_reserve(chunk, (size_t)length + 1)) {
+            return 0;
+        }
+        snprintf(chunk->data + chunk->length, (size_t)length + 1, format, value);
+    }
+    chunk->length += (size_t)length;
+    return 1;
+}
+
+/**
+ * @brief Форматирует строки [begin, end) матрицы в chunk
+ */
+static void format_rows(const OutputJob *job, OutputChunk *chunk, int begin, int end) {
+    const int cols = job->mat != NULL ? job->mat->cols : job->mat_f->cols;
+    const size_t element_max = job->precision < 0 ? DOUBLE_FORMAT_SHORTEST_MAX
+                                                  : DOUBLE_FORMAT_FIXED_MAX(job->precision);
+    for (int iter = begin; iter < end; iter++) {
+        const double *row = job->mat != NULL ? MATRIX_ROW(*job->mat, iter) : NULL;
+        const float *row_f = job->mat != NULL ? NULL : MATRIX_ROW(*job->mat_f, iter);
+        for (int iter_2 = 0; iter_2 < cols; iter_2++) {
+            const double value = row != NULL ? row[iter_2] : row_f[iter_2];
+            if (job->format != NULL) {
+                if (!chunk_append_formatted(chunk, job->format, value)) {
+                    return;
+                }
+                continue;
+            }
+            if (!chunk_reserve(chunk, element_max + 1)) {
+                return;
+            }
+            char *out = chunk->data + chunk->length;
+            int length;
+            if (job->precision >= 0) {
+                length = format_double_fixed(value, job->precision, out);
+            } else if (row != NULL) {
+                length = format_double_shortest(value, out);
+            } else {
+                length = format_float_shortest(row_f[iter_2], out);
+            }
+            out[length] = ' ';
+            chunk->length += (size_t)length + 1;
+        }
+        if (!chunk_reserve(chunk, 1)) {
+            return;
+        }
+        chunk->data[chunk->length++] = '\n';
+    }
+}
+
+static void format_task(void *ctx, int begin, int end) {
+    OutputJob *job = ctx;
+    for (int part = begin; part < end; part++) {
+        OutputChunk *chunk = &job->chunks[part];
+        chunk->length = 0;
+        int first = job->first_row + (int)((long long)job->rows * part / job->parts);
+        int last = job->first_row + (int)((long long)job->rows * (part + 1) / job->parts);
+        format_rows(job, chunk, first, last);
+    }
+}
+
+/**
+ * @brief Выводит строки матрицы пакетами: строки пакета форматируются параллельно
+ * по частям, затем каждая часть записывается в поток одним вызовом fwrite
+ * @param mat Матрица double или NULL, если выводится mat_f
+ */
+static int write_rows(FILE *stream, const Matrix *mat, const MatrixF *mat_f, int precision,
+                      const char *format) {
+    const int rows = mat != NULL ? mat->rows : mat_f->rows;
+    if (rows == 0) {
+        return 0;
+    }
+    const int cols_total = mat != NULL ? mat->cols : mat_f->cols;
+    const int cols = cols_total > 0 ? cols_total : 1;
+    const int batch_rows = cols >= OUTPUT_BATCH_ELEMENTS ? 1 : OUTPUT_BATCH_ELEMENTS / cols;
+    int parts = matrix_get_num_threads();
+    if ((long long)rows * cols < OUTPUT_PARALLEL_MIN_ELEMENTS) {
+        parts = 1;
+    }
+
+    OutputChunk *chunks = calloc((size_t)parts, sizeof(OutputChunk));
+    if (chunks == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для вывода матрицы!\n");
+        return -1;
+    }
+    OutputJob job = {.mat = mat,
+                     .mat_f = mat_f,
+                     .precision = precision,
+                     .format = format,
+                     .chunks = chunks};
+
+    int status = 0;
+    for (int first = 0; first < rows && status == 0; first += batch_rows) {
+        job.first_row = first;
+        job.rows = rows - first < batch_rows ? rows - first : batch_rows;
+        job.parts = job.rows < parts ? job.rows : parts;
+        if (job.parts > 1) {
+            parallel_for(job.parts, 1, format_task, &job);
+        } else {
+            format_task(&job, 0, 1);
+        }
+        for (int part = 0; part < job.parts && status == 0; part++) {
+            if (chunks[part].failed) {
+                fprintf(stderr, "Ошибка выделения памяти для вывода матрицы!\n");
+                status = -1;
+            } else if (fwrite(chunks[part].data, 1, chunks[part].length, stream) !=
+                       chunks[part].length) {
+                status = -1;
+            }
+        }
+    }
+
+    for (int part = 0; part < parts; part++) {
+        free(chunks[part].data);
+    }
+    free(chunks);
+    return status;
+}
+
+int write_matrix_text(FILE *stream, const Matrix *mat, int precision) {
+    if (stream == NULL || mat == NULL || mat->data == NULL) {
+        fprintf(stderr, "Ошибка: Неверные входные параметры!\n");
+        return -1;
+    }
+    const uint64_t stats = matrix_stats_begin();
+    int status = write_rows(stream, mat, NULL, precision, NULL);
+    matrix_stats_end(MATRIX_STAT_WRITE_TEXT, stats, (double)mat->rows * mat->cols, 0, 0);
+    return status;
+}
+
+int write_matrix_text_f(FILE *stream, const MatrixF *mat, int precision) {
+    if (stream == NULL || mat == NULL || mat->data == NULL) {
+        fprintf(stderr, "Ошибка: Неверные входные параметры!\n");
+        return -1;
+    }
+    const uint64_t stats = matrix_stats_begin();
+    int status = write_rows(stream, NULL, mat, precision, NULL);
+    matrix_stats_end(MATRIX_STAT_WRITE_TEXT_F, stats, (double)mat->rows * mat->cols, 0, 0);
+    return status;
+}
 
 /**
  * @brief Печатает матрицу с заданной точностью
@@ -22,15 +228,43 @@ void print_matrix(const Matrix *mat, int precision) {
         return;
     }
 
-    char format[10];
-    snprintf(format, sizeof(format), "%%.%df ", precision);
+    const uint64_t stats = matrix_stats_begin();
+    write_rows(stdout, mat, NULL, precision < 0 ? 0 : precision, NULL);
+    matrix_stats_end(MATRIX_STAT_PRINT, stats, (double)mat->rows * mat->cols, 0, 0);
+}
 
-    for (int iter = 0; iter < mat->rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat->cols; iter_2++) {
-            printf(format, mat->data[iter][iter_2]);
-        }
-        printf("\n");
+void print_matrix_f(const MatrixF *mat, int precision) {
+    if (mat == NULL || mat->data == NULL) {
+        fprintf(stderr, "Ошибка: Неверная матрица!\n");
+        return;
+    }
+    const uint64_t stats = matrix_stats_begin();
+    write_rows(stdout, NULL, mat, precision < 0 ? 0 : precision, NULL);
+    matrix_stats_end(MATRIX_STAT_PRINT_F, stats, (double)mat->rows * mat->cols, 0, 0);
+}
+
+/**
+ * @brief Записывает текстовый файл: размеры, затем элементы кратчайшей записью
+ * @param mat Матрица double или NULL, если сохраняется mat_f
+ */
+static int save_text(const Matrix *mat, const MatrixF *mat_f, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("Ошибка открытя файла!");
+        return -1;
     }
+
+    // Размеры матрицы
+    fprintf(file, "%d %d\n", mat != NULL ? mat->rows : mat_f->rows,
+            mat != NULL ? mat->cols : mat_f->cols);
+
+    // Данные матрицы
+    int status = write_rows(file, mat, mat_f, OUTPUT_PRECISION_SHORTEST, NULL);
+    if (fclose(file) != 0 || status != 0) {
+        perror("Ошибка записи файла!");
+        status = -1;
+    }
+    return status;
 }
 
 /**
@@ -42,7 +276,7 @@ void print_matrix(const Matrix *mat, int precision) {
  * @note Формат файла:
  * - Первая строка: количество строк и столбцов
  * - Последующие строки: элементы матрицы
- * - Элементы сохраняются с фиксированной точностью 6 знаков после запятой
+ * - Элементы сохраняются кратчайшей записью, читаемой обратно без потери точности
  */
 int save_matrix_to_file(const Matrix *mat, const char *filename) {
     if (mat == NULL || mat->data == NULL || filename == NULL) {
@@ -50,25 +284,101 @@ int save_matrix_to_file(const Matrix *mat, const char *filename) {
         return -1;
     }
 
-    FILE *file = fopen(filename, "w");
+    const uint64_t stats = matrix_stats_begin();
+    int status = save_text(mat, NULL, filename);
+    matrix_stats_end(MATRIX_STAT_SAVE_TEXT, stats,
+                     status == 0 ? (double)mat->rows * mat->cols : 0.0, 0, 0);
+    return status;
+}
+
+int save_matrix_to_file_f(const MatrixF *mat, const char *filename) {
+    if (mat == NULL || mat->data == NULL || filename == NULL) {
+        fprintf(stderr, "Ошибка: Неверные входные параметры!\n");
+        return -1;
+    }
+    const uint64_t stats = matrix_stats_begin();
+    int status = save_text(NULL, mat, filename);
+    matrix_stats_end(MATRIX_STAT_SAVE_TEXT_F, stats,
+                     status == 0 ? (double)mat->rows * mat->cols : 0.0, 0, 0);
+    return status;
+}
+
+/**
+ * @brief Записывает двоичный файл матрицы с элементами типа dtype
+ * @param data Первая строка матрицы
+ * @param size Размер элемента в байтах
+ * @param mem_stride Шаг строк матрицы в памяти в элементах
+ * @param file_stride Шаг строк в файле в элементах (не меньше cols)
+ */
+static int save_binary(const char *filename, int rows, int cols, const void *data, size_t size,
+                       int mem_stride, int file_stride, uint32_t dtype) {
+    FILE *file = fopen(filename, "wb");
     if (file == NULL) {
         perror("Ошибка открытя файла!");
         return -1;
     }
 
-    // Размеры матрицы
-    fprintf(file, "%d %d\n", mat->rows, mat->cols);
+    MatrixFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MATRIX_FILE_MAGIC, MATRIX_FILE_MAGIC_SIZE);
+    header.version = MATRIX_FILE_VERSION;
+    header.dtype = dtype;
+    header.endianness = MATRIX_FILE_ENDIAN_MARK;
+    header.alignment = MATRIX_ALIGNMENT;
+    header.rows = (uint64_t)rows;
+    header.cols = (uint64_t)cols;
+    header.stride = (uint64_t)file_stride;
+    header.data_offset = MATRIX_FILE_HEADER_SIZE;
 
-    // Данные матрицы
-    for (int iter = 0; iter < mat->rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat->cols; iter_2++) {
-            fprintf(file, "%.6f ", mat->data[iter][iter_2]);
-        }
-        fprintf(file, "\n");
+    static const char padding[MATRIX_ALIGNMENT] = {0};
+    const size_t pad = (size_t)(file_stride - cols) * size;
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int iter = 0; ok && iter < rows; iter++) {
+        const char *row = (const char *)data + (size_t)iter * (size_t)mem_stride * size;
+        ok = fwrite(row, size, (size_t)cols, file) == (size_t)cols &&
+             fwrite(padding, 1, pad, file) == pad;
+    }
+    if (fclose(file) != 0 || !ok) {
+        perror("Ошибка записи файла!");
+        ok = 0;
     }
+    return ok ? 0 : -1;
+}
 
-    fclose(file);
-    return 0;
+/**
+ * @brief Сохраняет матрицу в двоичном формате
+ * @param mat Указатель на матрицу для сохранения
+ * @param filename Имя файла для сохранения
+ * @return 0 в случае успеха, -1 при ошибке
+ *
+ * @note Строки дополняются нулями до шага matrix_stride_for(cols), чтобы при
+ * загрузке отображением в память они были выровнены так же, как в create_matrix
+ */
+int save_matrix_to_binary_file(const Matrix *mat, const char *filename) {
+    if (mat == NULL || mat->data == NULL || filename == NULL) {
+        fprintf(stderr, "Ошибка: Неверные входные параметры!\n");
+        return -1;
+    }
+
+    const uint64_t stats = matrix_stats_begin();
+    int status = save_binary(filename, mat->rows, mat->cols, mat->data, sizeof(double),
+                             mat->stride, matrix_stride_for(mat->cols), MATRIX_DTYPE_FLOAT64);
+    matrix_stats_end(MATRIX_STAT_SAVE_BINARY, stats,
+                     status == 0 ? (double)mat->rows * mat->cols : 0.0, 0, 0);
+    return status;
+}
+
+int save_matrix_to_binary_file_f(const MatrixF *mat, const char *filename) {
+    if (mat == NULL || mat->data == NULL || filename == NULL) {
+        fprintf(stderr, "Ошибка: Неверные входные параметры!\n");
+        return -1;
+    }
+    const uint64_t stats = matrix_stats_begin();
+    int status = save_binary(filename, mat->rows, mat->cols, mat->data, sizeof(float),
+                             mat->stride, matrix_stride_for_f(mat->cols), MATRIX_DTYPE_FLOAT32);
+    matrix_stats_end(MATRIX_STAT_SAVE_BINARY_F, stats,
+                     status == 0 ? (double)mat->rows * mat->cols : 0.0, 0, 0);
+    return status;
 }
 
 /**
@@ -85,10 +395,7 @@ void print_matrix_formatted(const Matrix *mat, const char *format) {
         return;
     }
 
-    for (int iter = 0; iter < mat->rows; iter++) {
-        for (int iter_2 = 0; iter_2 < mat->cols; iter_2++) {
-            printf(format, mat->data[iter][iter_2]);
-        }
-        printf("\n");
-    }
+    const uint64_t stats = matrix_stats_begin();
+    write_rows(stdout, mat, NULL, 0, format);
+    matrix_stats_end(MATRIX_STAT_PRINT_FORMATTED, stats, (double)mat->rows * mat->cols, 0, 0);
 }
\ No newline at end of file
@@ -12,6 +12,34 @@
 #include <stdlib.h>
 #include "../include/config.h"
 
+/**
+ * @brief Значение точности для кратчайшей записи, читаемой обратно без потерь
+ */
+#define OUTPUT_PRECISION_SHORTEST (-1)
+
+/**
+ * @brief Число элементов в пакете строк, форматируемом перед записью в поток
+ */
+#define OUTPUT_BATCH_ELEMENTS (1 << 16)
+
+/**
+ * @brief Минимальное число элементов матрицы для параллельного форматирования
+ */
+#define OUTPUT_PARALLEL_MIN_ELEMENTS (1 << 12)
+
+/**
+ * @brief Записывает элементы матрицы в поток в текстовом виде
+ * @param stream Поток для записи
+ * @param mat Указатель на матрицу
+ * @param precision Количество знаков после точки или OUTPUT_PRECISION_SHORTEST
+ * @return 0 при успешной записи, -1 при ошибке
+ *
+ * @note Формат такой же, как у print_matrix: элемент и пробел, строки разделены
+ * переносами. Числа форматируются без printf (double_format.h), строки пакета
+ * форматируются параллельно и записываются в поток одним вызовом fwrite.
+ */
+int write_matrix_text(FILE *stream, const Matrix *mat, int precision);
+
 /**
  * @brief Выводит матрицу в стандартный вывод с заданной точностью
  * @param mat Указатель на матрицу для вывода
@@ -30,11 +58,62 @@ void print_matrix(const Matrix *mat, int precision);
  *
  * @note Формат файла:
  * - Первая строка: количество строк и столбцов
- * - Последующие строки: элементы матрицы
+ * - Последующие строки: элементы матрицы в кратчайшей записи, из которой
+ *   load_matrix_from_file восстанавливает их точно
  * @warning При ошибке открытия файла возвращает -1 и выводит сообщение в stderr
  */
 int save_matrix_to_file(const Matrix *mat, const char *filename);
 
+/**
+ * @brief Сохраняет матрицу в двоичном формате
+ * @param mat Указатель на матрицу для сохранения
+ * @param filename Имя файла для сохранения
+ * @return 0 при успешном сохранении, -1 при ошибке
+ *
+ * @note Формат описан в matrix_format.h: заголовок 64 байта, затем строки,
+ * дополненные до шага matrix_stride_for(cols). Элементы сохраняются без потери
+ * точности, а файл загружается load_matrix_from_file без разбора и копирования.
+ * @warning При ошибке открытия или записи файла возвращает -1 и выводит сообщение в stderr
+ */
+int save_matrix_to_binary_file(const Matrix *mat, const char *filename);
+
+/**
+ * @brief Записывает элементы матрицы float в поток (см. write_matrix_text)
+ * @param stream Поток вывода
+ * @param mat Матрица float
+ * @param precision Количество знаков после запятой или OUTPUT_PRECISION_SHORTEST
+ * @return 0 в случае успеха, -1 при ошибке
+ * @note При OUTPUT_PRECISION_SHORTEST элементы записываются кратчайшей записью float
+ *       (format_float_shortest): 0.1f выводится как 0.1
+ */
+int write_matrix_text_f(FILE *stream, const MatrixF *mat, int precision);
+
+/**
+ * @brief Выводит матрицу float в стандартный вывод с заданной точностью (см. print_matrix)
+ * @param mat Матрица float
+ * @param precision Количество знаков после запятой
+ */
+void print_matrix_f(const MatrixF *mat, int precision);
+
+/**
+ * @brief Сохраняет матрицу float в текстовый файл (см. save_matrix_to_file)
+ * @param mat Матрица float
+ * @param filename Имя файла для сохранения
+ * @return 0 в случае успеха, -1 при ошибке
+ * @note Файл читается load_matrix_from_file_f без потери точности
+ */
+int save_matrix_to_file_f(const MatrixF *mat, const char *filename);
+
+/**
+ * @brief Сохраняет матрицу float в двоичном формате с типом MATRIX_DTYPE_FLOAT32
+ * @param mat Матрица float
+ * @param filename Имя файла для сохранения
+ * @return 0 в случае успеха, -1 при ошибке
+ * @note Строки дополняются до шага matrix_stride_for_f(cols); файл загружается
+ *       load_matrix_from_file_f отображением в память
+ */
+int save_matrix_to_binary_file_f(const MatrixF *mat, const char *filename);
+
 /**
  * @brief Выводит матрицу с пользовательским форматированием
  * @param mat Указатель на матрицу для вывода
@@ -0,0 +1,649 @@
+/**
+ * @file matrix_server.c
+ * @brief Реализация пакетного режима с именованными матрицами
+ * @ingroup Matrix_Server
+ *
+ * Именованные матрицы хранятся в массиве с линейным поиском: в сеансе обычно
+ * несколько матриц, и поиск по имени пренебрежимо мал по сравнению с вычислением.
+ * Выражение разбирается рекурсивным спуском сразу в дерево matrix_expr.h, при этом
+ * размеры операндов проверяются до создания узлов, так как конструкторы узлов
+ * завершают программу при несовпадении размеров.
+ */
+
+#include "matrix_server.h"
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "../matrix/matrix_expr.h"
+#include "../matrix/matrix_operations.h"
+#include "../output/matrix_cache.h"
+#include "../output/output.h"
+
+/**
+ * @brief Длина очереди соединений, ожидающих accept
+ */
+#define MATRIX_SERVER_BACKLOG 8
+
+/**
+ * @brief Размер буфера сообщения об ошибке и сведений строки состояния
+ */
+#define MATRIX_SERVER_MESSAGE_MAX 256
+
+/**
+ * @brief Наибольшая точность команды print
+ */
+#define MATRIX_SERVER_MAX_PRECISION 30
+
+/**
+ * @brief Именованная матрица сервера
+ */
+typedef struct {
+    char name[MATRIX_SERVER_NAME_MAX + 1]; /**< Имя матрицы */
+    Matrix mat;                            /**< Матрица (принадлежит серверу) */
+} ServerEntry;
+
+struct MatrixServer {
+    ServerEntry *entries; /**< Именованные матрицы */
+    int count;            /**< Число матриц */
+    int capacity;         /**< Емкость массива entries */
+};
+
+/**
+ * @brief Ответ на команду: сообщение об ошибке или сведения строки состояния
+ */
+typedef struct {
+    int failed;                               /**< 1, если команда завершилась ошибкой */
+    char message[MATRIX_SERVER_MESSAGE_MAX];  /**< Текст после времени выполнения */
+} ServerReply;
+
+/**
+ * @brief Записывает в ответ сведения или сообщение об ошибке (printf-формат)
+ */
+static void reply_set(ServerReply *reply, int failed, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    reply->failed = failed;
+    vsnprintf(reply->message, sizeof(reply->message), format, args);
+    va_end(args);
+}
+
+/**
+ * @brief Текущее время монотонных часов в наносекундах
+ */
+static double now_ns(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec * 1e9 + (double)time.tv_nsec;
+}
+
+MatrixServer *matrix_server_create(void) {
+    MatrixServer *server = (MatrixServer *)calloc(1, sizeof(MatrixServer));
+    if (server == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для сервера матриц!\n");
+        exit(EXIT_FAILURE);
+    }
+    return server;
+}
+
+void matrix_server_destroy(MatrixServer *server) {
+    if (server == NULL) {
+        return;
+    }
+    for (int iter = 0; iter < server->count; iter++) {
+        free_matrix(server->entries[iter].mat);
+    }
+    free(server->entries);
+    free(server);
+}
+
+/**
+ * @brief Возвращает номер матрицы с именем name или -1
+ */
+static int find_entry(const MatrixServer *server, const char *name) {
+    for (int iter = 0; iter < server->count; iter++) {
+        if (strcmp(server->entries[iter].name, name) == 0) {
+            return iter;
+        }
+    }
+    return -1;
+}
+
+const Matrix *matrix_server_find(const MatrixServer *server, const char *name) {
+    const int index = find_entry(server, name);
+    return index < 0 ? NULL : &server->entries[index].mat;
+}
+
+/**
+ * @brief Сохраняет матрицу под именем name, освобождая прежнюю матрицу с этим именем
+ */
+static void store_entry(MatrixServer *server, const char *name, Matrix mat) {
+    const int index = find_entry(server, name);
+    if (index >= 0) {
+        free_matrix(server->entries[index].mat);
+        server->entries[index].mat = mat;
+        return;
+    }
+    if (server->count == server->capacity) {
+        const int capacity = server->capacity > 0 ? server->capacity * 2 : 8;
+        ServerEntry *entries =
+            (ServerEntry *)realloc(server->entries, (size_t)capacity * sizeof(ServerEntry));
+        if (entries == NULL) {
+            fprintf(stderr, "Ошибка выделения памяти для матриц сервера!\n");
+            exit(EXIT_FAILURE);
+        }
+        server->entries = entries;
+        server->capacity = capacity;
+    }
+    ServerEntry *entry = &server->entries[server->count++];
+    strcpy(entry->name, name);
+    entry->mat = mat;
+}
+
+/**
+ * @brief Проверяет, что символ может продолжать имя матрицы
+ */
+static int is_name_char(char symbol) {
+    return isalnum((unsigned char)symbol) || symbol == '_';
+}
+
+/**
+ * @brief Проверяет имя матрицы: буква или '_', затем буквы, цифры и '_'
+ */
+static int valid_name(const char *name) {
+    if (!isalpha((unsigned char)name[0]) && name[0] != '_') {
+        return 0;
+    }
+    size_t length = 1;
+    while (is_name_char(name[length])) {
+        length++;
+    }
+    return name[length] == '\0' && length <= MATRIX_SERVER_NAME_MAX;
+}
+
+/**
+ * @brief Выделяет следующее слово строки
+ * @param cursor Позиция в изменяемой строке; сдвигается за слово
+ * @return Слово, завершенное нулем, или NULL, если слов больше нет
+ */
+static char *next_word(char **cursor) {
+    char *begin = *cursor;
+    while (isspace((unsigned char)*begin)) {
+        begin++;
+    }
+    if (*begin == '\0') {
+        *cursor = begin;
+        return NULL;
+    }
+    char *end = begin;
+    while (*end != '\0' && !isspace((unsigned char)*end)) {
+        end++;
+    }
+    *cursor = *end != '\0' ? end + 1 : end;
+    *end = '\0';
+    return begin;
+}
+
+/**
+ * @brief Состояние разбора выражения
+ */
+typedef struct {
+    const MatrixServer *server; /**< Сервер, в котором ищутся имена матриц */
+    const char *pos;            /**< Текущая позиция в тексте выражения */
+    ServerReply *reply;         /**< Ответ, в который записывается ошибка разбора */
+} ExprParser;
+
+static MatrixExpr *parse_sum(ExprParser *parser);
+
+/**
+ * @brief Пропускает пробелы перед следующей лексемой
+ */
+static void skip_spaces(ExprParser *parser) {
+    while (isspace((unsigned char)*parser->pos)) {
+        parser->pos++;
+    }
+}
+
+/**
+ * @brief Пропускает пробелы и проверяет, начинается ли текст с token
+ * @return 1 и позиция за token, если начинается; иначе 0
+ */
+static int accept_token(ExprParser *parser, const char *token) {
+    skip_spaces(parser);
+    const size_t length = strlen(token);
+    if (strncmp(parser->pos, token, length) != 0) {
+        return 0;
+    }
+    parser->pos += length;
+    return 1;
+}
+
+/**
+ * @brief Разбирает имя матрицы или выражение в скобках
+ */
+static MatrixExpr *parse_primary(ExprParser *parser) {
+    if (accept_token(parser, "(")) {
+        MatrixExpr *inner = parse_sum(parser);
+        if (inner != NULL && !accept_token(parser, ")")) {
+            reply_set(parser->reply, 1, "ожидается ')' в позиции \"%.20s\"", parser->pos);
+            matrix_expr_free(inner);
+            return NULL;
+        }
+        return inner;
+    }
+
+    const char *begin = parser->pos;
+    if (!isalpha((unsigned char)*begin) && *begin != '_') {
+        reply_set(parser->reply, 1, "ожидается имя матрицы в позиции \"%.20s\"", begin);
+        return NULL;
+    }
+    const char *end = begin;
+    while (is_name_char(*end)) {
+        end++;
+    }
+    char name[MATRIX_SERVER_NAME_MAX + 1];
+    if ((size_t)(end - begin) > MATRIX_SERVER_NAME_MAX) {
+        reply_set(parser->reply, 1, "слишком длинное имя матрицы");
+        return NULL;
+    }
+    memcpy(name, begin, (size_t)(end - begin));
+    name[end - begin] = '\0';
+    parser->pos = end;
+
+    const Matrix *mat = matrix_server_find(parser->server, name);
+    if (mat == NULL) {
+        reply_set(parser->reply, 1, "неизвестная матрица %s", name);
+        return NULL;
+    }
+    return matrix_expr_leaf(*mat);
+}
+
+/**
+ * @brief Разбирает операнд с постфиксными транспонированиями (^T, **T, ')
+ */
+static MatrixExpr *parse_postfix(ExprParser *parser) {
+    MatrixExpr *expr = parse_primary(parser);
+    while (expr != NULL) {
+        // "**T" проверяется раньше умножения, поэтому A**T - транспонирование, а A*T - произведение
+        const char *saved = parser->pos;
+        if (accept_token(parser, "^T") || accept_token(parser, "'") ||
+            (accept_token(parser, "**T") && !is_name_char(*parser->pos))) {
+            expr = matrix_expr_transpose(expr);
+        } else {
+            parser->pos = saved;
+            break;
+        }
+    }
+    return expr;
+}
+
+/**
+ * @brief Разбирает произведение операндов
+ */
+static MatrixExpr *parse_product(ExprParser *parser) {
+    MatrixExpr *expr = parse_postfix(parser);
+    while (expr != NULL) {
+        const char *saved = parser->pos;
+        if (!accept_token(parser, "*") || *parser->pos == '*') {
+            parser->pos = saved;
+            break;
+        }
+        MatrixExpr *rhs = parse_postfix(parser);
+        if (rhs == NULL) {
+            matrix_expr_free(expr);
+            return NULL;
+        }
+        if (matrix_expr_cols(expr) != matrix_expr_rows(rhs)) {
+            reply_set(parser->reply, 1, "размеры не совпадают для умножения: %dx%d * %dx%d",
+                      matrix_expr_rows(expr), matrix_expr_cols(expr), matrix_expr_rows(rhs),
+                      matrix_expr_cols(rhs));
+            matrix_expr_free(expr);
+            matrix_expr_free(rhs);
+            return NULL;
+        }
+        expr = matrix_expr_multiply(expr, rhs);
+    }
+    return expr;
+}
+
+/**
+ * @brief Разбирает сумму и разность произведений
+ */
+static MatrixExpr *parse_sum(ExprParser *parser) {
+    MatrixExpr *expr = parse_product(parser);
+    while (expr != NULL) {
+        int subtract;
+        if (accept_token(parser, "+")) {
+            subtract = 0;
+        } else if (accept_token(parser, "-")) {
+            subtract = 1;
+        } else {
+            break;
+        }
+        MatrixExpr *rhs = parse_product(parser);
+        if (rhs == NULL) {
+            matrix_expr_free(expr);
+            return NULL;
+        }
+        if (matrix_expr_rows(expr) != matrix_expr_rows(rhs) ||
+            matrix_expr_cols(expr) != matrix_expr_cols(rhs)) {
+            reply_set(parser->reply, 1, "размеры не совпадают для %s: %dx%d и %dx%d",
+                      subtract ? "вычитания" : "сложения", matrix_expr_rows(expr),
+                      matrix_expr_cols(expr), matrix_expr_rows(rhs), matrix_expr_cols(rhs));
+            matrix_expr_free(expr);
+            matrix_expr_free(rhs);
+            return NULL;
+        }
+        expr = subtract ? matrix_expr_subtract(expr, rhs) : matrix_expr_plus(expr, rhs);
+    }
+    return expr;
+}
+
+/**
+ * @brief Команда load NAME PATH
+ */
+static void command_load(MatrixServer *server, char *args, ServerReply *reply) {
+    const char *name = next_word(&args);
+    const char *path = next_word(&args);
+    if (name == NULL || path == NULL || next_word(&args) != NULL) {
+        reply_set(reply, 1, "формат: load NAME PATH");
+        return;
+    }
+    if (!valid_name(name)) {
+        reply_set(reply, 1, "недопустимое имя матрицы %s", name);
+        return;
+    }
+    // Недоступный или поврежденный файл - ошибка запроса, а не повод завершать сервер
+    Matrix mat;
+    MatrixHash hash;
+    char error[MATRIX_SERVER_MESSAGE_MAX];
+    if (matrix_cache_try_load_file(path, &mat, &hash, error, sizeof(error)) != 0) {
+        reply_set(reply, 1, "%s", error);
+        return;
+    }
+    store_entry(server, name, mat);
+    reply_set(reply, 0, "%s %dx%d", name, mat.rows, mat.cols);
+}
+
+/**
+ * @brief Команда eval NAME EXPR
+ */
+static void command_eval(MatrixServer *server, char *args, ServerReply *reply) {
+    const char *name = next_word(&args);
+    if (name == NULL) {
+        reply_set(reply, 1, "формат: eval NAME EXPR");
+        return;
+    }
+    if (!valid_name(name)) {
+        reply_set(reply, 1, "недопустимое имя матрицы %s", name);
+        return;
+    }
+
+    ExprParser parser = {.server = server, .pos = args, .reply = reply};
+    MatrixExpr *expr = parse_sum(&parser);
+    if (expr == NULL) {
+        return;
+    }
+    skip_spaces(&parser);
+    if (*parser.pos != '\0') {
+        reply_set(reply, 1, "лишний текст в позиции \"%.20s\"", parser.pos);
+        matrix_expr_free(expr);
+        return;
+    }
+
+    // Результат того же размера записывается в буфер прежней матрицы с этим именем
+    const int rows = matrix_expr_rows(expr);
+    const int cols = matrix_expr_cols(expr);
+    const int index = find_entry(server, name);
+    Matrix *target = index >= 0 ? &server->entries[index].mat : NULL;
+    if (target != NULL && target->rows == rows && target->cols == cols &&
+        !(target->flags & MATRIX_READONLY)) {
+        matrix_expr_evaluate_into(target, expr);
+    } else {
+        store_entry(server, name, matrix_expr_evaluate(expr));
+    }
+    matrix_expr_free(expr);
+    reply_set(reply, 0, "%s %dx%d", name, rows, cols);
+}
+
+/**
+ * @brief Находит матрицу, указанную первым словом аргументов команды
+ * @return Номер матрицы или -1 (тогда в ответ записана ошибка)
+ */
+static int require_entry(const MatrixServer *server, const char *name, const char *usage,
+                         ServerReply *reply) {
+    if (name == NULL) {
+        reply_set(reply, 1, "формат: %s", usage);
+        return -1;
+    }
+    const int index = find_entry(server, name);
+    if (index < 0) {
+        reply_set(reply, 1, "неизвестная матрица %s", name);
+    }
+    return index;
+}
+
+/**
+ * @brief Команда print NAME [PRECISION]
+ */
+static void command_print(MatrixServer *server, char *args, ServerReply *reply, FILE *out) {
+    const char *usage = "print NAME [PRECISION]";
+    const int index = require_entry(server, next_word(&args), usage, reply);
+    if (index < 0) {
+        return;
+    }
+    int precision = 2;
+    const char *text = next_word(&args);
+    if (text != NULL) {
+        char *end;
+        const long value = strtol(text, &end, 10);
+        if (*end != '\0' || value < OUTPUT_PRECISION_SHORTEST ||
+            value > MATRIX_SERVER_MAX_PRECISION) {
+            reply_set(reply, 1, "недопустимая точность %s", text);
+            return;
+        }
+        precision = (int)value;
+    }
+    if (next_word(&args) != NULL) {
+        reply_set(reply, 1, "формат: %s", usage);
+        return;
+    }
+    const Matrix *mat = &server->entries[index].mat;
+    if (write_matrix_text(out, mat, precision) != 0) {
+        reply_set(reply, 1, "ошибка записи матрицы");
+        return;
+    }
+    reply_set(reply, 0, "%s %dx%d", server->entries[index].name, mat->rows, mat->cols);
+}
+
+/**
+ * @brief Команда save NAME PATH [binary]
+ */
+static void command_save(MatrixServer *server, char *args, ServerReply *reply) {
+    const char *usage = "save NAME PATH [binary]";
+    const int index = require_entry(server, next_word(&args), usage, reply);
+    if (index < 0) {
+        return;
+    }
+    const char *path = next_word(&args);
+    const char *mode = next_word(&args);
+    if (path == NULL || (mode != NULL && strcmp(mode, "binary") != 0) ||
+        next_word(&args) != NULL) {
+        reply_set(reply, 1, "формат: %s", usage);
+        return;
+    }
+    const Matrix *mat = &server->entries[index].mat;
+    const int status = mode != NULL ? save_matrix_to_binary_file(mat, path)
+                                    : save_matrix_to_file(mat, path);
+    if (status != 0) {
+        reply_set(reply, 1, "ошибка сохранения в файл %s", path);
+        return;
+    }
+    reply_set(reply, 0, "%s", path);
+}
+
+/**
+ * @brief Команда free NAME
+ */
+static void command_free(MatrixServer *server, char *args, ServerReply *reply) {
+    const char *usage = "free NAME";
+    const int index = require_entry(server, next_word(&args), usage, reply);
+    if (index < 0) {
+        return;
+    }
+    if (next_word(&args) != NULL) {
+        reply_set(reply, 1, "формат: %s", usage);
+        return;
+    }
+    free_matrix(server->entries[index].mat);
+    server->entries[index] = server->entries[--server->count];
+    reply_set(reply, 0, "%d", server->count);
+}
+
+/**
+ * @brief Команда list: строка "NAME ROWSxCOLS" на каждую матрицу
+ */
+static void command_list(const MatrixServer *server, ServerReply *reply, FILE *out) {
+    for (int iter = 0; iter < server->count; iter++) {
+        const ServerEntry *entry = &server->entries[iter];
+        fprintf(out, "%s %dx%d\n", entry->name, entry->mat.rows, entry->mat.cols);
+    }
+    reply_set(reply, 0, "%d", server->count);
+}
+
+int matrix_server_execute(MatrixServer *server, const char *line, FILE *out) {
+    const double start = now_ns();
+    char *copy = strdup(line);
+    if (copy == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для команды сервера!\n");
+        exit(EXIT_FAILURE);
+    }
+    // Перевод строки не должен попасть в сообщения: ответ на команду - одна строка
+    copy[strcspn(copy, "\r\n")] = '\0';
+    char *args = copy;
+    const char *command = next_word(&args);
+    if (command == NULL || command[0] == '#') {
+        free(copy);
+        return MATRIX_SERVER_CONTINUE;
+    }
+
+    int status = MATRIX_SERVER_CONTINUE;
+    ServerReply reply = {.failed = 0, .message = ""};
+    if (strcmp(command, "load") == 0) {
+        command_load(server, args, &reply);
+    } else if (strcmp(command, "eval") == 0) {
+        command_eval(server, args, &reply);
+    } else if (strcmp(command, "print") == 0) {
+        command_print(server, args, &reply, out);
+    } else if (strcmp(command, "save") == 0) {
+        command_save(server, args, &reply);
+    } else if (strcmp(command, "free") == 0) {
+        command_free(server, args, &reply);
+    } else if (strcmp(command, "list") == 0) {
+        command_list(server, &reply, out);
+    } else if (strcmp(command, "quit") == 0) {
+        status = MATRIX_SERVER_QUIT;
+    } else if (strcmp(command, "shutdown") == 0) {
+        status = MATRIX_SERVER_SHUTDOWN;
+    } else {
+        reply_set(&reply, 1, "неизвестная команда %s", command);
+    }
+    free(copy);
+
+    const double elapsed_us = (now_ns() - start) / 1e3;
+    fprintf(out, "%s %.1f us%s%s\n", reply.failed ? "error" : "ok", elapsed_us,
+            reply.message[0] != '\0' ? " " : "", reply.message);
+    return status;
+}
+
+int matrix_server_run(MatrixServer *server, FILE *in, FILE *out) {
+    char *line = NULL;
+    size_t capacity = 0;
+    int status = MATRIX_SERVER_QUIT;
+    while (getline(&line, &capacity, in) != -1) {
+        status = matrix_server_execute(server, line, out);
+        fflush(out);
+        if (status != MATRIX_SERVER_CONTINUE) {
+            break;
+        }
+        status = MATRIX_SERVER_QUIT;
+    }
+    free(line);
+    return status;
+}
+
+int matrix_server_listen(MatrixServer *server, const char *path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Слишком длинный путь сокета %s!\n", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    // Удаляется только сокет, оставшийся от прошлого запуска, но не чужой файл
+    struct stat existing;
+    if (lstat(path, &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            fprintf(stderr, "Путь сокета %s занят файлом, который не является сокетом!\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("Невозможно создать сокет!");
+        return -1;
+    }
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(listener, MATRIX_SERVER_BACKLOG) != 0) {
+        perror("Невозможно открыть сокет!");
+        close(listener);
+        return -1;
+    }
+    // Клиент может закрыть соединение, не дочитав ответ: это не должно завершать сервер
+    signal(SIGPIPE, SIG_IGN);
+
+    int result = 0;
+    int status = MATRIX_SERVER_CONTINUE;
+    while (status != MATRIX_SERVER_SHUTDOWN) {
+        const int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Ошибка приема соединения!");
+            result = -1;
+            break;
+        }
+        // Отдельные потоки чтения и записи требуют отдельных дескрипторов
+        const int writer = dup(connection);
+        FILE *in = fdopen(connection, "r");
+        FILE *out = writer >= 0 ? fdopen(writer, "w") : NULL;
+        if (in != NULL && out != NULL) {
+            status = matrix_server_run(server, in, out);
+        }
+        if (in != NULL) {
+            fclose(in);
+        } else {
+            close(connection);
+        }
+        if (out != NULL) {
+            fclose(out);
+        } else if (writer >= 0) {
+            close(writer);
+        }
+    }
+    close(listener);
+    unlink(path);
+    return result;
+}
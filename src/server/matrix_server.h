@@ -0,0 +1,116 @@
+/**
+ * @file matrix_server.h
+ * @brief Пакетный режим: выполнение команд над именованными матрицами в одном процессе
+ * @defgroup Matrix_Server
+ * @{
+ *
+ * Сервер хранит загруженные и вычисленные матрицы под именами между запросами,
+ * поэтому входные файлы читаются и разбираются один раз, а каждое следующее
+ * выражение платит только за вычисление. Команды читаются построчно из потока
+ * (matrix_server_run) или из соединений Unix-сокета (matrix_server_listen).
+ *
+ * Команды (одна на строку, пустые строки и строки с '#' в начале пропускаются):
+ * - load NAME PATH - загружает матрицу из текстового или двоичного файла (через кэш
+ *   matrix_cache.h, если он включен)
+ * - eval NAME EXPR - вычисляет выражение и сохраняет результат под именем NAME
+ * - print NAME [PRECISION] - выводит матрицу
+ * - save NAME PATH [binary] - сохраняет матрицу в текстовый или двоичный файл
+ * - free NAME - освобождает матрицу
+ * - list - перечисляет матрицы и их размеры
+ * - quit - завершает сеанс (соединение)
+ * - shutdown - завершает сеанс и работу сервера на сокете
+ *
+ * Выражение EXPR строится из имен матриц, операций +, -, *, транспонирования
+ * (постфиксные ^T, **T или ') и скобок, например A - (B + C * D)^T; размеры
+ * операндов проверяются до вычисления. Если NAME уже содержит изменяемую матрицу
+ * того же размера, результат записывается в ее буфер без выделения памяти.
+ *
+ * На каждую команду выводится одна строка состояния с временем ее выполнения
+ * в микросекундах: "ok <время> us [сведения]" или "error <время> us <сообщение>";
+ * вывод print предшествует строке состояния. Ошибки в командах, включая
+ * недоступные и поврежденные файлы матриц, не завершают сервер.
+ */
+
+#ifndef MATRIX_SERVER_H
+#define MATRIX_SERVER_H
+
+#include <stdio.h>
+#include "../include/config.h"
+
+/**
+ * @brief Максимальная длина имени матрицы
+ */
+#define MATRIX_SERVER_NAME_MAX 63
+
+/**
+ * @brief Результат выполнения команды: продолжить чтение команд
+ */
+#define MATRIX_SERVER_CONTINUE 0
+
+/**
+ * @brief Результат выполнения команды: завершить текущий сеанс (quit)
+ */
+#define MATRIX_SERVER_QUIT 1
+
+/**
+ * @brief Результат выполнения команды: завершить работу сервера (shutdown)
+ */
+#define MATRIX_SERVER_SHUTDOWN 2
+
+/**
+ * @brief Сервер с именованными матрицами (непрозрачный тип)
+ */
+typedef struct MatrixServer MatrixServer;
+
+/**
+ * @brief Создает сервер без матриц
+ * @return Новый сервер (освобождается через matrix_server_destroy)
+ * @warning При нехватке памяти завершает программу с EXIT_FAILURE
+ */
+MatrixServer *matrix_server_create(void);
+
+/**
+ * @brief Освобождает сервер и все его матрицы
+ * @param server Сервер (может быть NULL)
+ */
+void matrix_server_destroy(MatrixServer *server);
+
+/**
+ * @brief Выполняет одну команду
+ * @param server Сервер
+ * @param line Текст команды (завершающий перевод строки допускается)
+ * @param out Поток для ответа
+ * @return MATRIX_SERVER_CONTINUE, MATRIX_SERVER_QUIT или MATRIX_SERVER_SHUTDOWN
+ */
+int matrix_server_execute(MatrixServer *server, const char *line, FILE *out);
+
+/**
+ * @brief Выполняет команды из потока до конца потока, quit или shutdown
+ * @param server Сервер
+ * @param in Поток команд
+ * @param out Поток ответов (сбрасывается после каждой команды)
+ * @return Результат последней команды (MATRIX_SERVER_QUIT в конце потока)
+ */
+int matrix_server_run(MatrixServer *server, FILE *in, FILE *out);
+
+/**
+ * @brief Принимает соединения на Unix-сокете и выполняет их команды
+ * @param server Сервер; матрицы сохраняются между соединениями
+ * @param path Путь сокета (оставшийся по этому пути сокет удаляется; если путь занят
+ *             файлом другого типа, сервер не запускается)
+ * @return 0 после команды shutdown, -1 при ошибке создания сокета
+ * @note Соединения обслуживаются по очереди; сокет удаляется при завершении
+ */
+int matrix_server_listen(MatrixServer *server, const char *path);
+
+/**
+ * @brief Находит матрицу по имени
+ * @param server Сервер
+ * @param name Имя матрицы
+ * @return Указатель на матрицу (действителен до следующей команды) или NULL
+ */
+const Matrix *matrix_server_find(const MatrixServer *server, const char *name);
+
+#endif
+
+/** @} */
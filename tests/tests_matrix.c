@@ -26,8 +26,8 @@ void test_create_and_free_matrix(void) {
     if (mat.data != NULL) {
         for (int iter = 0; iter < mat.rows; iter++) {
             for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
-                mat.data[iter][iter_2] = iter + iter_2;
-                CU_ASSERT_EQUAL(mat.data[iter][iter_2], iter + iter_2);
+                MATRIX_AT(mat, iter, iter_2) = iter + iter_2;
+                CU_ASSERT_EQUAL(MATRIX_AT(mat, iter, iter_2), iter + iter_2);
             }
         }
     }
@@ -35,6 +35,30 @@ void test_create_and_free_matrix(void) {
     free_matrix(mat);
 }
 
+/**
+ * @brief Тест размещения матрицы в памяти
+ *
+ * Проверяет:
+ * - Непрерывность буфера (строки идут подряд с шагом stride)
+ * - Выравнивание широких строк по границе MATRIX_ALIGNMENT
+ * - Отсутствие дополнения для узких матриц
+ */
+void test_matrix_layout(void) {
+    Matrix narrow = create_matrix(3, 5);
+    CU_ASSERT_EQUAL(narrow.stride, 5);
+    CU_ASSERT_PTR_EQUAL(MATRIX_ROW(narrow, 2), narrow.data + 10);
+
+    Matrix wide = create_matrix(4, 37);
+    CU_ASSERT(wide.stride >= wide.cols);
+    CU_ASSERT_EQUAL((wide.stride * sizeof(double)) % MATRIX_ALIGNMENT, 0);
+    CU_ASSERT_EQUAL((size_t)wide.data % MATRIX_ALIGNMENT, 0);
+    MATRIX_AT(wide, 3, 36) = 7.0;
+    CU_ASSERT_DOUBLE_EQUAL(wide.data[3 * wide.stride + 36], 7.0, 0.0001);
+
+    free_matrix(narrow);
+    free_matrix(wide);
+}
+
 /**
  * @brief Тест загрузки матрицы из файла
  *
@@ -58,8 +82,8 @@ void test_load_matrix_from_file(void) {
         Matrix mat = load_matrix_from_file(filename);
         CU_ASSERT_EQUAL(mat.rows, 2);
         CU_ASSERT_EQUAL(mat.cols, 3);
-        CU_ASSERT_DOUBLE_EQUAL(mat.data[0][0], 1.5, 0.0001);
-        CU_ASSERT_DOUBLE_EQUAL(mat.data[1][2], 6.5, 0.0001);
+        CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(mat, 0, 0), 1.5, 0.0001);
+        CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(mat, 1, 2), 6.5, 0.0001);
 
         // Удаляем тестовый файл
         remove(filename);
@@ -77,20 +101,20 @@ void test_load_matrix_from_file(void) {
  */
 void test_copy_matrix(void) {
     Matrix original = create_matrix(2, 2);
-    original.data[0][0] = 1.0;
-    original.data[0][1] = 2.0;
-    original.data[1][0] = 3.0;
-    original.data[1][1] = 4.0;
+    MATRIX_AT(original, 0, 0) = 1.0;
+    MATRIX_AT(original, 0, 1) = 2.0;
+    MATRIX_AT(original, 1, 0) = 3.0;
+    MATRIX_AT(original, 1, 1) = 4.0;
 
     Matrix copy = copy_matrix(original);
     CU_ASSERT_EQUAL(copy.rows, 2);
     CU_ASSERT_EQUAL(copy.cols, 2);
-    CU_ASSERT_DOUBLE_EQUAL(copy.data[0][0], 1.0, 0.0001);
-    CU_ASSERT_DOUBLE_EQUAL(copy.data[1][1], 4.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(copy, 0, 0), 1.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(copy, 1, 1), 4.0, 0.0001);
 
     // Проверка глубокого копирования
-    original.data[0][0] = 5.0;
-    CU_ASSERT_DOUBLE_EQUAL(copy.data[0][0], 1.0, 0.0001);
+    MATRIX_AT(original, 0, 0) = 5.0;
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(copy, 0, 0), 1.0, 0.0001);
 
     free_matrix(original);
     free_matrix(copy);
@@ -108,19 +132,19 @@ void test_add_matrices(void) {
     Matrix a = create_matrix(2, 2);
     Matrix b = create_matrix(2, 2);
 
-    a.data[0][0] = 1.0;
-    a.data[0][1] = 2.0;
-    a.data[1][0] = 3.0;
-    a.data[1][1] = 4.0;
+    MATRIX_AT(a, 0, 0) = 1.0;
+    MATRIX_AT(a, 0, 1) = 2.0;
+    MATRIX_AT(a, 1, 0) = 3.0;
+    MATRIX_AT(a, 1, 1) = 4.0;
 
-    b.data[0][0] = 0.5;
-    b.data[0][1] = 1.5;
-    b.data[1][0] = 2.5;
-    b.data[1][1] = 3.5;
+    MATRIX_AT(b, 0, 0) = 0.5;
+    MATRIX_AT(b, 0, 1) = 1.5;
+    MATRIX_AT(b, 1, 0) = 2.5;
+    MATRIX_AT(b, 1, 1) = 3.5;
 
     Matrix result = plus_matrices(a, b);
-    CU_ASSERT_DOUBLE_EQUAL(result.data[0][0], 1.5, 0.0001);
-    CU_ASSERT_DOUBLE_EQUAL(result.data[1][1], 7.5, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(result, 0, 0), 1.5, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(result, 1, 1), 7.5, 0.0001);
 
     free_matrix(a);
     free_matrix(b);
@@ -143,28 +167,489 @@ void test_multiply_matrices(void) {
     double aval = 1.0;
     for (int iter = 0; iter < 2; iter++) {
         for (int iter_2 = 0; iter_2 < 3; iter_2++) {
-            a.data[iter][iter_2] = aval++;
+            MATRIX_AT(a, iter, iter_2) = aval++;
         }
     }
 
     double bval = 0.5;
     for (int iter = 0; iter < 3; iter++) {
         for (int iter_2 = 0; iter_2 < 2; iter_2++) {
-            b.data[iter][iter_2] = bval++;
+            MATRIX_AT(b, iter, iter_2) = bval++;
         }
     }
 
     Matrix result = multiply_matrices(a, b);
     CU_ASSERT_EQUAL(result.rows, 2);
     CU_ASSERT_EQUAL(result.cols, 2);
-    CU_ASSERT_DOUBLE_EQUAL(result.data[0][0], 5.5, 0.0001);
-    CU_ASSERT_DOUBLE_EQUAL(result.data[1][1], 35.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(result, 0, 0), 5.5, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(result, 1, 1), 35.0, 0.0001);
 
     free_matrix(a);
     free_matrix(b);
     free_matrix(result);
 }
 
+/**
+ * @brief Эталонное умножение тройным циклом для проверки оптимизированных путей
+ * @param a Первая матрица
+ * @param b Вторая матрица
+ * @return Произведение a·b
+ */
+static Matrix reference_multiply(Matrix a, Matrix b) {
+    Matrix result = create_matrix(a.rows, b.cols);
+    for (int iter = 0; iter < a.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < b.cols; iter_2++) {
+            double sum = 0;
+            for (int iter_3 = 0; iter_3 < a.cols; iter_3++) {
+                sum += MATRIX_AT(a, iter, iter_3) * MATRIX_AT(b, iter_3, iter_2);
+            }
+            MATRIX_AT(result, iter, iter_2) = sum;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Заполняет матрицу детерминированными псевдослучайными значениями из [-1, 1]
+ * @param mat Матрица для заполнения
+ * @param seed Начальное значение генератора
+ */
+static void fill_pseudo_random(Matrix mat, unsigned seed) {
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            seed = seed * 1103515245u + 12345u;
+            MATRIX_AT(mat, iter, iter_2) = (double)((seed >> 8) % 2001) / 1000.0 - 1.0;
+        }
+    }
+}
+
+/**
+ * @brief Тест блочного умножения больших матриц
+ *
+ * Проверяет:
+ * - Совпадение с эталонным умножением для размеров, не кратных блокам
+ * - Переход через границу блока по общей размерности (k > GEMM_KC)
+ */
+void test_multiply_matrices_blocked(void) {
+    Matrix a = create_matrix(131, GEMM_KC + 45);
+    Matrix b = create_matrix(GEMM_KC + 45, 97);
+    fill_pseudo_random(a, 1);
+    fill_pseudo_random(b, 2);
+
+    Matrix result = multiply_matrices(a, b);
+    Matrix expected = reference_multiply(a, b);
+    CU_ASSERT_EQUAL(result.rows, 131);
+    CU_ASSERT_EQUAL(result.cols, 97);
+
+    double max_diff = 0;
+    for (int iter = 0; iter < result.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < result.cols; iter_2++) {
+            double diff = fabs(MATRIX_AT(result, iter, iter_2) - MATRIX_AT(expected, iter, iter_2));
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+    }
+    CU_ASSERT(max_diff < 1e-9);
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(result);
+    free_matrix(expected);
+}
+
+/**
+ * @brief Тест векторных ядер на всех поддерживаемых уровнях инструкций
+ *
+ * Проверяет для каждого уровня от скалярного до максимального доступного:
+ * - Точное совпадение сложения, вычитания и копирования со скалярным результатом
+ *   (включая хвосты строк, не кратные ширине регистра)
+ * - Совпадение блочного умножения с эталоном
+ */
+void test_simd_kernels_dispatch(void) {
+    Matrix a = create_matrix(67, 203);
+    Matrix b = create_matrix(67, 203);
+    Matrix c = create_matrix(203, 59);
+    fill_pseudo_random(a, 3);
+    fill_pseudo_random(b, 4);
+    fill_pseudo_random(c, 5);
+    Matrix expected = reference_multiply(a, c);
+
+    SimdLevel saved = simd_kernels()->level;
+    SimdLevel top = simd_detect_level();
+    for (int level = SIMD_SCALAR; level <= (int)top; level++) {
+        CU_ASSERT_EQUAL(simd_set_level((SimdLevel)level), (SimdLevel)level);
+
+        Matrix sum = plus_matrices(a, b);
+        Matrix diff = subtract_matrices(a, b);
+        Matrix copy = copy_matrix(a);
+        Matrix product = multiply_matrices(a, c);
+
+        int exact = 1;
+        for (int iter = 0; iter < a.rows; iter++) {
+            for (int iter_2 = 0; iter_2 < a.cols; iter_2++) {
+                double x = MATRIX_AT(a, iter, iter_2);
+                double y = MATRIX_AT(b, iter, iter_2);
+                exact &= MATRIX_AT(sum, iter, iter_2) == x + y;
+                exact &= MATRIX_AT(diff, iter, iter_2) == x - y;
+                exact &= MATRIX_AT(copy, iter, iter_2) == x;
+            }
+        }
+        CU_ASSERT(exact);
+
+        double max_diff = 0;
+        for (int iter = 0; iter < product.rows; iter++) {
+            for (int iter_2 = 0; iter_2 < product.cols; iter_2++) {
+                double d =
+                    fabs(MATRIX_AT(product, iter, iter_2) - MATRIX_AT(expected, iter, iter_2));
+                max_diff = d > max_diff ? d : max_diff;
+            }
+        }
+        CU_ASSERT(max_diff < 1e-9);
+
+        free_matrix(sum);
+        free_matrix(diff);
+        free_matrix(copy);
+        free_matrix(product);
+    }
+    simd_set_level(saved);
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(c);
+    free_matrix(expected);
+}
+
+/**
+ * @brief Проверяет побитовое совпадение двух матриц
+ * @param a Первая матрица
+ * @param b Вторая матрица
+ * @return 1, если размеры и все элементы совпадают, иначе 0
+ */
+static int matrices_identical(Matrix a, Matrix b) {
+    if (a.rows != b.rows || a.cols != b.cols) {
+        return 0;
+    }
+    for (int iter = 0; iter < a.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < a.cols; iter_2++) {
+            if (MATRIX_AT(a, iter, iter_2) != MATRIX_AT(b, iter, iter_2)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Тест параллельного выполнения операций
+ *
+ * Проверяет, что при 1 и 4 потоках результаты сложения, вычитания,
+ * копирования, транспонирования и умножения совпадают побитово.
+ */
+void test_parallel_operations(void) {
+    Matrix a = create_matrix(600, 700);
+    Matrix b = create_matrix(600, 700);
+    Matrix c = create_matrix(700, 300);
+    fill_pseudo_random(a, 6);
+    fill_pseudo_random(b, 7);
+    fill_pseudo_random(c, 8);
+
+    int saved = matrix_get_num_threads();
+    Matrix serial[5];
+    Matrix parallel[5];
+    for (int pass = 0; pass < 2; pass++) {
+        matrix_set_num_threads(pass == 0 ? 1 : 4);
+        Matrix *out = pass == 0 ? serial : parallel;
+        out[0] = plus_matrices(a, b);
+        out[1] = subtract_matrices(a, b);
+        out[2] = copy_matrix(a);
+        out[3] = transpose_matrix(a);
+        out[4] = multiply_matrices(a, c);
+    }
+    matrix_set_num_threads(saved);
+
+    for (int iter = 0; iter < 5; iter++) {
+        CU_ASSERT(matrices_identical(serial[iter], parallel[iter]));
+        free_matrix(serial[iter]);
+        free_matrix(parallel[iter]);
+    }
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(c);
+}
+
+/**
+ * @brief Тест операций с записью в существующую матрицу (_into)
+ *
+ * Проверяет:
+ * - Совпадение результатов с выделяющими версиями операций
+ * - Сложение и вычитание на месте (результат совпадает с операндом)
+ * - Транспонирование квадратной матрицы на месте
+ * - Повторное использование одной матрицы-результата в цикле
+ */
+void test_into_operations(void) {
+    Matrix a = create_matrix(40, 40);
+    Matrix b = create_matrix(40, 40);
+    fill_pseudo_random(a, 11);
+    fill_pseudo_random(b, 12);
+
+    Matrix expected_sum = plus_matrices(a, b);
+    Matrix expected_diff = subtract_matrices(a, b);
+    Matrix expected_product = multiply_matrices(a, b);
+    Matrix expected_transposed = transpose_matrix(a);
+
+    Matrix work = create_matrix(40, 40);
+    copy_matrix_into(&work, a);
+    CU_ASSERT(matrices_identical(work, a));
+    plus_matrices_into(&work, work, b);
+    CU_ASSERT(matrices_identical(work, expected_sum));
+
+    copy_matrix_into(&work, b);
+    subtract_matrices_into(&work, a, work);
+    CU_ASSERT(matrices_identical(work, expected_diff));
+
+    copy_matrix_into(&work, a);
+    transpose_matrix_into(&work, work);
+    CU_ASSERT(matrices_identical(work, expected_transposed));
+
+    for (int iter = 0; iter < 3; iter++) {
+        multiply_matrices_into(&work, a, b);
+        CU_ASSERT(matrices_identical(work, expected_product));
+    }
+
+    Matrix rect = create_matrix(3, 5);
+    Matrix rect_t = create_matrix(5, 3);
+    fill_pseudo_random(rect, 13);
+    transpose_matrix_into(&rect_t, rect);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(rect_t, 4, 2), MATRIX_AT(rect, 2, 4), 0.0);
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(expected_sum);
+    free_matrix(expected_diff);
+    free_matrix(expected_product);
+    free_matrix(expected_transposed);
+    free_matrix(work);
+    free_matrix(rect);
+    free_matrix(rect_t);
+}
+
+/**
+ * @brief Тест арены временных матриц
+ *
+ * Проверяет:
+ * - Выделение нескольких матриц из одного блока с выравниванием
+ * - Безопасность free_matrix для матриц из арены
+ * - Откат к отметке и полный сброс
+ * - Учет максимального заполнения (high-water mark)
+ */
+void test_matrix_arena(void) {
+    size_t first_size = matrix_arena_bytes_for(3, 40);
+    size_t second_size = matrix_arena_bytes_for(2, 2);
+    MatrixArena arena = matrix_arena_create(first_size + 2 * second_size);
+
+    Matrix first = matrix_arena_matrix(&arena, 3, 40);
+    CU_ASSERT(first.flags & MATRIX_BORROWED);
+    CU_ASSERT_EQUAL((size_t)first.data % MATRIX_ALIGNMENT, 0);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(first, 2, 39), 0.0, 0.0);
+
+    size_t mark = matrix_arena_mark(&arena);
+    Matrix second = matrix_arena_matrix(&arena, 2, 2);
+    Matrix third = matrix_arena_matrix(&arena, 2, 2);
+    CU_ASSERT_EQUAL((size_t)second.data % MATRIX_ALIGNMENT, 0);
+    CU_ASSERT_PTR_NOT_EQUAL(second.data, third.data);
+    MATRIX_AT(second, 1, 1) = 5.0;
+    free_matrix(second);
+    free_matrix(third);
+
+    matrix_arena_rewind(&arena, mark);
+    Matrix reused = matrix_arena_matrix(&arena, 2, 2);
+    CU_ASSERT_PTR_EQUAL(reused.data, second.data);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(reused, 1, 1), 0.0, 0.0);
+
+    CU_ASSERT_EQUAL(matrix_arena_high_water(&arena), first_size + 2 * second_size);
+    matrix_arena_reset(&arena);
+    CU_ASSERT_EQUAL(matrix_arena_mark(&arena), 0);
+    CU_ASSERT_EQUAL(matrix_arena_high_water(&arena), first_size + 2 * second_size);
+
+    matrix_arena_destroy(&arena);
+}
+
+/**
+ * @brief Тест быстрого разбора текстового формата
+ *
+ * Проверяет:
+ * - Побитовое совпадение разбора чисел с strtod (точные, трудные для округления,
+ *   денормализованные, inf/nan, случайные значения в записи %.17g)
+ * - Отказ на неверных токенах
+ * - Разбор матрицы с произвольными пробелами и переводами строк
+ * - Совпадение последовательного и параллельного разбора большого текста
+ */
+void test_matrix_text_parser(void) {
+    const char *samples[] = {"0",          "-0.0",         "1.5",        "+42",
+                             "0.1",        "3.14159",      "1e22",       "1e23",
+                             "123e25",     "9007199254740993",           "1e-300",
+                             "4.9e-324",   "2.2250738585072014e-308",    "1.7976931348623157e308",
+                             "1e400",      "0.000001234",  "123456789012345678901234567890",
+                             "0x1p-3",     "inf",          "-Infinity"};
+    int exact = 1;
+    for (size_t iter = 0; iter < sizeof(samples) / sizeof(samples[0]); iter++) {
+        const char *text = samples[iter];
+        double parsed = 0.0;
+        const char *stop = matrix_parse_double(text, text + strlen(text), &parsed);
+        double expected = strtod(text, NULL);
+        exact &= stop == text + strlen(text) && memcmp(&parsed, &expected, sizeof(double)) == 0;
+    }
+    CU_ASSERT(exact);
+
+    double nan_value = 0.0;
+    CU_ASSERT_PTR_NOT_NULL(matrix_parse_double("nan", "nan" + 3, &nan_value));
+    CU_ASSERT(isnan(nan_value));
+    double ignored;
+    CU_ASSERT_PTR_NULL(matrix_parse_double("1.5x", "1.5x" + 4, &ignored));
+    CU_ASSERT_PTR_NULL(matrix_parse_double("-", "-" + 1, &ignored));
+    CU_ASSERT_PTR_NULL(matrix_parse_double("1e", "1e" + 2, &ignored));
+
+    /* Случайные значения в записи с 17 значащими цифрами */
+    unsigned state = 12345u;
+    exact = 1;
+    for (int iter = 0; iter < 20000; iter++) {
+        state = state * 1103515245u + 12345u;
+        double value = ((double)state / 4294967296.0 - 0.5) * pow(10.0, (int)(state % 40) - 20);
+        char text[64];
+        snprintf(text, sizeof(text), iter % 2 ? "%.17g" : "%.6f", value);
+        double parsed = 0.0;
+        matrix_parse_double(text, text + strlen(text), &parsed);
+        double expected = strtod(text, NULL);
+        exact &= memcmp(&parsed, &expected, sizeof(double)) == 0;
+    }
+    CU_ASSERT(exact);
+
+    const char small[] = "2 3\n1 -2.5\t3e1\r\n\n  4\v5 6.25";
+    Matrix parsed = matrix_parse_text(small, sizeof(small) - 1, "test");
+    CU_ASSERT(parsed.rows == 2 && parsed.cols == 3);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(parsed, 0, 1), -2.5, 0.0);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(parsed, 0, 2), 30.0, 0.0);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(parsed, 1, 2), 6.25, 0.0);
+    free_matrix(parsed);
+
+    /* Большой текст: несколько частей при разборе в 4 потока */
+    Matrix mat = create_matrix(300, 211);
+    fill_pseudo_random(mat, 50);
+    size_t capacity = (size_t)mat.rows * mat.cols * 26 + 32;
+    char *text = (char *)malloc(capacity);
+    size_t length = (size_t)snprintf(text, capacity, "%d %d\n", mat.rows, mat.cols);
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            length += (size_t)snprintf(text + length, capacity - length, "%.17g ",
+                                       MATRIX_AT(mat, iter, iter_2));
+        }
+        text[length++] = '\n';
+    }
+    CU_ASSERT(length > 2 * TEXT_PARSE_CHUNK_MIN);
+
+    int saved = matrix_get_num_threads();
+    matrix_set_num_threads(1);
+    Matrix serial = matrix_parse_text(text, length, "serial");
+    matrix_set_num_threads(4);
+    Matrix parallel = matrix_parse_text(text, length, "parallel");
+    matrix_set_num_threads(saved);
+    CU_ASSERT(matrices_identical(serial, mat));
+    CU_ASSERT(matrices_identical(parallel, mat));
+
+    free(text);
+    free_matrix(mat);
+    free_matrix(serial);
+    free_matrix(parallel);
+}
+
+/**
+ * @brief Максимальное отклонение элементов двух матриц одинакового размера
+ */
+static double max_abs_difference(Matrix a, Matrix b) {
+    double diff = 0.0;
+    for (int iter = 0; iter < a.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < a.cols; iter_2++) {
+            double value = fabs(MATRIX_AT(a, iter, iter_2) - MATRIX_AT(b, iter, iter_2));
+            diff = value > diff ? value : diff;
+        }
+    }
+    return diff;
+}
+
+/**
+ * @brief Тест ленивых выражений с объединенным вычислением
+ *
+ * Проверяет:
+ * - Совпадение A - (B + C·D)^T с последовательным вычислением (в том числе
+ *   при глубине произведения больше GEMM_KC и параллельном выполнении)
+ * - Суммы без произведений с транспонированными слагаемыми
+ * - Вложенные произведения и транспонированные множители
+ * - Вычисление в матрицу, которая сама входит в выражение
+ */
+void test_matrix_expr(void) {
+    const int rows = 150, cols = 130, depth = 300;
+    Matrix a = create_matrix(rows, cols);
+    Matrix b = create_matrix(cols, rows);
+    Matrix c = create_matrix(cols, depth);
+    Matrix d = create_matrix(depth, rows);
+    fill_pseudo_random(a, 11);
+    fill_pseudo_random(b, 12);
+    fill_pseudo_random(c, 13);
+    fill_pseudo_random(d, 14);
+
+    MatrixExpr *expr = matrix_expr_subtract(
+        matrix_expr_leaf(a),
+        matrix_expr_transpose(matrix_expr_plus(
+            matrix_expr_leaf(b), matrix_expr_multiply(matrix_expr_leaf(c), matrix_expr_leaf(d)))));
+    CU_ASSERT_EQUAL(matrix_expr_rows(expr), rows);
+    CU_ASSERT_EQUAL(matrix_expr_cols(expr), cols);
+    Matrix fused = matrix_expr_evaluate(expr);
+    matrix_expr_free(expr);
+
+    Matrix cd = multiply_matrices(c, d);
+    Matrix sum = plus_matrices(b, cd);
+    Matrix sum_t = transpose_matrix(sum);
+    Matrix expected = subtract_matrices(a, sum_t);
+    CU_ASSERT(max_abs_difference(fused, expected) < 1e-11);
+
+    /* Без произведения: A - B^T + A */
+    expr = matrix_expr_plus(
+        matrix_expr_subtract(matrix_expr_leaf(a), matrix_expr_transpose(matrix_expr_leaf(b))),
+        matrix_expr_leaf(a));
+    Matrix elementwise = matrix_expr_evaluate(expr);
+    matrix_expr_free(expr);
+    Matrix b_t = transpose_matrix(b);
+    Matrix diff = subtract_matrices(a, b_t);
+    Matrix expected_sum = plus_matrices(diff, a);
+    CU_ASSERT(matrices_identical(elementwise, expected_sum));
+
+    /* Вложенное произведение с транспонированным множителем: B^T · (C · D) */
+    expr = matrix_expr_multiply(
+        matrix_expr_transpose(matrix_expr_leaf(b)),
+        matrix_expr_multiply(matrix_expr_leaf(c), matrix_expr_leaf(d)));
+    Matrix nested = matrix_expr_evaluate(expr);
+    matrix_expr_free(expr);
+    Matrix expected_nested = reference_multiply(b_t, cd);
+    CU_ASSERT(max_abs_difference(nested, expected_nested) < 1e-10);
+
+    /* Результат совпадает с операндом: S = S - S^T */
+    Matrix square = create_matrix(3, 3);
+    fill_pseudo_random(square, 15);
+    Matrix square_t = transpose_matrix(square);
+    Matrix expected_skew = subtract_matrices(square, square_t);
+    expr = matrix_expr_subtract(matrix_expr_leaf(square),
+                                matrix_expr_transpose(matrix_expr_leaf(square)));
+    matrix_expr_evaluate_into(&square, expr);
+    matrix_expr_free(expr);
+    CU_ASSERT(matrices_identical(square, expected_skew));
+
+    Matrix all[] = {a, b, c, d, fused, cd, sum, sum_t, expected, elementwise, b_t, diff,
+                    expected_sum, nested, expected_nested, square, square_t, expected_skew};
+    for (size_t iter = 0; iter < sizeof(all) / sizeof(all[0]); iter++) {
+        free_matrix(all[iter]);
+    }
+}
+
 /**
  * @brief Тест транспонирования матрицы
  *
@@ -175,23 +660,121 @@ void test_multiply_matrices(void) {
  */
 void test_transpose_matrix(void) {
     Matrix original = create_matrix(2, 3);
-    original.data[0][0] = 1.0;
-    original.data[0][1] = 2.0;
-    original.data[0][2] = 3.0;
-    original.data[1][0] = 4.0;
-    original.data[1][1] = 5.0;
-    original.data[1][2] = 6.0;
+    MATRIX_AT(original, 0, 0) = 1.0;
+    MATRIX_AT(original, 0, 1) = 2.0;
+    MATRIX_AT(original, 0, 2) = 3.0;
+    MATRIX_AT(original, 1, 0) = 4.0;
+    MATRIX_AT(original, 1, 1) = 5.0;
+    MATRIX_AT(original, 1, 2) = 6.0;
 
     Matrix transposed = transpose_matrix(original);
     CU_ASSERT_EQUAL(transposed.rows, 3);
     CU_ASSERT_EQUAL(transposed.cols, 2);
-    CU_ASSERT_DOUBLE_EQUAL(transposed.data[0][0], 1.0, 0.0001);
-    CU_ASSERT_DOUBLE_EQUAL(transposed.data[2][1], 6.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(transposed, 0, 0), 1.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(transposed, 2, 1), 6.0, 0.0001);
 
     free_matrix(original);
     free_matrix(transposed);
 }
 
+/**
+ * @brief Проверяет, что t - транспонированная матрица m
+ */
+static int is_transpose_of(Matrix t, Matrix m) {
+    if (t.rows != m.cols || t.cols != m.rows) {
+        return 0;
+    }
+    for (int iter = 0; iter < m.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < m.cols; iter_2++) {
+            if (MATRIX_AT(t, iter_2, iter) != MATRIX_AT(m, iter, iter_2)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Тест блочного транспонирования
+ *
+ * Проверяет для каждого уровня векторных ядер:
+ * - Размеры, не кратные блоку и ядру, в том числе вырожденные (1×n)
+ * - Транспонирование квадратной матрицы на месте (порядок больше и меньше TRANSPOSE_TILE)
+ * - Ядра блока transpose_nb×transpose_nb (double и float) с ведущими размерностями,
+ *   отличными от стороны блока
+ * - Параллельное выполнение
+ */
+void test_transpose_blocked(void) {
+    const int shapes[][2] = {{1, 5}, {8, 8}, {67, 45}, {200, 130}};
+    const int orders[] = {2, 37, 100};
+    SimdLevel saved = simd_kernels()->level;
+    SimdLevel top = simd_detect_level();
+    for (int level = SIMD_SCALAR; level <= (int)top; level++) {
+        simd_set_level((SimdLevel)level);
+        const SimdKernels *kernels = simd_kernels();
+        const SimdKernelsF *kernels_f = simd_kernels_f();
+        CU_ASSERT(kernels->level == (SimdLevel)level && kernels_f->level == (SimdLevel)level);
+        double block[16 * 19];
+        double block_t[16 * 21];
+        float block_f[16 * 19];
+        float block_f_t[16 * 21];
+        for (int iter = 0; iter < 16 * 19; iter++) {
+            block[iter] = iter;
+            block_f[iter] = (float)iter;
+        }
+        kernels->transpose_kernel(block, 19, block_t, 21);
+        kernels_f->transpose_kernel(block_f, 19, block_f_t, 21);
+        int kernel_ok = kernels->transpose_nb <= 16 && kernels_f->transpose_nb <= 16;
+        for (int iter = 0; kernel_ok && iter < kernels->transpose_nb; iter++) {
+            for (int iter_2 = 0; iter_2 < kernels->transpose_nb; iter_2++) {
+                kernel_ok &= block_t[iter_2 * 21 + iter] == block[iter * 19 + iter_2];
+            }
+        }
+        for (int iter = 0; kernel_ok && iter < kernels_f->transpose_nb; iter++) {
+            for (int iter_2 = 0; iter_2 < kernels_f->transpose_nb; iter_2++) {
+                kernel_ok &= block_f_t[iter_2 * 21 + iter] == block_f[iter * 19 + iter_2];
+            }
+        }
+        CU_ASSERT(kernel_ok);
+        for (size_t iter = 0; iter < sizeof(shapes) / sizeof(shapes[0]); iter++) {
+            Matrix mat = create_matrix(shapes[iter][0], shapes[iter][1]);
+            fill_pseudo_random(mat, 20 + (unsigned)iter);
+            Matrix transposed = transpose_matrix(mat);
+            CU_ASSERT(is_transpose_of(transposed, mat));
+            free_matrix(mat);
+            free_matrix(transposed);
+        }
+        for (size_t iter = 0; iter < sizeof(orders) / sizeof(orders[0]); iter++) {
+            Matrix mat = create_matrix(orders[iter], orders[iter]);
+            fill_pseudo_random(mat, 30 + (unsigned)iter);
+            Matrix original = copy_matrix(mat);
+            transpose_matrix_into(&mat, mat);
+            CU_ASSERT(is_transpose_of(mat, original));
+            free_matrix(mat);
+            free_matrix(original);
+        }
+    }
+    simd_set_level(saved);
+
+    int saved_threads = matrix_get_num_threads();
+    matrix_set_num_threads(4);
+    Matrix wide = create_matrix(300, 700);
+    fill_pseudo_random(wide, 40);
+    Matrix wide_t = transpose_matrix(wide);
+    CU_ASSERT(is_transpose_of(wide_t, wide));
+    Matrix square = create_matrix(500, 500);
+    fill_pseudo_random(square, 41);
+    Matrix square_copy = copy_matrix(square);
+    transpose_matrix_into(&square, square);
+    CU_ASSERT(is_transpose_of(square, square_copy));
+    matrix_set_num_threads(saved_threads);
+
+    free_matrix(wide);
+    free_matrix(wide_t);
+    free_matrix(square);
+    free_matrix(square_copy);
+}
+
 /**
  * @brief Тест вычисления определителя
  *
@@ -202,21 +785,21 @@ void test_transpose_matrix(void) {
  */
 void test_determinant(void) {
     Matrix mat2x2 = create_matrix(2, 2);
-    mat2x2.data[0][0] = 1.0;
-    mat2x2.data[0][1] = 2.0;
-    mat2x2.data[1][0] = 3.0;
-    mat2x2.data[1][1] = 4.0;
+    MATRIX_AT(mat2x2, 0, 0) = 1.0;
+    MATRIX_AT(mat2x2, 0, 1) = 2.0;
+    MATRIX_AT(mat2x2, 1, 0) = 3.0;
+    MATRIX_AT(mat2x2, 1, 1) = 4.0;
 
     Matrix mat3x3 = create_matrix(3, 3);
-    mat3x3.data[0][0] = 2.0;
-    mat3x3.data[0][1] = -1.0;
-    mat3x3.data[0][2] = 3.0;
-    mat3x3.data[1][0] = 0.0;
-    mat3x3.data[1][1] = 4.0;
-    mat3x3.data[1][2] = -2.0;
-    mat3x3.data[2][0] = 1.0;
-    mat3x3.data[2][1] = 0.0;
-    mat3x3.data[2][2] = 5.0;
+    MATRIX_AT(mat3x3, 0, 0) = 2.0;
+    MATRIX_AT(mat3x3, 0, 1) = -1.0;
+    MATRIX_AT(mat3x3, 0, 2) = 3.0;
+    MATRIX_AT(mat3x3, 1, 0) = 0.0;
+    MATRIX_AT(mat3x3, 1, 1) = 4.0;
+    MATRIX_AT(mat3x3, 1, 2) = -2.0;
+    MATRIX_AT(mat3x3, 2, 0) = 1.0;
+    MATRIX_AT(mat3x3, 2, 1) = 0.0;
+    MATRIX_AT(mat3x3, 2, 2) = 5.0;
 
     CU_ASSERT_DOUBLE_EQUAL(determinant(mat2x2), -2.0, 0.0001);
     CU_ASSERT_DOUBLE_EQUAL(determinant(mat3x3), 42.0, 0.0001);
@@ -225,6 +808,70 @@ void test_determinant(void) {
     free_matrix(mat3x3);
 }
 
+/**
+ * @brief Тест определителя больших матриц через блочное LU-разложение
+ *
+ * Проверяет:
+ * - Определитель A = L·U с известной диагональю U при n > LU_BLOCK
+ * - Смену знака при перестановке строк
+ * - Логарифм модуля определителя, когда сам определитель переполняется
+ * - Вырожденную матрицу (знак 0, логарифм -INFINITY)
+ */
+void test_determinant_lu(void) {
+    const int n = LU_BLOCK * 2 + 37;
+    Matrix lower = create_matrix(n, n);
+    Matrix upper = create_matrix(n, n);
+    fill_pseudo_random(lower, 9);
+    fill_pseudo_random(upper, 10);
+    double expected_log = 0;
+    for (int iter = 0; iter < n; iter++) {
+        for (int iter_2 = 0; iter_2 < n; iter_2++) {
+            // Малые внедиагональные элементы L делают A хорошо обусловленной
+            MATRIX_AT(lower, iter, iter_2) *= iter_2 > iter ? 0.0 : 0.05;
+            if (iter_2 < iter) {
+                MATRIX_AT(upper, iter, iter_2) = 0;
+            }
+        }
+        MATRIX_AT(lower, iter, iter) = 1.0;
+        MATRIX_AT(upper, iter, iter) = 1.0 + (iter % 3) * 0.5;
+        expected_log += log(MATRIX_AT(upper, iter, iter));
+    }
+    Matrix a = reference_multiply(lower, upper);
+
+    int sign = 0;
+    CU_ASSERT_DOUBLE_EQUAL(log_abs_determinant(a, &sign), expected_log, 1e-8);
+    CU_ASSERT_EQUAL(sign, 1);
+    double det = determinant(a);
+    CU_ASSERT(fabs(det / exp(expected_log) - 1.0) < 1e-8);
+
+    for (int iter = 0; iter < n; iter++) {
+        double tmp = MATRIX_AT(a, 0, iter);
+        MATRIX_AT(a, 0, iter) = MATRIX_AT(a, 5, iter);
+        MATRIX_AT(a, 5, iter) = tmp;
+    }
+    CU_ASSERT(fabs(determinant(a) / -exp(expected_log) - 1.0) < 1e-8);
+    log_abs_determinant(a, &sign);
+    CU_ASSERT_EQUAL(sign, -1);
+
+    Matrix big = create_matrix(400, 400);
+    for (int iter = 0; iter < big.rows; iter++) {
+        MATRIX_AT(big, iter, iter) = iter % 2 == 0 ? 10.0 : -10.0;
+    }
+    CU_ASSERT(isinf(determinant(big)));
+    CU_ASSERT_DOUBLE_EQUAL(log_abs_determinant(big, &sign), 400 * log(10.0), 1e-9);
+    CU_ASSERT_EQUAL(sign, 1);
+
+    MATRIX_AT(big, 7, 7) = 0;
+    CU_ASSERT_DOUBLE_EQUAL(determinant(big), 0.0, 0.0);
+    CU_ASSERT(isinf(log_abs_determinant(big, &sign)));
+    CU_ASSERT_EQUAL(sign, 0);
+
+    free_matrix(lower);
+    free_matrix(upper);
+    free_matrix(a);
+    free_matrix(big);
+}
+
 /**
  * @brief Тест вычитания матриц
  *
@@ -237,23 +884,961 @@ void test_subtract_matrices(void) {
     Matrix a = create_matrix(2, 2);
     Matrix b = create_matrix(2, 2);
 
-    a.data[0][0] = 5.0;
-    a.data[0][1] = 5.0;
-    a.data[1][0] = 5.0;
-    a.data[1][1] = 5.0;
+    MATRIX_AT(a, 0, 0) = 5.0;
+    MATRIX_AT(a, 0, 1) = 5.0;
+    MATRIX_AT(a, 1, 0) = 5.0;
+    MATRIX_AT(a, 1, 1) = 5.0;
 
-    b.data[0][0] = 1.0;
-    b.data[0][1] = 2.0;
-    b.data[1][0] = 3.0;
-    b.data[1][1] = 4.0;
+    MATRIX_AT(b, 0, 0) = 1.0;
+    MATRIX_AT(b, 0, 1) = 2.0;
+    MATRIX_AT(b, 1, 0) = 3.0;
+    MATRIX_AT(b, 1, 1) = 4.0;
 
     Matrix result = subtract_matrices(a, b);
-    CU_ASSERT_DOUBLE_EQUAL(result.data[0][0], 4.0, 0.0001);
-    CU_ASSERT_DOUBLE_EQUAL(result.data[1][1], 1.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(result, 0, 0), 4.0, 0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(result, 1, 1), 1.0, 0.0001);
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(result);
+}
+
+/**
+ * @brief Тест умножения матриц из файлов по блокам
+ *
+ * Проверяет:
+ * - Выбор стороны блока по бюджету памяти
+ * - Совпадение результата с эталоном при неполных краевых блоках по всем измерениям
+ * - Повторное использование загруженного блока, когда общее измерение - один блок
+ */
+void test_multiply_matrix_files(void) {
+    CU_ASSERT(out_of_core_tile_size(5 * sizeof(double) * 16 * 16) == 16);
+    CU_ASSERT(out_of_core_tile_size(5 * sizeof(double) * 20 * 20) == 16);
+    CU_ASSERT(out_of_core_tile_size(1) == OUT_OF_CORE_TILE_MIN);
+
+    const char *a_file = "test_ooc_a.bin";
+    const char *b_file = "test_ooc_b.bin";
+    const char *c_file = "test_ooc_c.bin";
+    const int sizes[][3] = {{37, 53, 29}, {40, 12, 45}, {5, 8, 7}};
+    for (size_t iter = 0; iter < sizeof(sizes) / sizeof(sizes[0]); iter++) {
+        Matrix a = create_matrix(sizes[iter][0], sizes[iter][1]);
+        Matrix b = create_matrix(sizes[iter][1], sizes[iter][2]);
+        fill_pseudo_random(a, 70 + (unsigned)iter);
+        fill_pseudo_random(b, 80 + (unsigned)iter);
+        CU_ASSERT(save_matrix_to_binary_file(&a, a_file) == 0);
+        CU_ASSERT(save_matrix_to_binary_file(&b, b_file) == 0);
+
+        multiply_matrix_files(a_file, b_file, c_file, 5 * sizeof(double) * 16 * 16);
+        Matrix result = load_matrix_from_file(c_file);
+        Matrix expected = reference_multiply(a, b);
+        CU_ASSERT(result.rows == expected.rows && result.cols == expected.cols);
+        if (result.rows == expected.rows && result.cols == expected.cols) {
+            CU_ASSERT(max_abs_difference(result, expected) < 1e-12);
+        }
+
+        free_matrix(result);
+        free_matrix(expected);
+        free_matrix(a);
+        free_matrix(b);
+    }
+    remove(a_file);
+    remove(b_file);
+    remove(c_file);
+}
+
+/**
+ * @brief Тест счетчиков производительности
+ *
+ * Проверяет:
+ * - Учет вызовов, элементов, операций и выделенной памяти
+ * - Учет вложенных вызовов (multiply_matrices вызывает create_matrix)
+ * - Такой же учет операций над матрицами float
+ * - Отсутствие учета при выключенных счетчиках
+ */
+void test_matrix_stats(void) {
+    const int was_enabled = matrix_stats_enabled();
+    Matrix a = create_matrix(8, 6);
+    Matrix b = create_matrix(6, 5);
+
+    matrix_stats_set_enabled(1);
+    matrix_stats_reset();
+    Matrix c = multiply_matrices(a, b);
+    MatrixStatCounters counters;
+    matrix_stats_get(MATRIX_STAT_MULTIPLY, &counters);
+    CU_ASSERT(counters.calls == 1);
+    CU_ASSERT(counters.elements == 40);
+    CU_ASSERT(counters.flops == 2 * 8 * 5 * 6);
+    CU_ASSERT(counters.bytes_allocated == (uint64_t)c.rows * c.stride * sizeof(double));
+    CU_ASSERT(counters.max_ns <= counters.total_ns);
+    matrix_stats_get(MATRIX_STAT_MULTIPLY_INTO, &counters);
+    CU_ASSERT(counters.calls == 1 && counters.bytes_allocated == 0);
+    matrix_stats_get(MATRIX_STAT_CREATE, &counters);
+    CU_ASSERT(counters.calls == 1);
+
+    MatrixF a_f = matrix_to_float(a);
+    MatrixF b_f = matrix_to_float(b);
+    MatrixF c_f = multiply_matrices_f(a_f, b_f);
+    matrix_stats_get(MATRIX_STAT_MULTIPLY_F, &counters);
+    CU_ASSERT(counters.calls == 1);
+    CU_ASSERT(counters.elements == 40);
+    CU_ASSERT(counters.flops == 2 * 8 * 5 * 6);
+    CU_ASSERT(counters.bytes_allocated == (uint64_t)c_f.rows * c_f.stride * sizeof(float));
+    matrix_stats_get(MATRIX_STAT_CREATE_F, &counters);
+    CU_ASSERT(counters.calls == 3);
+    matrix_stats_get(MATRIX_STAT_TO_FLOAT, &counters);
+    CU_ASSERT(counters.calls == 2 && counters.elements == 8 * 6 + 6 * 5);
+    FILE *sink = tmpfile();
+    CU_ASSERT(sink != NULL && write_matrix_text_f(sink, &c_f, 3) == 0);
+    if (sink != NULL) {
+        fclose(sink);
+    }
+    matrix_stats_get(MATRIX_STAT_WRITE_TEXT_F, &counters);
+    CU_ASSERT(counters.calls == 1 && counters.elements == 40);
+    free_matrix_f(c_f);
+    free_matrix_f(b_f);
+    free_matrix_f(a_f);
+    matrix_stats_get(MATRIX_STAT_FREE_F, &counters);
+    CU_ASSERT(counters.calls == 3);
+
+    matrix_stats_set_enabled(0);
+    free_matrix(c);
+    c = multiply_matrices(a, b);
+    matrix_stats_get(MATRIX_STAT_MULTIPLY, &counters);
+    CU_ASSERT(counters.calls == 1);
+    matrix_stats_get(MATRIX_STAT_FREE, &counters);
+    CU_ASSERT(counters.calls == 0);
+
+    matrix_stats_reset();
+    matrix_stats_get(MATRIX_STAT_CREATE, &counters);
+    CU_ASSERT(counters.calls == 0 && counters.total_ns == 0);
+    matrix_stats_set_enabled(was_enabled);
 
     free_matrix(a);
     free_matrix(b);
+    free_matrix(c);
+}
+
+/**
+ * @brief Тест умножения по схеме Штрассена-Винограда
+ *
+ * Проверяет:
+ * - Совпадение с эталоном для нечетных и прямоугольных размеров на нескольких уровнях рекурсии
+ * - Погрешность квадратного произведения в пределах оценки Хайэма
+ * - Совпадение с обычным умножением для размеров меньше порога
+ */
+void test_strassen_multiply(void) {
+    const int sizes[][3] = {{67, 45, 53}, {33, 64, 17}, {64, 31, 128}};
+    for (size_t iter = 0; iter < sizeof(sizes) / sizeof(sizes[0]); iter++) {
+        const int m = sizes[iter][0];
+        const int n = sizes[iter][2];
+        const int k = sizes[iter][1];
+        Matrix a = create_matrix(m, k);
+        Matrix b = create_matrix(k, n);
+        Matrix result = create_matrix(m, n);
+        fill_pseudo_random(a, 90 + (unsigned)iter);
+        fill_pseudo_random(b, 100 + (unsigned)iter);
+        strassen_multiply(m, n, k, a.data, a.stride, b.data, b.stride, result.data,
+                          result.stride, 8, NULL);
+        Matrix expected = reference_multiply(a, b);
+        CU_ASSERT(max_abs_difference(result, expected) < 1e-12);
+        free_matrix(expected);
+        free_matrix(result);
+        free_matrix(a);
+        free_matrix(b);
+    }
+
+    const int order = 128;
+    const int crossover = 16;
+    Matrix a = create_matrix(order, order);
+    Matrix b = create_matrix(order, order);
+    Matrix result = create_matrix(order, order);
+    fill_pseudo_random(a, 110);
+    fill_pseudo_random(b, 111);
+    double *workspace = malloc(strassen_workspace_size(order, order, order, crossover) *
+                               sizeof(double));
+    strassen_multiply(order, order, order, a.data, a.stride, b.data, b.stride, result.data,
+                      result.stride, crossover, workspace);
+    free(workspace);
+
+    double error = 0;
+    for (int iter = 0; iter < order; iter++) {
+        for (int iter_2 = 0; iter_2 < order; iter_2++) {
+            long double sum = 0;
+            for (int iter_3 = 0; iter_3 < order; iter_3++) {
+                sum += (long double)MATRIX_AT(a, iter, iter_3) * MATRIX_AT(b, iter_3, iter_2);
+            }
+            double diff = fabs((double)(sum - MATRIX_AT(result, iter, iter_2)));
+            error = diff > error ? diff : error;
+        }
+    }
+    const double ratio = (double)order / crossover;
+    const double bound = (pow(ratio, log2(18.0)) * (crossover * crossover + 6.0 * crossover) -
+                          6.0 * order) * (DBL_EPSILON / 2);
+    printf("\nПогрешность Штрассена-Винограда (n = %d): %.3e, оценка %.3e\n", order, error,
+           bound);
+    CU_ASSERT(error <= bound);
+
+    Matrix small_a = create_matrix(45, 37);
+    Matrix small_b = create_matrix(37, 29);
+    fill_pseudo_random(small_a, 120);
+    fill_pseudo_random(small_b, 121);
+    Matrix classical = multiply_matrices(small_a, small_b);
+    Matrix strassen = multiply_matrices_strassen(small_a, small_b);
+    CU_ASSERT(matrices_identical(classical, strassen));
+    multiply_matrices_strassen_into(&result, a, b);
+    Matrix blocked = multiply_matrices(a, b);
+    CU_ASSERT(max_abs_difference(result, blocked) < 1e-12);
+
+    free_matrix(blocked);
+    free_matrix(strassen);
+    free_matrix(classical);
+    free_matrix(small_b);
+    free_matrix(small_a);
     free_matrix(result);
+    free_matrix(b);
+    free_matrix(a);
+}
+
+/**
+ * @brief Обнуляет большую часть элементов матрицы
+ * @param mat Матрица
+ * @param seed Начальное значение генератора
+ * @param percent Доля сохраняемых элементов в процентах
+ */
+static void sparsify(Matrix mat, unsigned seed, unsigned percent) {
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 8) % 100 >= percent) {
+                MATRIX_AT(mat, iter, iter_2) = 0.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Проверяет, что номера внутри каждой линии разреженной матрицы строго возрастают
+ */
+static int sparse_is_sorted(SparseMatrix mat) {
+    for (int iter = 0; iter < SPARSE_MAJOR(mat); iter++) {
+        for (size_t iter_2 = mat.offsets[iter] + 1; iter_2 < mat.offsets[iter + 1]; iter_2++) {
+            if (mat.indices[iter_2 - 1] >= mat.indices[iter_2]) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Сравнивает разреженную матрицу с плотной
+ * @return Наибольшее абсолютное отклонение или бесконечность при несовпадении размеров
+ */
+static double sparse_difference(SparseMatrix sparse, Matrix dense) {
+    if (!sparse_is_sorted(sparse)) {
+        return INFINITY;
+    }
+    Matrix expanded = sparse_to_dense(sparse);
+    double difference = expanded.rows == dense.rows && expanded.cols == dense.cols
+                            ? max_abs_difference(expanded, dense)
+                            : INFINITY;
+    free_matrix(expanded);
+    return difference;
+}
+
+/**
+ * @brief Тест операций с разреженными матрицами
+ *
+ * Проверяет:
+ * - Преобразование из плотной матрицы и обратно, смену формата CSR/CSC
+ * - Транспонирование, сложение и вычитание
+ * - Умножение на вектор, на плотную и на разреженную матрицу во всех сочетаниях форматов
+ */
+void test_sparse_matrix(void) {
+    Matrix a = create_matrix(47, 61);
+    Matrix b = create_matrix(61, 38);
+    Matrix c = create_matrix(47, 61);
+    fill_pseudo_random(a, 130);
+    fill_pseudo_random(b, 131);
+    fill_pseudo_random(c, 132);
+    sparsify(a, 140, 10);
+    sparsify(b, 141, 15);
+    sparsify(c, 142, 10);
+
+    const SparseFormat formats[] = {SPARSE_CSR, SPARSE_CSC};
+    for (int iter = 0; iter < 2; iter++) {
+        SparseMatrix sa = dense_to_sparse(a, formats[iter]);
+        SparseMatrix sc = dense_to_sparse(c, formats[iter]);
+        CU_ASSERT(sa.format == formats[iter]);
+        CU_ASSERT(sparse_difference(sa, a) == 0.0);
+
+        SparseMatrix other = convert_sparse(sa, formats[1 - iter]);
+        CU_ASSERT(SPARSE_NNZ(other) == SPARSE_NNZ(sa));
+        CU_ASSERT(sparse_difference(other, a) == 0.0);
+
+        SparseMatrix st = transpose_sparse(sa);
+        Matrix at = transpose_matrix(a);
+        CU_ASSERT(st.format == sa.format);
+        CU_ASSERT(sparse_difference(st, at) == 0.0);
+
+        SparseMatrix sum = plus_sparse(sa, sc);
+        Matrix dense_sum = plus_matrices(a, c);
+        CU_ASSERT(sparse_difference(sum, dense_sum) == 0.0);
+        SparseMatrix difference = subtract_sparse(sa, other);
+        CU_ASSERT(SPARSE_NNZ(difference) == SPARSE_NNZ(sa));
+        Matrix zero = create_matrix(a.rows, a.cols);
+        CU_ASSERT(sparse_difference(difference, zero) == 0.0);
+
+        double x[61];
+        double y[47];
+        for (int iter_2 = 0; iter_2 < a.cols; iter_2++) {
+            x[iter_2] = MATRIX_AT(b, iter_2, 3);
+        }
+        sparse_multiply_vector(sa, x, y);
+        Matrix expected = reference_multiply(a, b);
+        double vector_error = 0.0;
+        for (int iter_2 = 0; iter_2 < a.rows; iter_2++) {
+            vector_error = fmax(vector_error, fabs(y[iter_2] - MATRIX_AT(expected, iter_2, 3)));
+        }
+        CU_ASSERT(vector_error < 1e-12);
+
+        Matrix product = multiply_sparse_dense(sa, b);
+        CU_ASSERT(max_abs_difference(product, expected) < 1e-12);
+        for (int iter_2 = 0; iter_2 < 2; iter_2++) {
+            SparseMatrix sb = dense_to_sparse(b, formats[iter_2]);
+            SparseMatrix sparse_product = multiply_sparse(sa, sb);
+            CU_ASSERT(sparse_product.format == sa.format);
+            CU_ASSERT(sparse_difference(sparse_product, expected) < 1e-12);
+            free_sparse_matrix(sparse_product);
+            free_sparse_matrix(sb);
+        }
+
+        free_matrix(product);
+        free_matrix(expected);
+        free_matrix(zero);
+        free_sparse_matrix(difference);
+        free_matrix(dense_sum);
+        free_sparse_matrix(sum);
+        free_matrix(at);
+        free_sparse_matrix(st);
+        free_sparse_matrix(other);
+        free_sparse_matrix(sc);
+        free_sparse_matrix(sa);
+    }
+
+    /* Плотная строка результата упорядочивается просмотром аккумулятора */
+    Matrix full = create_matrix(3, 40);
+    fill_pseudo_random(full, 150);
+    SparseMatrix dense_left = dense_to_sparse(full, SPARSE_CSR);
+    Matrix full_right = transpose_matrix(full);
+    SparseMatrix dense_right = dense_to_sparse(full_right, SPARSE_CSR);
+    SparseMatrix gram = multiply_sparse(dense_right, dense_left);
+    Matrix expected_gram = reference_multiply(full_right, full);
+    CU_ASSERT(SPARSE_NNZ(gram) == 40 * 40);
+    CU_ASSERT(sparse_difference(gram, expected_gram) < 1e-12);
+    free_matrix(expected_gram);
+    free_sparse_matrix(gram);
+    free_sparse_matrix(dense_right);
+    free_matrix(full_right);
+    free_sparse_matrix(dense_left);
+    free_matrix(full);
+
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(c);
+}
+
+/**
+ * @brief Тест загрузки разреженной матрицы из файла в формате координат
+ *
+ * Проверяет:
+ * - Комментарии, суммирование повторяющихся координат, нумерацию с единицы
+ * - Заголовок Matrix Market с симметричной матрицей
+ */
+void test_load_sparse_matrix(void) {
+    const char *filename = "test_sparse.mtx";
+    FILE *file = fopen(filename, "w");
+    CU_ASSERT(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+    fprintf(file, "%% координаты с единицы\n3 4 5\n1 2 1.5\n3 4 -2\n%% повтор\n1 2 0.5\n"
+                  "2 1 4e-1\n3 1 7\n");
+    fclose(file);
+    SparseMatrix mat = load_sparse_matrix_from_file(filename, SPARSE_CSR);
+    Matrix expected = create_matrix(3, 4);
+    MATRIX_AT(expected, 0, 1) = 2.0;
+    MATRIX_AT(expected, 1, 0) = 0.4;
+    MATRIX_AT(expected, 2, 0) = 7.0;
+    MATRIX_AT(expected, 2, 3) = -2.0;
+    CU_ASSERT(SPARSE_NNZ(mat) == 4);
+    CU_ASSERT(sparse_difference(mat, expected) == 0.0);
+    free_sparse_matrix(mat);
+    free_matrix(expected);
+
+    file = fopen(filename, "w");
+    CU_ASSERT(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+    fprintf(file, "%%%%MatrixMarket matrix coordinate real symmetric\n3 3 3\n1 1 2\n3 1 -1\n"
+                  "3 2 5\n");
+    fclose(file);
+    mat = load_sparse_matrix_from_file(filename, SPARSE_CSC);
+    expected = create_matrix(3, 3);
+    MATRIX_AT(expected, 0, 0) = 2.0;
+    MATRIX_AT(expected, 2, 0) = MATRIX_AT(expected, 0, 2) = -1.0;
+    MATRIX_AT(expected, 2, 1) = MATRIX_AT(expected, 1, 2) = 5.0;
+    CU_ASSERT(mat.format == SPARSE_CSC);
+    CU_ASSERT(SPARSE_NNZ(mat) == 5);
+    CU_ASSERT(sparse_difference(mat, expected) == 0.0);
+    free_sparse_matrix(mat);
+    free_matrix(expected);
+    remove(filename);
+}
+
+/**
+ * @brief Тест матриц одинарной точности
+ *
+ * Проверяет:
+ * - Преобразование double -> float -> double с округлением к ближайшему float
+ * - Поэлементные операции, умножение и транспонирование float на всех уровнях
+ *   векторных инструкций (умножение - с точностью float относительно double)
+ * - Определитель, вычисляемый в double
+ * - Сохранение и загрузку в текстовом и двоичном формате, в том числе чтение
+ *   двоичного файла float как double и наоборот
+ */
+void test_float_matrices(void) {
+    Matrix a = create_matrix(67, 203);
+    Matrix b = create_matrix(67, 203);
+    Matrix c = create_matrix(203, 59);
+    fill_pseudo_random(a, 13);
+    fill_pseudo_random(b, 14);
+    fill_pseudo_random(c, 15);
+    MatrixF af = matrix_to_float(a);
+    MatrixF bf = matrix_to_float(b);
+    MatrixF cf = matrix_to_float(c);
+    CU_ASSERT(af.rows == 67 && af.cols == 203 && af.stride == matrix_stride_for_f(203));
+    CU_ASSERT_EQUAL((size_t)af.data % MATRIX_ALIGNMENT, 0);
+    int rounded = 1;
+    for (int iter = 0; iter < a.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < a.cols; iter_2++) {
+            rounded &= MATRIX_AT(af, iter, iter_2) == (float)MATRIX_AT(a, iter, iter_2);
+        }
+    }
+    CU_ASSERT(rounded);
+
+    Matrix wide_a = matrix_to_double(af);
+    Matrix wide_c = matrix_to_double(cf);
+    Matrix expected = reference_multiply(wide_a, wide_c);
+    SimdLevel saved = simd_kernels()->level;
+    SimdLevel top = simd_detect_level();
+    for (int level = SIMD_SCALAR; level <= (int)top; level++) {
+        CU_ASSERT_EQUAL(simd_set_level((SimdLevel)level), (SimdLevel)level);
+
+        MatrixF sum = plus_matrices_f(af, bf);
+        MatrixF diff = subtract_matrices_f(af, bf);
+        MatrixF copy = copy_matrix_f(af);
+        MatrixF transposed = transpose_matrix_f(af);
+        int exact = 1;
+        for (int iter = 0; iter < a.rows; iter++) {
+            for (int iter_2 = 0; iter_2 < a.cols; iter_2++) {
+                float x = MATRIX_AT(af, iter, iter_2);
+                float y = MATRIX_AT(bf, iter, iter_2);
+                exact &= MATRIX_AT(sum, iter, iter_2) == x + y;
+                exact &= MATRIX_AT(diff, iter, iter_2) == x - y;
+                exact &= MATRIX_AT(copy, iter, iter_2) == x;
+                exact &= MATRIX_AT(transposed, iter_2, iter) == x;
+            }
+        }
+        CU_ASSERT(exact);
+
+        // Элементы из [-1, 1]: ошибка суммы из k слагаемых не больше k·FLT_EPSILON
+        MatrixF product = multiply_matrices_f(af, cf);
+        Matrix wide_product = matrix_to_double(product);
+        CU_ASSERT(max_abs_difference(wide_product, expected) < af.cols * FLT_EPSILON);
+
+        free_matrix_f(sum);
+        free_matrix_f(diff);
+        free_matrix_f(copy);
+        free_matrix_f(transposed);
+        free_matrix_f(product);
+        free_matrix(wide_product);
+    }
+    simd_set_level(saved);
+
+    MatrixF square = create_matrix_f(3, 3);
+    const float values[9] = {2.0f, -1.0f, 0.5f, 4.0f, 3.0f, -2.0f, 1.0f, 0.25f, 5.0f};
+    Matrix square_wide = create_matrix(3, 3);
+    for (int iter = 0; iter < 9; iter++) {
+        MATRIX_AT(square, iter / 3, iter % 3) = values[iter];
+        MATRIX_AT(square_wide, iter / 3, iter % 3) = values[iter];
+    }
+    CU_ASSERT_DOUBLE_EQUAL(determinant_f(square), determinant(square_wide), 1e-12);
+    free_matrix_f(square);
+    free_matrix(square_wide);
+
+    const char *text_name = "test_float_matrix.txt";
+    const char *binary_name = "test_float_matrix.bin";
+    const char *double_name = "test_double_matrix.bin";
+    CU_ASSERT(save_matrix_to_file_f(&af, text_name) == 0);
+    MatrixF from_text = load_matrix_from_file_f(text_name);
+    CU_ASSERT(save_matrix_to_binary_file_f(&af, binary_name) == 0);
+    MatrixF mapped = load_matrix_from_file_f(binary_name);
+    CU_ASSERT(mapped.flags & MATRIX_MAPPED);
+    CU_ASSERT_EQUAL(mapped.stride, matrix_stride_for_f(af.cols));
+    Matrix widened = load_matrix_from_file(binary_name);
+    CU_ASSERT_FALSE(widened.flags & MATRIX_MAPPED);
+    CU_ASSERT(save_matrix_to_binary_file(&a, double_name) == 0);
+    MatrixF narrowed = load_matrix_from_file_f(double_name);
+    CU_ASSERT_FALSE(narrowed.flags & MATRIX_MAPPED);
+    int same = from_text.rows == af.rows && mapped.rows == af.rows &&
+               widened.rows == af.rows && narrowed.rows == af.rows;
+    for (int iter = 0; same && iter < af.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < af.cols; iter_2++) {
+            float value = MATRIX_AT(af, iter, iter_2);
+            same &= MATRIX_AT(from_text, iter, iter_2) == value;
+            same &= MATRIX_AT(mapped, iter, iter_2) == value;
+            same &= MATRIX_AT(widened, iter, iter_2) == (double)value;
+            same &= MATRIX_AT(narrowed, iter, iter_2) == value;
+        }
+    }
+    CU_ASSERT(same);
+    remove(text_name);
+    remove(binary_name);
+    remove(double_name);
+
+    free_matrix_f(from_text);
+    free_matrix_f(mapped);
+    free_matrix(widened);
+    free_matrix_f(narrowed);
+    free_matrix(expected);
+    free_matrix(wide_a);
+    free_matrix(wide_c);
+    free_matrix_f(af);
+    free_matrix_f(bf);
+    free_matrix_f(cf);
+    free_matrix(a);
+    free_matrix(b);
+    free_matrix(c);
+}
+
+/**
+ * @brief Заполняет пакет псевдослучайными матрицами и возвращает их копии
+ * @return Массив из batch.count матриц (освобождается вызывающим)
+ */
+static Matrix *fill_batch(MatrixBatch batch, unsigned seed) {
+    Matrix *mats = malloc((size_t)batch.count * sizeof(Matrix));
+    for (int iter = 0; iter < batch.count; iter++) {
+        mats[iter] = create_matrix(batch.rows, batch.cols);
+        fill_pseudo_random(mats[iter], seed + (unsigned)iter);
+        matrix_batch_set(batch, iter, mats[iter]);
+    }
+    return mats;
+}
+
+static void free_matrices(Matrix *mats, int count) {
+    for (int iter = 0; iter < count; iter++) {
+        free_matrix(mats[iter]);
+    }
+    free(mats);
+}
+
+/**
+ * @brief Тест пакетных операций над маленькими матрицами
+ *
+ * Проверяет для всех порядков от 1 до 10 (больше MATRIX_BATCH_MAX_ORDER - через
+ * обычный determinant), неквадратных матриц и всех уровней векторных инструкций:
+ * - Побитовое совпадение умножения с эталонным умножением каждой матрицы
+ * - Побитовое совпадение определителей с determinant, в том числе при равных по модулю
+ *   кандидатах в ведущие элементы
+ * - Поэлементные операции и транспонирование
+ * - Число матриц, не кратное MATRIX_BATCH_LANES
+ */
+void test_matrix_batch(void) {
+    const int count = 2 * MATRIX_BATCH_LANES + 5;
+    SimdLevel saved = simd_kernels()->level;
+    SimdLevel top = simd_detect_level();
+    for (int level = SIMD_SCALAR; level <= (int)top; level++) {
+        CU_ASSERT_EQUAL(simd_set_level((SimdLevel)level), (SimdLevel)level);
+        for (int order = 1; order <= MATRIX_BATCH_MAX_ORDER + 2; order++) {
+            // Для order > MATRIX_BATCH_MAX_ORDER проверяется и произведение неквадратных
+            const int inner = order > MATRIX_BATCH_MAX_ORDER ? order - 7 : order;
+            MatrixBatch a = create_matrix_batch(count, order, inner);
+            MatrixBatch b = create_matrix_batch(count, inner, order);
+            MatrixBatch square = create_matrix_batch(count, order, order);
+            Matrix *mats_a = fill_batch(a, 100u * (unsigned)order);
+            Matrix *mats_b = fill_batch(b, 200u * (unsigned)order);
+            Matrix *mats_square = fill_batch(square, 300u * (unsigned)order);
+            if (order == 4) {
+                // Вырожденная матрица: две одинаковые строки
+                for (int iter = 0; iter < order; iter++) {
+                    MATRIX_AT(mats_square[3], 1, iter) = MATRIX_AT(mats_square[3], 2, iter);
+                }
+                matrix_batch_set(square, 3, mats_square[3]);
+
+                // Равные по модулю кандидаты во втором столбце после перестановки в первом:
+                // ведущей должна стать та же строка, что и в determinant
+                const double tie[4][4] = {{1.0, 5.0, 0.37, -2.9},
+                                          {2.0, -5.0, 1.3, 0.71},
+                                          {4.0, 0.0, 0.0, 0.0},
+                                          {3.0, 1.9, -0.83, 4.1}};
+                for (int iter = 0; iter < order; iter++) {
+                    for (int iter_2 = 0; iter_2 < order; iter_2++) {
+                        MATRIX_AT(mats_square[4], iter, iter_2) = tie[iter][iter_2];
+                    }
+                }
+                matrix_batch_set(square, 4, mats_square[4]);
+            }
+
+            MatrixBatch product = multiply_matrix_batch(a, b);
+            MatrixBatch transposed = transpose_matrix_batch(a);
+            MatrixBatch sum = plus_matrix_batch(square, product);
+            MatrixBatch diff = subtract_matrix_batch(square, product);
+            double dets[2 * MATRIX_BATCH_LANES + 5];
+            determinant_matrix_batch(square, dets);
+
+            int exact = product.rows == order && product.cols == order &&
+                        transposed.rows == inner && transposed.cols == order;
+            for (int iter = 0; exact && iter < count; iter++) {
+                Matrix expected = reference_multiply(mats_a[iter], mats_b[iter]);
+                Matrix got = matrix_batch_get(product, iter);
+                exact &= matrices_identical(got, expected);
+                exact &= dets[iter] == determinant(mats_square[iter]);
+                for (int iter_2 = 0; iter_2 < order; iter_2++) {
+                    for (int iter_3 = 0; iter_3 < order; iter_3++) {
+                        double x = MATRIX_AT(mats_square[iter], iter_2, iter_3);
+                        double y = MATRIX_AT(expected, iter_2, iter_3);
+                        exact &= MATRIX_BATCH_AT(sum, iter, iter_2, iter_3) == x + y;
+                        exact &= MATRIX_BATCH_AT(diff, iter, iter_2, iter_3) == x - y;
+                    }
+                    for (int iter_3 = 0; iter_3 < inner; iter_3++) {
+                        exact &= MATRIX_BATCH_AT(transposed, iter, iter_3, iter_2) ==
+                                 MATRIX_AT(mats_a[iter], iter_2, iter_3);
+                    }
+                }
+                free_matrix(expected);
+                free_matrix(got);
+            }
+            CU_ASSERT(exact);
+            if (order == 4) {
+                CU_ASSERT(dets[3] == 0.0);
+            }
+
+            free_matrix_batch(product);
+            free_matrix_batch(transposed);
+            free_matrix_batch(sum);
+            free_matrix_batch(diff);
+            free_matrices(mats_a, count);
+            free_matrices(mats_b, count);
+            free_matrices(mats_square, count);
+            free_matrix_batch(a);
+            free_matrix_batch(b);
+            free_matrix_batch(square);
+        }
+    }
+    simd_set_level(saved);
+}
+
+/**
+ * @brief Тест упакованных симметричных и треугольных матриц
+ *
+ * Проверяет для порядков, не кратных PACKED_PANEL_ROWS и больших него:
+ * - Совпадение syrk_matrix с эталонным произведением X·Xᵀ
+ * - Упаковку и разворачивание всех видов матриц, доступ к элементам
+ * - Совпадение произведения упакованной матрицы на плотную с эталонным
+ */
+void test_packed_matrices(void) {
+    const int orders[] = {0, 1, 7, PACKED_PANEL_ROWS + 3, 2 * PACKED_PANEL_ROWS + 45};
+    const PackedKind kinds[] = {PACKED_SYMMETRIC, PACKED_LOWER, PACKED_UPPER};
+    for (size_t iter = 0; iter < sizeof(orders) / sizeof(orders[0]); iter++) {
+        const int order = orders[iter];
+        Matrix x = create_matrix(order, 37);
+        fill_pseudo_random(x, 500u + (unsigned)order);
+        Matrix xt = transpose_matrix(x);
+        Matrix gram = reference_multiply(x, xt);
+        PackedMatrix syrk = syrk_matrix(x);
+        Matrix syrk_dense = packed_to_dense(syrk);
+        CU_ASSERT_EQUAL(syrk.order, order);
+        CU_ASSERT_EQUAL(syrk.kind, PACKED_SYMMETRIC);
+        CU_ASSERT(max_abs_difference(syrk_dense, gram) < 1e-12);
+
+        Matrix square = create_matrix(order, order);
+        Matrix b = create_matrix(order, 29);
+        fill_pseudo_random(square, 600u + (unsigned)order);
+        fill_pseudo_random(b, 700u + (unsigned)order);
+        for (size_t iter_2 = 0; iter_2 < sizeof(kinds) / sizeof(kinds[0]); iter_2++) {
+            const PackedKind kind = kinds[iter_2];
+            PackedMatrix packed = dense_to_packed(square, kind);
+            Matrix expanded = packed_to_dense(packed);
+            int exact = 1;
+            for (int row = 0; row < order; row++) {
+                for (int col = 0; col < order; col++) {
+                    double expected = MATRIX_AT(square, row, col);
+                    if (kind == PACKED_SYMMETRIC && col > row) {
+                        expected = MATRIX_AT(square, col, row);
+                    } else if ((kind == PACKED_LOWER && col > row) ||
+                               (kind == PACKED_UPPER && col < row)) {
+                        expected = 0.0;
+                    }
+                    exact &= MATRIX_AT(expanded, row, col) == expected;
+                    exact &= packed_matrix_get(packed, row, col) == expected;
+                }
+            }
+            CU_ASSERT(exact);
+
+            Matrix product = multiply_packed_dense(packed, b);
+            Matrix expected = reference_multiply(expanded, b);
+            CU_ASSERT(max_abs_difference(product, expected) < 1e-12);
+            free_matrix(product);
+            free_matrix(expected);
+
+            if (order > 3) {
+                packed_matrix_set(packed, kind == PACKED_UPPER ? 1 : 3,
+                                  kind == PACKED_UPPER ? 3 : 1, 42.0);
+                CU_ASSERT_EQUAL(packed_matrix_get(packed, kind == PACKED_UPPER ? 1 : 3,
+                                                  kind == PACKED_UPPER ? 3 : 1), 42.0);
+                if (kind == PACKED_SYMMETRIC) {
+                    packed_matrix_set(packed, 0, 2, -5.0);
+                    CU_ASSERT_EQUAL(packed_matrix_get(packed, 2, 0), -5.0);
+                }
+            }
+            free_matrix(expanded);
+            free_packed_matrix(packed);
+        }
+
+        free_matrix(square);
+        free_matrix(b);
+        free_matrix(syrk_dense);
+        free_packed_matrix(syrk);
+        free_matrix(gram);
+        free_matrix(xt);
+        free_matrix(x);
+    }
+}
+
+/**
+ * @brief Тест представлений блоков матрицы
+ *
+ * Проверяет:
+ * - Общий буфер представления и исходной матрицы, флаги представления
+ * - Операции *_into между непересекающимися блоками одной матрицы
+ * - Определитель и транспонирование на месте для представления
+ * - Проверку пересечения блоков, в том числе с переносом через ведущую размерность
+ */
+void test_matrix_views(void) {
+    Matrix parent = create_matrix(40, 70);
+    fill_pseudo_random(parent, 900u);
+    Matrix block = matrix_view(parent, 3, 5, 10, 20);
+    CU_ASSERT(block.flags & MATRIX_VIEW);
+    CU_ASSERT(block.flags & MATRIX_BORROWED);
+    CU_ASSERT_EQUAL(block.stride, parent.stride);
+    CU_ASSERT_EQUAL(MATRIX_AT(block, 2, 4), MATRIX_AT(parent, 5, 9));
+    MATRIX_AT(block, 0, 0) = 7.0;
+    CU_ASSERT_EQUAL(MATRIX_AT(parent, 3, 5), 7.0);
+    Matrix row = matrix_row_view(parent, 6);
+    Matrix col = matrix_col_view(parent, 8);
+    CU_ASSERT(row.rows == 1 && row.cols == 70 && col.rows == 40 && col.cols == 1);
+    CU_ASSERT_EQUAL(MATRIX_AT(col, 6, 0), MATRIX_AT(row, 0, 8));
+
+    // Левая половина = левая + правая: диапазоны адресов половин чередуются
+    Matrix left = matrix_view(parent, 0, 0, 40, 35);
+    Matrix right = matrix_view(parent, 0, 35, 40, 35);
+    Matrix expected = plus_matrices(left, right);
+    plus_matrices_into(&left, left, right);
+    CU_ASSERT(matrices_identical(left, expected));
+    free_matrix(expected);
+
+    // Произведение блоков записывается в третий блок той же матрицы
+    Matrix a = matrix_view(parent, 0, 0, 20, 30);
+    Matrix b = matrix_view(parent, 0, 30, 30, 40);
+    Matrix c = matrix_view(parent, 30, 0, 10, 40);
+    CU_ASSERT(!matrices_overlap(a, b) && !matrices_overlap(b, c) && !matrices_overlap(a, c));
+    Matrix a_part = matrix_view(a, 0, 0, 10, 30);
+    Matrix reference = reference_multiply(a_part, b);
+    multiply_matrices_into(&c, a_part, b);
+    CU_ASSERT(max_abs_difference(c, reference) < 1e-12);
+    free_matrix(reference);
+
+    Matrix square = matrix_view(parent, 10, 40, 12, 12);
+    Matrix square_copy = copy_matrix(square);
+    CU_ASSERT_EQUAL(determinant(square), determinant(square_copy));
+    transpose_matrix_into(&square, square);
+    CU_ASSERT_EQUAL(MATRIX_AT(square, 2, 7), MATRIX_AT(square_copy, 7, 2));
+    CU_ASSERT_EQUAL(MATRIX_AT(parent, 10 + 2, 40 + 7), MATRIX_AT(square_copy, 7, 2));
+    free_matrix(square_copy);
+    free_matrix(square);
+
+    CU_ASSERT(matrices_overlap(row, col));
+    CU_ASSERT(matrices_overlap(block, matrix_view(parent, 12, 24, 5, 5)));
+    CU_ASSERT(!matrices_overlap(block, matrix_view(parent, 13, 5, 5, 5)));
+    CU_ASSERT(!matrices_overlap(matrix_view(parent, 0, 3, 3, 2), matrix_view(parent, 1, 0, 2, 2)));
+    // Строка второго блока выходит за ведущую размерность в решетке строк первого
+    CU_ASSERT(matrices_overlap(matrix_view(parent, 0, 3, 3, 2), matrix_view(parent, 1, 1, 1, 4)));
+    free_matrix(parent);
+}
+
+/**
+ * @brief Задача пула: освобождает копии [begin, end)
+ */
+static void free_copies_task(void *ctx, int begin, int end) {
+    Matrix *copies = (Matrix *)ctx;
+    for (int iter = begin; iter < end; iter++) {
+        free_matrix(copies[iter]);
+    }
+}
+
+/**
+ * @brief Тест режима копирования при записи
+ *
+ * Проверяет:
+ * - copy_matrix без копирования элементов и счетчик ссылок
+ * - Отделение буфера при matrix_make_writable и в операциях *_into
+ * - Представление, созданное до copy_matrix, не дает записать в общий буфер
+ * - Неизменность общего буфера при определителе, выражениях и записи в копию
+ * - Освобождение копий из нескольких потоков
+ */
+void test_copy_on_write(void) {
+    const int saved = matrix_copy_on_write_enabled();
+    matrix_set_copy_on_write(1);
+    Matrix a = create_matrix(60, 50);
+    fill_pseudo_random(a, 1000u);
+    Matrix original = create_matrix(60, 50);
+    copy_matrix_into(&original, a);
+    CU_ASSERT(a.flags & MATRIX_SHARED);
+
+    Matrix b = copy_matrix(a);
+    CU_ASSERT(b.data == a.data);
+    CU_ASSERT_EQUAL(matrix_reference_count(a), 2);
+    CU_ASSERT(matrix_view(a, 0, 0, 2, 2).flags & MATRIX_READONLY);
+    matrix_make_writable(&b);
+    CU_ASSERT(b.data != a.data);
+    CU_ASSERT(matrix_reference_count(a) == 1 && matrix_reference_count(b) == 1);
+    CU_ASSERT(matrices_identical(b, a));
+    MATRIX_AT(b, 0, 0) = 100.0;
+    CU_ASSERT(matrices_identical(a, original));
+
+    // Представление, созданное до появления копии, не позволяет изменить общий буфер
+    Matrix early_view = matrix_view(a, 0, 0, 3, 3);
+    CU_ASSERT_EQUAL(matrix_reference_count(a), 1);
+    CU_ASSERT(early_view.flags & MATRIX_READONLY);
+    Matrix late_copy = copy_matrix(a);
+    CU_ASSERT(late_copy.data == a.data);
+    CU_ASSERT(early_view.flags & MATRIX_READONLY);
+    matrix_make_writable(&a);
+    MATRIX_AT(a, 0, 0) += 1.0;
+    CU_ASSERT_EQUAL(MATRIX_AT(late_copy, 0, 0), MATRIX_AT(original, 0, 0));
+    MATRIX_AT(a, 0, 0) = MATRIX_AT(original, 0, 0);
+    free_matrix(late_copy);
+
+    Matrix c = copy_matrix(a);
+    plus_matrices_into(&c, c, a);
+    CU_ASSERT(c.data != a.data);
+    CU_ASSERT_EQUAL(MATRIX_AT(c, 5, 7), 2.0 * MATRIX_AT(a, 5, 7));
+    Matrix square = matrix_view(a, 0, 0, 40, 40);
+    Matrix d = copy_matrix(square);
+    Matrix e = copy_matrix(d);
+    transpose_matrix_into(&e, e);
+    CU_ASSERT_EQUAL(MATRIX_AT(e, 3, 9), MATRIX_AT(d, 9, 3));
+    const double det = determinant(d);
+    CU_ASSERT_EQUAL(determinant(d), det);
+    MatrixExpr *expr = matrix_expr_plus(matrix_expr_leaf(a), matrix_expr_leaf(a));
+    Matrix f = copy_matrix(a);
+    matrix_expr_evaluate_into(&f, expr);
+    matrix_expr_free(expr);
+    CU_ASSERT(f.data != a.data && matrix_reference_count(f) == 1);
+    CU_ASSERT(matrices_identical(f, c));
+    CU_ASSERT(matrices_identical(a, original));
+
+    int saved_threads = matrix_get_num_threads();
+    matrix_set_num_threads(4);
+    Matrix copies[64];
+    for (int iter = 0; iter < 64; iter++) {
+        copies[iter] = copy_matrix(a);
+    }
+    CU_ASSERT_EQUAL(matrix_reference_count(a), 65);
+    parallel_for(64, 1, free_copies_task, copies);
+    CU_ASSERT_EQUAL(matrix_reference_count(a), 1);
+    matrix_set_num_threads(saved_threads);
+
+    free_matrix(f);
+    free_matrix(e);
+    free_matrix(d);
+    free_matrix(c);
+    free_matrix(b);
+    free_matrix(original);
+    free_matrix(a);
+    matrix_set_copy_on_write(saved);
+}
+
+/**
+ * @brief Тест решения систем и обращения по LU-разложению
+ *
+ * Проверяет для порядков меньше и больше LU_BLOCK:
+ * - Невязку A·X - B для нескольких правых частей с одним разложением
+ * - Решение на месте и A·A^-1 = I
+ * - Совпадение determinant и log_abs_determinant с lu_determinant
+ * - Признак вырожденности разложения
+ */
+void test_lu_solver(void) {
+    const int orders[] = {1, 5, LU_BLOCK + 7, 2 * LU_BLOCK + 30};
+    for (size_t iter = 0; iter < sizeof(orders) / sizeof(orders[0]); iter++) {
+        const int n = orders[iter];
+        Matrix a = create_matrix(n, n);
+        Matrix b = create_matrix(n, 13);
+        Matrix vector = create_matrix(n, 1);
+        fill_pseudo_random(a, 1100u + (unsigned)n);
+        fill_pseudo_random(b, 1200u + (unsigned)n);
+        fill_pseudo_random(vector, 1300u + (unsigned)n);
+
+        LuFactorization lu = lu_factor(a);
+        CU_ASSERT_EQUAL(lu.info, 0);
+        Matrix x = lu_solve(lu, b);
+        Matrix check = multiply_matrices(a, x);
+        CU_ASSERT(max_abs_difference(check, b) < 1e-9);
+        free_matrix(check);
+
+        Matrix in_place = copy_matrix(vector);
+        lu_solve_into(&in_place, lu, in_place);
+        check = multiply_matrices(a, in_place);
+        CU_ASSERT(max_abs_difference(check, vector) < 1e-9);
+        free_matrix(check);
+
+        Matrix inverse = lu_inverse(lu);
+        Matrix identity = multiply_matrices(a, inverse);
+        for (int iter_2 = 0; iter_2 < n; iter_2++) {
+            MATRIX_AT(identity, iter_2, iter_2) -= 1.0;
+        }
+        Matrix zero = create_matrix(n, n);
+        CU_ASSERT(max_abs_difference(identity, zero) < 1e-9);
+
+        int sign;
+        CU_ASSERT_EQUAL(determinant(a), lu_determinant(lu));
+        CU_ASSERT_EQUAL(log_abs_determinant(a, &sign), lu_log_abs_determinant(lu, NULL));
+        CU_ASSERT_EQUAL(sign, lu_determinant(lu) < 0 ? -1 : 1);
+
+        free_matrix(zero);
+        free_matrix(identity);
+        free_matrix(inverse);
+        free_matrix(in_place);
+        free_matrix(x);
+        free_lu_factorization(lu);
+        free_matrix(vector);
+        free_matrix(b);
+        free_matrix(a);
+    }
+
+    // Вырожденная матрица: нулевая строка остается нулевой при исключении
+    Matrix singular = create_matrix(4, 4);
+    fill_pseudo_random(singular, 1400u);
+    for (int iter = 0; iter < 4; iter++) {
+        MATRIX_AT(singular, 2, iter) = 0.0;
+    }
+    LuFactorization lu = lu_factor(singular);
+    CU_ASSERT(lu.info != 0);
+    CU_ASSERT_EQUAL(lu_determinant(lu), 0.0);
+    free_lu_factorization(lu);
+    free_matrix(singular);
 }
 
 /**
@@ -270,11 +1855,32 @@ void register_matrix_operations_tests() {
     }
 
     CU_add_test(suite, "Создание и очистка матрицы", test_create_and_free_matrix);
+    CU_add_test(suite, "Размещение матрицы в памяти", test_matrix_layout);
     CU_add_test(suite, "Загрузка матрицы из файла", test_load_matrix_from_file);
+    CU_add_test(suite, "Быстрый разбор текста", test_matrix_text_parser);
     CU_add_test(suite, "Копирование матрицы", test_copy_matrix);
     CU_add_test(suite, "Сложение матриц", test_add_matrices);
     CU_add_test(suite, "Умножение матриц", test_multiply_matrices);
+    CU_add_test(suite, "Блочное умножение матриц", test_multiply_matrices_blocked);
+    CU_add_test(suite, "Умножение матриц из файлов", test_multiply_matrix_files);
+    CU_add_test(suite, "Счетчики производительности", test_matrix_stats);
+    CU_add_test(suite, "Умножение по схеме Штрассена-Винограда", test_strassen_multiply);
+    CU_add_test(suite, "Разреженные матрицы", test_sparse_matrix);
+    CU_add_test(suite, "Загрузка разреженной матрицы", test_load_sparse_matrix);
+    CU_add_test(suite, "Матрицы одинарной точности", test_float_matrices);
+    CU_add_test(suite, "Пакетные операции над маленькими матрицами", test_matrix_batch);
+    CU_add_test(suite, "Упакованные симметричные и треугольные матрицы", test_packed_matrices);
+    CU_add_test(suite, "Представления блоков матрицы", test_matrix_views);
+    CU_add_test(suite, "Копирование при записи", test_copy_on_write);
+    CU_add_test(suite, "Решение систем по LU-разложению", test_lu_solver);
+    CU_add_test(suite, "Векторные ядра и их выбор", test_simd_kernels_dispatch);
+    CU_add_test(suite, "Параллельное выполнение операций", test_parallel_operations);
+    CU_add_test(suite, "Операции с записью в готовую матрицу", test_into_operations);
+    CU_add_test(suite, "Арена временных матриц", test_matrix_arena);
+    CU_add_test(suite, "Объединенное вычисление выражений", test_matrix_expr);
     CU_add_test(suite, "Транспонирование матрицы", test_transpose_matrix);
+    CU_add_test(suite, "Блочное транспонирование", test_transpose_blocked);
     CU_add_test(suite, "Детерминант матрицы", test_determinant);
+    CU_add_test(suite, "Детерминант через LU-разложение", test_determinant_lu);
     CU_add_test(suite, "Вычитание матриц", test_subtract_matrices);
 }
\ No newline at end of file
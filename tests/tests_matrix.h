@@ -9,9 +9,26 @@
  
  #include <stdio.h>
  #include <stdlib.h>
+ #include <float.h>
+ #include <math.h>
+ #include <string.h>
  #include <CUnit/CUnit.h>
  #include <CUnit/Basic.h>
  #include "../src/matrix/matrix_operations.h"
+ #include "../src/matrix/gemm.h"
+ #include "../src/matrix/lu.h"
+ #include "../src/matrix/matrix_arena.h"
+ #include "../src/matrix/matrix_batch.h"
+ #include "../src/matrix/matrix_expr.h"
+ #include "../src/matrix/matrix_float.h"
+ #include "../src/matrix/matrix_out_of_core.h"
+ #include "../src/matrix/matrix_stats.h"
+ #include "../src/matrix/matrix_text.h"
+ #include "../src/matrix/packed_matrix.h"
+ #include "../src/matrix/simd_kernels.h"
+ #include "../src/matrix/sparse_matrix.h"
+ #include "../src/matrix/strassen.h"
+ #include "../src/output/output.h"
  
  /**
   * @brief Регистрирует все тестовые случаи для операций с матрицами
@@ -17,14 +17,10 @@
  * Это позволяет легко проверять корректность вывода
  */
 Matrix create_test_matrix(int rows, int cols) {
-    Matrix mat;
-    mat.rows = rows;
-    mat.cols = cols;
-    mat.data = (double **)malloc(rows * sizeof(double *));
+    Matrix mat = create_matrix(rows, cols);
     for (int iter = 0; iter < rows; iter++) {
-        mat.data[iter] = (double *)malloc(cols * sizeof(double));
         for (int iter_2 = 0; iter_2 < cols; iter_2++) {
-            mat.data[iter][iter_2] = (iter + 1) * 10 + (iter_2 + 1) * 0.1;
+            MATRIX_AT(mat, iter, iter_2) = (iter + 1) * 10 + (iter_2 + 1) * 0.1;
         }
     }
     return mat;
@@ -96,7 +92,7 @@ void test_save_matrix_to_file_normal(void) {
     for (int iter = 0; iter < 2; iter++) {
         for (int iter_2 = 0; iter_2 < 2; iter_2++) {
             CU_ASSERT(fscanf(file, "%lf", &val) == 1);
-            CU_ASSERT_DOUBLE_EQUAL(val, mat.data[iter][iter_2], 0.000001);
+            CU_ASSERT_DOUBLE_EQUAL(val, MATRIX_AT(mat, iter, iter_2), 0.000001);
         }
     }
 
@@ -125,6 +121,247 @@ void test_save_matrix_to_file_errors(void) {
     free_matrix(mat);
 }
 
+/**
+ * @brief Тест двоичного формата
+ *
+ * Проверяет:
+ * - Загрузку через load_matrix_from_file с распознаванием по сигнатуре
+ * - Отображение файла без копирования (флаги, выравнивание, шаг строк)
+ * - Точное совпадение элементов после записи и чтения
+ * - Чтение файла с обратным порядком байт
+ */
+void test_save_matrix_to_binary_file(void) {
+    const char *filename = "test_output_matrix.bin";
+    Matrix mat = create_test_matrix(3, 37);
+    MATRIX_AT(mat, 2, 36) = 1.0 / 3.0;
+    CU_ASSERT(save_matrix_to_binary_file(&mat, filename) == 0);
+
+    Matrix loaded = load_matrix_from_file(filename);
+    CU_ASSERT(loaded.rows == 3 && loaded.cols == 37);
+    CU_ASSERT(loaded.flags & MATRIX_MAPPED);
+    CU_ASSERT(loaded.flags & MATRIX_READONLY);
+    CU_ASSERT_EQUAL(loaded.stride, matrix_stride_for(37));
+    CU_ASSERT_EQUAL((size_t)loaded.data % MATRIX_ALIGNMENT, 0);
+    int same = 1;
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            same &= MATRIX_AT(loaded, iter, iter_2) == MATRIX_AT(mat, iter, iter_2);
+        }
+    }
+    CU_ASSERT(same);
+    free_matrix(loaded);
+
+    // Переставляем байты всех полей и элементов, как если бы файл записала другая машина
+    FILE *file = fopen(filename, "r+b");
+    CU_ASSERT_PTR_NOT_NULL(file);
+    if (file == NULL) {
+        remove(filename);
+        free_matrix(mat);
+        return;
+    }
+    unsigned char bytes[MATRIX_FILE_HEADER_SIZE];
+    long offsets[] = {8, 12, 16, 20};
+    CU_ASSERT(fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes));
+    for (size_t iter = 0; iter < sizeof(offsets) / sizeof(offsets[0]); iter++) {
+        unsigned char *field = bytes + offsets[iter];
+        unsigned char tmp = field[0];
+        field[0] = field[3];
+        field[3] = tmp;
+        tmp = field[1];
+        field[1] = field[2];
+        field[2] = tmp;
+    }
+    for (int iter = 24; iter < MATRIX_FILE_HEADER_SIZE; iter += 8) {
+        for (int iter_2 = 0; iter_2 < 4; iter_2++) {
+            unsigned char tmp = bytes[iter + iter_2];
+            bytes[iter + iter_2] = bytes[iter + 7 - iter_2];
+            bytes[iter + 7 - iter_2] = tmp;
+        }
+    }
+    rewind(file);
+    CU_ASSERT(fwrite(bytes, 1, sizeof(bytes), file) == sizeof(bytes));
+    unsigned char value[8];
+    long position = MATRIX_FILE_HEADER_SIZE;
+    while (fseek(file, position, SEEK_SET) == 0 && fread(value, 1, 8, file) == 8) {
+        for (int iter = 0; iter < 4; iter++) {
+            unsigned char tmp = value[iter];
+            value[iter] = value[7 - iter];
+            value[7 - iter] = tmp;
+        }
+        fseek(file, position, SEEK_SET);
+        fwrite(value, 1, 8, file);
+        position += 8;
+    }
+    fclose(file);
+
+    Matrix swapped = load_matrix_from_file(filename);
+    CU_ASSERT_FALSE(swapped.flags & MATRIX_MAPPED);
+    CU_ASSERT(swapped.rows == 3 && swapped.cols == 37);
+    same = 1;
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            same &= MATRIX_AT(swapped, iter, iter_2) == MATRIX_AT(mat, iter, iter_2);
+        }
+    }
+    CU_ASSERT(same);
+
+    CU_ASSERT(save_matrix_to_binary_file(NULL, filename) == -1);
+    CU_ASSERT(save_matrix_to_binary_file(&mat, "/nonexistent_dir/test.bin") == -1);
+
+    remove(filename);
+    free_matrix(swapped);
+    free_matrix(mat);
+}
+
+/**
+ * @brief Тест быстрого форматирования чисел и записи матрицы в поток
+ *
+ * Проверяет:
+ * - Точное восстановление strtod из кратчайшей записи для случайных битовых шаблонов
+ * - Совпадение записи с фиксированной точностью с snprintf("%.*f")
+ * - Запись матрицы пакетами (с параллельным форматированием) и чтение обратно
+ */
+void test_double_format(void) {
+    char buffer[DOUBLE_FORMAT_FIXED_MAX(17)];
+    char expected[DOUBLE_FORMAT_FIXED_MAX(17)];
+    unsigned long long state = 0x9E3779B97F4A7C15ull;
+    int round_trip = 1;
+    int fixed_match = 1;
+
+    for (int iter = 0; iter < 200000; iter++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        double value;
+        if (iter % 2 == 0) {
+            unsigned long long bits = state ^ (state >> 29);
+            memcpy(&value, &bits, sizeof(value));
+            if (!isfinite(value)) {
+                continue;
+            }
+        } else {
+            value = (double)(long long)(state >> 20) / 1e6 - 4e6;
+        }
+
+        int length = format_double_shortest(value, buffer);
+        double parsed = strtod(buffer, NULL);
+        round_trip &= length == (int)strlen(buffer) && length < DOUBLE_FORMAT_SHORTEST_MAX &&
+                      memcmp(&parsed, &value, sizeof(value)) == 0;
+
+        int precision = iter % 12;
+        format_double_fixed(value, precision, buffer);
+        snprintf(expected, sizeof(expected), "%.*f", precision, value);
+        fixed_match &= strcmp(buffer, expected) == 0;
+    }
+    CU_ASSERT(round_trip);
+    CU_ASSERT(fixed_match);
+
+    format_double_shortest(0.1, buffer);
+    CU_ASSERT(strcmp(buffer, "0.1") == 0);
+    format_double_shortest(-1500.0, buffer);
+    CU_ASSERT(strcmp(buffer, "-1500") == 0);
+    format_double_shortest(1e22, buffer);
+    CU_ASSERT(strcmp(buffer, "1e22") == 0);
+    format_double_shortest(-0.0, buffer);
+    CU_ASSERT(strcmp(buffer, "-0") == 0);
+    format_double_fixed(2.5, 0, buffer);
+    CU_ASSERT(strcmp(buffer, "2") == 0);
+    format_double_fixed(-0.001, 2, buffer);
+    CU_ASSERT(strcmp(buffer, "-0.00") == 0);
+
+    Matrix mat = create_test_matrix(70, 90);
+    MATRIX_AT(mat, 3, 4) = 1.0 / 3.0;
+    MATRIX_AT(mat, 69, 89) = -2.5e-300;
+    FILE *file = tmpfile();
+    CU_ASSERT(file != NULL);
+    if (file == NULL) {
+        free_matrix(mat);
+        return;
+    }
+    CU_ASSERT(write_matrix_text(file, &mat, OUTPUT_PRECISION_SHORTEST) == 0);
+    rewind(file);
+    int same = 1;
+    for (int iter = 0; iter < mat.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat.cols; iter_2++) {
+            double value = 0.0;
+            same &= fscanf(file, "%lf", &value) == 1 && value == MATRIX_AT(mat, iter, iter_2);
+        }
+    }
+    CU_ASSERT(same);
+    fclose(file);
+    free_matrix(mat);
+}
+
+/**
+ * @brief Число значащих цифр в десятичной записи числа
+ */
+static int significant_digits(const char *text) {
+    int first = -1;
+    int last = -1;
+    int count = 0;
+    for (; *text != '\0' && *text != 'e'; text++) {
+        if (*text >= '0' && *text <= '9') {
+            if (*text != '0') {
+                first = first < 0 ? count : first;
+                last = count;
+            }
+            count++;
+        }
+    }
+    return first < 0 ? 0 : last - first + 1;
+}
+
+/**
+ * @brief Тест кратчайшей записи чисел float
+ *
+ * Проверяет:
+ * - Точное восстановление strtof для случайных битовых шаблонов
+ * - Не больше 9 значащих цифр и краткость для простых значений
+ * - Запись матрицы float в поток и чтение обратно
+ */
+void test_float_format(void) {
+    char buffer[DOUBLE_FORMAT_SHORTEST_MAX];
+    unsigned state = 0x9E3779B9u;
+    int round_trip = 1;
+    int short_enough = 1;
+    for (int iter = 0; iter < 200000; iter++) {
+        state = state * 1664525u + 1013904223u;
+        float value;
+        memcpy(&value, &state, sizeof(value));
+        if (!isfinite(value)) {
+            continue;
+        }
+        int length = format_float_shortest(value, buffer);
+        float parsed = strtof(buffer, NULL);
+        round_trip &= length == (int)strlen(buffer) && memcmp(&parsed, &value, sizeof(value)) == 0;
+        short_enough &= significant_digits(buffer) <= 9;
+    }
+    CU_ASSERT(round_trip);
+    CU_ASSERT(short_enough);
+
+    format_float_shortest(0.1f, buffer);
+    CU_ASSERT(strcmp(buffer, "0.1") == 0);
+    format_float_shortest(-3.4028235e38f, buffer);
+    CU_ASSERT(strcmp(buffer, "-3.4028235e38") == 0);
+    format_float_shortest(1e-45f, buffer);
+    CU_ASSERT(strcmp(buffer, "1e-45") == 0);
+
+    MatrixF mat = create_matrix_f(2, 3);
+    MATRIX_AT(mat, 0, 0) = 0.1f;
+    MATRIX_AT(mat, 1, 2) = 1.0f / 3.0f;
+    FILE *file = tmpfile();
+    CU_ASSERT(file != NULL);
+    if (file == NULL) {
+        free_matrix_f(mat);
+        return;
+    }
+    CU_ASSERT(write_matrix_text_f(file, &mat, OUTPUT_PRECISION_SHORTEST) == 0);
+    rewind(file);
+    char text[128] = {0};
+    CU_ASSERT(fread(text, 1, sizeof(text) - 1, file) > 0);
+    CU_ASSERT(strcmp(text, "0.1 0 0 \n0 0 0.33333334 \n") == 0);
+    fclose(file);
+    free_matrix_f(mat);
+}
+
 /**
  * @brief Тест форматированного вывода матрицы
  *
@@ -144,6 +381,350 @@ void test_print_matrix_formatted(void) {
     free_matrix(mat);
 }
 
+/**
+ * @brief Считает строки ответа сервера, начинающиеся с prefix
+ */
+static int count_replies(FILE *out, const char *prefix) {
+    char line[512];
+    int count = 0;
+    rewind(out);
+    while (fgets(line, sizeof(line), out) != NULL) {
+        count += strncmp(line, prefix, strlen(prefix)) == 0;
+    }
+    return count;
+}
+
+/**
+ * @brief Тест пакетного режима (matrix_server.h)
+ *
+ * Проверяет:
+ * - Загрузку матриц по именам и вычисление A - (B + C * D)^T, совпадающее с
+ *   вычислением отдельными операциями
+ * - Запись повторного результата того же размера в прежний буфер
+ * - Сообщения об ошибках размеров, неизвестных имен и команд без завершения сервера
+ * - Ошибку загрузки поврежденных текстовых и двоичных файлов без завершения сервера
+ * - Сохранение результата в двоичный файл, освобождение матрицы и команду quit
+ * - Отказ открывать сокет по пути, занятому обычным файлом (файл сохраняется)
+ */
+void test_matrix_server(void) {
+    const char *paths[4] = {"test_server_A.txt", "test_server_B.txt", "test_server_C.txt",
+                            "test_server_D.txt"};
+    Matrix inputs[4] = {create_test_matrix(2, 3), create_test_matrix(3, 2),
+                        create_test_matrix(3, 4), create_test_matrix(4, 2)};
+    MATRIX_AT(inputs[2], 1, 2) = 1.0 / 3.0;
+    for (int iter = 0; iter < 4; iter++) {
+        CU_ASSERT(save_matrix_to_file(&inputs[iter], paths[iter]) == 0);
+    }
+
+    const char *commands = "load A test_server_A.txt\n"
+                           "load B test_server_B.txt\n"
+                           "load C test_server_C.txt\n"
+                           "# комментарий\n"
+                           "\n"
+                           "load D test_server_D.txt\n"
+                           "eval R A - (B + C * D)^T\n";
+    MatrixServer *server = matrix_server_create();
+    FILE *out = tmpfile();
+    CU_ASSERT_PTR_NOT_NULL(out);
+    if (out == NULL) {
+        matrix_server_destroy(server);
+        return;
+    }
+    FILE *in = fmemopen((void *)commands, strlen(commands), "r");
+    CU_ASSERT(matrix_server_run(server, in, out) == MATRIX_SERVER_QUIT);
+    fclose(in);
+    CU_ASSERT_EQUAL(count_replies(out, "ok "), 5);
+
+    Matrix product = multiply_matrices(inputs[2], inputs[3]);
+    Matrix sum = plus_matrices(inputs[1], product);
+    Matrix transposed = transpose_matrix(sum);
+    Matrix expected = subtract_matrices(inputs[0], transposed);
+    const Matrix *result = matrix_server_find(server, "R");
+    CU_ASSERT_PTR_NOT_NULL(result);
+    if (result != NULL) {
+        CU_ASSERT(result->rows == 2 && result->cols == 3);
+        double difference = 0.0;
+        for (int iter = 0; iter < 2; iter++) {
+            for (int iter_2 = 0; iter_2 < 3; iter_2++) {
+                difference = fmax(difference, fabs(MATRIX_AT(*result, iter, iter_2) -
+                                                   MATRIX_AT(expected, iter, iter_2)));
+            }
+        }
+        CU_ASSERT(difference < 1e-9);
+
+        // Результат того же размера записывается в прежний буфер, даже если читает R
+        const double *buffer = result->data;
+        CU_ASSERT(matrix_server_execute(server, "eval R R + A'^T", out) ==
+                  MATRIX_SERVER_CONTINUE);
+        result = matrix_server_find(server, "R");
+        CU_ASSERT(result->data == buffer);
+        CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(*result, 1, 2),
+                               MATRIX_AT(expected, 1, 2) + MATRIX_AT(inputs[0], 1, 2), 1e-9);
+    }
+
+    // Поврежденные файлы: неверный токен, нехватка элементов, огромные размеры,
+    // неверный заголовок, усеченные данные и недопустимое выравнивание двоичного файла
+    const char *broken[] = {"2 2\n1 2\n3 x\n", "2 2\n1 2 3\n", "100000 100000\n1\n"};
+    const char *broken_paths[] = {"test_server_bad.txt", "test_server_short.txt",
+                                  "test_server_huge.txt"};
+    for (int iter = 0; iter < 3; iter++) {
+        FILE *file = fopen(broken_paths[iter], "w");
+        CU_ASSERT_PTR_NOT_NULL(file);
+        if (file != NULL) {
+            fputs(broken[iter], file);
+            fclose(file);
+        }
+    }
+    FILE *header = fopen("test_server_header.bin", "wb");
+    CU_ASSERT_PTR_NOT_NULL(header);
+    if (header != NULL) {
+        char bytes[MATRIX_FILE_HEADER_SIZE] = {0};
+        memcpy(bytes, MATRIX_FILE_MAGIC, MATRIX_FILE_MAGIC_SIZE);
+        fwrite(bytes, 1, sizeof(bytes), header);
+        fclose(header);
+    }
+    CU_ASSERT(save_matrix_to_binary_file(&inputs[2], "test_server_short.bin") == 0);
+    CU_ASSERT(truncate("test_server_short.bin", MATRIX_FILE_HEADER_SIZE + 16) == 0);
+    CU_ASSERT(save_matrix_to_binary_file(&inputs[2], "test_server_aligned.bin") == 0);
+    FILE *aligned = fopen("test_server_aligned.bin", "r+b");
+    CU_ASSERT_PTR_NOT_NULL(aligned);
+    if (aligned != NULL) {
+        const uint32_t alignment = 24;
+        fseek(aligned, (long)offsetof(MatrixFileHeader, alignment), SEEK_SET);
+        fwrite(&alignment, sizeof(alignment), 1, aligned);
+        fclose(aligned);
+    }
+
+    // Ошибки не завершают сервер и не меняют матрицы
+    const char *bad[] = {"eval E A * A",
+                         "eval E A + B",
+                         "eval E A + Q",
+                         "eval E (A",
+                         "eval E A B",
+                         "eval 1E A",
+                         "load F missing_file.txt",
+                         "load F test_server_bad.txt",
+                         "load F test_server_short.txt",
+                         "load F test_server_huge.txt",
+                         "load F test_server_header.bin",
+                         "load F test_server_short.bin",
+                         "load F test_server_aligned.bin",
+                         "print Q",
+                         "print R 99",
+                         "free A extra",
+                         "frobnicate"};
+    const int bad_count = (int)(sizeof(bad) / sizeof(bad[0]));
+    for (int iter = 0; iter < bad_count; iter++) {
+        CU_ASSERT(matrix_server_execute(server, bad[iter], out) == MATRIX_SERVER_CONTINUE);
+    }
+    CU_ASSERT_EQUAL(count_replies(out, "error "), bad_count);
+    CU_ASSERT_PTR_NULL(matrix_server_find(server, "E"));
+    CU_ASSERT_PTR_NULL(matrix_server_find(server, "F"));
+    CU_ASSERT_PTR_NOT_NULL(matrix_server_find(server, "A"));
+    for (int iter = 0; iter < 3; iter++) {
+        remove(broken_paths[iter]);
+    }
+    remove("test_server_header.bin");
+    remove("test_server_short.bin");
+    remove("test_server_aligned.bin");
+
+    CU_ASSERT(matrix_server_execute(server, "eval E A**T", out) == MATRIX_SERVER_CONTINUE);
+    CU_ASSERT(matrix_server_find(server, "E") != NULL &&
+              matrix_server_find(server, "E")->rows == 3);
+    CU_ASSERT(matrix_server_execute(server, "save R test_server_R.bin binary", out) ==
+              MATRIX_SERVER_CONTINUE);
+    Matrix saved = load_matrix_from_file("test_server_R.bin");
+    result = matrix_server_find(server, "R");
+    CU_ASSERT(result != NULL && saved.rows == 2 &&
+              MATRIX_AT(saved, 0, 1) == MATRIX_AT(*result, 0, 1));
+    free_matrix(saved);
+    CU_ASSERT(matrix_server_execute(server, "free R", out) == MATRIX_SERVER_CONTINUE);
+    CU_ASSERT_PTR_NULL(matrix_server_find(server, "R"));
+    CU_ASSERT_PTR_NOT_NULL(matrix_server_find(server, "D"));
+
+    const char *tail = "list\nquit\nfree A\n";
+    in = fmemopen((void *)tail, strlen(tail), "r");
+    CU_ASSERT(matrix_server_run(server, in, out) == MATRIX_SERVER_QUIT);
+    fclose(in);
+    CU_ASSERT_PTR_NOT_NULL(matrix_server_find(server, "A"));
+    CU_ASSERT_EQUAL(count_replies(out, "E 3x2"), 1);
+
+    CU_ASSERT(matrix_server_listen(server, paths[0]) == -1);
+    Matrix kept = load_matrix_from_file(paths[0]);
+    CU_ASSERT(kept.rows == 2 && kept.cols == 3);
+    free_matrix(kept);
+
+    fclose(out);
+    matrix_server_destroy(server);
+    for (int iter = 0; iter < 4; iter++) {
+        remove(paths[iter]);
+        free_matrix(inputs[iter]);
+    }
+    remove("test_server_R.bin");
+    free_matrix(product);
+    free_matrix(sum);
+    free_matrix(transposed);
+    free_matrix(expected);
+}
+
+/**
+ * @brief Проверяет поэлементное совпадение матриц одного размера
+ */
+static int same_elements(Matrix mat1, Matrix mat2) {
+    if (mat1.rows != mat2.rows || mat1.cols != mat2.cols) {
+        return 0;
+    }
+    for (int iter = 0; iter < mat1.rows; iter++) {
+        for (int iter_2 = 0; iter_2 < mat1.cols; iter_2++) {
+            if (MATRIX_AT(mat1, iter, iter_2) != MATRIX_AT(mat2, iter, iter_2)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Пауза, после которой время изменения файлов гарантированно различается
+ */
+static void pause_for_mtime(void) {
+    struct timespec delay = {.tv_sec = 0, .tv_nsec = 20000000};
+    nanosleep(&delay, NULL);
+}
+
+/**
+ * @brief Тест дискового кэша матриц
+ *
+ * Проверяет:
+ * - Промах при первой загрузке файла и попадание при повторной с тем же результатом
+ * - Попадание для произведения тех же операндов и промах после изменения файла операнда
+ * - Вытеснение давно не использованного элемента при превышении ограничения размера
+ * - Пропуск элементов больше ограничения и работу без кэша
+ * - Удаление усеченного или поврежденного элемента с промахом вместо завершения программы
+ */
+void test_matrix_cache(void) {
+    const char *directory = "test_matrix_cache";
+    const char *path_a = "test_cache_A.txt";
+    const char *path_b = "test_cache_B.txt";
+    matrix_cache_set_directory(directory);
+    matrix_cache_set_limit(MATRIX_CACHE_DEFAULT_LIMIT);
+    matrix_cache_clear();
+    matrix_cache_reset_stats();
+
+    Matrix a = create_test_matrix(40, 30);
+    Matrix b = create_test_matrix(30, 20);
+    MATRIX_AT(a, 3, 7) = 1.0 / 7.0;
+    CU_ASSERT(save_matrix_to_file(&a, path_a) == 0);
+    CU_ASSERT(save_matrix_to_file(&b, path_b) == 0);
+
+    MatrixHash hash_a, hash_a2, hash_b, hash_ab, hash_ab2;
+    Matrix loaded = matrix_cache_load_file(path_a, &hash_a);
+    Matrix cached = matrix_cache_load_file(path_a, &hash_a2);
+    CU_ASSERT(hash_a == hash_a2 && hash_a != 0);
+    CU_ASSERT_FALSE(loaded.flags & MATRIX_MAPPED);
+    CU_ASSERT(cached.flags & MATRIX_MAPPED);
+    CU_ASSERT(same_elements(loaded, a) && same_elements(cached, a));
+    MatrixCacheStats stats;
+    matrix_cache_get_stats(&stats);
+    CU_ASSERT(stats.hits == 1 && stats.misses == 1 && stats.stores == 1);
+
+    Matrix loaded_b = matrix_cache_load_file(path_b, &hash_b);
+    Matrix product = matrix_cache_multiply(loaded, hash_a, loaded_b, hash_b, &hash_ab);
+    Matrix cached_product = matrix_cache_multiply(cached, hash_a2, loaded_b, hash_b, &hash_ab2);
+    CU_ASSERT(hash_ab == hash_ab2);
+    CU_ASSERT(cached_product.flags & MATRIX_MAPPED);
+    CU_ASSERT(same_elements(product, cached_product));
+    matrix_cache_get_stats(&stats);
+    CU_ASSERT(stats.hits == 2 && stats.misses == 3 && stats.stores == 3);
+
+    // Изменение файла меняет ключ загрузки и ключ зависящего от него произведения
+    MATRIX_AT(b, 0, 0) += 1.0;
+    CU_ASSERT(save_matrix_to_file(&b, path_b) == 0);
+    Matrix changed_b = matrix_cache_load_file(path_b, &hash_b);
+    Matrix changed_product = matrix_cache_multiply(cached, hash_a, changed_b, hash_b, &hash_ab2);
+    CU_ASSERT(hash_ab2 != hash_ab);
+    CU_ASSERT_FALSE(changed_product.flags & MATRIX_MAPPED);
+    CU_ASSERT_DOUBLE_EQUAL(MATRIX_AT(changed_product, 0, 0),
+                           MATRIX_AT(product, 0, 0) + MATRIX_AT(a, 0, 0), 1e-9);
+    free_matrix(changed_product);
+    free_matrix(changed_b);
+    free_matrix(cached_product);
+    free_matrix(product);
+    free_matrix(loaded_b);
+    free_matrix(cached);
+
+    // Помещаются два элемента: третий вытесняет тот, что дольше всех не использовался
+    const size_t entry =
+        MATRIX_FILE_HEADER_SIZE + (size_t)a.rows * matrix_stride_for(a.cols) * sizeof(double);
+    matrix_cache_clear();
+    matrix_cache_reset_stats();
+    matrix_cache_set_limit(2 * entry + entry / 2);
+    Matrix found;
+    matrix_cache_store(1, &a);
+    pause_for_mtime();
+    matrix_cache_store(2, &a);
+    pause_for_mtime();
+    CU_ASSERT(matrix_cache_lookup(1, &found));
+    free_matrix(found);
+    pause_for_mtime();
+    matrix_cache_store(3, &a);
+    CU_ASSERT_FALSE(matrix_cache_lookup(2, &found));
+    CU_ASSERT(matrix_cache_lookup(1, &found));
+    free_matrix(found);
+    CU_ASSERT(matrix_cache_lookup(3, &found));
+    CU_ASSERT(same_elements(found, a));
+    free_matrix(found);
+    Matrix large = create_test_matrix(100, 100);
+    matrix_cache_store(4, &large);
+    CU_ASSERT_FALSE(matrix_cache_lookup(4, &found));
+    matrix_cache_get_stats(&stats);
+    CU_ASSERT(stats.stores == 3 && stats.evictions == 1);
+
+    // Усеченный элемент и элемент с испорченным заголовком - промахи, файлы удаляются
+    const char *entry_3 = "test_matrix_cache/0000000000000003.bin";
+    CU_ASSERT(truncate(entry_3, 40) == 0);
+    CU_ASSERT_FALSE(matrix_cache_lookup(3, &found));
+    CU_ASSERT(access(entry_3, F_OK) != 0);
+    matrix_cache_store(3, &a);
+    CU_ASSERT(truncate(entry_3, (off_t)entry - 8) == 0);
+    CU_ASSERT_FALSE(matrix_cache_lookup(3, &found));
+    matrix_cache_store(3, &a);
+    FILE *corrupt = fopen(entry_3, "r+b");
+    CU_ASSERT_PTR_NOT_NULL(corrupt);
+    if (corrupt != NULL) {
+        fputs("garbage!", corrupt);
+        fclose(corrupt);
+    }
+    matrix_cache_reset_stats();
+    CU_ASSERT_FALSE(matrix_cache_lookup(3, &found));
+    CU_ASSERT(access(entry_3, F_OK) != 0);
+    matrix_cache_store(3, &a);
+    CU_ASSERT(matrix_cache_lookup(3, &found));
+    CU_ASSERT(same_elements(found, a));
+    free_matrix(found);
+    matrix_cache_get_stats(&stats);
+    CU_ASSERT(stats.misses == 1 && stats.hits == 1 && stats.stores == 1);
+
+    matrix_cache_clear();
+    CU_ASSERT(rmdir(directory) == 0);
+    matrix_cache_set_directory(NULL);
+    CU_ASSERT_FALSE(matrix_cache_enabled());
+    matrix_cache_reset_stats();
+    Matrix uncached = matrix_cache_load_file(path_a, &hash_a);
+    CU_ASSERT(hash_a == 0 && same_elements(uncached, a));
+    CU_ASSERT_FALSE(matrix_cache_lookup(1, &found));
+    matrix_cache_get_stats(&stats);
+    CU_ASSERT(stats.hits == 0 && stats.misses == 0);
+
+    remove(path_a);
+    remove(path_b);
+    free_matrix(uncached);
+    free_matrix(large);
+    free_matrix(loaded);
+    free_matrix(a);
+    free_matrix(b);
+}
+
 /**
  * @brief Регистрирует все тесты функций вывода
  *
@@ -152,7 +733,11 @@ void test_print_matrix_formatted(void) {
  * - Граничных случаев
  * - Сохранения в файл
  * - Обработки ошибок
+ * - Двоичного формата
+ * - Форматирования чисел
  * - Форматированного вывода
+ * - Пакетного режима
+ * - Дискового кэша матриц
  */
 void register_output_operations_tests() {
     CU_pSuite suite = CU_add_suite("Вывод матриц", NULL, NULL);
@@ -165,5 +750,10 @@ void register_output_operations_tests() {
     CU_add_test(suite, "Граничные случаи", test_print_matrix_edge_cases);
     CU_add_test(suite, "Сохранение в файл", test_save_matrix_to_file_normal);
     CU_add_test(suite, "Ошибки сохранения", test_save_matrix_to_file_errors);
+    CU_add_test(suite, "Двоичный формат", test_save_matrix_to_binary_file);
+    CU_add_test(suite, "Форматирование чисел", test_double_format);
+    CU_add_test(suite, "Форматирование чисел float", test_float_format);
     CU_add_test(suite, "Форматированный вывод", test_print_matrix_formatted);
+    CU_add_test(suite, "Пакетный режим", test_matrix_server);
+    CU_add_test(suite, "Дисковый кэш", test_matrix_cache);
 }
\ No newline at end of file
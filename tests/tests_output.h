@@ -16,13 +16,21 @@
  #include <stdio.h>
  #include <string.h>
  #include <stdlib.h>
+ #include <stddef.h>
  #include <sys/stat.h>
  #include <math.h>
+ #include <time.h>
+ #include <unistd.h>
  #include <CUnit/CUnit.h>
  #include <CUnit/Basic.h>
  #include "../src/include/config.h"
+ #include "../src/include/matrix_format.h"
+ #include "../src/matrix/matrix_float.h"
  #include "../src/matrix/matrix_operations.h"
+ #include "../src/output/double_format.h"
+ #include "../src/output/matrix_cache.h"
  #include "../src/output/output.h"
+ #include "../src/server/matrix_server.h"
  
  /**
   * @brief Регистрирует все тесты для функций вывода матриц
@@ -32,7 +40,11 @@
   * - test_print_matrix_edge_cases: Тестирование граничных случаев
   * - test_save_matrix_to_file_normal: Тестирование сохранения в файл
   * - test_save_matrix_to_file_errors: Тестирование обработки ошибок
+  * - test_save_matrix_to_binary_file: Тестирование двоичного формата
+  * - test_double_format: Тестирование форматирования чисел
   * - test_print_matrix_formatted: Тестирование форматированного вывода
+  * - test_matrix_server: Тестирование пакетного режима
+  * - test_matrix_cache: Тестирование дискового кэша матриц
   * 
   * @note Должен вызываться перед запуском тестов CU_BasicRun()
   * @see output.h